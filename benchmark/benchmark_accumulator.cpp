@@ -0,0 +1,71 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_common.hpp"
+#include "xtensor/xaccumulator.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+
+namespace xt
+{
+    using shape_type = xarray<double>::shape_type;
+
+    // The argument is the accumulation axis of a 64 x 64 x 64 array.
+    // Assigning an xaccumulator traverses the array row by row whatever
+    // the axis, while the loop walks along the axis for each position of
+    // the orthogonal slice.
+
+    static void accumulator_cumsum(benchmark::State& state)
+    {
+        std::size_t axis = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({64, 64, 64}), 1.);
+        xarray<double> res(a.shape());
+        for (auto _ : state)
+        {
+            noalias(res) = cumsum(a, axis);
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+    }
+    BENCHMARK(accumulator_cumsum)->Arg(0)->Arg(1)->Arg(2);
+
+    static void accumulator_cumsum_loop(benchmark::State& state)
+    {
+        std::size_t axis = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({64, 64, 64}), 1.);
+        xarray<double> res(a.shape());
+        std::size_t strides[] = {64 * 64, 64, 1};
+        std::size_t stride = strides[axis];
+        std::size_t outer_stride = strides[axis == 0 ? 1 : 0];
+        std::size_t inner_stride = strides[axis == 2 ? 1 : 2];
+        for (auto _ : state)
+        {
+            const double* src = a.data().data();
+            double* dst = res.data().data();
+            for (std::size_t i = 0; i < 64; ++i)
+            {
+                for (std::size_t j = 0; j < 64; ++j)
+                {
+                    std::size_t offset = i * outer_stride + j * inner_stride;
+                    double acc = 0.;
+                    for (std::size_t k = 0; k < 64; ++k, offset += stride)
+                    {
+                        acc += src[offset];
+                        dst[offset] = acc;
+                    }
+                }
+            }
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+    }
+    BENCHMARK(accumulator_cumsum_loop)->Arg(0)->Arg(1)->Arg(2);
+}
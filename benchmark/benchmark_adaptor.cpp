@@ -0,0 +1,60 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_common.hpp"
+#include "xtensor/xarray.hpp"
+
+namespace xt
+{
+    using vector_type = std::vector<double>;
+    using adaptor_type = xarray_adaptor<vector_type>;
+    using shape_type = adaptor_type::shape_type;
+
+    // The argument is the number of rows of 1024 doubles, i.e. the size
+    // of the buffer in units of 8 KB.
+
+    static void adaptor_assign(benchmark::State& state)
+    {
+        std::size_t rows = static_cast<std::size_t>(state.range(0));
+        vector_type v(rows * 1024, 1.);
+        adaptor_type a(v, shape_type({rows, 1024}));
+        xarray<double> b(shape_type({rows, 1024}), 2.);
+        allocation_counter counter;
+        for (auto _ : state)
+        {
+            a = b * 0.5 + 1.;
+            benchmark::DoNotOptimize(v.data());
+        }
+        counter.report(state);
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(v.size() * sizeof(double)));
+    }
+    BENCHMARK(adaptor_assign)->RangeMultiplier(4)->Range(64, 4096);
+
+    static void adaptor_assign_reshape(benchmark::State& state)
+    {
+        std::size_t rows = static_cast<std::size_t>(state.range(0));
+        vector_type v(rows * 1024, 1.);
+        adaptor_type a(v, shape_type({rows, 1024}));
+        xarray<double> b(shape_type({2, rows, 1024}), 2.);
+        xarray<double> c(shape_type({rows, 1024}), 3.);
+        allocation_counter counter;
+        for (auto _ : state)
+        {
+            a = b + 1.;
+            a = c + 1.;
+            benchmark::DoNotOptimize(v.data());
+        }
+        counter.report(state);
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(3 * rows * 1024 * sizeof(double)));
+    }
+    BENCHMARK(adaptor_assign_reshape)->RangeMultiplier(4)->Range(64, 4096);
+}
@@ -0,0 +1,154 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_common.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+
+namespace xt
+{
+    using shape_type = xarray<double>::shape_type;
+
+    // The argument is the number of columns of a matrix of 64 rows.
+    // Broadcasting a row over the matrix goes through data_assigner
+    // while adding two matrices of the same shape is a trivial
+    // broadcast, assigned by batches of elements.
+
+    static void assign_trivial(benchmark::State& state)
+    {
+        std::size_t cols = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({64, cols}), 1.);
+        xarray<double> b(shape_type({64, cols}), 2.);
+        xarray<double> res(shape_type({64, cols}));
+        for (auto _ : state)
+        {
+            noalias(res) = a + b;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(assign_trivial)->RangeMultiplier(8)->Range(8, 4096);
+
+    static void assign_broadcast_row(benchmark::State& state)
+    {
+        std::size_t cols = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({64, cols}), 1.);
+        xarray<double> b(shape_type({cols}), 2.);
+        xarray<double> res(shape_type({64, cols}));
+        for (auto _ : state)
+        {
+            noalias(res) = a + b;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(assign_broadcast_row)->RangeMultiplier(8)->Range(8, 4096);
+
+    static void assign_broadcast_column(benchmark::State& state)
+    {
+        std::size_t cols = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({64, cols}), 1.);
+        xarray<double> b(shape_type({64, 1}), 2.);
+        xarray<double> res(shape_type({64, cols}));
+        for (auto _ : state)
+        {
+            noalias(res) = a + b;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(assign_broadcast_column)->RangeMultiplier(8)->Range(8, 4096);
+
+    // Same as assign_broadcast_row with column-major matrices, whose
+    // columns are assigned by the innermost loop.
+
+    static void assign_broadcast_row_column_major(benchmark::State& state)
+    {
+        std::size_t cols = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({64, cols}), 1., layout::column_major);
+        xarray<double> b(shape_type({cols}), 2.);
+        xarray<double> res(shape_type({64, cols}), layout::column_major);
+        for (auto _ : state)
+        {
+            noalias(res) = a + b;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(assign_broadcast_row_column_major)->RangeMultiplier(8)->Range(8, 4096);
+
+    // Copies of a 4096 x 4096 column-major matrix into a row-major one:
+    // the assignment goes through tiled_assigner, while data_assigner
+    // traverses the rows of the result, reading the matrix with a stride
+    // of 4096 elements.
+
+    static void assign_transpose_tiled(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({4096, 4096}), 1., layout::column_major);
+        xarray<double> res(shape_type({4096, 4096}));
+        for (auto _ : state)
+        {
+            noalias(res) = a;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(assign_transpose_tiled);
+
+    static void assign_transpose_rows(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({4096, 4096}), 1., layout::column_major);
+        xarray<double> res(shape_type({4096, 4096}));
+        for (auto _ : state)
+        {
+            data_assigner<xarray<double>, xarray<double>>(res, a).run();
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(assign_transpose_rows);
+
+    // A 4096 x 4096 column-major matrix plus a column broadcast along
+    // its rows, assigned to a column-major matrix: the function is read
+    // along the columns of the matrix, so the assignment is not tiled.
+
+    static void assign_function_column_major(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({4096, 4096}), 1., layout::column_major);
+        xarray<double> b(shape_type({4096, 1}), 2., layout::column_major);
+        xarray<double> res(shape_type({4096, 4096}), layout::column_major);
+        for (auto _ : state)
+        {
+            noalias(res) = a + b;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(assign_function_column_major);
+
+    // Assignment of a 6-D grid of extent 8 plus a 3-D grid broadcast
+    // along its three outermost dimensions: the three innermost
+    // dimensions are merged into rows of 512 elements.
+
+    static void assign_broadcast_6d(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({8, 8, 8, 8, 8, 8}), 1.);
+        xarray<double> b(shape_type({8, 8, 8}), 2.);
+        xarray<double> res(a.shape());
+        for (auto _ : state)
+        {
+            noalias(res) = a + b;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(assign_broadcast_6d);
+}
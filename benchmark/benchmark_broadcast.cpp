@@ -0,0 +1,53 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbroadcast.hpp"
+#include "xtensor/xnoalias.hpp"
+
+namespace xt
+{
+    using shape_type = xarray<double>::shape_type;
+
+    // Design matrix of 1024 x 1024 elements built from a column of
+    // observations and a row of weights: the column is either copied
+    // into a full matrix first, or broadcast lazily.
+
+    static void broadcast_copy(benchmark::State& state)
+    {
+        xarray<double> col(shape_type({1024, 1}), 2.);
+        xarray<double> row(shape_type({1024}), 3.);
+        xarray<double> res;
+        for (auto _ : state)
+        {
+            xarray<double> full(shape_type({1024, 1024}));
+            noalias(full) = col;
+            res = full * row;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * 1024 * 1024);
+    }
+    BENCHMARK(broadcast_copy);
+
+    static void broadcast_lazy(benchmark::State& state)
+    {
+        xarray<double> col(shape_type({1024, 1}), 2.);
+        xarray<double> row(shape_type({1024}), 3.);
+        xarray<double> res;
+        for (auto _ : state)
+        {
+            res = broadcast(col, shape_type({1024, 1024})) * row;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * 1024 * 1024);
+    }
+    BENCHMARK(broadcast_lazy);
+}
@@ -0,0 +1,48 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef BENCHMARK_COMMON_HPP
+#define BENCHMARK_COMMON_HPP
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+
+namespace xt
+{
+    namespace benchmark_detail
+    {
+        extern std::size_t allocation_count;
+    }
+
+    // Counts the allocations performed between its construction and the
+    // call to report, and stores the average per iteration in the
+    // "allocs" counter of the benchmark.
+    class allocation_counter
+    {
+
+    public:
+
+        inline allocation_counter()
+            : m_start(benchmark_detail::allocation_count)
+        {
+        }
+
+        inline void report(benchmark::State& state) const
+        {
+            double count = static_cast<double>(benchmark_detail::allocation_count - m_start);
+            state.counters["allocs"] = count / static_cast<double>(state.iterations());
+        }
+
+    private:
+
+        std::size_t m_start;
+    };
+}
+
+#endif
@@ -0,0 +1,83 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using shape_type = xarray<double>::shape_type;
+
+    // Binary searches in a sorted 1024 x 1024 matrix: xiterator moves by
+    // any number of elements in constant time, so that std::lower_bound
+    // performs a logarithmic number of steps, as on the linear storage.
+
+    static void iterator_lower_bound(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({1024, 1024}));
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            a.data_element(i) = double(i);
+        }
+        double value = 0.;
+        for (auto _ : state)
+        {
+            auto it = std::lower_bound(a.cbegin(), a.cend(), value);
+            benchmark::DoNotOptimize(*it);
+            value = value < double(a.size() - 7919) ? value + 7919. : 0.;
+        }
+    }
+    BENCHMARK(iterator_lower_bound);
+
+    static void iterator_lower_bound_storage(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({1024, 1024}));
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            a.data_element(i) = double(i);
+        }
+        double value = 0.;
+        for (auto _ : state)
+        {
+            auto it = std::lower_bound(a.storage_begin(), a.storage_end(), value);
+            benchmark::DoNotOptimize(*it);
+            value = value < double(a.size() - 7919) ? value + 7919. : 0.;
+        }
+    }
+    BENCHMARK(iterator_lower_bound_storage);
+
+    // Median of a column of a 1024 x 1024 matrix, through a view.
+
+    static void iterator_nth_element_view(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({1024, 1024}));
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            a.data_element(i) = double((i * 7919) % 1031);
+        }
+        auto col = make_xview(a, range(0, 1024), 3);
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            for (std::size_t i = 0; i < 1024; ++i)
+            {
+                col(i) = double((i * 7919) % 1031);
+            }
+            state.ResumeTiming();
+            auto it = col.begin() + 512;
+            std::nth_element(col.begin(), it, col.end());
+            benchmark::DoNotOptimize(*it);
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * 1024);
+    }
+    BENCHMARK(iterator_nth_element_view);
+}
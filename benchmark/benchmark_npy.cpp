@@ -0,0 +1,91 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_common.hpp"
+#include "xtensor/xnpy.hpp"
+
+namespace xt
+{
+    using shape_type = xarray<double>::shape_type;
+
+    // The argument is the number of rows of 1024 doubles. The raw
+    // fwrite/fread benchmarks give the bound dump_npy and load_npy
+    // should be close to.
+
+    static const std::string npy_path = "xtensor_benchmark.npy";
+
+    static void npy_raw_fwrite(benchmark::State& state)
+    {
+        std::size_t rows = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({rows, 1024}), 1.);
+        for (auto _ : state)
+        {
+            std::FILE* f = std::fopen(npy_path.c_str(), "wb");
+            std::fwrite(a.data().data(), sizeof(double), a.size(), f);
+            std::fclose(f);
+        }
+        std::remove(npy_path.c_str());
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(a.size() * sizeof(double)));
+    }
+    BENCHMARK(npy_raw_fwrite)->RangeMultiplier(8)->Range(8, 4096);
+
+    static void npy_dump(benchmark::State& state)
+    {
+        std::size_t rows = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({rows, 1024}), 1., layout::column_major);
+        allocation_counter counter;
+        for (auto _ : state)
+        {
+            dump_npy(npy_path, a);
+        }
+        counter.report(state);
+        std::remove(npy_path.c_str());
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(a.size() * sizeof(double)));
+    }
+    BENCHMARK(npy_dump)->RangeMultiplier(8)->Range(8, 4096);
+
+    static void npy_raw_fread(benchmark::State& state)
+    {
+        std::size_t rows = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({rows, 1024}), 1.);
+        dump_npy(npy_path, a);
+        for (auto _ : state)
+        {
+            std::FILE* f = std::fopen(npy_path.c_str(), "rb");
+            std::fseek(f, 128, SEEK_SET);
+            std::size_t n = std::fread(a.data().data(), sizeof(double), a.size(), f);
+            std::fclose(f);
+            benchmark::DoNotOptimize(n);
+        }
+        std::remove(npy_path.c_str());
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(a.size() * sizeof(double)));
+    }
+    BENCHMARK(npy_raw_fread)->RangeMultiplier(8)->Range(8, 4096);
+
+    static void npy_load(benchmark::State& state)
+    {
+        std::size_t rows = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({rows, 1024}), 1.);
+        dump_npy(npy_path, a);
+        allocation_counter counter;
+        for (auto _ : state)
+        {
+            load_npy(npy_path, a);
+            benchmark::DoNotOptimize(a.data().data());
+        }
+        counter.report(state);
+        std::remove(npy_path.c_str());
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(a.size() * sizeof(double)));
+    }
+    BENCHMARK(npy_load)->RangeMultiplier(8)->Range(8, 4096);
+}
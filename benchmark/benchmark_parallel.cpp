@@ -0,0 +1,76 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xparallel.hpp"
+
+namespace xt
+{
+    using shape_type = xarray<double>::shape_type;
+
+    // The arguments are the number of rows of a matrix of 1024 columns
+    // and the number of threads assigning it; one thread means that
+    // parallel assignment is disabled.
+
+    class parallel_scope
+    {
+
+    public:
+
+        explicit parallel_scope(benchmark::State& state)
+        {
+            std::size_t num_threads = static_cast<std::size_t>(state.range(1));
+            if(num_threads > 1)
+            {
+                enable_parallel_assign(num_threads, 0);
+            }
+        }
+
+        ~parallel_scope()
+        {
+            disable_parallel_assign();
+        }
+    };
+
+    static void parallel_assign_trivial(benchmark::State& state)
+    {
+        std::size_t rows = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({rows, 1024}), 1.);
+        xarray<double> b(shape_type({rows, 1024}), 2.);
+        xarray<double> res(shape_type({rows, 1024}));
+        parallel_scope scope(state);
+        for (auto _ : state)
+        {
+            noalias(res) = a + b * exp(a);
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(parallel_assign_trivial)->ArgsProduct({{16, 256, 4096}, {1, 2, 4, 8}})->UseRealTime();
+
+    static void parallel_assign_broadcast(benchmark::State& state)
+    {
+        std::size_t rows = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({rows, 1024}), 1.);
+        xarray<double> b(shape_type({1024}), 2.);
+        xarray<double> res(shape_type({rows, 1024}));
+        parallel_scope scope(state);
+        for (auto _ : state)
+        {
+            noalias(res) = a + b * exp(a);
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(res.size()));
+    }
+    BENCHMARK(parallel_assign_broadcast)->ArgsProduct({{16, 256, 4096}, {1, 2, 4, 8}})->UseRealTime();
+}
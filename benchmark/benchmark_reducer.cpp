@@ -0,0 +1,94 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_common.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xreducer.hpp"
+
+namespace xt
+{
+    using shape_type = xarray<double>::shape_type;
+
+    // The argument is the reduced axis of a 512 x 512 matrix. Assigning
+    // an xreducer traverses the matrix row by row whatever the axis,
+    // while evaluating it element by element, as inside an xfunction,
+    // reduces along the axis for each element of the result.
+
+    static void reducer_sum(benchmark::State& state)
+    {
+        std::size_t axis = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({512, 512}), 1.);
+        xarray<double> res(shape_type({512}));
+        for (auto _ : state)
+        {
+            noalias(res) = sum(a, { axis });
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+    }
+    BENCHMARK(reducer_sum)->Arg(0)->Arg(1);
+
+    static void reducer_sum_elementwise(benchmark::State& state)
+    {
+        std::size_t axis = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({512, 512}), 1.);
+        xarray<double> res(shape_type({512}));
+        for (auto _ : state)
+        {
+            noalias(res) = sum(a, { axis }) + 0.;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+    }
+    BENCHMARK(reducer_sum_elementwise)->Arg(0)->Arg(1);
+
+    static void reducer_sum_loop(benchmark::State& state)
+    {
+        std::size_t axis = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({512, 512}), 1.);
+        xarray<double> res(shape_type({512}));
+        for (auto _ : state)
+        {
+            std::fill(res.storage_begin(), res.storage_end(), 0.);
+            for (std::size_t i = 0; i < 512; ++i)
+            {
+                for (std::size_t j = 0; j < 512; ++j)
+                {
+                    res(axis == 0 ? j : i) += a(i, j);
+                }
+            }
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+    }
+    BENCHMARK(reducer_sum_loop)->Arg(0)->Arg(1);
+
+    // The argument is the number of threads summing a vector of 2^22
+    // floats, 0 standing for the serial evaluation.
+
+    static void reducer_sum_float(benchmark::State& state)
+    {
+        std::size_t thread_count = static_cast<std::size_t>(state.range(0));
+        xarray<float> a(shape_type({std::size_t(1) << 22}), 0.1f);
+        xarray<float> res(shape_type({}));
+        xthread_pool pool(thread_count == 0 ? 1 : thread_count);
+        xexecutor* executor = thread_count == 0 ? nullptr : &pool;
+        for (auto _ : state)
+        {
+            sum(a).assign_to(res, executor);
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+    }
+    BENCHMARK(reducer_sum_float)->Arg(0)->Arg(1)->Arg(2)->Arg(4);
+}
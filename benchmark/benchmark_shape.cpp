@@ -0,0 +1,94 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_common.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+
+namespace xt
+{
+    using shape_type = xarray<double>::shape_type;
+
+    // The arguments are the number of dimensions, each dimension
+    // having a size of 4. Assigning without temporary to an already
+    // allocated array must not allocate as long as the shape is stored
+    // inline.
+
+    inline shape_type make_bench_shape(std::size_t dim)
+    {
+        return shape_type(dim, std::size_t(4));
+    }
+
+    static void shape_assign_function(benchmark::State& state)
+    {
+        shape_type shape = make_bench_shape(static_cast<std::size_t>(state.range(0)));
+        xarray<double> a(shape, 1.);
+        xarray<double> b(shape, 2.);
+        xarray<double> res(shape);
+        allocation_counter counter;
+        for (auto _ : state)
+        {
+            noalias(res) = a + b;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        counter.report(state);
+    }
+    BENCHMARK(shape_assign_function)->DenseRange(1, 8);
+
+    static void shape_computed_assign(benchmark::State& state)
+    {
+        shape_type shape = make_bench_shape(static_cast<std::size_t>(state.range(0)));
+        xarray<double> a(shape, 1.);
+        xarray<double> res(shape, 0.);
+        allocation_counter counter;
+        for (auto _ : state)
+        {
+            noalias(res) += a;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        counter.report(state);
+    }
+    BENCHMARK(shape_computed_assign)->DenseRange(1, 8);
+
+    static void shape_broadcast_assign(benchmark::State& state)
+    {
+        std::size_t dim = static_cast<std::size_t>(state.range(0));
+        shape_type shape = make_bench_shape(dim);
+        xarray<double> a(shape, 1.);
+        xarray<double> b(make_bench_shape(dim - 1), 2.);
+        xarray<double> res(shape);
+        allocation_counter counter;
+        for (auto _ : state)
+        {
+            noalias(res) = a * b;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        counter.report(state);
+    }
+    BENCHMARK(shape_broadcast_assign)->DenseRange(2, 8);
+
+    static void shape_iterate(benchmark::State& state)
+    {
+        xarray<double> a(make_bench_shape(static_cast<std::size_t>(state.range(0))), 1.);
+        allocation_counter counter;
+        for (auto _ : state)
+        {
+            double sum = 0.;
+            for (auto it = a.cbegin(); it != a.cend(); ++it)
+            {
+                sum += *it;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        counter.report(state);
+    }
+    BENCHMARK(shape_iterate)->DenseRange(1, 8);
+}
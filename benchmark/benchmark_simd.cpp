@@ -0,0 +1,131 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_common.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+
+namespace xt
+{
+    // Each expression is assigned twice: by batches through assign_data,
+    // and element by element through the storage iterators of the
+    // expression, which is how trivial broadcasts were assigned before
+    // the SIMD interface. The argument is the number of elements.
+
+    template <class T>
+    struct simd_operands
+    {
+        using array_type = xarray<T>;
+        using shape_type = typename array_type::shape_type;
+
+        explicit simd_operands(std::size_t size)
+            : a(shape_type({size}), T(0.5)),
+              b(shape_type({size}), T(1.5)),
+              c(shape_type({size}), T(2.5)),
+              res(shape_type({size}))
+        {
+        }
+
+        array_type a;
+        array_type b;
+        array_type c;
+        array_type res;
+    };
+
+    template <class T>
+    void simd_add_mul(benchmark::State& state)
+    {
+        simd_operands<T> op(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            noalias(op.res) = op.a + op.b * op.c;
+            benchmark::DoNotOptimize(op.res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(op.res.size()));
+    }
+
+    template <class T>
+    void scalar_add_mul(benchmark::State& state)
+    {
+        simd_operands<T> op(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            auto f = op.a + op.b * op.c;
+            std::copy(f.storage_begin(), f.storage_end(), op.res.storage_begin());
+            benchmark::DoNotOptimize(op.res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(op.res.size()));
+    }
+
+    template <class T>
+    void simd_exp_sin(benchmark::State& state)
+    {
+        simd_operands<T> op(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            noalias(op.res) = exp(op.a) * sin(op.b);
+            benchmark::DoNotOptimize(op.res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(op.res.size()));
+    }
+
+    template <class T>
+    void scalar_exp_sin(benchmark::State& state)
+    {
+        simd_operands<T> op(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            auto f = exp(op.a) * sin(op.b);
+            std::copy(f.storage_begin(), f.storage_end(), op.res.storage_begin());
+            benchmark::DoNotOptimize(op.res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(op.res.size()));
+    }
+
+    template <class T>
+    void simd_log_tanh_erf(benchmark::State& state)
+    {
+        simd_operands<T> op(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            noalias(op.res) = log(op.a) + tanh(op.b) * erf(op.c);
+            benchmark::DoNotOptimize(op.res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(op.res.size()));
+    }
+
+    template <class T>
+    void scalar_log_tanh_erf(benchmark::State& state)
+    {
+        simd_operands<T> op(static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            auto f = log(op.a) + tanh(op.b) * erf(op.c);
+            std::copy(f.storage_begin(), f.storage_end(), op.res.storage_begin());
+            benchmark::DoNotOptimize(op.res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(op.res.size()));
+    }
+
+    BENCHMARK_TEMPLATE(simd_add_mul, float)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(scalar_add_mul, float)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(simd_add_mul, double)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(scalar_add_mul, double)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(simd_exp_sin, float)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(scalar_exp_sin, float)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(simd_exp_sin, double)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(scalar_exp_sin, double)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(simd_log_tanh_erf, float)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(scalar_log_tanh_erf, float)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(simd_log_tanh_erf, double)->Range(64, 1 << 16);
+    BENCHMARK_TEMPLATE(scalar_log_tanh_erf, double)->Range(64, 1 << 16);
+}
@@ -0,0 +1,62 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xstorage.hpp"
+#include "xtensor/xarray.hpp"
+
+namespace xt
+{
+    // Allocation followed by a first write of every element, as done
+    // when evaluating an expression into a new temporary. The argument
+    // is the number of elements.
+
+    template <class C>
+    inline void storage_allocate_fill(benchmark::State& state)
+    {
+        std::size_t size = static_cast<std::size_t>(state.range(0));
+        for (auto _ : state)
+        {
+            C c(size);
+            std::fill(c.begin(), c.end(), 1.);
+            benchmark::DoNotOptimize(c.data());
+        }
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size * sizeof(double)));
+    }
+
+    static void storage_std_vector(benchmark::State& state)
+    {
+        storage_allocate_fill<std::vector<double>>(state);
+    }
+    BENCHMARK(storage_std_vector)->Range(1 << 10, 1 << 24);
+
+    static void storage_uvector(benchmark::State& state)
+    {
+        storage_allocate_fill<uvector<double>>(state);
+    }
+    BENCHMARK(storage_uvector)->Range(1 << 10, 1 << 24);
+
+    static void storage_xarray_temporary(benchmark::State& state)
+    {
+        using shape_type = xarray<double>::shape_type;
+        std::size_t size = static_cast<std::size_t>(state.range(0));
+        xarray<double> a(shape_type({size}), 1.);
+        xarray<double> b(shape_type({size}), 2.);
+        for (auto _ : state)
+        {
+            xarray<double> res(a + b);
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(size * sizeof(double)));
+    }
+    BENCHMARK(storage_xarray_temporary)->Range(1 << 10, 1 << 24);
+}
@@ -0,0 +1,91 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using shape_type = xarray<double>::shape_type;
+
+    // Sum of a block of rows of a 1024 x 1024 matrix, evaluated into a new
+    // array. The xview maps each index through its slices, the strided view
+    // of the same block is contiguous and is assigned along its storage.
+
+    template <class V>
+    inline void view_block_sum(benchmark::State& state, V&& view, const xarray<double>& b)
+    {
+        xarray<double> res;
+        for (auto _ : state)
+        {
+            res = view + b;
+            benchmark::DoNotOptimize(res.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(b.size()));
+    }
+
+    static void view_block_xview(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({1024, 1024}), 1.);
+        xarray<double> b(shape_type({256, 1024}), 2.);
+        view_block_sum(state, make_xview(a, range(256, 512)), b);
+    }
+    BENCHMARK(view_block_xview);
+
+    static void view_block_xstrided_view(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({1024, 1024}), 1.);
+        xarray<double> b(shape_type({256, 1024}), 2.);
+        view_block_sum(state, make_xstrided_view(a, range(256, 512)), b);
+    }
+    BENCHMARK(view_block_xstrided_view);
+
+    // Same with a block of columns, which is not contiguous: the strided
+    // view is traversed by its steppers.
+
+    static void view_columns_xview(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({1024, 1024}), 1.);
+        xarray<double> b(shape_type({1024, 256}), 2.);
+        view_block_sum(state, make_xview(a, range(0, 1024), range(256, 512)), b);
+    }
+    BENCHMARK(view_columns_xview);
+
+    static void view_columns_xstrided_view(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({1024, 1024}), 1.);
+        xarray<double> b(shape_type({1024, 256}), 2.);
+        view_block_sum(state, make_xstrided_view(a, range(0, 1024), range(256, 512)), b);
+    }
+    BENCHMARK(view_columns_xstrided_view);
+
+    // Row by row update of a 1024 x 1024 matrix: each row is a contiguous
+    // view, assigned along the storage of the matrix.
+
+    static void view_rows_noalias(benchmark::State& state)
+    {
+        xarray<double> a(shape_type({1024, 1024}), 1.);
+        xarray<double> b(shape_type({1024}), 2.);
+        for (auto _ : state)
+        {
+            for (std::size_t i = 0; i < 1024; ++i)
+            {
+                auto row = make_xview(a, i);
+                noalias(row) = row + b;
+            }
+            benchmark::DoNotOptimize(a.data().data());
+        }
+        state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+    }
+    BENCHMARK(view_rows_noalias);
+}
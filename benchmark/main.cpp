@@ -0,0 +1,42 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_common.hpp"
+
+// Every dynamic allocation performed by the benchmark binary goes
+// through these operators, so that benchmarks can report how many
+// allocations a single iteration requires.
+
+std::size_t xt::benchmark_detail::allocation_count = 0;
+
+void* operator new(std::size_t size)
+{
+    ++xt::benchmark_detail::allocation_count;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,881 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XACCUMULATOR_HPP
+#define XACCUMULATOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xexpression.hpp"
+#include "xiterator.hpp"
+#include "xparallel.hpp"
+#include "xreducer.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /****************************
+     * xaccumulator declaration *
+     ****************************/
+
+    template <class F, class E>
+    class xaccumulator_stepper;
+
+    /**
+     * @class xaccumulator
+     * @brief Lazy cumulative reduction of an xexpression along an axis.
+     *
+     * The xaccumulator class implements an xexpression whose elements are
+     * the reductions of the elements of another xexpression preceding them
+     * along the specified axis, themselves included; its shape is the shape
+     * of the accumulated expression. It relies on the reducing functors of
+     * xreducer.hpp. When an xaccumulator is assigned as a whole, the
+     * accumulated expression is traversed once in row-major order, so that
+     * its innermost dimension is read contiguously whether it is the
+     * accumulation axis or not, and the results are written directly to the
+     * assigned expression. Since an element depends on all the elements
+     * preceding it along the axis, a traversal by iterators or as an operand
+     * of an \ref xfunction evaluates the whole xaccumulator the same way into
+     * a buffer owned by the traversal, on its first access, and operator()
+     * accumulates the elements preceding the requested one. Nothing is cached
+     * by the xaccumulator, whose elements always reflect the current values
+     * of the accumulated expression; assign it to a container to keep them.
+     *
+     * @tparam F the reducing functor type
+     * @tparam E the type of the accumulated expression
+     */
+    template <class F, class E>
+    class xaccumulator : public xexpression<xaccumulator<F, E>>
+    {
+
+    public:
+
+        using self_type = xaccumulator<F, E>;
+        using functor_type = F;
+        using expression_type = E;
+
+        using value_type = typename F::result_type;
+        using reference = value_type;
+        using const_reference = value_type;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = typename E::size_type;
+        using difference_type = typename E::difference_type;
+
+        using shape_type = typename E::shape_type;
+        using strides_type = shape_type;
+
+        using closure_type = const self_type;
+
+        using temporary_type = xarray<value_type>;
+
+        using const_stepper = xaccumulator_stepper<F, E>;
+        using const_iterator = xiterator<const_stepper, shape_type>;
+        template <class S>
+        using const_broadcast_iterator = xiterator<const_stepper, S>;
+        using const_storage_iterator = const_iterator;
+
+        template <class Func>
+        xaccumulator(Func&& f, const E& e, size_type axis);
+
+        size_type dimension() const noexcept;
+        const shape_type& shape() const noexcept;
+        size_type axis() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+
+        template <class S>
+        bool broadcast_shape(S& shape) const;
+
+        template <class S>
+        bool is_trivial_broadcast(const S& strides) const noexcept;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        template <class S>
+        const_broadcast_iterator<S> xbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> xend(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxend(const S& shape) const;
+
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const;
+        template <class S>
+        const_stepper stepper_end(const S& shape) const;
+
+        const_storage_iterator storage_begin() const;
+        const_storage_iterator storage_end() const;
+
+        template <class E1>
+        void assign_to(E1& e1, xexecutor* executor = default_executor()) const;
+
+    private:
+
+        using substepper_type = typename E::const_stepper;
+        using accumulator_type = typename F::accumulator_type;
+        using accumulator_vector = std::vector<accumulator_type>;
+        using linear_cursor = detail::xreducer_linear_cursor<E>;
+        using stepper_cursor = detail::xreducer_stepper_cursor<substepper_type>;
+
+        typename E::closure_type m_e;
+        F m_f;
+        size_type m_axis;
+        shape_type m_shape;
+        xshape<size_type> m_strides;
+
+        value_type accumulate(substepper_type it, size_type index) const;
+        temporary_type evaluate() const;
+
+        template <class E1>
+        void assign_impl(E1& e1, xexecutor* executor, std::true_type /*linear*/) const;
+        template <class E1>
+        void assign_impl(E1& e1, xexecutor* executor, std::false_type /*linear*/) const;
+        template <class E1, class C>
+        void assign_impl(E1& e1, const C& cursor, xexecutor* executor) const;
+
+        template <class O, class C>
+        void scan_rows(O out, C cursor, size_type restricted_dim, size_type first, size_type last) const;
+
+        friend class xaccumulator_stepper<F, E>;
+    };
+
+    /************************************
+     * xaccumulator_stepper declaration *
+     ************************************/
+
+    // Steps through the row-major evaluation of an xaccumulator, computed
+    // when the stepper or one of its copies is first dereferenced and
+    // shared by them.
+    template <class F, class E>
+    class xaccumulator_stepper
+    {
+
+    public:
+
+        using self_type = xaccumulator_stepper<F, E>;
+        using xaccumulator_type = xaccumulator<F, E>;
+
+        using value_type = typename xaccumulator_type::value_type;
+        using reference = typename xaccumulator_type::const_reference;
+        using pointer = typename xaccumulator_type::const_pointer;
+        using size_type = typename xaccumulator_type::size_type;
+        using difference_type = typename xaccumulator_type::difference_type;
+
+        xaccumulator_stepper(const xaccumulator_type* a, size_type offset, size_type index);
+
+        reference operator*() const;
+
+        void step(size_type dim, size_type n = 1);
+        void step_back(size_type dim, size_type n = 1);
+        void reset(size_type dim);
+
+        void to_end();
+
+        bool equal(const self_type& rhs) const;
+
+    private:
+
+        using temporary_type = typename xaccumulator_type::temporary_type;
+
+        struct evaluation
+        {
+            std::once_flag m_flag;
+            temporary_type m_values;
+        };
+
+        const xaccumulator_type* p_a;
+        std::shared_ptr<evaluation> p_evaluation;
+        size_type m_offset;
+        size_type m_index;
+    };
+
+    template <class F, class E>
+    bool operator==(const xaccumulator_stepper<F, E>& lhs,
+                    const xaccumulator_stepper<F, E>& rhs);
+
+    template <class F, class E>
+    bool operator!=(const xaccumulator_stepper<F, E>& lhs,
+                    const xaccumulator_stepper<F, E>& rhs);
+
+    /*******************************
+     * xaccumulator implementation *
+     *******************************/
+
+    /**
+     * @name Constructor
+     */
+    //@{
+    /**
+     * Constructs an xaccumulator accumulating \c e along \c axis with the
+     * reducing functor \c f.
+     * @param f the reducing functor
+     * @param e the expression to accumulate
+     * @param axis the axis along which \c e is accumulated
+     * @throw std::out_of_range if \c axis is not less than the dimension of \c e
+     */
+    template <class F, class E>
+    template <class Func>
+    inline xaccumulator<F, E>::xaccumulator(Func&& f, const E& e, size_type axis)
+        : m_e(e), m_f(std::forward<Func>(f)), m_axis(axis), m_shape(m_e.shape())
+    {
+        if(m_axis >= m_shape.size())
+        {
+            throw std::out_of_range("accumulation axis out of range");
+        }
+        m_strides = detail::row_major_strides(m_shape);
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of dimensions of the xaccumulator.
+     */
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the xaccumulator.
+     */
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the accumulation axis.
+     */
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::axis() const noexcept -> size_type
+    {
+        return m_axis;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the reduction of the elements of the accumulated expression
+     * preceding the specified position along the accumulation axis, in time
+     * proportional to the index along that axis.
+     * @param args a list of indices specifying the position in the xaccumulator.
+     * Indices must be unsigned integers, the number of indices should be equal
+     * or greater than the number of dimensions of the xaccumulator.
+     */
+    template <class F, class E>
+    template <class... Args>
+    inline auto xaccumulator<F, E>::operator()(Args... args) const -> const_reference
+    {
+        std::array<size_type, sizeof...(Args)> index = {{ static_cast<size_type>(args)... }};
+        substepper_type it = m_e.stepper_begin(m_shape);
+        size_type dim = dimension();
+        size_type count = std::min(dim, index.size());
+        size_type position = 0;
+        for(size_type i = 0; i != count; ++i)
+        {
+            size_type d = dim - count + i;
+            size_type n = index[index.size() - count + i];
+            it.step(d, n);
+            position = d == m_axis ? n : position;
+        }
+        return accumulate(it, position);
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the xaccumulator to the specified parameter.
+     * @param shape the result shape
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class F, class E>
+    template <class S>
+    inline bool xaccumulator<F, E>::broadcast_shape(S& shape) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Compares the specified strides with those of the xaccumulator to see
+     * whether the broadcasting is trivial. Since the elements of an
+     * xaccumulator are not stored, the broadcasting is never trivial.
+     * @return false
+     */
+    template <class F, class E>
+    template <class S>
+    inline bool xaccumulator<F, E>::is_trivial_broadcast(const S& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    /**
+     * @name Iterators
+     */
+    //@{
+    /**
+     * Returns a constant iterator to the first element of the xaccumulator.
+     */
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::begin() const -> const_iterator
+    {
+        return xbegin(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last
+     * element of the xaccumulator.
+     */
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::end() const -> const_iterator
+    {
+        return xend(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the xaccumulator.
+     */
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::cbegin() const -> const_iterator
+    {
+        return begin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last
+     * element of the xaccumulator.
+     */
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::cend() const -> const_iterator
+    {
+        return end();
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the xaccumulator.
+     * The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class F, class E>
+    template <class S>
+    inline auto xaccumulator<F, E>::xbegin(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the xaccumulator. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class F, class E>
+    template <class S>
+    inline auto xaccumulator<F, E>::xend(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape, true);
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the xaccumulator.
+     * The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class F, class E>
+    template <class S>
+    inline auto xaccumulator<F, E>::cxbegin(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return xbegin(shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the xaccumulator. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class F, class E>
+    template <class S>
+    inline auto xaccumulator<F, E>::cxend(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return xend(shape);
+    }
+    //@}
+
+    /***************
+     * stepper api *
+     ***************/
+
+    template <class F, class E>
+    template <class S>
+    inline auto xaccumulator<F, E>::stepper_begin(const S& shape) const -> const_stepper
+    {
+        return const_stepper(this, shape.size() - dimension(), 0);
+    }
+
+    template <class F, class E>
+    template <class S>
+    inline auto xaccumulator<F, E>::stepper_end(const S& shape) const -> const_stepper
+    {
+        const_stepper res(this, shape.size() - dimension(), 0);
+        res.to_end();
+        return res;
+    }
+
+    /************************
+     * storage_iterator api *
+     ************************/
+
+    /**
+     * @name Storage iterators
+     */
+    //@{
+    /**
+     * Returns a constant iterator to the first element of the xaccumulator,
+     * its elements being traversed in row-major order.
+     */
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::storage_begin() const -> const_storage_iterator
+    {
+        return begin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last
+     * element of the xaccumulator.
+     */
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::storage_end() const -> const_storage_iterator
+    {
+        return end();
+    }
+    //@}
+
+    namespace detail
+    {
+        // Outputs of the evaluation of an xaccumulator: row(offset) returns
+        // an iterator to the element of the assigned expression at the given
+        // row-major offset, which is either computed from the beginning of its
+        // storage, or is the iterator following the last written element when
+        // the rows are written in order.
+
+        template <class It>
+        class xaccumulator_linear_output
+        {
+
+        public:
+
+            explicit xaccumulator_linear_output(It first)
+                : m_first(first)
+            {
+            }
+
+            It row(std::size_t offset) const
+            {
+                return m_first + static_cast<typename std::iterator_traits<It>::difference_type>(offset);
+            }
+
+        private:
+
+            It m_first;
+        };
+
+        template <class It>
+        class xaccumulator_sequential_output
+        {
+
+        public:
+
+            explicit xaccumulator_sequential_output(It first)
+                : m_it(first)
+            {
+            }
+
+            It& row(std::size_t /*offset*/)
+            {
+                return m_it;
+            }
+
+        private:
+
+            It m_it;
+        };
+
+        template <class It>
+        using is_random_access_iterator = std::is_base_of<std::random_access_iterator_tag,
+                                                          typename std::iterator_traits<It>::iterator_category>;
+    }
+
+    /**
+     * Evaluates the xaccumulator into \c e1, whose shape must be the shape
+     * of the xaccumulator. The results are written directly to \c e1, which
+     * must not be aliased by the accumulated expression.
+     *
+     * The accumulated expression is read along its linear storage when it
+     * is a trivial broadcast of a row-major container, and traversed with
+     * its steppers otherwise. When the storage of \c e1 is row-major, large
+     * expressions are evaluated in parallel on \c executor, the rows being
+     * split along the outermost dimension other than the accumulation axis.
+     * @param e1 the expression to assign the results to
+     * @param executor the executor running the evaluation, or a null
+     * pointer for a serial evaluation
+     */
+    template <class F, class E>
+    template <class E1>
+    inline void xaccumulator<F, E>::assign_to(E1& e1, xexecutor* executor) const
+    {
+        if(data_size(m_shape) != 0)
+        {
+            assign_impl(e1, executor, has_simd_interface<E, typename E::value_type>());
+        }
+    }
+
+    template <class F, class E>
+    template <class E1>
+    inline void xaccumulator<F, E>::assign_impl(E1& e1, xexecutor* executor, std::true_type) const
+    {
+        xshape<size_type> strides = detail::row_major_strides(m_shape);
+        if(m_e.is_trivial_broadcast(strides))
+        {
+            assign_impl(e1, linear_cursor(m_e, strides), executor);
+        }
+        else
+        {
+            assign_impl(e1, executor, std::false_type());
+        }
+    }
+
+    template <class F, class E>
+    template <class E1>
+    inline void xaccumulator<F, E>::assign_impl(E1& e1, xexecutor* executor, std::false_type) const
+    {
+        assign_impl(e1, stepper_cursor(m_e.stepper_begin(m_shape), m_shape.size() - 1), executor);
+    }
+
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::accumulate(substepper_type it, size_type index) const -> value_type
+    {
+        it.step_back(m_axis, index);
+        accumulator_type acc = m_f.accumulate(m_f.init(), *it, 0);
+        for(size_type k = 1; k <= index; ++k)
+        {
+            it.step(m_axis);
+            acc = m_f.accumulate(acc, *it, k);
+        }
+        return m_f.result(acc, index + 1);
+    }
+
+    // The evaluation is serial, since it may be triggered by a task
+    // running on the executor.
+    template <class F, class E>
+    inline auto xaccumulator<F, E>::evaluate() const -> temporary_type
+    {
+        temporary_type res(xshape<size_type>(m_shape.cbegin(), m_shape.cend()));
+        assign_to(res, nullptr);
+        return res;
+    }
+
+    template <class F, class E>
+    template <class E1, class C>
+    inline void xaccumulator<F, E>::assign_impl(E1& e1, const C& cursor, xexecutor* executor) const
+    {
+        using linear_iterator = decltype(detail::linear_begin(e1));
+        using linear_output = detail::xaccumulator_linear_output<linear_iterator>;
+        using sequential_output = detail::xaccumulator_sequential_output<typename E1::iterator>;
+
+        size_type dim = m_shape.size();
+        xshape<size_type> strides = detail::row_major_strides(m_shape);
+        bool linear = detail::is_random_access_iterator<linear_iterator>::value && e1.is_trivial_broadcast(strides);
+        if(linear && dim > 1 && detail::use_executor(executor, data_size(m_shape)))
+        {
+            size_type outer = m_axis == 0 ? 1 : 0;
+            linear_output out(detail::linear_begin(e1));
+            parallel_chunks(*executor, m_shape[outer], 1, [this, &cursor, out, outer](size_type first, size_type last) {
+                scan_rows(out, cursor, outer, first, last);
+            });
+        }
+        else if(linear)
+        {
+            scan_rows(linear_output(detail::linear_begin(e1)), cursor, dim, 0, 0);
+        }
+        else
+        {
+            scan_rows(sequential_output(e1.begin()), cursor, dim, 0, 0);
+        }
+    }
+
+    // Traverses the rows of the expression whose index along the restricted
+    // dimension is in [first, last), or all the rows if restricted_dim is the
+    // dimension of the expression. The accumulators of the elements preceding
+    // the current row along the accumulation axis are kept in a buffer of the
+    // size of a slice orthogonal to the axis.
+    template <class F, class E>
+    template <class O, class C>
+    inline void xaccumulator<F, E>::scan_rows(O out, C cursor, size_type restricted_dim,
+                                              size_type first, size_type last) const
+    {
+        size_type dim = m_shape.size();
+        xshape<size_type> lower(dim, size_type(0));
+        xshape<size_type> upper(m_shape.cbegin(), m_shape.cend());
+        if(restricted_dim != dim)
+        {
+            lower[restricted_dim] = first;
+            upper[restricted_dim] = last;
+        }
+
+        // Offsets of the result and of the accumulator for a step along
+        // each dimension; the accumulators are indexed by the dimensions
+        // following the accumulation axis.
+        xshape<size_type> out_strides = detail::row_major_strides(m_shape);
+        xshape<size_type> acc_strides(dim, size_type(0));
+        size_type slice_size = 1;
+        for(size_type d = m_axis + 1; d != dim; ++d)
+        {
+            acc_strides[d] = out_strides[d];
+            slice_size *= m_shape[d];
+        }
+
+        size_type inner = dim - 1;
+        accumulator_vector acc(m_axis == inner ? size_type(0) : slice_size);
+        xshape<size_type> index(lower);
+        size_type out_offset = 0;
+        size_type acc_offset = 0;
+        for(size_type d = 0; d != dim; ++d)
+        {
+            cursor.step(d, lower[d]);
+            out_offset += out_strides[d] * lower[d];
+            acc_offset += acc_strides[d] * lower[d];
+        }
+
+        size_type row_size = upper[inner] - lower[inner];
+        bool done = row_size == 0;
+        while(!done)
+        {
+            auto&& it = out.row(out_offset);
+            if(m_axis == inner)
+            {
+                size_type count = 0;
+                cursor.scan(m_f, m_f.init(), row_size, 0, [this, &it, &count](const accumulator_type& a) {
+                    *it = m_f.result(a, ++count);
+                    ++it;
+                });
+            }
+            else
+            {
+                // The elements of the row are accumulated to the results of
+                // the previous row along the accumulation axis.
+                accumulator_type* row = acc.data() + acc_offset;
+                size_type k = index[m_axis];
+                if(k == 0)
+                {
+                    std::fill(row, row + row_size, m_f.init());
+                }
+                cursor.accumulate(m_f, row, row_size, k);
+                for(size_type i = 0; i != row_size; ++i, ++it)
+                {
+                    *it = m_f.result(row[i], k + 1);
+                }
+            }
+            cursor.end_row();
+
+            done = true;
+            for(size_type i = inner; i != 0; --i)
+            {
+                size_type d = i - 1;
+                if(++index[d] != upper[d])
+                {
+                    cursor.step(d, 1);
+                    out_offset += out_strides[d];
+                    acc_offset += acc_strides[d];
+                    done = false;
+                    break;
+                }
+                size_type n = upper[d] - lower[d] - 1;
+                index[d] = lower[d];
+                cursor.step_back(d, n);
+                out_offset -= out_strides[d] * n;
+                acc_offset -= acc_strides[d] * n;
+            }
+        }
+    }
+
+    /***************************************
+     * xaccumulator_stepper implementation *
+     ***************************************/
+
+    // The stepper holds its row-major position in the evaluation, which
+    // does not move along the dimensions of size 1.
+    template <class F, class E>
+    inline xaccumulator_stepper<F, E>::xaccumulator_stepper(const xaccumulator_type* a,
+                                                            size_type offset, size_type index)
+        : p_a(a), p_evaluation(std::make_shared<evaluation>()), m_offset(offset), m_index(index)
+    {
+    }
+
+    template <class F, class E>
+    inline auto xaccumulator_stepper<F, E>::operator*() const -> reference
+    {
+        std::call_once(p_evaluation->m_flag, [this]() {
+            p_evaluation->m_values = p_a->evaluate();
+        });
+        return p_evaluation->m_values.data()[m_index];
+    }
+
+    template <class F, class E>
+    inline void xaccumulator_stepper<F, E>::step(size_type dim, size_type n)
+    {
+        if(dim >= m_offset)
+        {
+            m_index += n * p_a->m_strides[dim - m_offset];
+        }
+    }
+
+    template <class F, class E>
+    inline void xaccumulator_stepper<F, E>::step_back(size_type dim, size_type n)
+    {
+        if(dim >= m_offset)
+        {
+            m_index -= n * p_a->m_strides[dim - m_offset];
+        }
+    }
+
+    template <class F, class E>
+    inline void xaccumulator_stepper<F, E>::reset(size_type dim)
+    {
+        if(dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            m_index -= (p_a->m_shape[d] - 1) * p_a->m_strides[d];
+        }
+    }
+
+    template <class F, class E>
+    inline void xaccumulator_stepper<F, E>::to_end()
+    {
+        m_index = data_size(p_a->m_shape);
+    }
+
+    template <class F, class E>
+    inline bool xaccumulator_stepper<F, E>::equal(const self_type& rhs) const
+    {
+        return p_a == rhs.p_a && m_index == rhs.m_index && m_offset == rhs.m_offset;
+    }
+
+    template <class F, class E>
+    inline bool operator==(const xaccumulator_stepper<F, E>& lhs,
+                           const xaccumulator_stepper<F, E>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class F, class E>
+    inline bool operator!=(const xaccumulator_stepper<F, E>& lhs,
+                           const xaccumulator_stepper<F, E>& rhs)
+    {
+        return !(lhs.equal(rhs));
+    }
+
+    /**************************
+     * accumulating functions *
+     **************************/
+
+    namespace detail
+    {
+        template <template <class, class> class F, class A, class E>
+        inline auto make_xaccumulator(const E& e, std::size_t axis)
+        {
+            using functor_type = F<typename E::value_type, A>;
+            return xaccumulator<functor_type, E>(functor_type(), e, axis);
+        }
+    }
+
+    /**
+     * @brief Accumulates an expression with a custom reducing functor.
+     *
+     * Returns an \ref xaccumulator applying \em f to the elements of \em e
+     * along the specified axis. See xreducer.hpp for the requirements on
+     * the reducing functor.
+     * @param f the reducing functor
+     * @param e an \ref xexpression
+     * @param axis the axis along which \em e is accumulated
+     * @return an \ref xaccumulator
+     */
+    template <class F, class E>
+    inline auto accumulate(F&& f, const xexpression<E>& e, std::size_t axis)
+    {
+        using functor_type = std::decay_t<F>;
+        return xaccumulator<functor_type, E>(std::forward<F>(f), e.derived_cast(), axis);
+    }
+
+    /**
+     * @defgroup accumulating_functions Accumulating functions
+     */
+
+    /**
+     * @ingroup accumulating_functions
+     * @brief Cumulative sum of elements along an axis.
+     *
+     * Returns an \ref xaccumulator for the cumulative sum of the elements
+     * of \em e along \em axis. Integral elements are summed in 64-bit
+     * integers unless another accumulator type \em A is specified.
+     * @param e an \ref xexpression
+     * @param axis the axis along which the cumulative sum is computed
+     * @return an \ref xaccumulator
+     */
+    template <class A = void, class E>
+    inline auto cumsum(const xexpression<E>& e, std::size_t axis)
+    {
+        return detail::make_xaccumulator<reducers::sum_fun, A>(e.derived_cast(), axis);
+    }
+
+    /**
+     * @ingroup accumulating_functions
+     * @brief Cumulative product of elements along an axis.
+     *
+     * Returns an \ref xaccumulator for the cumulative product of the elements
+     * of \em e along \em axis. Integral elements are multiplied in 64-bit
+     * integers unless another accumulator type \em A is specified.
+     * @param e an \ref xexpression
+     * @param axis the axis along which the cumulative product is computed
+     * @return an \ref xaccumulator
+     */
+    template <class A = void, class E>
+    inline auto cumprod(const xexpression<E>& e, std::size_t axis)
+    {
+        return detail::make_xaccumulator<reducers::prod_fun, A>(e.derived_cast(), axis);
+    }
+}
+
+#endif
@@ -0,0 +1,277 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XARENA_HPP
+#define XARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace xt
+{
+
+    namespace detail
+    {
+        void* aligned_malloc(std::size_t size, std::size_t alignment);
+        void aligned_free(void* ptr) noexcept;
+    }
+
+    /*******************************
+     * temporary_arena declaration *
+     *******************************/
+
+    /// Default limit of the bytes cached by a temporary_arena.
+    constexpr std::size_t default_arena_cached_bytes = std::size_t(64) << 20;
+    /// Default limit of the blocks of a given size cached by a temporary_arena.
+    constexpr std::size_t default_arena_blocks_per_size = 4;
+
+    /**
+     * @class temporary_arena
+     * @brief Scoped cache of memory blocks for expression temporaries.
+     *
+     * While a temporary_arena is alive, the storage that aligned_allocator
+     * releases on the thread that created it is kept in the arena instead
+     * of being returned to the system, and allocations of the same size
+     * and alignment are served from these blocks. Since the temporaries
+     * built by xsemantic_base::operator= and computed_assign are swapped
+     * into the destination and the previous storage is released right
+     * after, repeated assignments of same-shaped expressions recycle the
+     * same buffers instead of calling the memory allocator.
+     *
+     * Because every block released on the thread is cached, including the
+     * storage of long-lived containers, the arena keeps at most a given number of blocks of
+     * each size and alignment, and a given number of bytes: the blocks
+     * released beyond these limits are returned to the system, so that a
+     * loop over expressions of varying shapes does not make the cache grow
+     * without bound.
+     *
+     * Arenas can be nested; the innermost one is used. The cached blocks
+     * are released when the arena is destroyed. An arena must be
+     * destroyed on the thread that created it.
+     *
+     * \code{.cpp}
+     * xt::temporary_arena scope;
+     * for (auto& request : requests)
+     * {
+     *     res = a * request.scale + b; // reuses the buffer of the previous iteration
+     * }
+     * std::size_t recycled = scope.stats().recycled_bytes;
+     * \endcode
+     */
+    class temporary_arena
+    {
+
+    public:
+
+        /**
+         * @struct stats_type
+         * @brief Usage statistics of a temporary_arena.
+         */
+        struct stats_type
+        {
+            /// Number of allocations requested while the arena was active.
+            std::size_t allocation_count = 0;
+            /// Number of allocations served from a cached block.
+            std::size_t recycled_count = 0;
+            /// Total size in bytes of the allocations served from cached blocks.
+            std::size_t recycled_bytes = 0;
+            /// Size in bytes of the blocks currently cached.
+            std::size_t cached_bytes = 0;
+            /// Number of released blocks returned to the system because
+            /// a limit of the cache was reached.
+            std::size_t discarded_count = 0;
+        };
+
+        explicit temporary_arena(std::size_t max_cached_bytes = default_arena_cached_bytes,
+                                 std::size_t max_blocks_per_size = default_arena_blocks_per_size);
+        ~temporary_arena();
+
+        temporary_arena(const temporary_arena&) = delete;
+        temporary_arena& operator=(const temporary_arena&) = delete;
+
+        temporary_arena(temporary_arena&&) = delete;
+        temporary_arena& operator=(temporary_arena&&) = delete;
+
+        const stats_type& stats() const noexcept;
+        void release() noexcept;
+
+        static temporary_arena* current() noexcept;
+
+        void* allocate(std::size_t size, std::size_t alignment);
+        void deallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept;
+
+    private:
+
+        using key_type = std::pair<std::size_t, std::size_t>;
+        using block_list = std::vector<void*>;
+
+        std::map<key_type, block_list> m_blocks;
+        stats_type m_stats;
+        std::size_t m_max_cached_bytes;
+        std::size_t m_max_blocks_per_size;
+        temporary_arena* p_previous;
+
+        static temporary_arena*& current_ref() noexcept;
+    };
+
+    /*********************************
+     * aligned memory implementation *
+     *********************************/
+
+    namespace detail
+    {
+        // Over-allocates so that the aligned block can be preceded by the
+        // address returned by operator new, needed by aligned_free.
+        inline void* aligned_malloc(std::size_t size, std::size_t alignment)
+        {
+            void* raw = ::operator new(size + alignment + sizeof(void*));
+            std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+            void* res = reinterpret_cast<void*>((addr + alignment - 1) & ~std::uintptr_t(alignment - 1));
+            *(static_cast<void**>(res) - 1) = raw;
+            return res;
+        }
+
+        inline void aligned_free(void* ptr) noexcept
+        {
+            if (ptr != nullptr)
+            {
+                ::operator delete(*(static_cast<void**>(ptr) - 1));
+            }
+        }
+    }
+
+    /**********************************
+     * temporary_arena implementation *
+     **********************************/
+
+    /**
+     * Creates an empty arena and makes it the active arena of the
+     * current thread.
+     * @param max_cached_bytes the maximal size in bytes of the cached blocks
+     * @param max_blocks_per_size the maximal number of cached blocks of
+     * a given size and alignment
+     */
+    inline temporary_arena::temporary_arena(std::size_t max_cached_bytes, std::size_t max_blocks_per_size)
+        : m_blocks(), m_stats(), m_max_cached_bytes(max_cached_bytes),
+          m_max_blocks_per_size(max_blocks_per_size), p_previous(current_ref())
+    {
+        current_ref() = this;
+    }
+
+    /**
+     * Releases the cached blocks and restores the arena that was active
+     * when this one was created.
+     */
+    inline temporary_arena::~temporary_arena()
+    {
+        current_ref() = p_previous;
+        release();
+    }
+
+    /**
+     * Returns the usage statistics of the arena.
+     */
+    inline auto temporary_arena::stats() const noexcept -> const stats_type&
+    {
+        return m_stats;
+    }
+
+    /**
+     * Returns the cached blocks to the system.
+     */
+    inline void temporary_arena::release() noexcept
+    {
+        for (auto& blocks : m_blocks)
+        {
+            for (void* ptr : blocks.second)
+            {
+                detail::aligned_free(ptr);
+            }
+        }
+        m_blocks.clear();
+        m_stats.cached_bytes = 0;
+    }
+
+    /**
+     * Returns the active arena of the current thread, or a null pointer
+     * if there is none.
+     */
+    inline temporary_arena* temporary_arena::current() noexcept
+    {
+        return current_ref();
+    }
+
+    /**
+     * Returns a block of \c size bytes aligned on \c alignment bytes,
+     * recycling a cached block when possible.
+     */
+    inline void* temporary_arena::allocate(std::size_t size, std::size_t alignment)
+    {
+        ++m_stats.allocation_count;
+        auto it = m_blocks.find(key_type(size, alignment));
+        if (it != m_blocks.end() && !it->second.empty())
+        {
+            void* res = it->second.back();
+            it->second.pop_back();
+            if (it->second.empty())
+            {
+                m_blocks.erase(it);
+            }
+            ++m_stats.recycled_count;
+            m_stats.recycled_bytes += size;
+            m_stats.cached_bytes -= size;
+            return res;
+        }
+        return detail::aligned_malloc(size, alignment);
+    }
+
+    /**
+     * Caches the block \c ptr of \c size bytes aligned on \c alignment
+     * bytes, or returns it to the system if the cache is full. The block
+     * must have been returned by detail::aligned_malloc or by the allocate
+     * method of an arena.
+     */
+    inline void temporary_arena::deallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        if (m_max_blocks_per_size != 0 && size <= m_max_cached_bytes - std::min(m_stats.cached_bytes, m_max_cached_bytes))
+        {
+            try
+            {
+                block_list& blocks = m_blocks[key_type(size, alignment)];
+                if (blocks.size() < m_max_blocks_per_size)
+                {
+                    blocks.push_back(ptr);
+                    m_stats.cached_bytes += size;
+                    return;
+                }
+            }
+            catch (...)
+            {
+            }
+        }
+        ++m_stats.discarded_count;
+        detail::aligned_free(ptr);
+    }
+
+    inline temporary_arena*& temporary_arena::current_ref() noexcept
+    {
+        static thread_local temporary_arena* p_current = nullptr;
+        return p_current;
+    }
+}
+
+#endif
@@ -11,7 +11,6 @@
 
 #include <initializer_list>
 #include <utility>
-#include <vector>
 #include <algorithm>
 
 #include "xarray_base.hpp"
@@ -20,41 +19,51 @@
 namespace xt
 {
 
-    /**********************
-     * xarray declaration *
-     **********************/
+    /********************************
+     * xarray_container declaration *
+     ********************************/
 
-    template <class T>
-    class xarray;
+    template <class C>
+    class xarray_container;
 
-    template <class T>
-    struct array_inner_types<xarray<T>>
+    template <class C>
+    class xarray_adaptor;
+
+    template <class C>
+    struct array_inner_types<xarray_container<C>>
     {
-        using container_type = std::vector<T>;
-        using temporary_type = xarray<T>;
+        using container_type = C;
+        using shape_type = xshape<typename container_type::size_type>;
+        using strides_type = xstrides<typename container_type::size_type>;
+        using temporary_type = xarray_container<C>;
     };
 
     /**
-     * @class xarray
+     * @class xarray_container
      * @brief Dense multidimensional container with tensor
      * semantic.
      *
-     * The xarray class implements a dense multidimensional container
-     * with tensor semantic.
+     * The xarray_container class implements a dense multidimensional
+     * container with tensor semantic, whose elements are stored in a
+     * container of type \c C.
      *
-     * @tparam T The type of objects stored in the container.
+     * @tparam C The type of the container holding the elements. It must
+     * provide the interface of a sequence container and be constructible
+     * from its allocator.
+     * @sa xarray
      */
-    template <class T>
-    class xarray : public xarray_base<xarray<T>>,
-                   public xarray_semantic<xarray<T>>
+    template <class C>
+    class xarray_container : public xarray_base<xarray_container<C>>,
+                             public xarray_semantic<xarray_container<C>>
     {
 
     public:
 
-        using self_type = xarray<T>;
+        using self_type = xarray_container<C>;
         using base_type = xarray_base<self_type>;
         using semantic_base = xarray_semantic<self_type>;
         using container_type = typename base_type::container_type;
+        using allocator_type = container_allocator_t<container_type>;
         using value_type = typename base_type::value_type;
         using reference = typename base_type::reference;
         using const_reference = typename base_type::const_reference;
@@ -65,32 +74,39 @@ namespace xt
 
         using closure_type = const self_type&;
 
-        xarray();
-        explicit xarray(const shape_type& shape, layout l = layout::row_major);
-        explicit xarray(const shape_type& shape, const_reference value, layout l = layout::row_major);
-        explicit xarray(const shape_type& shape, const strides_type& strides);
-        explicit xarray(const shape_type& shape, const strides_type& strides, const_reference value);
+        xarray_container();
+        explicit xarray_container(const allocator_type& alloc);
+        explicit xarray_container(const shape_type& shape, layout l = layout::row_major, const allocator_type& alloc = allocator_type());
+        explicit xarray_container(const shape_type& shape, const allocator_type& alloc);
+        explicit xarray_container(const shape_type& shape, const_reference value, layout l = layout::row_major, const allocator_type& alloc = allocator_type());
+        explicit xarray_container(const shape_type& shape, const strides_type& strides, const allocator_type& alloc = allocator_type());
+        explicit xarray_container(const shape_type& shape, const strides_type& strides, const_reference value, const allocator_type& alloc = allocator_type());
+
+        explicit xarray_container(const value_type& t, const allocator_type& alloc = allocator_type());
+        xarray_container(std::initializer_list<value_type> t);
+        xarray_container(std::initializer_list<std::initializer_list<value_type>> t);
+        xarray_container(std::initializer_list<std::initializer_list<std::initializer_list<value_type>>> t);
+        xarray_container(std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<value_type>>>> t);
+        xarray_container(std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<value_type>>>>> t);
 
-        explicit xarray(const T& t);
-        xarray(std::initializer_list<T> t);
-        xarray(std::initializer_list<std::initializer_list<T>> t);
-        xarray(std::initializer_list<std::initializer_list<std::initializer_list<T>>> t);
-        xarray(std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<T>>>> t);
-        xarray(std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<T>>>>> t);
+        ~xarray_container() = default;
 
-        ~xarray() = default;
+        xarray_container(const xarray_container&) = default;
+        xarray_container& operator=(const xarray_container&) = default;
 
-        xarray(const xarray&) = default;
-        xarray& operator=(const xarray&) = default;
+        xarray_container(xarray_container&&) = default;
+        xarray_container& operator=(xarray_container&&) = default;
 
-        xarray(xarray&&) = default;
-        xarray& operator=(xarray&&) = default;
+        template <class E>
+        xarray_container(const xexpression<E>& e);
 
         template <class E>
-        xarray(const xexpression<E>& e);
+        xarray_container(const xexpression<E>& e, const allocator_type& alloc);
 
         template <class E>
-        xarray& operator=(const xexpression<E>& e);
+        xarray_container& operator=(const xexpression<E>& e);
+
+        allocator_type get_allocator() const noexcept;
 
     private:
 
@@ -99,21 +115,37 @@ namespace xt
         container_type& data_impl();
         const container_type& data_impl() const;
 
-        friend class xarray_base<xarray<T>>;
+        template <class D>
+        friend class xarray_adaptor;
+
+        friend class xarray_base<xarray_container<C>>;
     };
 
+    /**
+     * @typedef xarray
+     * Dense multidimensional container with tensor semantic, storing
+     * its elements in a uvector: allocating an xarray does not
+     * initialize them.
+     *
+     * @tparam T The type of objects stored in the container.
+     * @tparam A The allocator of the container. Temporaries created
+     * when assigning an xexpression to an xarray use the allocator of
+     * the xarray.
+     */
+    template <class T, class A = aligned_allocator<T>>
+    using xarray = xarray_container<uvector<T, A>>;
+
     /******************************
      * xarray_adaptor declaration *
      ******************************/
 
-    template <class C>
-    class xarray_adaptor;
-
     template <class C>
     struct array_inner_types<xarray_adaptor<C>>
     {
         using container_type = C;
-        using temporary_type = xarray<typename C::value_type>;
+        using shape_type = xshape<typename container_type::size_type>;
+        using strides_type = xstrides<typename container_type::size_type>;
+        using temporary_type = xarray_container<temporary_container_t<C>>;
     };
 
     /**
@@ -173,9 +205,9 @@ namespace xt
         friend class xadaptor_semantic<xarray_adaptor<C>>;
     };
 
-    /*************************
-     * xarray implementation *
-     *************************/
+    /***********************************
+     * xarray_container implementation *
+     ***********************************/
 
     /**
      * @name Constructors
@@ -184,9 +216,20 @@ namespace xt
     /**
      * Allocates an uninitialized xarray that holds 0 element.
      */
-    template <class T>
-    inline xarray<T>::xarray()
-        : base_type(), m_data(1, value_type())
+    template <class C>
+    inline xarray_container<C>::xarray_container()
+        : xarray_container(allocator_type())
+    {
+    }
+
+    /**
+     * Allocates an uninitialized xarray that holds 0 element, using
+     * the specified allocator.
+     * @param alloc the allocator of the xarray
+     */
+    template <class C>
+    inline xarray_container<C>::xarray_container(const allocator_type& alloc)
+        : base_type(), m_data(1, value_type(), alloc)
     {
     }
 
@@ -195,24 +238,39 @@ namespace xt
      * layout.
      * @param shape the shape of the xarray
      * @param l the layout of the xarray
+     * @param alloc the allocator of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(const shape_type& shape, layout l)
-        : base_type()
+    template <class C>
+    inline xarray_container<C>::xarray_container(const shape_type& shape, layout l, const allocator_type& alloc)
+        : base_type(), m_data(alloc)
     {
         base_type::reshape(shape, l);
     }
 
+    /**
+     * Allocates an uninitialized row-major xarray with the specified shape,
+     * using the specified allocator.
+     * @param shape the shape of the xarray
+     * @param alloc the allocator of the xarray
+     */
+    template <class C>
+    inline xarray_container<C>::xarray_container(const shape_type& shape, const allocator_type& alloc)
+        : base_type(), m_data(alloc)
+    {
+        base_type::reshape(shape, layout::row_major);
+    }
+
     /**
      * Allocates an xarray with the specified shape and layout. Elements
      * are initialized to the specified value.
      * @param shape the shape of the xarray
      * @param value the value of the elements
      * @param l the layout of the xarray
+     * @param alloc the allocator of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(const shape_type& shape, const_reference value, layout l)
-        : base_type()
+    template <class C>
+    inline xarray_container<C>::xarray_container(const shape_type& shape, const_reference value, layout l, const allocator_type& alloc)
+        : base_type(), m_data(alloc)
     {
         base_type::reshape(shape, l);
         std::fill(m_data.begin(), m_data.end(), value);
@@ -222,10 +280,11 @@ namespace xt
      * Allocates an uninitialized xarray with the specified shape and strides.
      * @param shape the shape of the xarray
      * @param strides the strides of the xarray
+     * @param alloc the allocator of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(const shape_type& shape, const strides_type& strides)
-        : base_type()
+    template <class C>
+    inline xarray_container<C>::xarray_container(const shape_type& shape, const strides_type& strides, const allocator_type& alloc)
+        : base_type(), m_data(alloc)
     {
         base_type::reshape(shape, strides);
     }
@@ -236,10 +295,11 @@ namespace xt
      * @param shape the shape of the xarray
      * @param strides the strides of the xarray
      * @param value the value of the elements
+     * @param alloc the allocator of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(const shape_type& shape, const strides_type& strides, const_reference value)
-        : base_type()
+    template <class C>
+    inline xarray_container<C>::xarray_container(const shape_type& shape, const strides_type& strides, const_reference value, const allocator_type& alloc)
+        : base_type(), m_data(alloc)
     {
         base_type::reshape(shape, strides);
         std::fill(m_data.begin(), m_data.end(), value);
@@ -249,10 +309,11 @@ namespace xt
      * Allocates an xarray that holds a single element initialized to the
      * specified value.
      * @param t the value of the element
+     * @param alloc the allocator of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(const T& t)
-        : base_type()
+    template <class C>
+    inline xarray_container<C>::xarray_container(const value_type& t, const allocator_type& alloc)
+        : base_type(), m_data(alloc)
     {
         base_type::reshape(xt::shape<shape_type>(t), layout::row_major);
         nested_copy(m_data.begin(), t);
@@ -267,8 +328,8 @@ namespace xt
      * Allocates a one-dimensional xarray.
      * @param t the elements of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(std::initializer_list<T> t)
+    template <class C>
+    inline xarray_container<C>::xarray_container(std::initializer_list<value_type> t)
         : base_type()
     {
         base_type::reshape(xt::shape<shape_type>(t), layout::row_major);
@@ -279,8 +340,8 @@ namespace xt
      * Allocates a two-dimensional xarray.
      * @param t the elements of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(std::initializer_list<std::initializer_list<T>> t)
+    template <class C>
+    inline xarray_container<C>::xarray_container(std::initializer_list<std::initializer_list<value_type>> t)
         : base_type()
     {
         base_type::reshape(xt::shape<shape_type>(t), layout::row_major);
@@ -291,8 +352,8 @@ namespace xt
      * Allocates a three-dimensional xarray.
      * @param t the elements of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(std::initializer_list<std::initializer_list<std::initializer_list<T>>> t)
+    template <class C>
+    inline xarray_container<C>::xarray_container(std::initializer_list<std::initializer_list<std::initializer_list<value_type>>> t)
         : base_type()
     {
         base_type::reshape(xt::shape<shape_type>(t), layout::row_major);
@@ -303,8 +364,8 @@ namespace xt
      * Allocates a four-dimensional xarray.
      * @param t the elements of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<T>>>> t)
+    template <class C>
+    inline xarray_container<C>::xarray_container(std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<value_type>>>> t)
         : base_type()
     {
         base_type::reshape(xt::shape<shape_type>(t), layout::row_major);
@@ -315,8 +376,8 @@ namespace xt
      * Allocates a five-dimensional xarray.
      * @param t the elements of the xarray
      */
-    template <class T>
-    inline xarray<T>::xarray(std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<T>>>>> t)
+    template <class C>
+    inline xarray_container<C>::xarray_container(std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<std::initializer_list<value_type>>>>> t)
         : base_type()
     {
         base_type::reshape(xt::shape<shape_type>(t), layout::row_major);
@@ -331,33 +392,65 @@ namespace xt
     /**
      * The extended copy constructor.
      */
-    template <class T>
+    template <class C>
     template <class E>
-    inline xarray<T>::xarray(const xexpression<E>& e)
+    inline xarray_container<C>::xarray_container(const xexpression<E>& e)
         : base_type()
     {
+        // A 0-D expression does not reshape the xarray, whose single
+        // element must be allocated here.
+        if(e.derived_cast().dimension() == 0)
+        {
+            m_data.resize(1);
+        }
+        semantic_base::assign(e);
+    }
+
+    /**
+     * The extended copy constructor, using the specified allocator.
+     */
+    template <class C>
+    template <class E>
+    inline xarray_container<C>::xarray_container(const xexpression<E>& e, const allocator_type& alloc)
+        : base_type(), m_data(alloc)
+    {
+        // A 0-D expression does not reshape the xarray, whose single
+        // element must be allocated here.
+        if(e.derived_cast().dimension() == 0)
+        {
+            m_data.resize(1);
+        }
         semantic_base::assign(e);
     }
 
     /**
      * The extended assignment operator.
      */
-    template <class T>
+    template <class C>
     template <class E>
-    inline auto xarray<T>::operator=(const xexpression<E>& e) -> self_type&
+    inline auto xarray_container<C>::operator=(const xexpression<E>& e) -> self_type&
     {
         return semantic_base::operator=(e);
     }
     //@}
 
-    template <class T>
-    inline auto xarray<T>::data_impl() -> container_type&
+    /**
+     * Returns the allocator of the xarray.
+     */
+    template <class C>
+    inline auto xarray_container<C>::get_allocator() const noexcept -> allocator_type
+    {
+        return m_data.get_allocator();
+    }
+
+    template <class C>
+    inline auto xarray_container<C>::data_impl() -> container_type&
     {
         return m_data;
     }
 
-    template <class T>
-    inline auto xarray<T>::data_impl() const -> const container_type&
+    template <class C>
+    inline auto xarray_container<C>::data_impl() const -> const container_type&
     {
         return m_data;
     }
@@ -366,6 +459,26 @@ namespace xt
      * xarray_adaptor *
      ******************/
 
+    namespace detail
+    {
+        // When the temporary holds a container of the adapted type, its
+        // buffer is moved into the adapted container; otherwise, its
+        // elements are copied.
+
+        template <class C>
+        inline void assign_temporary_container(C& c, C& tmp)
+        {
+            c = std::move(tmp);
+        }
+
+        template <class C, class CT>
+        inline void assign_temporary_container(C& c, CT& tmp)
+        {
+            c.resize(tmp.size());
+            std::copy(tmp.begin(), tmp.end(), c.begin());
+        }
+    }
+
     /**
      * @name Constructors
      */
@@ -455,13 +568,12 @@ namespace xt
     template <class C>
     inline void xarray_adaptor<C>::assign_temporary_impl(temporary_type& tmp)
     {
-        // TODO (performance improvement) : consider moving tmps
-        // shape and strides
-        base_type::get_shape() = tmp.shape();
-        base_type::get_strides() = tmp.strides();
-        base_type::get_backstrides() = tmp.backstrides();
-        m_data.resize(tmp.size());
-        std::copy(tmp.data().begin(), tmp.data().end(), m_data.begin());
+        // The data are assigned first so that the adaptor is left unchanged
+        // if the adapted container cannot hold them.
+        detail::assign_temporary_container(m_data, tmp.m_data);
+        base_type::get_shape() = std::move(tmp.get_shape());
+        base_type::get_strides() = std::move(tmp.get_strides());
+        base_type::get_backstrides() = std::move(tmp.get_backstrides());
     }
 }
 
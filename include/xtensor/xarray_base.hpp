@@ -10,7 +10,9 @@
 #define XARRAY_BASE_HPP
 
 #include <functional>
+#include <algorithm>
 
+#include "xbatch.hpp"
 #include "xindex.hpp"
 #include "xiterator.hpp"
 #include "xoperation.hpp"
@@ -19,6 +21,22 @@
 namespace xt
 {
 
+    namespace detail
+    {
+        // Containers whose data() returns a pointer store their elements
+        // contiguously and can be loaded by batches.
+        template <class C, class = void>
+        struct has_raw_data : std::false_type
+        {
+        };
+
+        template <class C>
+        struct has_raw_data<C, void_t<decltype(std::declval<const C&>().data())>>
+            : std::is_same<decltype(std::declval<const C&>().data()), const typename C::value_type*>
+        {
+        };
+    }
+
     enum class layout
     {
         row_major,
@@ -54,14 +72,19 @@ namespace xt
         using size_type = typename container_type::size_type;
         using difference_type = typename container_type::difference_type;
 
-        using shape_type = xshape<size_type>;
-        using strides_type = xstrides<size_type>;
+        using shape_type = typename inner_types::shape_type;
+        using strides_type = typename inner_types::strides_type;
 
         using stepper = xstepper<D>;
         using const_stepper = xstepper<const D>;
 
-        using iterator = xiterator<stepper>;
-        using const_iterator = xiterator<const_stepper>;
+        using iterator = xiterator<stepper, shape_type>;
+        using const_iterator = xiterator<const_stepper, shape_type>;
+
+        template <class S>
+        using broadcast_iterator = xiterator<stepper, S>;
+        template <class S>
+        using const_broadcast_iterator = xiterator<const_stepper, S>;
 
         using storage_iterator = typename container_type::iterator;
         using const_storage_iterator = typename container_type::const_iterator;
@@ -87,8 +110,11 @@ namespace xt
         container_type& data();
         const container_type& data() const;
 
-        bool broadcast_shape(shape_type& shape) const;
-        bool is_trivial_broadcast(const strides_type& strides) const;
+        template <class S>
+        bool broadcast_shape(S& shape) const;
+
+        template <class S>
+        bool is_trivial_broadcast(const S& strides) const;
 
         iterator begin();
         iterator end();
@@ -98,19 +124,29 @@ namespace xt
         const_iterator cbegin() const;
         const_iterator cend() const;
 
-        iterator xbegin(const shape_type& shape);
-        iterator xend(const shape_type& shape);
-
-        const_iterator xbegin(const shape_type& shape) const;
-        const_iterator xend(const shape_type& shape) const;
-        const_iterator cxbegin(const shape_type& shape) const;
-        const_iterator cxend(const shape_type& shape) const;
-
-        stepper stepper_begin(const shape_type& shape);
-        stepper stepper_end(const shape_type& shape);
-
-        const_stepper stepper_begin(const shape_type& shape) const;
-        const_stepper stepper_end(const shape_type& shape) const;
+        template <class S>
+        broadcast_iterator<S> xbegin(const S& shape);
+        template <class S>
+        broadcast_iterator<S> xend(const S& shape);
+
+        template <class S>
+        const_broadcast_iterator<S> xbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> xend(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxend(const S& shape) const;
+
+        template <class S>
+        stepper stepper_begin(const S& shape);
+        template <class S>
+        stepper stepper_end(const S& shape);
+
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const;
+        template <class S>
+        const_stepper stepper_end(const S& shape) const;
 
         storage_iterator storage_begin();
         storage_iterator storage_end();
@@ -118,6 +154,18 @@ namespace xt
         const_storage_iterator storage_begin() const;
         const_storage_iterator storage_end() const;
 
+        template <class V>
+        using simd_enabled = std::integral_constant<bool, std::is_same<V, value_type>::value &&
+                                                          simd_traits<V>::size != 1 &&
+                                                          detail::has_raw_data<container_type>::value>;
+
+        template <class V = value_type>
+        simd_type_t<V> load_simd(size_type i) const;
+        void store_simd(size_type i, const simd_type_t<value_type>& batch);
+
+        reference data_element(size_type i);
+        const_reference data_element(size_type i) const;
+
     protected:
 
         xarray_base() = default;
@@ -265,8 +313,8 @@ namespace xt
     inline void xarray_base<D>::reshape(const shape_type& shape, layout l)
     {
         m_shape = shape;
-        m_strides.resize(m_shape.size());
-        m_backstrides.resize(m_shape.size());
+        resize_container(m_strides, m_shape.size());
+        resize_container(m_backstrides, m_shape.size());
         size_type data_size = 1;
         if(l == layout::row_major)
         {
@@ -299,7 +347,7 @@ namespace xt
     {
         m_shape = shape;
         m_strides = strides;
-        m_backstrides.resize(m_strides.size());
+        resize_container(m_backstrides, m_strides.size());
         adapt_strides();
         data().resize(data_size(m_shape));
     }
@@ -319,7 +367,7 @@ namespace xt
     template <class... Args>
     inline auto xarray_base<D>::operator()(Args... args) -> reference
     {
-        size_type index = data_offset(m_strides, static_cast<size_type>(args)...);
+        size_type index = data_offset(m_strides, args...);
         return data()[index];
     }
 
@@ -333,7 +381,7 @@ namespace xt
     template <class... Args>
     inline auto xarray_base<D>::operator()(Args... args) const -> const_reference
     {
-        size_type index = data_offset(m_strides, static_cast<size_type>(args)...);
+        size_type index = data_offset(m_strides, args...);
         return data()[index];
     }
 
@@ -367,7 +415,8 @@ namespace xt
      * @return a boolean indicating whether the broadcast is trivial
      */
     template <class D>
-    inline bool xarray_base<D>::broadcast_shape(shape_type& shape) const
+    template <class S>
+    inline bool xarray_base<D>::broadcast_shape(S& shape) const
     {
         return xt::broadcast_shape(m_shape, shape);
     }
@@ -378,9 +427,11 @@ namespace xt
      * @return a boolean indicating whether the broadcast is trivial
      */
     template <class D>
-    inline bool xarray_base<D>::is_trivial_broadcast(const strides_type& str) const
+    template <class S>
+    inline bool xarray_base<D>::is_trivial_broadcast(const S& str) const
     {
-        return str == strides();
+        return str.size() == m_strides.size() &&
+            std::equal(str.cbegin(), str.cend(), m_strides.cbegin());
     }
     //@}
 
@@ -455,9 +506,10 @@ namespace xt
      * @param shape the shape used for braodcasting
      */
     template <class D>
-    inline auto xarray_base<D>::xbegin(const shape_type& shape) -> iterator
+    template <class S>
+    inline auto xarray_base<D>::xbegin(const S& shape) -> broadcast_iterator<S>
     {
-        return iterator(stepper_begin(shape), shape);
+        return broadcast_iterator<S>(stepper_begin(shape), shape);
     }
 
     /**
@@ -466,9 +518,10 @@ namespace xt
      * @param shape the shape used for broadcasting
      */
     template <class D>
-    inline auto xarray_base<D>::xend(const shape_type& shape) -> iterator
+    template <class S>
+    inline auto xarray_base<D>::xend(const S& shape) -> broadcast_iterator<S>
     {
-        return iterator(stepper_end(shape), shape);
+        return broadcast_iterator<S>(stepper_begin(shape), shape, true);
     }
 
     /**
@@ -477,9 +530,10 @@ namespace xt
      * @param shape the shape used for braodcasting
      */
     template <class D>
-    inline auto xarray_base<D>::xbegin(const shape_type& shape) const -> const_iterator
+    template <class S>
+    inline auto xarray_base<D>::xbegin(const S& shape) const -> const_broadcast_iterator<S>
     {
-        return const_iterator(stepper_begin(shape), shape);
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape);
     }
 
     /**
@@ -488,9 +542,10 @@ namespace xt
      * @param shape the shape used for broadcasting
      */
     template <class D>
-    inline auto xarray_base<D>::xend(const shape_type& shape) const -> const_iterator
+    template <class S>
+    inline auto xarray_base<D>::xend(const S& shape) const -> const_broadcast_iterator<S>
     {
-        return const_iterator(stepper_end(shape), shape);
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape, true);
     }
 
     /**
@@ -499,7 +554,8 @@ namespace xt
      * @param shape the shape used for braodcasting
      */
     template <class D>
-    inline auto xarray_base<D>::cxbegin(const shape_type& shape) const -> const_iterator
+    template <class S>
+    inline auto xarray_base<D>::cxbegin(const S& shape) const -> const_broadcast_iterator<S>
     {
         return xbegin(shape);
     }
@@ -510,7 +566,8 @@ namespace xt
      * @param shape the shape used for broadcasting
      */
     template <class D>
-    inline auto xarray_base<D>::cxend(const shape_type& shape) const -> const_iterator
+    template <class S>
+    inline auto xarray_base<D>::cxend(const S& shape) const -> const_broadcast_iterator<S>
     {
         return xend(shape);
     }
@@ -521,28 +578,32 @@ namespace xt
      ***************/
 
     template <class D>
-    inline auto xarray_base<D>::stepper_begin(const shape_type& shape) -> stepper
+    template <class S>
+    inline auto xarray_base<D>::stepper_begin(const S& shape) -> stepper
     {
         size_type offset = shape.size() - dimension();
         return stepper(static_cast<derived_type*>(this), data().begin(), offset);
     }
 
     template <class D>
-    inline auto xarray_base<D>::stepper_end(const shape_type& shape) -> stepper
+    template <class S>
+    inline auto xarray_base<D>::stepper_end(const S& shape) -> stepper
     {
         size_type offset = shape.size() - dimension();
         return stepper(static_cast<derived_type*>(this), data().end(), offset);
     }
 
     template <class D>
-    inline auto xarray_base<D>::stepper_begin(const shape_type& shape) const -> const_stepper
+    template <class S>
+    inline auto xarray_base<D>::stepper_begin(const S& shape) const -> const_stepper
     {
         size_type offset = shape.size() - dimension();
         return const_stepper(static_cast<const derived_type*>(this), data().begin(), offset);
     }
 
     template <class D>
-    inline auto xarray_base<D>::stepper_end(const shape_type& shape) const -> const_stepper
+    template <class S>
+    inline auto xarray_base<D>::stepper_end(const S& shape) const -> const_stepper
     {
         size_type offset = shape.size() - dimension();
         return const_stepper(static_cast<const derived_type*>(this), data().end(), offset);
@@ -597,6 +658,57 @@ namespace xt
     }
     //@}
 
+    /************
+     * simd api *
+     ************/
+
+    /**
+     * @name SIMD interface
+     */
+    //@{
+    /**
+     * Loads the batch of elements starting at the i-th element of the
+     * buffer containing the elements of the container.
+     * @tparam V the type of the elements of the batch, which must be the
+     * value type of the container
+     */
+    template <class D>
+    template <class V>
+    inline auto xarray_base<D>::load_simd(size_type i) const -> simd_type_t<V>
+    {
+        return simd_type_t<V>::load_unaligned(data().data() + i);
+    }
+
+    /**
+     * Stores \c batch to the elements of the buffer starting at the i-th one.
+     */
+    template <class D>
+    inline void xarray_base<D>::store_simd(size_type i, const simd_type_t<value_type>& batch)
+    {
+        batch.store_unaligned(data().data() + i);
+    }
+
+    /**
+     * Returns a reference to the i-th element of the buffer containing
+     * the elements of the container.
+     */
+    template <class D>
+    inline auto xarray_base<D>::data_element(size_type i) -> reference
+    {
+        return data()[i];
+    }
+
+    /**
+     * Returns a constant reference to the i-th element of the buffer
+     * containing the elements of the container.
+     */
+    template <class D>
+    inline auto xarray_base<D>::data_element(size_type i) const -> const_reference
+    {
+        return data()[i];
+    }
+    //@}
+
     /**************
      * comparison *
      **************/
@@ -611,8 +723,15 @@ namespace xt
     template <class D1, class D2>
     inline bool operator==(const xarray_base<D1>& lhs, const xarray_base<D2>& rhs)
     {
-        return lhs.shape() == rhs.shape() && lhs.strides() == rhs.strides()
-            && lhs.data() == rhs.data();
+        const auto& lhs_shape = lhs.shape();
+        const auto& rhs_shape = rhs.shape();
+        const auto& lhs_strides = lhs.strides();
+        const auto& rhs_strides = rhs.strides();
+        return lhs_shape.size() == rhs_shape.size()
+            && std::equal(lhs_shape.cbegin(), lhs_shape.cend(), rhs_shape.cbegin())
+            && std::equal(lhs_strides.cbegin(), lhs_strides.cend(), rhs_strides.cbegin())
+            && lhs.size() == rhs.size()
+            && std::equal(lhs.data().cbegin(), lhs.data().cend(), rhs.data().cbegin());
     }
 
     /**
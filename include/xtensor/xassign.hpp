@@ -9,8 +9,18 @@
 #ifndef XASSIGN_HPP
 #define XASSIGN_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "xbatch.hpp"
 #include "xindex.hpp"
 #include "xiterator.hpp"
+#include "xparallel.hpp"
 
 namespace xt
 {
@@ -24,12 +34,18 @@ namespace xt
     template <class E1, class E2>
     void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial);
 
+    template <class E1, class E2>
+    void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, xexecutor* executor);
+
     template <class E1, class E2>
     bool reshape(xexpression<E1>& e1, const xexpression<E2>& e2);
 
     template <class E1, class E2>
     void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2);
 
+    template <class E1, class E2>
+    void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2, xexecutor& executor);
+
     template <class E1, class E2>
     void computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2);
 
@@ -39,10 +55,23 @@ namespace xt
     template <class E1, class E2>
     void assert_compatible_shape(const xexpression<E1>& e1, const xexpression<E2>& e2);
 
+    template <class E, class... Args>
+    typename array_inner_types<E>::temporary_type make_temporary(const E& e, Args&&... args);
+
     /*****************
      * data_assigner *
      *****************/
 
+    // Assigns the elements of e2 to e1 row by row: the elements of a row,
+    // i.e. along the innermost dimension, are assigned in a loop that only
+    // steps along this dimension; the index of the outer dimensions is
+    // only incremented between rows. The dimensions are traversed in the
+    // memory order of e1, given by detail::traversal_order, so that the
+    // rows of a column-major container are its columns. The innermost
+    // dimensions of the traversal are merged into a single row as long
+    // as the steppers of both expressions can go through them by stepping
+    // along the innermost one, see xt::mergeable_dimensions: the rows of
+    // contiguous containers span all their dimensions but the outermost.
     template <class E1, class E2>
     class data_assigner
     {
@@ -57,8 +86,10 @@ namespace xt
         data_assigner(E1& e1, const E2 & e2);
 
         void run();
+        void run(size_type first, size_type last);
 
-        void step(size_type i);
+        void step(size_type i, size_type n = 1);
+        void step_back(size_type i, size_type n = 1);
         void reset(size_type i);
 
         void to_end();
@@ -69,30 +100,424 @@ namespace xt
 
         lhs_iterator m_lhs;
         rhs_iterator m_rhs;
-        rhs_iterator m_rhs_end;
 
-        shape_type m_index;
+        xshape<size_type> m_order;
+        xshape<size_type> m_index;
+        size_type m_outer_end;
+        size_type m_row_begin;
+        size_type m_row_size;
+
+        void assign_row(size_type dim, size_type size);
+        bool next_row();
+    };
+
+    /******************
+     * tiled_assigner *
+     ******************/
+
+    // Assigns the elements of e2 to e1 by square tiles spanning the
+    // innermost dimension of the traversal of e1 and the tiled dimension,
+    // along which e2 is stored contiguously: the cache lines read along
+    // the columns of a tile are reused by its next rows instead of being
+    // evicted before the traversal comes back to them.
+    template <class E1, class E2>
+    class tiled_assigner
+    {
+
+    public:
+
+        using lhs_iterator = typename E1::stepper;
+        using rhs_iterator = typename E2::const_stepper;
+        using shape_type = typename E1::shape_type;
+        using size_type = typename lhs_iterator::size_type;
+
+        tiled_assigner(E1& e1, const E2& e2, size_type tiled_dim);
+
+        void run();
+        void run(size_type first, size_type last);
+
+    private:
+
+        void assign_tiles(lhs_iterator lhs, rhs_iterator rhs, size_type first, size_type last) const;
+
+        E1& m_e1;
+        const E2& m_e2;
+        xshape<size_type> m_order;
+        size_type m_tiled_dim;
+        size_type m_inner;
     };
 
+    /****************************
+     * trivial_assigner helpers *
+     ****************************/
+
+    namespace detail
+    {
+        template <class E1, class E2>
+        using simd_assignable = std::integral_constant<bool,
+            has_simd_interface<E1, typename E1::value_type>::value &&
+            has_simd_interface<E2, typename E1::value_type>::value>;
+
+        // Views provide data_xbegin() and data_xend(), iterating over the
+        // part of the storage of their underlying expression that they refer
+        // to, while storage_begin() and storage_end() iterate over their
+        // elements; the former are only used once the view is known to be
+        // contiguous.
+        template <class E, class = void>
+        struct has_data_iterator : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_data_iterator<E, void_t<decltype(std::declval<E&>().data_xbegin())>>
+            : std::true_type
+        {
+        };
+
+        template <class E>
+        inline auto linear_begin(E& e, std::true_type)
+        {
+            return e.data_xbegin();
+        }
+
+        template <class E>
+        inline auto linear_begin(E& e, std::false_type)
+        {
+            return e.storage_begin();
+        }
+
+        template <class E>
+        inline auto linear_end(E& e, std::true_type)
+        {
+            return e.data_xend();
+        }
+
+        template <class E>
+        inline auto linear_end(E& e, std::false_type)
+        {
+            return e.storage_end();
+        }
+
+        template <class E>
+        inline auto linear_begin(E& e)
+        {
+            return linear_begin(e, has_data_iterator<E>());
+        }
+
+        template <class E>
+        inline auto linear_end(E& e)
+        {
+            return linear_end(e, has_data_iterator<E>());
+        }
+
+        // Number of elements along each side of the tiles of a tiled
+        // assignment, so that a tile of both expressions fits in a 32 kB
+        // L1 data cache.
+        template <class T>
+        constexpr std::size_t assign_tile_size() noexcept
+        {
+            std::size_t size = 256;
+            while(size > 8 && 2 * size * size * sizeof(T) > 32768)
+            {
+                size /= 2;
+            }
+            return size;
+        }
+
+        // Returns true if the elements described by shape and strides fill
+        // a contiguous block of memory, whatever the order of the dimensions.
+        template <class S, class ST>
+        inline bool is_contiguous(const S& shape, const ST& strides)
+        {
+            std::size_t dim = shape.size();
+            if(data_size(shape) == 0)
+            {
+                return true;
+            }
+            xshape<std::size_t> order;
+            for(std::size_t d = 0; d != dim; ++d)
+            {
+                if(shape[d] != 1)
+                {
+                    order.push_back(d);
+                }
+            }
+            std::sort(order.begin(), order.end(),
+                    [&strides](std::size_t lhs, std::size_t rhs) { return strides[lhs] < strides[rhs]; });
+            std::size_t expected = 1;
+            for(std::size_t d : order)
+            {
+                if(static_cast<std::size_t>(strides[d]) != expected)
+                {
+                    return false;
+                }
+                expected *= shape[d];
+            }
+            return true;
+        }
+
+        // Containers are contiguous; views providing is_contiguous may
+        // only cover a part of the storage of their underlying container,
+        // in which case they cannot be assigned along their linear storage.
+        template <class E, class = void>
+        struct has_is_contiguous : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_is_contiguous<E, void_t<decltype(std::declval<const E&>().is_contiguous())>>
+            : std::true_type
+        {
+        };
+
+        template <class E>
+        inline bool is_contiguous_expression(const E& e, std::true_type)
+        {
+            return e.is_contiguous();
+        }
+
+        template <class E>
+        inline bool is_contiguous_expression(const E& /*e*/, std::false_type)
+        {
+            return true;
+        }
+
+        // Order in which an assignment traverses the dimensions of e, from
+        // the outermost to the innermost one: by decreasing strides, so that
+        // the innermost loop runs along the dimension where e is the most
+        // contiguous. Dimensions of size 1 come first, and row-major
+        // containers are traversed in the order of their dimensions.
+        template <class E>
+        inline xshape<std::size_t> traversal_order(const E& e)
+        {
+            const auto& shape = e.shape();
+            const auto& strides = e.strides();
+            std::size_t dim = shape.size();
+            xshape<std::size_t> order(dim);
+            xshape<std::size_t> keys(dim);
+            for(std::size_t d = 0; d != dim; ++d)
+            {
+                order[d] = d;
+                keys[d] = shape[d] == 1 ? std::numeric_limits<std::size_t>::max()
+                                        : static_cast<std::size_t>(std::abs(static_cast<std::ptrdiff_t>(strides[d])));
+            }
+            std::stable_sort(order.begin(), order.end(),
+                    [&keys](std::size_t lhs, std::size_t rhs) { return keys[lhs] > keys[rhs]; });
+            return order;
+        }
+
+        // Returns the dimension to tile with the innermost dimension of the
+        // traversal of e1 when e2 is not contiguous along it and its rows are
+        // long enough to evict the lines of a column from the cache, or the
+        // dimension of e1 when they are assigned row by row. Functions read
+        // their arguments in the order given by xt::contiguous_dimension;
+        // when it is not determined, e2 is read in the order of e1.
+        template <class E1, class E2>
+        inline std::size_t tiled_dimension(const E1& e1, const E2& e2)
+        {
+            std::size_t dim = e1.dimension();
+            if(dim < 2)
+            {
+                return dim;
+            }
+            std::size_t inner = traversal_order(e1).back();
+            if(e1.shape()[inner] <= assign_tile_size<typename E1::value_type>())
+            {
+                return dim;
+            }
+            std::size_t rhs_dim = xt::contiguous_dimension(e2, dim);
+            return rhs_dim == inner ? dim : rhs_dim;
+        }
+
+        // Assigns e2 to e1 when the broadcast is trivial, i.e. when both
+        // expressions can be traversed along their linear storage. When
+        // they both provide the SIMD interface, batches of elements are
+        // assigned at once and the remaining elements are assigned one
+        // by one.
+        template <class E1, class E2, bool simd = simd_assignable<E1, E2>::value>
+        struct trivial_assigner
+        {
+            static void run(E1& e1, const E2& e2)
+            {
+                std::copy(linear_begin(e2), linear_end(e2), linear_begin(e1));
+            }
+        };
+
+        template <class E1, class E2>
+        struct trivial_assigner<E1, E2, true>
+        {
+            using size_type = typename E1::size_type;
+
+            static void run(E1& e1, const E2& e2)
+            {
+                run(e1, e2, size_type(0), e1.size());
+            }
+
+            // Assigns the elements in [first, last) of the linear storage;
+            // first must be a multiple of the batch size.
+            static void run(E1& e1, const E2& e2, size_type first, size_type last)
+            {
+                using value_type = typename E1::value_type;
+                constexpr size_type simd_size = simd_traits<value_type>::size;
+
+                size_type simd_end = last - (last - first) % simd_size;
+                for(size_type i = first; i < simd_end; i += simd_size)
+                {
+                    e1.store_simd(i, e2.template load_simd<value_type>(i));
+                }
+                for(size_type i = simd_end; i < last; ++i)
+                {
+                    e1.data_element(i) = e2.data_element(i);
+                }
+            }
+        };
+
+        // Parallel assignment: trivial broadcasts of expressions providing
+        // the SIMD interface are split along the linear storage, in chunks
+        // of whole batches; other assignments are split along the outermost
+        // dimension of their traversal, each chunk being assigned by its own
+        // data_assigner or tiled_assigner.
+        template <class E1, class E2>
+        inline void parallel_assign(xexecutor& executor, E1& e1, const E2& e2, bool /*trivial*/, std::false_type /*simd*/)
+        {
+            if(e1.dimension() == 0)
+            {
+                data_assigner<E1, E2>(e1, e2).run();
+                return;
+            }
+            std::size_t outer = traversal_order(e1).front();
+            std::size_t tiled_dim = tiled_dimension(e1, e2);
+            if(tiled_dim != e1.dimension())
+            {
+                std::size_t alignment = tiled_dim == outer ? assign_tile_size<typename E1::value_type>() : 1;
+                parallel_chunks(executor, e1.shape()[outer], alignment, [&e1, &e2, tiled_dim](std::size_t first, std::size_t last) {
+                    tiled_assigner<E1, E2>(e1, e2, tiled_dim).run(first, last);
+                });
+                return;
+            }
+            parallel_chunks(executor, e1.shape()[outer], 1, [&e1, &e2](std::size_t first, std::size_t last) {
+                data_assigner<E1, E2>(e1, e2).run(first, last);
+            });
+        }
+
+        template <class E1, class E2>
+        inline void parallel_assign(xexecutor& executor, E1& e1, const E2& e2, bool trivial, std::true_type /*simd*/)
+        {
+            if(!trivial)
+            {
+                parallel_assign(executor, e1, e2, trivial, std::false_type());
+                return;
+            }
+            constexpr std::size_t simd_size = simd_traits<typename E1::value_type>::size;
+            parallel_chunks(executor, e1.size(), simd_size, [&e1, &e2](std::size_t first, std::size_t last) {
+                trivial_assigner<E1, E2, true>::run(e1, e2, first, last);
+            });
+        }
+
+        // Expressions providing an assign_to method, such as reducers,
+        // evaluate themselves as a whole more efficiently than element
+        // by element; they are used when no broadcasting is involved.
+        template <class E1, class E2, class = void>
+        struct has_assign_to : std::false_type
+        {
+        };
+
+        template <class E1, class E2>
+        struct has_assign_to<E1, E2, void_t<decltype(std::declval<const E2&>().assign_to(std::declval<E1&>(), std::declval<xexecutor*>()))>>
+            : std::true_type
+        {
+        };
+
+        template <class E1, class E2>
+        inline bool assign_to(E1& e1, const E2& e2, xexecutor* executor, std::true_type)
+        {
+            if(e1.shape().size() == e2.shape().size() &&
+               std::equal(e1.shape().cbegin(), e1.shape().cend(), e2.shape().cbegin()))
+            {
+                e2.assign_to(e1, executor);
+                return true;
+            }
+            return false;
+        }
+
+        template <class E1, class E2>
+        inline bool assign_to(E1& /*e1*/, const E2& /*e2*/, xexecutor* /*executor*/, std::false_type)
+        {
+            return false;
+        }
+
+        template <class E1, class E2, class F>
+        inline void parallel_transform(xexecutor& executor, E1& e1, const E2& e2, F& f, std::true_type /*random_access*/)
+        {
+            auto begin = e1.storage_begin();
+            std::size_t size = static_cast<std::size_t>(std::distance(begin, e1.storage_end()));
+            parallel_chunks(executor, size, 1, [begin, &e2, &f](std::size_t first, std::size_t last) {
+                std::transform(begin + first, begin + last, begin + first,
+                        [&e2, &f](const auto& v) { return f(v, e2); });
+            });
+        }
+
+        template <class E1, class E2, class F>
+        inline void parallel_transform(xexecutor& /*executor*/, E1& e1, const E2& e2, F& f, std::false_type /*random_access*/)
+        {
+            std::transform(e1.storage_begin(), e1.storage_end(), e1.storage_begin(),
+                    [&e2, &f](const auto& v) { return f(v, e2); });
+        }
+    }
+
     /***********************************
      * Assign functions implementation *
      ***********************************/
 
     template <class E1, class E2>
     inline void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial)
+    {
+        assign_data(e1, e2, trivial, default_executor());
+    }
+
+    /**
+     * Assigns the elements of \c e2 to \c e1, whose shape must already
+     * match. When \c executor is not null, has a concurrency greater than
+     * one and \c e1 holds at least parallel_threshold() elements, the
+     * assignment is split into chunks run by \c executor. When \c trivial
+     * is true, \c e1 is contiguous and \c e2 has the same strides, both
+     * expressions are traversed along their linear storage; otherwise the
+     * dimensions are traversed in the memory order of \c e1; when \c e2
+     * is not contiguous along the innermost one, as when assigning a
+     * column-major container to a row-major one, the elements are assigned
+     * by tiles fitting in the L1 cache.
+     */
+    template <class E1, class E2>
+    inline void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial, xexecutor* executor)
     {
         E1& de1 = e1.derived_cast();
         const E2& de2 = e2.derived_cast();
-        bool trivial_broadcast = trivial && de2.is_trivial_broadcast(de1.strides());
-        if(trivial_broadcast)
+        if(detail::assign_to(de1, de2, executor, detail::has_assign_to<E1, E2>()))
         {
-            std::copy(de2.storage_begin(), de2.storage_end(), de1.storage_begin());
+            return;
+        }
+        bool trivial_broadcast = trivial && detail::is_contiguous_expression(de1, detail::has_is_contiguous<E1>()) &&
+            de2.is_trivial_broadcast(de1.strides());
+        if(detail::use_executor(executor, data_size(de1.shape())))
+        {
+            detail::parallel_assign(*executor, de1, de2, trivial_broadcast, detail::simd_assignable<E1, E2>());
+        }
+        else if(trivial_broadcast)
+        {
+            detail::trivial_assigner<E1, E2>::run(de1, de2);
         }
         else
         {
-            const auto& shape = de1.shape();
-            data_assigner<E1, E2> assigner(de1, de2);
-            assigner.run();
+            std::size_t tiled_dim = detail::tiled_dimension(de1, de2);
+            if(tiled_dim != de1.dimension())
+            {
+                tiled_assigner<E1, E2>(de1, de2, tiled_dim).run();
+            }
+            else
+            {
+                data_assigner<E1, E2> assigner(de1, de2);
+                assigner.run();
+            }
         }
     }
 
@@ -103,12 +528,73 @@ namespace xt
         using size_type = typename E1::size_type;
         const E2& de2 = e2.derived_cast();
         size_type size = de2.dimension();
-        shape_type shape(size, size_type(1));
+        shape_type shape = make_sequence<shape_type>(size, size_type(1));
         bool trivial_broadcast = de2.broadcast_shape(shape);
         e1.derived_cast().reshape(shape);
         return trivial_broadcast;
     }
 
+    // Temporaries are built with the allocator of the expression they are
+    // assigned to, so that they come from the same pool; expressions whose
+    // data do not provide an allocator, or whose temporary type does not
+    // accept one, get a default constructed temporary.
+
+    namespace detail
+    {
+        template <class E, class = void>
+        struct has_data_allocator : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_data_allocator<E, void_t<decltype(std::declval<const E&>().data().get_allocator())>>
+            : std::true_type
+        {
+        };
+
+        template <class E, bool B = has_data_allocator<E>::value>
+        struct temporary_builder
+        {
+            template <class... Args>
+            static inline typename array_inner_types<E>::temporary_type make(const E& /*e*/, Args&&... args)
+            {
+                return typename array_inner_types<E>::temporary_type(std::forward<Args>(args)...);
+            }
+        };
+
+        template <class E>
+        struct temporary_builder<E, true>
+        {
+            using temporary_type = typename array_inner_types<E>::temporary_type;
+            using allocator_type = decltype(std::declval<const E&>().data().get_allocator());
+
+            template <class... Args>
+            static inline std::enable_if_t<std::is_constructible<temporary_type, Args..., allocator_type>::value, temporary_type>
+            make(const E& e, Args&&... args)
+            {
+                return temporary_type(std::forward<Args>(args)..., e.data().get_allocator());
+            }
+
+            template <class... Args>
+            static inline std::enable_if_t<!std::is_constructible<temporary_type, Args..., allocator_type>::value, temporary_type>
+            make(const E& /*e*/, Args&&... args)
+            {
+                return temporary_type(std::forward<Args>(args)...);
+            }
+        };
+    }
+
+    /**
+     * Builds a temporary of the type required to assign an xexpression
+     * to \c e, forwarding \c args to its constructor. When the data of
+     * \c e provide an allocator, the temporary uses a copy of it.
+     */
+    template <class E, class... Args>
+    inline typename array_inner_types<E>::temporary_type make_temporary(const E& e, Args&&... args)
+    {
+        return detail::temporary_builder<E>::make(e, std::forward<Args>(args)...);
+    }
+
     template <class E1, class E2>
     inline void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2)
     {
@@ -116,6 +602,18 @@ namespace xt
         assign_data(e1, e2, trivial_broadcast);
     }
 
+    /**
+     * Reshapes \c e1 and assigns \c e2 to it through \c executor instead
+     * of the default executor. As with noalias, \c e2 must not depend
+     * on \c e1.
+     */
+    template <class E1, class E2>
+    inline void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2, xexecutor& executor)
+    {
+        bool trivial_broadcast = reshape(e1, e2);
+        assign_data(e1, e2, trivial_broadcast, &executor);
+    }
+
     template <class E1, class E2>
     inline void computed_assign(xexpression<E1>& e1, const xexpression<E2>& e2)
     {
@@ -126,12 +624,12 @@ namespace xt
         const E2& de2 = e2.derived_cast();
 
         size_type dim = de2.dimension();
-        shape_type shape(dim, size_type(1));
+        shape_type shape = make_sequence<shape_type>(dim, size_type(1));
         bool trivial_broadcast = de2.broadcast_shape(shape);
 
         if(dim > de1.dimension() || shape > de1.shape())
         {
-            typename E1::temporary_type tmp(shape);
+            auto tmp = make_temporary(de1, shape);
             assign_data(tmp, e2, trivial_broadcast);
             de1.assign_temporary(tmp);
         }
@@ -144,9 +642,19 @@ namespace xt
     template <class E1, class E2, class F>
     inline void scalar_computed_assign(xexpression<E1>& e1, const E2& e2, F&& f)
     {
+        using iterator_category = typename std::iterator_traits<typename E1::storage_iterator>::iterator_category;
+        using random_access = std::is_base_of<std::random_access_iterator_tag, iterator_category>;
         E1& d = e1.derived_cast();
-        std::transform(d.storage_begin(), d.storage_end(), d.storage_begin(),
-                [e2, &f](const auto& v) { return f(v, e2); });
+        xexecutor* executor = default_executor();
+        if(detail::use_executor(executor, data_size(d.shape())))
+        {
+            detail::parallel_transform(*executor, d, e2, f, random_access());
+        }
+        else
+        {
+            std::transform(d.storage_begin(), d.storage_end(), d.storage_begin(),
+                    [e2, &f](const auto& v) { return f(v, e2); });
+        }
     }
 
     template <class E1, class E2>
@@ -157,7 +665,7 @@ namespace xt
         const E1& de1 = e1.derived_cast();
         const E2& de2 = e2.derived_cast();
         size_type size = de2.dimension();
-        shape_type shape(size, size_type(1));
+        shape_type shape = make_sequence<shape_type>(size, size_type(1));
         de2.broadcast_shape(shape);
         if(shape.size() > de1.shape().size() || shape > de1.shape())
         {
@@ -172,26 +680,90 @@ namespace xt
     template <class E1, class E2>
     inline data_assigner<E1, E2>::data_assigner(E1& e1, const E2& e2)
         : m_e1(e1), m_lhs(e1.stepper_begin(e1.shape())),
-          m_rhs(e2.stepper_begin(e1.shape())), m_rhs_end(e2.stepper_end(e1.shape())),
-          m_index(e1.shape().size(), size_type(0))
+          m_rhs(e2.stepper_begin(e1.shape())),
+          m_order(detail::traversal_order(e1)),
+          m_index(e1.shape().size(), size_type(0)),
+          m_outer_end(0), m_row_begin(0), m_row_size(1)
     {
+        const shape_type& shape = e1.shape();
+        size_type dim = shape.size();
+        if(dim == 0)
+        {
+            return;
+        }
+        // The outermost dimension is never merged, so that run can
+        // restrict the traversal along it.
+        size_type inner = m_order.back();
+        m_row_begin = dim - 1;
+        m_row_size = shape[inner];
+        while(m_row_begin > 1)
+        {
+            size_type outer = m_order[m_row_begin - 1];
+            if(shape[outer] != 1 &&
+               !(mergeable_dimensions(e1, dim, outer, inner, m_row_size) &&
+                 mergeable_dimensions(e2, dim, outer, inner, m_row_size)))
+            {
+                break;
+            }
+            m_row_size *= shape[outer];
+            --m_row_begin;
+        }
     }
 
     template <class E1, class E2>
     inline void data_assigner<E1, E2>::run()
     {
-        while(m_rhs != m_rhs_end)
+        const shape_type& shape = m_e1.shape();
+        if(shape.size() == 0)
         {
             *m_lhs = *m_rhs;
-            increment_stepper(*this, m_index, m_e1.shape());
+            return;
+        }
+        run(size_type(0), shape[m_order[0]]);
+    }
+
+    // Assigns the elements whose index along the outermost dimension of
+    // the traversal is in [first, last); the steppers must not have been
+    // moved before.
+    template <class E1, class E2>
+    inline void data_assigner<E1, E2>::run(size_type first, size_type last)
+    {
+        const shape_type& shape = m_e1.shape();
+        if(first == last || std::find(shape.cbegin(), shape.cend(), size_type(0)) != shape.cend())
+        {
+            return;
+        }
+        if(first != 0)
+        {
+            step(m_order[0], first);
+        }
+        size_type inner = m_order.back();
+        if(shape.size() == 1)
+        {
+            assign_row(inner, last - first);
+            return;
         }
+        m_index[0] = first;
+        m_outer_end = last;
+        do
+        {
+            assign_row(inner, m_row_size);
+        }
+        while(next_row());
+    }
+
+    template <class E1, class E2>
+    inline void data_assigner<E1, E2>::step(size_type i, size_type n)
+    {
+        m_lhs.step(i, n);
+        m_rhs.step(i, n);
     }
 
     template <class E1, class E2>
-    inline void data_assigner<E1, E2>::step(size_type i)
+    inline void data_assigner<E1, E2>::step_back(size_type i, size_type n)
     {
-        m_lhs.step(i);
-        m_rhs.step(i);
+        m_lhs.step_back(i, n);
+        m_rhs.step_back(i, n);
     }
 
     template <class E1, class E2>
@@ -207,7 +779,171 @@ namespace xt
         m_lhs.to_end();
         m_rhs.to_end();
     }
+
+    template <class E1, class E2>
+    inline void data_assigner<E1, E2>::assign_row(size_type dim, size_type size)
+    {
+        // Local copies of the steppers let the compiler keep them in
+        // registers during the loop.
+        lhs_iterator lhs = m_lhs;
+        rhs_iterator rhs = m_rhs;
+        *lhs = *rhs;
+        for(size_type i = 1; i != size; ++i)
+        {
+            lhs.step(dim);
+            rhs.step(dim);
+            *lhs = *rhs;
+        }
+        m_lhs = lhs;
+        m_rhs = rhs;
+    }
+
+    // Moves the steppers to the beginning of the next row, returns false
+    // if the last row has been assigned.
+    template <class E1, class E2>
+    inline bool data_assigner<E1, E2>::next_row()
+    {
+        const shape_type& shape = m_e1.shape();
+        size_type inner = m_order.back();
+        if(m_row_begin == shape.size() - 1)
+        {
+            reset(inner);
+        }
+        else
+        {
+            step_back(inner, m_row_size - 1);
+        }
+        for(size_type j = m_row_begin; j != 0; --j)
+        {
+            size_type i = j - 1;
+            size_type dim = m_order[i];
+            if(++m_index[i] != (i == 0 ? m_outer_end : shape[dim]))
+            {
+                step(dim);
+                return true;
+            }
+            m_index[i] = 0;
+            reset(dim);
+        }
+        return false;
+    }
+
+    /*********************************
+     * tiled_assigner implementation *
+     *********************************/
+
+    template <class E1, class E2>
+    inline tiled_assigner<E1, E2>::tiled_assigner(E1& e1, const E2& e2, size_type tiled_dim)
+        : m_e1(e1), m_e2(e2), m_order(detail::traversal_order(e1)),
+          m_tiled_dim(tiled_dim), m_inner(m_order.back())
+    {
+    }
+
+    template <class E1, class E2>
+    inline void tiled_assigner<E1, E2>::run()
+    {
+        run(size_type(0), m_e1.shape()[m_order[0]]);
+    }
+
+    // Assigns the elements whose index along the outermost dimension of
+    // the traversal is in [first, last); the planes of tiles are traversed
+    // in the order of the traversal of e1.
+    template <class E1, class E2>
+    inline void tiled_assigner<E1, E2>::run(size_type first, size_type last)
+    {
+        const shape_type& shape = m_e1.shape();
+        if(first == last || std::find(shape.cbegin(), shape.cend(), size_type(0)) != shape.cend())
+        {
+            return;
+        }
+        size_type dim = shape.size();
+        size_type outer = m_order[0];
+        shape_type lower = make_sequence<shape_type>(dim, size_type(0));
+        shape_type upper = shape;
+        lower[outer] = first;
+        upper[outer] = last;
+
+        lhs_iterator lhs = m_e1.stepper_begin(shape);
+        rhs_iterator rhs = m_e2.stepper_begin(shape);
+        lhs.step(outer, first);
+        rhs.step(outer, first);
+        shape_type index = lower;
+        bool done = false;
+        while(!done)
+        {
+            assign_tiles(lhs, rhs, lower[m_tiled_dim], upper[m_tiled_dim]);
+            done = true;
+            for(size_type i = dim; i != 0; --i)
+            {
+                size_type d = m_order[i - 1];
+                if(d == m_tiled_dim || d == m_inner)
+                {
+                    continue;
+                }
+                if(++index[d] != upper[d])
+                {
+                    lhs.step(d);
+                    rhs.step(d);
+                    done = false;
+                    break;
+                }
+                size_type n = upper[d] - lower[d] - 1;
+                index[d] = lower[d];
+                lhs.step_back(d, n);
+                rhs.step_back(d, n);
+            }
+        }
+    }
+
+    // Assigns the tiles of the plane of the tiled and the innermost
+    // dimensions starting at lhs and rhs, whose index along the tiled
+    // dimension is in [first, last).
+    template <class E1, class E2>
+    inline void tiled_assigner<E1, E2>::assign_tiles(lhs_iterator lhs, rhs_iterator rhs, size_type first, size_type last) const
+    {
+        constexpr size_type tile_size = detail::assign_tile_size<typename E1::value_type>();
+        size_type inner = m_inner;
+        size_type row_size = m_e1.shape()[inner];
+        for(size_type i = first; i < last; i += tile_size)
+        {
+            size_type rows = std::min(tile_size, last - i);
+            lhs_iterator lhs_tile = lhs;
+            rhs_iterator rhs_tile = rhs;
+            for(size_type j = 0; j < row_size; j += tile_size)
+            {
+                size_type cols = std::min(tile_size, row_size - j);
+                lhs_iterator lhs_row = lhs_tile;
+                rhs_iterator rhs_row = rhs_tile;
+                for(size_type k = 0; k != rows; ++k)
+                {
+                    lhs_iterator l = lhs_row;
+                    rhs_iterator r = rhs_row;
+                    *l = *r;
+                    for(size_type n = 1; n != cols; ++n)
+                    {
+                        l.step(inner);
+                        r.step(inner);
+                        *l = *r;
+                    }
+                    if(k + 1 != rows)
+                    {
+                        lhs_row.step(m_tiled_dim);
+                        rhs_row.step(m_tiled_dim);
+                    }
+                }
+                if(j + tile_size < row_size)
+                {
+                    lhs_tile.step(inner, tile_size);
+                    rhs_tile.step(inner, tile_size);
+                }
+            }
+            if(i + tile_size < last)
+            {
+                lhs.step(m_tiled_dim, tile_size);
+                rhs.step(m_tiled_dim, tile_size);
+            }
+        }
+    }
 }
 
 #endif
-
@@ -0,0 +1,622 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XBATCH_HPP
+#define XBATCH_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "xutils.hpp"
+
+
+// The widest instruction set enabled at compile time is used: AVX-512F,
+// AVX2, or SSE2. Defining XTENSOR_DISABLE_SIMD forces scalar evaluation.
+#if !defined(XTENSOR_DISABLE_SIMD)
+    #if defined(__AVX512F__)
+        #define XTENSOR_SIMD_BYTES 64
+    #elif defined(__AVX2__)
+        #define XTENSOR_SIMD_BYTES 32
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define XTENSOR_SIMD_BYTES 16
+    #endif
+#endif
+
+#if defined(XTENSOR_SIMD_BYTES)
+    #include <immintrin.h>
+#endif
+
+namespace xt
+{
+
+    template <class T, std::size_t N>
+    class xbatch;
+
+    /**
+     * @class simd_traits
+     * @brief Batch type used for the vectorized evaluation of
+     * expressions of \c T.
+     *
+     * The type member is an xbatch of as many elements as fit in a
+     * register of the widest enabled instruction set when T is float
+     * or double, and T itself otherwise; the size member is the number
+     * of elements of the batch.
+     */
+    template <class T>
+    struct simd_traits
+    {
+        using type = T;
+        static constexpr std::size_t size = 1;
+    };
+
+    template <class T>
+    using simd_type_t = typename simd_traits<T>::type;
+
+    /**
+     * @class has_simd_interface
+     * @brief Checks whether the expression \c E can be evaluated by
+     * batches of elements of type \c V.
+     *
+     * Expressions providing the SIMD interface define the member template
+     * simd_enabled<V>, an integral constant stating whether batches of V
+     * can be loaded, and the following methods, where the index \c i
+     * refers to the linear storage of the expression and is only meaningful
+     * for trivial broadcasts:
+     * - <tt>template <class V> simd_type_t<V> load_simd(size_type i) const</tt>
+     * - <tt>const_reference data_element(size_type i) const</tt>
+     *
+     * Assignable expressions also provide store_simd(i, batch) and a non
+     * constant data_element.
+     */
+    template <class E, class V, class = void>
+    struct has_simd_interface : std::false_type
+    {
+    };
+
+    template <class E, class V>
+    struct has_simd_interface<E, V, detail::void_t<typename E::template simd_enabled<V>>>
+        : E::template simd_enabled<V>
+    {
+    };
+
+    /**
+     * @class has_simd_apply
+     * @brief Checks whether the functor \c F provides a simd_apply
+     * method accepting arguments of types \c Args.
+     */
+    template <class F, class... Args>
+    struct has_simd_apply;
+
+    /**********************
+     * xbatch declaration *
+     **********************/
+
+    namespace detail
+    {
+        // Instruction set specific implementation of the batches of N
+        // elements of type T: register_type, set1, loadu, load, storeu,
+        // store, add, sub, mul, div, min, max, sqrt and mul_add; bitwise
+        // operations and shifts; comparisons returning a mask_type, select
+        // and all; and for float, the conversions to_double and from_double
+        // between a batch and two batches of doubles.
+        template <class T, std::size_t N>
+        struct simd_kernel;
+    }
+
+    /**
+     * @class xbatch
+     * @brief Batch of elements held in a SIMD register.
+     *
+     * The xbatch class wraps a SIMD register holding N elements of type T
+     * and provides the arithmetic operators and basic mathematical
+     * functions operating on all the elements at once.
+     *
+     * @tparam T The type of the elements.
+     * @tparam N The number of elements.
+     */
+    template <class T, std::size_t N>
+    class xbatch
+    {
+
+    public:
+
+        using self_type = xbatch<T, N>;
+        using value_type = T;
+        using kernel_type = detail::simd_kernel<T, N>;
+        using register_type = typename kernel_type::register_type;
+
+        static constexpr std::size_t size = N;
+
+        xbatch() = default;
+        xbatch(value_type v) noexcept;
+        xbatch(register_type r) noexcept;
+
+        operator register_type() const noexcept;
+
+        static self_type load_aligned(const value_type* src) noexcept;
+        static self_type load_unaligned(const value_type* src) noexcept;
+
+        void store_aligned(value_type* dst) const noexcept;
+        void store_unaligned(value_type* dst) const noexcept;
+
+        value_type operator[](std::size_t i) const noexcept;
+
+        self_type& operator+=(const self_type& rhs) noexcept;
+        self_type& operator-=(const self_type& rhs) noexcept;
+        self_type& operator*=(const self_type& rhs) noexcept;
+        self_type& operator/=(const self_type& rhs) noexcept;
+
+    private:
+
+        register_type m_value;
+    };
+
+    template <class T, std::size_t N>
+    xbatch<T, N> operator+(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept;
+
+    template <class T, std::size_t N>
+    xbatch<T, N> operator-(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept;
+
+    template <class T, std::size_t N>
+    xbatch<T, N> operator*(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept;
+
+    template <class T, std::size_t N>
+    xbatch<T, N> operator/(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept;
+
+    template <class T, std::size_t N>
+    xbatch<T, N> operator+(const xbatch<T, N>& rhs) noexcept;
+
+    template <class T, std::size_t N>
+    xbatch<T, N> operator-(const xbatch<T, N>& rhs) noexcept;
+
+    template <class T, std::size_t N>
+    xbatch<T, N> min(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept;
+
+    template <class T, std::size_t N>
+    xbatch<T, N> max(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept;
+
+    template <class T, std::size_t N>
+    xbatch<T, N> sqrt(const xbatch<T, N>& rhs) noexcept;
+
+    template <class F, class T, std::size_t N, class... B>
+    xbatch<T, N> simd_map(const F& f, const xbatch<T, N>& arg, const B&... args);
+
+    /*******************************
+     * simd_kernel implementations *
+     *******************************/
+
+#if defined(XTENSOR_SIMD_BYTES)
+
+    namespace detail
+    {
+        // The kernels are assembled from the following macros, where
+        // PREFIX is the prefix of the intrinsics of the instruction set,
+        // SUFFIX the suffix of the element type, e.g. _mm256 and pd,
+        // ISUFFIX the suffix of the integer register, e.g. si256, and
+        // WIDTH the suffix of integers as wide as the elements.
+
+#define XTENSOR_SIMD_ARITHMETIC(T, REGISTER, PREFIX, SUFFIX)                                     \
+        using register_type = REGISTER;                                                          \
+        static register_type set1(T v) noexcept { return PREFIX##_set1_##SUFFIX(v); }            \
+        static register_type load(const T* src) noexcept { return PREFIX##_load_##SUFFIX(src); }   \
+        static register_type loadu(const T* src) noexcept { return PREFIX##_loadu_##SUFFIX(src); } \
+        static void store(T* dst, register_type r) noexcept { PREFIX##_store_##SUFFIX(dst, r); }   \
+        static void storeu(T* dst, register_type r) noexcept { PREFIX##_storeu_##SUFFIX(dst, r); } \
+        static register_type add(register_type a, register_type b) noexcept { return PREFIX##_add_##SUFFIX(a, b); } \
+        static register_type sub(register_type a, register_type b) noexcept { return PREFIX##_sub_##SUFFIX(a, b); } \
+        static register_type mul(register_type a, register_type b) noexcept { return PREFIX##_mul_##SUFFIX(a, b); } \
+        static register_type div(register_type a, register_type b) noexcept { return PREFIX##_div_##SUFFIX(a, b); } \
+        static register_type min(register_type a, register_type b) noexcept { return PREFIX##_min_##SUFFIX(a, b); } \
+        static register_type max(register_type a, register_type b) noexcept { return PREFIX##_max_##SUFFIX(a, b); } \
+        static register_type sqrt(register_type a) noexcept { return PREFIX##_sqrt_##SUFFIX(a); }
+
+// a * b + c, rounded once when fused multiply-add instructions are available
+#define XTENSOR_SIMD_FUSED_MUL_ADD(PREFIX, SUFFIX)                                               \
+        static register_type mul_add(register_type a, register_type b, register_type c) noexcept \
+        { return PREFIX##_fmadd_##SUFFIX(a, b, c); }
+
+#define XTENSOR_SIMD_UNFUSED_MUL_ADD(PREFIX, SUFFIX)                                             \
+        static register_type mul_add(register_type a, register_type b, register_type c) noexcept \
+        { return PREFIX##_add_##SUFFIX(PREFIX##_mul_##SUFFIX(a, b), c); }
+
+#if defined(__FMA__)
+    #define XTENSOR_SIMD_MUL_ADD XTENSOR_SIMD_FUSED_MUL_ADD
+#else
+    #define XTENSOR_SIMD_MUL_ADD XTENSOR_SIMD_UNFUSED_MUL_ADD
+#endif
+
+// Bitwise operations on the representation of the elements; the shifts
+// operate on each element as on an unsigned integer of the same width.
+#define XTENSOR_SIMD_BITWISE(PREFIX, SUFFIX, ISUFFIX, WIDTH)                                     \
+        static register_type bitwise_and(register_type a, register_type b) noexcept              \
+        { return PREFIX##_cast##ISUFFIX##_##SUFFIX(PREFIX##_and_##ISUFFIX(PREFIX##_cast##SUFFIX##_##ISUFFIX(a), PREFIX##_cast##SUFFIX##_##ISUFFIX(b))); } \
+        static register_type bitwise_or(register_type a, register_type b) noexcept               \
+        { return PREFIX##_cast##ISUFFIX##_##SUFFIX(PREFIX##_or_##ISUFFIX(PREFIX##_cast##SUFFIX##_##ISUFFIX(a), PREFIX##_cast##SUFFIX##_##ISUFFIX(b))); } \
+        static register_type bitwise_xor(register_type a, register_type b) noexcept              \
+        { return PREFIX##_cast##ISUFFIX##_##SUFFIX(PREFIX##_xor_##ISUFFIX(PREFIX##_cast##SUFFIX##_##ISUFFIX(a), PREFIX##_cast##SUFFIX##_##ISUFFIX(b))); } \
+        static register_type bitwise_andnot(register_type a, register_type b) noexcept           \
+        { return PREFIX##_cast##ISUFFIX##_##SUFFIX(PREFIX##_andnot_##ISUFFIX(PREFIX##_cast##SUFFIX##_##ISUFFIX(a), PREFIX##_cast##SUFFIX##_##ISUFFIX(b))); } \
+        template <int S>                                                                         \
+        static register_type shift_left(register_type a) noexcept                                \
+        { return PREFIX##_cast##ISUFFIX##_##SUFFIX(PREFIX##_slli_##WIDTH(PREFIX##_cast##SUFFIX##_##ISUFFIX(a), S)); } \
+        template <int S>                                                                         \
+        static register_type shift_right(register_type a) noexcept                               \
+        { return PREFIX##_cast##ISUFFIX##_##SUFFIX(PREFIX##_srli_##WIDTH(PREFIX##_cast##SUFFIX##_##ISUFFIX(a), S)); }
+
+// SSE2 comparisons return registers whose elements have all their bits set
+// where the comparison holds.
+#define XTENSOR_SSE_COMPARISON(SUFFIX, ALL)                                                      \
+        using mask_type = register_type;                                                         \
+        static mask_type eq(register_type a, register_type b) noexcept { return _mm_cmpeq_##SUFFIX(a, b); }   \
+        static mask_type neq(register_type a, register_type b) noexcept { return _mm_cmpneq_##SUFFIX(a, b); } \
+        static mask_type lt(register_type a, register_type b) noexcept { return _mm_cmplt_##SUFFIX(a, b); }   \
+        static mask_type le(register_type a, register_type b) noexcept { return _mm_cmple_##SUFFIX(a, b); }   \
+        static register_type select(mask_type m, register_type a, register_type b) noexcept     \
+        { return _mm_or_##SUFFIX(_mm_and_##SUFFIX(m, a), _mm_andnot_##SUFFIX(m, b)); }          \
+        static bool all(mask_type m) noexcept { return _mm_movemask_##SUFFIX(m) == ALL; }
+
+#define XTENSOR_AVX_COMPARISON(SUFFIX, ALL)                                                      \
+        using mask_type = register_type;                                                         \
+        static mask_type eq(register_type a, register_type b) noexcept { return _mm256_cmp_##SUFFIX(a, b, _CMP_EQ_OQ); }   \
+        static mask_type neq(register_type a, register_type b) noexcept { return _mm256_cmp_##SUFFIX(a, b, _CMP_NEQ_UQ); } \
+        static mask_type lt(register_type a, register_type b) noexcept { return _mm256_cmp_##SUFFIX(a, b, _CMP_LT_OQ); }   \
+        static mask_type le(register_type a, register_type b) noexcept { return _mm256_cmp_##SUFFIX(a, b, _CMP_LE_OQ); }   \
+        static register_type select(mask_type m, register_type a, register_type b) noexcept     \
+        { return _mm256_blendv_##SUFFIX(b, a, m); }                                              \
+        static bool all(mask_type m) noexcept { return _mm256_movemask_##SUFFIX(m) == ALL; }
+
+// AVX-512 comparisons return mask registers, one bit per element.
+#define XTENSOR_AVX512_COMPARISON(SUFFIX, MASK, ALL)                                             \
+        using mask_type = MASK;                                                                  \
+        static mask_type eq(register_type a, register_type b) noexcept { return _mm512_cmp_##SUFFIX##_mask(a, b, _CMP_EQ_OQ); }   \
+        static mask_type neq(register_type a, register_type b) noexcept { return _mm512_cmp_##SUFFIX##_mask(a, b, _CMP_NEQ_UQ); } \
+        static mask_type lt(register_type a, register_type b) noexcept { return _mm512_cmp_##SUFFIX##_mask(a, b, _CMP_LT_OQ); }   \
+        static mask_type le(register_type a, register_type b) noexcept { return _mm512_cmp_##SUFFIX##_mask(a, b, _CMP_LE_OQ); }   \
+        static register_type select(mask_type m, register_type a, register_type b) noexcept     \
+        { return _mm512_mask_blend_##SUFFIX(m, b, a); }                                          \
+        static bool all(mask_type m) noexcept { return m == ALL; }
+
+        template <>
+        struct simd_kernel<float, 4>
+        {
+            XTENSOR_SIMD_ARITHMETIC(float, __m128, _mm, ps)
+            XTENSOR_SIMD_MUL_ADD(_mm, ps)
+            XTENSOR_SIMD_BITWISE(_mm, ps, si128, epi32)
+            XTENSOR_SSE_COMPARISON(ps, 0xF)
+
+            using double_register_type = __m128d;
+
+            static void to_double(register_type a, double_register_type& lo, double_register_type& hi) noexcept
+            {
+                lo = _mm_cvtps_pd(a);
+                hi = _mm_cvtps_pd(_mm_movehl_ps(a, a));
+            }
+
+            static register_type from_double(double_register_type lo, double_register_type hi) noexcept
+            {
+                return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+            }
+        };
+
+        template <>
+        struct simd_kernel<double, 2>
+        {
+            XTENSOR_SIMD_ARITHMETIC(double, __m128d, _mm, pd)
+            XTENSOR_SIMD_MUL_ADD(_mm, pd)
+            XTENSOR_SIMD_BITWISE(_mm, pd, si128, epi64)
+            XTENSOR_SSE_COMPARISON(pd, 0x3)
+        };
+
+#if XTENSOR_SIMD_BYTES >= 32
+        template <>
+        struct simd_kernel<float, 8>
+        {
+            XTENSOR_SIMD_ARITHMETIC(float, __m256, _mm256, ps)
+            XTENSOR_SIMD_MUL_ADD(_mm256, ps)
+            XTENSOR_SIMD_BITWISE(_mm256, ps, si256, epi32)
+            XTENSOR_AVX_COMPARISON(ps, 0xFF)
+
+            using double_register_type = __m256d;
+
+            static void to_double(register_type a, double_register_type& lo, double_register_type& hi) noexcept
+            {
+                lo = _mm256_cvtps_pd(_mm256_castps256_ps128(a));
+                hi = _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1));
+            }
+
+            static register_type from_double(double_register_type lo, double_register_type hi) noexcept
+            {
+                return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)), _mm256_cvtpd_ps(hi), 1);
+            }
+        };
+
+        template <>
+        struct simd_kernel<double, 4>
+        {
+            XTENSOR_SIMD_ARITHMETIC(double, __m256d, _mm256, pd)
+            XTENSOR_SIMD_MUL_ADD(_mm256, pd)
+            XTENSOR_SIMD_BITWISE(_mm256, pd, si256, epi64)
+            XTENSOR_AVX_COMPARISON(pd, 0xF)
+        };
+#endif
+
+#if XTENSOR_SIMD_BYTES >= 64
+        template <>
+        struct simd_kernel<float, 16>
+        {
+            XTENSOR_SIMD_ARITHMETIC(float, __m512, _mm512, ps)
+            XTENSOR_SIMD_FUSED_MUL_ADD(_mm512, ps)
+            XTENSOR_SIMD_BITWISE(_mm512, ps, si512, epi32)
+            XTENSOR_AVX512_COMPARISON(ps, __mmask16, 0xFFFF)
+
+            using double_register_type = __m512d;
+
+            static void to_double(register_type a, double_register_type& lo, double_register_type& hi) noexcept
+            {
+                lo = _mm512_cvtps_pd(_mm512_castps512_ps256(a));
+                hi = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1)));
+            }
+
+            static register_type from_double(double_register_type lo, double_register_type hi) noexcept
+            {
+                __m512d res = _mm512_castps_pd(_mm512_castps256_ps512(_mm512_cvtpd_ps(lo)));
+                return _mm512_castpd_ps(_mm512_insertf64x4(res, _mm256_castps_pd(_mm512_cvtpd_ps(hi)), 1));
+            }
+        };
+
+        template <>
+        struct simd_kernel<double, 8>
+        {
+            XTENSOR_SIMD_ARITHMETIC(double, __m512d, _mm512, pd)
+            XTENSOR_SIMD_FUSED_MUL_ADD(_mm512, pd)
+            XTENSOR_SIMD_BITWISE(_mm512, pd, si512, epi64)
+            XTENSOR_AVX512_COMPARISON(pd, __mmask8, 0xFF)
+        };
+#endif
+
+#undef XTENSOR_AVX512_COMPARISON
+#undef XTENSOR_AVX_COMPARISON
+#undef XTENSOR_SSE_COMPARISON
+#undef XTENSOR_SIMD_BITWISE
+#undef XTENSOR_SIMD_MUL_ADD
+#undef XTENSOR_SIMD_UNFUSED_MUL_ADD
+#undef XTENSOR_SIMD_FUSED_MUL_ADD
+#undef XTENSOR_SIMD_ARITHMETIC
+    }
+
+    template <>
+    struct simd_traits<float>
+    {
+        static constexpr std::size_t size = XTENSOR_SIMD_BYTES / sizeof(float);
+        using type = xbatch<float, size>;
+    };
+
+    template <>
+    struct simd_traits<double>
+    {
+        static constexpr std::size_t size = XTENSOR_SIMD_BYTES / sizeof(double);
+        using type = xbatch<double, size>;
+    };
+
+#endif
+
+    /*************************
+     * xbatch implementation *
+     *************************/
+
+    /**
+     * Constructs a batch whose elements are all equal to \c v.
+     */
+    template <class T, std::size_t N>
+    inline xbatch<T, N>::xbatch(value_type v) noexcept
+        : m_value(kernel_type::set1(v))
+    {
+    }
+
+    /**
+     * Constructs a batch from a SIMD register.
+     */
+    template <class T, std::size_t N>
+    inline xbatch<T, N>::xbatch(register_type r) noexcept
+        : m_value(r)
+    {
+    }
+
+    template <class T, std::size_t N>
+    inline xbatch<T, N>::operator register_type() const noexcept
+    {
+        return m_value;
+    }
+
+    /**
+     * Loads N elements from \c src, which must be aligned on the size
+     * of the batch.
+     */
+    template <class T, std::size_t N>
+    inline auto xbatch<T, N>::load_aligned(const value_type* src) noexcept -> self_type
+    {
+        return self_type(kernel_type::load(src));
+    }
+
+    /**
+     * Loads N elements from \c src.
+     */
+    template <class T, std::size_t N>
+    inline auto xbatch<T, N>::load_unaligned(const value_type* src) noexcept -> self_type
+    {
+        return self_type(kernel_type::loadu(src));
+    }
+
+    /**
+     * Stores the elements to \c dst, which must be aligned on the size
+     * of the batch.
+     */
+    template <class T, std::size_t N>
+    inline void xbatch<T, N>::store_aligned(value_type* dst) const noexcept
+    {
+        kernel_type::store(dst, m_value);
+    }
+
+    /**
+     * Stores the elements to \c dst.
+     */
+    template <class T, std::size_t N>
+    inline void xbatch<T, N>::store_unaligned(value_type* dst) const noexcept
+    {
+        kernel_type::storeu(dst, m_value);
+    }
+
+    /**
+     * Returns the i-th element of the batch. This is slow and meant for
+     * tests and debugging.
+     */
+    template <class T, std::size_t N>
+    inline auto xbatch<T, N>::operator[](std::size_t i) const noexcept -> value_type
+    {
+        alignas(N * sizeof(T)) value_type buffer[N];
+        store_aligned(buffer);
+        return buffer[i];
+    }
+
+    template <class T, std::size_t N>
+    inline auto xbatch<T, N>::operator+=(const self_type& rhs) noexcept -> self_type&
+    {
+        m_value = kernel_type::add(m_value, rhs);
+        return *this;
+    }
+
+    template <class T, std::size_t N>
+    inline auto xbatch<T, N>::operator-=(const self_type& rhs) noexcept -> self_type&
+    {
+        m_value = kernel_type::sub(m_value, rhs);
+        return *this;
+    }
+
+    template <class T, std::size_t N>
+    inline auto xbatch<T, N>::operator*=(const self_type& rhs) noexcept -> self_type&
+    {
+        m_value = kernel_type::mul(m_value, rhs);
+        return *this;
+    }
+
+    template <class T, std::size_t N>
+    inline auto xbatch<T, N>::operator/=(const self_type& rhs) noexcept -> self_type&
+    {
+        m_value = kernel_type::div(m_value, rhs);
+        return *this;
+    }
+
+    template <class T, std::size_t N>
+    inline xbatch<T, N> operator+(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept
+    {
+        return detail::simd_kernel<T, N>::add(lhs, rhs);
+    }
+
+    template <class T, std::size_t N>
+    inline xbatch<T, N> operator-(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept
+    {
+        return detail::simd_kernel<T, N>::sub(lhs, rhs);
+    }
+
+    template <class T, std::size_t N>
+    inline xbatch<T, N> operator*(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept
+    {
+        return detail::simd_kernel<T, N>::mul(lhs, rhs);
+    }
+
+    template <class T, std::size_t N>
+    inline xbatch<T, N> operator/(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept
+    {
+        return detail::simd_kernel<T, N>::div(lhs, rhs);
+    }
+
+    template <class T, std::size_t N>
+    inline xbatch<T, N> operator+(const xbatch<T, N>& rhs) noexcept
+    {
+        return rhs;
+    }
+
+    // Multiplying by -1 is exact and flips the sign of zeros and NaNs.
+    template <class T, std::size_t N>
+    inline xbatch<T, N> operator-(const xbatch<T, N>& rhs) noexcept
+    {
+        return rhs * xbatch<T, N>(T(-1));
+    }
+
+    template <class T, std::size_t N>
+    inline xbatch<T, N> min(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept
+    {
+        return detail::simd_kernel<T, N>::min(lhs, rhs);
+    }
+
+    template <class T, std::size_t N>
+    inline xbatch<T, N> max(const xbatch<T, N>& lhs, const xbatch<T, N>& rhs) noexcept
+    {
+        return detail::simd_kernel<T, N>::max(lhs, rhs);
+    }
+
+    template <class T, std::size_t N>
+    inline xbatch<T, N> sqrt(const xbatch<T, N>& rhs) noexcept
+    {
+        return detail::simd_kernel<T, N>::sqrt(rhs);
+    }
+
+    namespace detail
+    {
+        template <class F, class T, std::size_t M, std::size_t N, std::size_t... I>
+        inline T apply_lane(const F& f, const T (&buffer)[M][N], std::size_t i, std::index_sequence<I...>)
+        {
+            return static_cast<T>(f(buffer[I][i]...));
+        }
+    }
+
+    /**
+     * Applies the scalar function \c f to each element of the batches,
+     * for functions that have no vectorized implementation.
+     */
+    template <class F, class T, std::size_t N, class... B>
+    inline xbatch<T, N> simd_map(const F& f, const xbatch<T, N>& arg, const B&... args)
+    {
+        constexpr std::size_t arity = 1 + sizeof...(B);
+        alignas(N * sizeof(T)) T buffer[arity][N];
+        const xbatch<T, N>* batches[arity] = { &arg, &args... };
+        for (std::size_t j = 0; j < arity; ++j)
+        {
+            batches[j]->store_aligned(buffer[j]);
+        }
+        alignas(N * sizeof(T)) T res[N];
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            res[i] = detail::apply_lane(f, buffer, i, std::make_index_sequence<arity>());
+        }
+        return xbatch<T, N>::load_aligned(res);
+    }
+
+    /*********************************
+     * has_simd_apply implementation *
+     *********************************/
+
+    template <class F, class... Args>
+    struct has_simd_apply
+    {
+    private:
+
+        template <class G>
+        static auto test(int) -> decltype(std::declval<const G&>().simd_apply(std::declval<const Args&>()...), std::true_type());
+
+        template <class G>
+        static std::false_type test(...);
+
+    public:
+
+        static constexpr bool value = decltype(test<F>(0))::value;
+    };
+}
+
+#endif
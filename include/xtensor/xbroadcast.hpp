@@ -0,0 +1,664 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XBROADCAST_HPP
+#define XBROADCAST_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include "xexception.hpp"
+#include "xexpression.hpp"
+#include "xiterator.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /**************************
+     * xbroadcast declaration *
+     **************************/
+
+    template <class E, class S>
+    class xbroadcast_stepper;
+
+    template <class E, class S>
+    class xbroadcast;
+
+    namespace detail
+    {
+        // An xbroadcast of an expression with strides is traversed like a
+        // container, through the storage of this expression; other
+        // expressions are traversed by their own steppers, wrapped so
+        // that they do not move along the broadcast dimensions.
+        template <class E, class S, bool = has_strides<E>::value>
+        struct xbroadcast_traversal
+        {
+            using const_stepper = xbroadcast_stepper<E, S>;
+            using const_storage_iterator = xiterator<const_stepper, S>;
+        };
+
+        template <class E, class S>
+        struct xbroadcast_traversal<E, S, true>
+        {
+            using const_stepper = xstepper<const xbroadcast<E, S>>;
+            using const_storage_iterator = typename E::const_storage_iterator;
+        };
+    }
+
+    /**
+     * @class xbroadcast
+     * @brief Lazy broadcast of an xexpression to a shape.
+     *
+     * The xbroadcast class implements an xexpression whose elements are
+     * those of another xexpression broadcast to the specified shape: the
+     * broadcast expression is aligned with the trailing dimensions of the
+     * shape and is repeated along the leading dimensions and along its
+     * dimensions of size 1. The elements are never copied: an xbroadcast
+     * steps through the broadcast expression as if its strides along the
+     * broadcast dimensions were zero, so that it can be used as an operand
+     * of any expression. When the broadcast expression has strides, so does
+     * the xbroadcast, which is then traversed like a container through the
+     * storage of the broadcast expression.
+     *
+     * @tparam E the type of the broadcast expression
+     * @tparam S the type of the shape
+     */
+    template <class E, class S>
+    class xbroadcast : public xexpression<xbroadcast<E, S>>
+    {
+
+    public:
+
+        using self_type = xbroadcast<E, S>;
+        using expression_type = E;
+
+        using value_type = typename E::value_type;
+        using reference = typename E::const_reference;
+        using const_reference = typename E::const_reference;
+        using pointer = typename E::const_pointer;
+        using const_pointer = typename E::const_pointer;
+        using size_type = typename E::size_type;
+        using difference_type = typename E::difference_type;
+
+        using shape_type = S;
+        using strides_type = S;
+
+        using closure_type = const self_type;
+
+        using const_stepper = typename detail::xbroadcast_traversal<E, S>::const_stepper;
+        using const_iterator = xiterator<const_stepper, shape_type>;
+        template <class ST>
+        using const_broadcast_iterator = xiterator<const_stepper, ST>;
+        using const_storage_iterator = typename detail::xbroadcast_traversal<E, S>::const_storage_iterator;
+
+        xbroadcast(const E& e, const S& shape);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const shape_type& shape() const noexcept;
+
+        template <class T = E>
+        std::enable_if_t<detail::has_strides<T>::value, const strides_type&> strides() const noexcept;
+        template <class T = E>
+        std::enable_if_t<detail::has_strides<T>::value, const strides_type&> backstrides() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+
+        template <class ST>
+        bool broadcast_shape(ST& shape) const;
+
+        template <class ST>
+        bool is_trivial_broadcast(const ST& strides) const noexcept;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        template <class ST>
+        const_broadcast_iterator<ST> xbegin(const ST& shape) const;
+        template <class ST>
+        const_broadcast_iterator<ST> xend(const ST& shape) const;
+        template <class ST>
+        const_broadcast_iterator<ST> cxbegin(const ST& shape) const;
+        template <class ST>
+        const_broadcast_iterator<ST> cxend(const ST& shape) const;
+
+        template <class ST>
+        const_stepper stepper_begin(const ST& shape) const;
+        template <class ST>
+        const_stepper stepper_end(const ST& shape) const;
+
+        const_storage_iterator storage_begin() const;
+        const_storage_iterator storage_end() const;
+
+    private:
+
+        typename E::closure_type m_e;
+        shape_type m_shape;
+        strides_type m_strides;
+        strides_type m_backstrides;
+
+        size_type expression_stride(size_type dim, std::true_type /*strides*/) const;
+        size_type expression_stride(size_type dim, std::false_type /*strides*/) const;
+
+        const_stepper stepper_impl(size_type offset, bool end, std::true_type /*strides*/) const;
+        const_stepper stepper_impl(size_type offset, bool end, std::false_type /*strides*/) const;
+
+        const_storage_iterator storage_begin_impl(std::true_type /*strides*/) const;
+        const_storage_iterator storage_begin_impl(std::false_type /*strides*/) const;
+        const_storage_iterator storage_end_impl(std::true_type /*strides*/) const;
+        const_storage_iterator storage_end_impl(std::false_type /*strides*/) const;
+
+        friend class xbroadcast_stepper<E, S>;
+    };
+
+    template <class E, class S>
+    xbroadcast<E, S> broadcast(const xexpression<E>& e, const S& shape);
+
+    template <class E, class I, std::size_t L>
+    xbroadcast<E, std::array<std::size_t, L>> broadcast(const xexpression<E>& e, const I (&shape)[L]);
+
+    /**********************************
+     * xbroadcast_stepper declaration *
+     **********************************/
+
+    template <class E, class S>
+    class xbroadcast_stepper
+    {
+
+    public:
+
+        using self_type = xbroadcast_stepper<E, S>;
+        using xbroadcast_type = xbroadcast<E, S>;
+
+        using substepper_type = typename E::const_stepper;
+
+        using value_type = typename substepper_type::value_type;
+        using reference = typename substepper_type::reference;
+        using pointer = typename substepper_type::pointer;
+        using size_type = typename xbroadcast_type::size_type;
+        using difference_type = typename substepper_type::difference_type;
+
+        xbroadcast_stepper(const xbroadcast_type* b, substepper_type it, size_type offset);
+
+        reference operator*() const;
+
+        void step(size_type dim, size_type n = 1);
+        void step_back(size_type dim, size_type n = 1);
+        void reset(size_type dim);
+
+        void to_end();
+
+        bool equal(const self_type& rhs) const;
+
+    private:
+
+        const xbroadcast_type* p_b;
+        substepper_type m_it;
+        size_type m_offset;
+    };
+
+    template <class E, class S>
+    bool operator==(const xbroadcast_stepper<E, S>& lhs,
+                    const xbroadcast_stepper<E, S>& rhs);
+
+    template <class E, class S>
+    bool operator!=(const xbroadcast_stepper<E, S>& lhs,
+                    const xbroadcast_stepper<E, S>& rhs);
+
+    /*****************************
+     * xbroadcast implementation *
+     *****************************/
+
+    /**
+     * @name Constructor
+     */
+    //@{
+    /**
+     * Constructs an xbroadcast of \c e to \c shape.
+     * @param e the expression to broadcast
+     * @param shape the shape of the xbroadcast
+     * @throw broadcast_error if \c e cannot be broadcast to \c shape
+     */
+    template <class E, class S>
+    inline xbroadcast<E, S>::xbroadcast(const E& e, const S& shape)
+        : m_e(e), m_shape(shape)
+    {
+        shape_type broadcast_shape = m_shape;
+        xt::broadcast_shape(m_e.shape(), broadcast_shape);
+        if(!std::equal(broadcast_shape.cbegin(), broadcast_shape.cend(), m_shape.cbegin()))
+        {
+            throw broadcast_error<size_type>(m_shape, m_e.shape());
+        }
+        // Without strides, m_strides only tells the broadcast dimensions
+        // apart, with a zero stride.
+        m_strides = make_sequence<strides_type>(dimension(), 0);
+        m_backstrides = make_sequence<strides_type>(dimension(), 0);
+        size_type offset = dimension() - m_e.dimension();
+        for(size_type d = offset; d != dimension(); ++d)
+        {
+            size_type extent = m_e.shape()[d - offset];
+            if(extent != 1 || m_shape[d] == 1)
+            {
+                m_strides[d] = expression_stride(d - offset, detail::has_strides<E>());
+                m_backstrides[d] = m_strides[d] * (m_shape[d] == 0 ? 0 : m_shape[d] - 1);
+            }
+        }
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of elements of the xbroadcast.
+     */
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::size() const noexcept -> size_type
+    {
+        return data_size(m_shape);
+    }
+
+    /**
+     * Returns the number of dimensions of the xbroadcast.
+     */
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the xbroadcast.
+     */
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the strides of the xbroadcast: zero along the broadcast
+     * dimensions, those of the broadcast expression along the others.
+     * Only available when the broadcast expression has strides.
+     */
+    template <class E, class S>
+    template <class T>
+    inline auto xbroadcast<E, S>::strides() const noexcept
+        -> std::enable_if_t<detail::has_strides<T>::value, const strides_type&>
+    {
+        return m_strides;
+    }
+
+    /**
+     * Returns the backstrides of the xbroadcast. Only available when the
+     * broadcast expression has strides.
+     */
+    template <class E, class S>
+    template <class T>
+    inline auto xbroadcast<E, S>::backstrides() const noexcept
+        -> std::enable_if_t<detail::has_strides<T>::value, const strides_type&>
+    {
+        return m_backstrides;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns a constant reference to the element at the specified position
+     * in the xbroadcast, i.e. to the element of the broadcast expression at
+     * this position, ignoring the indices along the broadcast dimensions.
+     * @param args a list of indices specifying the position in the xbroadcast.
+     * Indices must be unsigned integers, the number of indices should be equal
+     * or greater than the number of dimensions of the xbroadcast.
+     */
+    template <class E, class S>
+    template <class... Args>
+    inline auto xbroadcast<E, S>::operator()(Args... args) const -> const_reference
+    {
+        std::array<size_type, sizeof...(Args)> index = {{ static_cast<size_type>(args)... }};
+        const_stepper it = stepper_begin(m_shape);
+        size_type dim = dimension();
+        size_type count = std::min(dim, index.size());
+        for(size_type i = 0; i != count; ++i)
+        {
+            it.step(dim - count + i, index[index.size() - count + i]);
+        }
+        return *it;
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the xbroadcast to the specified parameter.
+     * @param shape the result shape
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class E, class S>
+    template <class ST>
+    inline bool xbroadcast<E, S>::broadcast_shape(ST& shape) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Compares the specified strides with those of the xbroadcast to see
+     * whether the broadcasting is trivial. Since the elements of an
+     * xbroadcast are not stored, the broadcasting is never trivial.
+     * @return false
+     */
+    template <class E, class S>
+    template <class ST>
+    inline bool xbroadcast<E, S>::is_trivial_broadcast(const ST& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    /**
+     * @name Iterators
+     */
+    //@{
+    /**
+     * Returns a constant iterator to the first element of the xbroadcast.
+     */
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::begin() const -> const_iterator
+    {
+        return xbegin(m_shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the xbroadcast.
+     */
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::end() const -> const_iterator
+    {
+        return xend(m_shape);
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the xbroadcast.
+     */
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::cbegin() const -> const_iterator
+    {
+        return begin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the xbroadcast.
+     */
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::cend() const -> const_iterator
+    {
+        return end();
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the xbroadcast.
+     * The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class S>
+    template <class ST>
+    inline auto xbroadcast<E, S>::xbegin(const ST& shape) const -> const_broadcast_iterator<ST>
+    {
+        return const_broadcast_iterator<ST>(stepper_begin(shape), shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the xbroadcast. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class S>
+    template <class ST>
+    inline auto xbroadcast<E, S>::xend(const ST& shape) const -> const_broadcast_iterator<ST>
+    {
+        return const_broadcast_iterator<ST>(stepper_begin(shape), shape, true);
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the xbroadcast.
+     * The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class S>
+    template <class ST>
+    inline auto xbroadcast<E, S>::cxbegin(const ST& shape) const -> const_broadcast_iterator<ST>
+    {
+        return xbegin(shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the xbroadcast. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class S>
+    template <class ST>
+    inline auto xbroadcast<E, S>::cxend(const ST& shape) const -> const_broadcast_iterator<ST>
+    {
+        return xend(shape);
+    }
+    //@}
+
+    /***************
+     * stepper api *
+     ***************/
+
+    template <class E, class S>
+    template <class ST>
+    inline auto xbroadcast<E, S>::stepper_begin(const ST& shape) const -> const_stepper
+    {
+        return stepper_impl(shape.size() - dimension(), false, detail::has_strides<E>());
+    }
+
+    template <class E, class S>
+    template <class ST>
+    inline auto xbroadcast<E, S>::stepper_end(const ST& shape) const -> const_stepper
+    {
+        return stepper_impl(shape.size() - dimension(), true, detail::has_strides<E>());
+    }
+
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::expression_stride(size_type dim, std::true_type) const -> size_type
+    {
+        return m_e.strides()[dim];
+    }
+
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::expression_stride(size_type /*dim*/, std::false_type) const -> size_type
+    {
+        return 1;
+    }
+
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::stepper_impl(size_type offset, bool end, std::true_type) const -> const_stepper
+    {
+        return const_stepper(this, end ? m_e.storage_end() : m_e.storage_begin(), offset);
+    }
+
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::stepper_impl(size_type offset, bool end, std::false_type) const -> const_stepper
+    {
+        return const_stepper(this, end ? m_e.stepper_end(m_shape) : m_e.stepper_begin(m_shape), offset);
+    }
+
+    /************************
+     * storage_iterator api *
+     ************************/
+
+    /**
+     * @name Storage iterators
+     */
+    //@{
+    /**
+     * Returns a constant iterator to the first element of the buffer
+     * containing the elements of the xbroadcast: the storage of the
+     * broadcast expression when it has strides, an iterator on the
+     * elements of the xbroadcast in row-major order otherwise.
+     */
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::storage_begin() const -> const_storage_iterator
+    {
+        return storage_begin_impl(detail::has_strides<E>());
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last
+     * element of the buffer containing the elements of the xbroadcast.
+     */
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::storage_end() const -> const_storage_iterator
+    {
+        return storage_end_impl(detail::has_strides<E>());
+    }
+    //@}
+
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::storage_begin_impl(std::true_type) const -> const_storage_iterator
+    {
+        return m_e.storage_begin();
+    }
+
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::storage_begin_impl(std::false_type) const -> const_storage_iterator
+    {
+        return begin();
+    }
+
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::storage_end_impl(std::true_type) const -> const_storage_iterator
+    {
+        return m_e.storage_end();
+    }
+
+    template <class E, class S>
+    inline auto xbroadcast<E, S>::storage_end_impl(std::false_type) const -> const_storage_iterator
+    {
+        return end();
+    }
+
+    /**
+     * Returns an \ref xbroadcast of \c e to \c shape, whose elements are
+     * those of \c e repeated along the broadcast dimensions without being
+     * copied.
+     * @param e the expression to broadcast
+     * @param shape the shape of the result
+     * @throw broadcast_error if \c e cannot be broadcast to \c shape
+     */
+    template <class E, class S>
+    inline xbroadcast<E, S> broadcast(const xexpression<E>& e, const S& shape)
+    {
+        return xbroadcast<E, S>(e.derived_cast(), shape);
+    }
+
+    /**
+     * Returns an \ref xbroadcast of \c e to \c shape, given as a list of
+     * sizes, as in <tt>broadcast(e, {3, 4})</tt>.
+     * @param e the expression to broadcast
+     * @param shape the shape of the result
+     * @throw broadcast_error if \c e cannot be broadcast to \c shape
+     */
+    template <class E, class I, std::size_t L>
+    inline xbroadcast<E, std::array<std::size_t, L>> broadcast(const xexpression<E>& e, const I (&shape)[L])
+    {
+        std::array<std::size_t, L> s;
+        std::copy(shape, shape + L, s.begin());
+        return xbroadcast<E, std::array<std::size_t, L>>(e.derived_cast(), s);
+    }
+
+    /*************************************
+     * xbroadcast_stepper implementation *
+     *************************************/
+
+    template <class E, class S>
+    inline xbroadcast_stepper<E, S>::xbroadcast_stepper(const xbroadcast_type* b, substepper_type it, size_type offset)
+        : p_b(b), m_it(it), m_offset(offset)
+    {
+    }
+
+    template <class E, class S>
+    inline auto xbroadcast_stepper<E, S>::operator*() const -> reference
+    {
+        return *m_it;
+    }
+
+    // Steps along the broadcast dimensions leave the stepper of the
+    // broadcast expression in place.
+    template <class E, class S>
+    inline void xbroadcast_stepper<E, S>::step(size_type dim, size_type n)
+    {
+        if(dim >= m_offset && p_b->m_strides[dim - m_offset] != 0)
+        {
+            m_it.step(dim - m_offset, n);
+        }
+    }
+
+    template <class E, class S>
+    inline void xbroadcast_stepper<E, S>::step_back(size_type dim, size_type n)
+    {
+        if(dim >= m_offset && p_b->m_strides[dim - m_offset] != 0)
+        {
+            m_it.step_back(dim - m_offset, n);
+        }
+    }
+
+    template <class E, class S>
+    inline void xbroadcast_stepper<E, S>::reset(size_type dim)
+    {
+        if(dim >= m_offset && p_b->m_strides[dim - m_offset] != 0)
+        {
+            m_it.reset(dim - m_offset);
+        }
+    }
+
+    template <class E, class S>
+    inline void xbroadcast_stepper<E, S>::to_end()
+    {
+        m_it.to_end();
+    }
+
+    template <class E, class S>
+    inline bool xbroadcast_stepper<E, S>::equal(const self_type& rhs) const
+    {
+        return p_b == rhs.p_b && m_it == rhs.m_it && m_offset == rhs.m_offset;
+    }
+
+    template <class E, class S>
+    inline bool operator==(const xbroadcast_stepper<E, S>& lhs,
+                           const xbroadcast_stepper<E, S>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class E, class S>
+    inline bool operator!=(const xbroadcast_stepper<E, S>& lhs,
+                           const xbroadcast_stepper<E, S>& rhs)
+    {
+        return !(lhs.equal(rhs));
+    }
+}
+
+#endif
@@ -0,0 +1,364 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XBUFFER_ADAPTOR_HPP
+#define XBUFFER_ADAPTOR_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "xstorage.hpp"
+
+namespace xt
+{
+
+    /*******************************
+     * xbuffer_adaptor declaration *
+     *******************************/
+
+    /**
+     * @class xbuffer_adaptor
+     * @brief Non-owning container interface over a raw buffer.
+     *
+     * The xbuffer_adaptor class provides the interface of a sequence
+     * container over memory it does not own, given as a pointer and a
+     * number of elements. It can be adapted by xarray_adaptor so that
+     * xtensor expressions operate in place on buffers coming from
+     * shared memory, mapped files or foreign libraries.
+     *
+     * The size of the buffer is fixed: resizing to another size throws
+     * std::runtime_error, so that an xarray_adaptor can only be reshaped
+     * or assigned to shapes holding the same number of elements.
+     *
+     * \code{.cpp}
+     * xt::xbuffer_adaptor<double> buf(ptr, 12);
+     * xt::xarray_adaptor<xt::xbuffer_adaptor<double>> a(buf, {3, 4});
+     * a = 2. * a + 1.;
+     * \endcode
+     *
+     * @tparam T The type of the elements of the buffer.
+     */
+    template <class T>
+    class xbuffer_adaptor
+    {
+
+    public:
+
+        using self_type = xbuffer_adaptor<T>;
+        using value_type = T;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using iterator = pointer;
+        using const_iterator = const_pointer;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        xbuffer_adaptor() noexcept;
+        xbuffer_adaptor(pointer data, size_type size) noexcept;
+
+        ~xbuffer_adaptor() = default;
+
+        xbuffer_adaptor(const xbuffer_adaptor&) = default;
+        xbuffer_adaptor& operator=(const xbuffer_adaptor&) = default;
+
+        xbuffer_adaptor(xbuffer_adaptor&&) = default;
+        xbuffer_adaptor& operator=(xbuffer_adaptor&&) = default;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type max_size() const noexcept;
+
+        void resize(size_type n);
+
+        reference operator[](size_type idx);
+        const_reference operator[](size_type idx) const;
+
+        reference front();
+        const_reference front() const;
+
+        reference back();
+        const_reference back() const;
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        void swap(xbuffer_adaptor& rhs) noexcept;
+
+    private:
+
+        pointer p_data;
+        size_type m_size;
+    };
+
+    template <class T>
+    bool operator==(const xbuffer_adaptor<T>& lhs, const xbuffer_adaptor<T>& rhs);
+
+    template <class T>
+    bool operator!=(const xbuffer_adaptor<T>& lhs, const xbuffer_adaptor<T>& rhs);
+
+    template <class T>
+    void swap(xbuffer_adaptor<T>& lhs, xbuffer_adaptor<T>& rhs) noexcept;
+
+    // Temporaries of an adapted buffer cannot be buffers themselves
+    // since they must own their memory.
+    template <class T>
+    struct temporary_container<xbuffer_adaptor<T>>
+    {
+        using type = uvector<std::remove_const_t<T>>;
+    };
+
+    /**********************************
+     * xbuffer_adaptor implementation *
+     **********************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs an xbuffer_adaptor over an empty buffer.
+     */
+    template <class T>
+    inline xbuffer_adaptor<T>::xbuffer_adaptor() noexcept
+        : p_data(nullptr), m_size(0)
+    {
+    }
+
+    /**
+     * Constructs an xbuffer_adaptor over the buffer of \c size elements
+     * starting at \c data. The buffer must outlive the xbuffer_adaptor.
+     * @param data pointer to the first element of the buffer
+     * @param size the number of elements of the buffer
+     */
+    template <class T>
+    inline xbuffer_adaptor<T>::xbuffer_adaptor(pointer data, size_type size) noexcept
+        : p_data(data), m_size(size)
+    {
+    }
+    //@}
+
+    /**
+     * @name Size
+     */
+    //@{
+    template <class T>
+    inline bool xbuffer_adaptor<T>::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::max_size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Checks that \c n matches the size of the buffer, which cannot
+     * be resized.
+     * @throw std::runtime_error if \c n differs from the size.
+     */
+    template <class T>
+    inline void xbuffer_adaptor<T>::resize(size_type n)
+    {
+        if (n != m_size)
+        {
+            throw std::runtime_error("xbuffer_adaptor: cannot resize a buffer it does not own");
+        }
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    template <class T>
+    inline auto xbuffer_adaptor<T>::operator[](size_type idx) -> reference
+    {
+        return p_data[idx];
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::operator[](size_type idx) const -> const_reference
+    {
+        return p_data[idx];
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::front() -> reference
+    {
+        return p_data[0];
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::front() const -> const_reference
+    {
+        return p_data[0];
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::back() -> reference
+    {
+        return p_data[m_size - 1];
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::back() const -> const_reference
+    {
+        return p_data[m_size - 1];
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::data() noexcept -> pointer
+    {
+        return p_data;
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::data() const noexcept -> const_pointer
+    {
+        return p_data;
+    }
+    //@}
+
+    /**
+     * @name Iterators
+     */
+    //@{
+    template <class T>
+    inline auto xbuffer_adaptor<T>::begin() noexcept -> iterator
+    {
+        return p_data;
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::end() noexcept -> iterator
+    {
+        return p_data + m_size;
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::begin() const noexcept -> const_iterator
+    {
+        return p_data;
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::end() const noexcept -> const_iterator
+    {
+        return p_data + m_size;
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::cbegin() const noexcept -> const_iterator
+    {
+        return begin();
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::cend() const noexcept -> const_iterator
+    {
+        return end();
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(end());
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return rbegin();
+    }
+
+    template <class T>
+    inline auto xbuffer_adaptor<T>::crend() const noexcept -> const_reverse_iterator
+    {
+        return rend();
+    }
+    //@}
+
+    template <class T>
+    inline void xbuffer_adaptor<T>::swap(xbuffer_adaptor& rhs) noexcept
+    {
+        std::swap(p_data, rhs.p_data);
+        std::swap(m_size, rhs.m_size);
+    }
+
+    template <class T>
+    inline bool operator==(const xbuffer_adaptor<T>& lhs, const xbuffer_adaptor<T>& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T>
+    inline bool operator!=(const xbuffer_adaptor<T>& lhs, const xbuffer_adaptor<T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T>
+    inline void swap(xbuffer_adaptor<T>& lhs, xbuffer_adaptor<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
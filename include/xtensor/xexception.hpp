@@ -2,7 +2,9 @@
 #define XEXCEPTION_HPP
 
 #include <exception>
+#include <iterator>
 #include <sstream>
+#include <string>
 
 #include "xindex.hpp"
 
@@ -19,7 +21,8 @@ namespace xt
 
     public:
 
-        broadcast_error(const xshape<S>& lhs, const xshape<S>& rhs);
+        template <class S1, class S2>
+        broadcast_error(const S1& lhs, const S2& rhs);
 
         virtual const char* what() const noexcept;
 
@@ -33,8 +36,8 @@ namespace xt
      **********************************/
 
     template <class S>
-    inline broadcast_error<S>::broadcast_error(const xshape<S>& lhs,
-                                               const xshape<S>& rhs)
+    template <class S1, class S2>
+    inline broadcast_error<S>::broadcast_error(const S1& lhs, const S2& rhs)
     {
         std::ostringstream buf("Incompatible dimension of arrays:", std::ios_base::ate);
         buf << "\n LHS shape = (";
@@ -15,6 +15,7 @@
 #include <tuple>
 #include <algorithm>
 
+#include "xbatch.hpp"
 #include "xexpression.hpp"
 #include "xiterator.hpp"
 #include "xutils.hpp"
@@ -61,7 +62,7 @@ namespace xt
 
     public:
 
-        using self_type = xfunction<F, E...>;
+        using self_type = xfunction<F, R, E...>;
         using functor_type = F;
 
         using value_type = R;
@@ -73,14 +74,17 @@ namespace xt
         using size_type = std::common_type_t<typename E::size_type...>; // detail::common_size_type<E...>;
         using difference_type = std::common_type_t<typename E::difference_type...>; //detail::common_difference_type<E...>;
 
-        using shape_type = xshape<size_type>;
-        using strides_type = xstrides<size_type>;
+        using shape_type = promote_shape_t<typename E::shape_type...>;
+        using strides_type = promote_strides_t<typename E::strides_type...>;
         using closure_type = const self_type;
 
         using const_stepper = xfunction_stepper<F, R, E...>;
-        using const_iterator = xiterator<const_stepper>;
+        using const_iterator = xiterator<const_stepper, shape_type>;
         using const_storage_iterator = xf_storage_iterator<F, R, E...>;
 
+        template <class S>
+        using const_broadcast_iterator = xiterator<const_stepper, S>;
+
         template <class Func>
         xfunction(Func&& f, const E&...e) noexcept;
 
@@ -89,25 +93,50 @@ namespace xt
         template <class... Args>
         const_reference operator()(Args... args) const;
 
-        bool broadcast_shape(shape_type& shape) const;
-        bool is_trivial_broadcast(const strides_type& strides) const;
+        template <class S>
+        bool broadcast_shape(S& shape) const;
+
+        template <class S>
+        bool is_trivial_broadcast(const S& strides) const;
+
+        bool mergeable_dimensions(size_type dim, size_type outer, size_type inner, size_type size) const;
+        size_type contiguous_dimension(size_type dim) const;
 
         const_iterator begin() const;
         const_iterator end() const;
         const_iterator cbegin() const;
         const_iterator cend() const;
 
-        const_iterator xbegin(const shape_type& shape) const;
-        const_iterator xend(const shape_type& shape) const;
-        const_iterator cxbegin(const shape_type& shape) const;
-        const_iterator cxend(const shape_type& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> xbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> xend(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxend(const S& shape) const;
 
-        const_stepper stepper_begin(const shape_type& shape) const;
-        const_stepper stepper_end(const shape_type& shape) const;
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const;
+        template <class S>
+        const_stepper stepper_end(const S& shape) const;
 
         const_storage_iterator storage_begin() const;
         const_storage_iterator storage_end() const;
 
+        // The function can be evaluated by batches when all its arguments
+        // can and the functor provides a simd_apply method.
+        template <class V>
+        using simd_enabled = std::integral_constant<bool, std::is_same<V, value_type>::value &&
+                                                          simd_traits<V>::size != 1 &&
+                                                          and_<has_simd_interface<E, V>...>::value &&
+                                                          has_simd_apply<F, std::conditional_t<true, simd_type_t<V>, E>...>::value>;
+
+        template <class V = value_type>
+        simd_type_t<V> load_simd(size_type i) const;
+
+        const_reference data_element(size_type i) const;
+
         shape_type shape() const;
 
     private:
@@ -115,6 +144,12 @@ namespace xt
         template <std::size_t... I, class... Args>
         const_reference access_impl(std::index_sequence<I...>, Args... args) const;
 
+        template <class V, std::size_t... I>
+        simd_type_t<V> load_simd_impl(std::index_sequence<I...>, size_type i) const;
+
+        template <std::size_t... I>
+        const_reference data_element_impl(std::index_sequence<I...>, size_type i) const;
+
         template <class Func, std::size_t... I>
         const_stepper build_stepper(Func&& f, std::index_sequence<I...>) const;
 
@@ -306,7 +341,8 @@ namespace xt
      * @return a boolean indicating whether the broadcast is trivial
      */
     template <class F, class R, class... E>
-    inline bool xfunction<F, R, E...>::broadcast_shape(shape_type& shape) const
+    template <class S>
+    inline bool xfunction<F, R, E...>::broadcast_shape(S& shape) const
     {
         // e.broadcast_shape must be evaluated even if b is false
         auto func = [&shape](bool b, auto&& e) { return e.broadcast_shape(shape) && b; };
@@ -319,11 +355,38 @@ namespace xt
      * @return a boolean indicating whether the broadcast is trivial
      */
     template <class F, class R, class... E>
-    inline bool xfunction<F, R, E...>::is_trivial_broadcast(const strides_type& strides) const
+    template <class S>
+    inline bool xfunction<F, R, E...>::is_trivial_broadcast(const S& strides) const
     {
         auto func = [&strides](bool b, auto&& e) { return b && e.is_trivial_broadcast(strides); };
         return accumulate(func, true, m_e);
     }
+
+    /**
+     * Checks whether the steppers of all the arguments of the function
+     * can traverse the dimensions \c outer and \c inner in a single loop.
+     * @sa xt::mergeable_dimensions
+     */
+    template <class F, class R, class... E>
+    inline bool xfunction<F, R, E...>::mergeable_dimensions(size_type dim, size_type outer, size_type inner, size_type size) const
+    {
+        auto func = [=](bool b, auto&& e) { return b && xt::mergeable_dimensions(e, dim, outer, inner, size); };
+        return accumulate(func, true, m_e);
+    }
+
+    /**
+     * Returns the dimension along which the first argument of the function
+     * that determines it is contiguous, or \c dim if none does.
+     * @sa xt::contiguous_dimension
+     */
+    template <class F, class R, class... E>
+    inline auto xfunction<F, R, E...>::contiguous_dimension(size_type dim) const -> size_type
+    {
+        auto func = [dim](size_type d, auto&& e) {
+            return d != dim ? d : static_cast<size_type>(xt::contiguous_dimension(e, dim));
+        };
+        return accumulate(func, dim, m_e);
+    }
     //@}
 
     /**
@@ -336,7 +399,7 @@ namespace xt
     template <class F, class R, class... E>
     inline auto xfunction<F, R, E...>::begin() const -> const_iterator
     {
-        shape_type shape(dimension(), size_type(1));
+        shape_type shape = make_sequence<shape_type>(dimension(), size_type(1));
         broadcast_shape(shape);
         return xbegin(shape);
     }
@@ -348,7 +411,7 @@ namespace xt
     template <class F, class R, class... E>
     inline auto xfunction<F, R, E...>::end() const -> const_iterator
     {
-        shape_type shape(dimension(), size_type(1));
+        shape_type shape = make_sequence<shape_type>(dimension(), size_type(1));
         broadcast_shape(shape);
         return xend(shape);
     }
@@ -378,9 +441,10 @@ namespace xt
      * @param shape the shape used for braodcasting
      */
     template <class F, class R, class... E>
-    inline auto xfunction<F, R, E...>::xbegin(const shape_type& shape) const -> const_iterator
+    template <class S>
+    inline auto xfunction<F, R, E...>::xbegin(const S& shape) const -> const_broadcast_iterator<S>
     {
-        return const_iterator(stepper_begin(shape), shape);
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape);
     }
 
     /**
@@ -389,9 +453,10 @@ namespace xt
      * @param shape the shape used for broadcasting
      */
     template <class F, class R, class... E>
-    inline auto xfunction<F, R, E...>::xend(const shape_type& shape) const -> const_iterator
+    template <class S>
+    inline auto xfunction<F, R, E...>::xend(const S& shape) const -> const_broadcast_iterator<S>
     {
-        return const_iterator(stepper_end(shape), shape);
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape, true);
     }
 
     /**
@@ -400,7 +465,8 @@ namespace xt
      * @param shape the shape used for braodcasting
      */
     template <class F, class R, class... E>
-    inline auto xfunction<F, R, E...>::cxbegin(const shape_type& shape) const -> const_iterator
+    template <class S>
+    inline auto xfunction<F, R, E...>::cxbegin(const S& shape) const -> const_broadcast_iterator<S>
     {
         return xbegin(shape);
     }
@@ -411,21 +477,24 @@ namespace xt
      * @param shape the shape used for broadcasting
      */
     template <class F, class R, class... E>
-    inline auto xfunction<F, R, E...>::cxend(const shape_type& shape) const -> const_iterator
+    template <class S>
+    inline auto xfunction<F, R, E...>::cxend(const S& shape) const -> const_broadcast_iterator<S>
     {
         return xend(shape);
     }
     //@}
 
     template <class F, class R, class... E>
-    inline auto xfunction<F, R, E...>::stepper_begin(const shape_type& shape) const -> const_stepper
+    template <class S>
+    inline auto xfunction<F, R, E...>::stepper_begin(const S& shape) const -> const_stepper
     {
         auto f = [&shape](const auto& e) { return e.stepper_begin(shape); };
         return build_stepper(f, std::make_index_sequence<sizeof...(E)>());
     }
 
     template <class F, class R, class... E>
-    inline auto xfunction<F, R, E...>::stepper_end(const shape_type& shape) const -> const_stepper
+    template <class S>
+    inline auto xfunction<F, R, E...>::stepper_end(const S& shape) const -> const_stepper
     {
         auto f = [&shape](const auto& e) { return e.stepper_end(shape); };
         return build_stepper(f, std::make_index_sequence<sizeof...(E)>());
@@ -457,13 +526,40 @@ namespace xt
     }
     //@}
 
+    /**
+     * @name SIMD interface
+     */
+    //@{
+    /**
+     * Returns the batch of elements of the function starting at the
+     * i-th element of the buffers of its arguments. Only meaningful
+     * for trivial broadcasts.
+     */
+    template <class F, class R, class... E>
+    template <class V>
+    inline auto xfunction<F, R, E...>::load_simd(size_type i) const -> simd_type_t<V>
+    {
+        return load_simd_impl<V>(std::make_index_sequence<sizeof...(E)>(), i);
+    }
+
+    /**
+     * Returns the element of the function computed from the i-th element
+     * of the buffers of its arguments. Only meaningful for trivial broadcasts.
+     */
+    template <class F, class R, class... E>
+    inline auto xfunction<F, R, E...>::data_element(size_type i) const -> const_reference
+    {
+        return data_element_impl(std::make_index_sequence<sizeof...(E)>(), i);
+    }
+    //@}
+
     /**
      * Returns the shape of the xfunction.
      */
     template <class F, class R, class... E>
     inline auto xfunction<F, R, E...>::shape() const -> shape_type
     {
-        shape_type shape(dimension(), size_type(1));
+        shape_type shape = make_sequence<shape_type>(dimension(), size_type(1));
         broadcast_shape(shape);
         return shape;
     }
@@ -476,6 +572,20 @@ namespace xt
         return m_f(detail::get_element(std::get<I>(m_e), args...)...);
     }
 
+    template <class F, class R, class... E>
+    template <class V, std::size_t... I>
+    inline auto xfunction<F, R, E...>::load_simd_impl(std::index_sequence<I...>, size_type i) const -> simd_type_t<V>
+    {
+        return m_f.simd_apply(std::get<I>(m_e).template load_simd<V>(i)...);
+    }
+
+    template <class F, class R, class... E>
+    template <std::size_t... I>
+    inline auto xfunction<F, R, E...>::data_element_impl(std::index_sequence<I...>, size_type i) const -> const_reference
+    {
+        return m_f(std::get<I>(m_e).data_element(i)...);
+    }
+
     template <class F, class R, class... E>
     template <class Func, std::size_t... I>
     inline auto xfunction<F, R, E...>::build_stepper(Func&& f, std::index_sequence<I...>) const -> const_stepper
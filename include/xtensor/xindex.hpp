@@ -9,27 +9,32 @@
 #ifndef XINDEX_HPP
 #define XINDEX_HPP
 
-#include <vector>
 #include <numeric>
 #include <functional>
 
+#include "xstorage.hpp"
+
 namespace xt
 {
 
     template <class C>
     struct array_inner_types;
 
+    // Shapes and strides of containers with dynamic dimension hold up
+    // to 8 dimensions inline, so that reshaping and evaluating typical
+    // expressions does not allocate memory for the metadata.
+
     template <class S>
-    using xshape = std::vector<S>;
+    using xshape = svector<S, 8>;
 
     template <class S>
-    using xstrides = std::vector<S>;
+    using xstrides = svector<S, 8>;
 
     template <class S, class... Args>
-    S data_offset(const xstrides<S>& strides, Args... args);
+    constexpr typename S::value_type data_offset(const S& strides, Args... args);
 
     template <class S>
-    S data_size(const xshape<S>& s);
+    typename S::value_type data_size(const S& s);
 
     /******************************
      * data_offset implementation *
@@ -38,28 +43,29 @@ namespace xt
     namespace detail
     {
         template <class S>
-        inline S data_offset_impl(const xstrides<S>& strides)
+        constexpr typename S::value_type data_offset_impl(const S& /*strides*/)
         {
             return 0;
         }
 
         template <class S, class... Args>
-        inline S data_offset_impl(const xstrides<S>& strides, S i, Args... args)
+        constexpr typename S::value_type data_offset_impl(const S& strides, typename S::value_type i, Args... args)
         {
             return i * strides[strides.size() - sizeof...(args) - 1] + data_offset_impl(strides, args...);
         }
     }
 
     template <class S, class... Args>
-    inline S data_offset(const xstrides<S>& strides, Args... args)
+    constexpr typename S::value_type data_offset(const S& strides, Args... args)
     {
-        return detail::data_offset_impl(strides, static_cast<S>(args)...);
+        return detail::data_offset_impl(strides, static_cast<typename S::value_type>(args)...);
     }
 
     template <class S>
-    inline S data_size(const xshape<S>& s)
+    inline typename S::value_type data_size(const S& s)
     {
-        return std::accumulate(s.begin(), s.end(), S(1), std::multiplies<S>());
+        using size_type = typename S::value_type;
+        return std::accumulate(s.begin(), s.end(), size_type(1), std::multiplies<size_type>());
     }
 }
 
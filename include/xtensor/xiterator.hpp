@@ -15,6 +15,8 @@
 #include <iterator>
 #include <array>
 #include <algorithm>
+#include <cstddef>
+#include <cstdlib>
 
 #include "xindex.hpp"
 #include "xutils.hpp"
@@ -27,8 +29,19 @@ namespace xt
      * broadcast functions *
      ***********************/
 
-    template <class S>
-    bool broadcast_shape(const xshape<S>& input, xshape<S>& output);
+    template <class S1, class S2>
+    bool broadcast_shape(const S1& input, S2& output);
+
+    /************************
+     * mergeable_dimensions *
+     ************************/
+
+    template <class E>
+    bool mergeable_dimensions(const E& e, std::size_t dim, std::size_t outer,
+                              std::size_t inner, std::size_t size);
+
+    template <class E>
+    std::size_t contiguous_dimension(const E& e, std::size_t dim);
 
     /************
      * xstepper *
@@ -60,10 +73,10 @@ namespace xt
 
         using container_type = C;
         using subiterator_type = get_storage_iterator<C>;
-        using value_type = typename subiterator_type::value_type;
-        using reference = typename subiterator_type::reference;
-        using pointer = typename subiterator_type::pointer;
-        using difference_type = typename subiterator_type::difference_type;
+        using value_type = typename std::iterator_traits<subiterator_type>::value_type;
+        using reference = typename std::iterator_traits<subiterator_type>::reference;
+        using pointer = typename std::iterator_traits<subiterator_type>::pointer;
+        using difference_type = typename std::iterator_traits<subiterator_type>::difference_type;
         using size_type = typename container_type::size_type;
 
         xstepper(container_type* c, subiterator_type it, size_type offset);
@@ -93,22 +106,28 @@ namespace xt
     bool operator!=(const xstepper<C>& lhs,
                     const xstepper<C>& rhs);
 
-    template <class S>
-    void increment_stepper(S& stepper,
-                           xshape<typename S::size_type>& index,
-                           const xshape<typename S::size_type>& shape);
+    template <class It, class I, class S>
+    void increment_stepper(It& stepper, I& index, const S& shape);
+
+    template <class It, class I, class S>
+    void decrement_stepper(It& stepper, I& index, const S& shape);
 
     /*************
      * xiterator *
      *************/
 
-    template <class It>
+    // Iterates over the elements of an expression in row-major order of
+    // their indices. The iterator keeps track of its index and of its
+    // position in that order, so that it can be moved by any number of
+    // elements at once; it is a random access iterator when the stepper
+    // dereferences to an lvalue, as for containers and views.
+    template <class It, class S>
     class xiterator
     {
 
     public:
 
-        using self_type = xiterator<It>;
+        using self_type = xiterator<It, S>;
 
         using subiterator_type = It;
         using value_type = typename subiterator_type::value_type;
@@ -116,42 +135,81 @@ namespace xt
         using pointer = typename subiterator_type::pointer;
         using difference_type = typename subiterator_type::difference_type;
         using size_type = typename subiterator_type::size_type;
-        using iterator_category = std::input_iterator_tag;
+        using iterator_category = std::conditional_t<std::is_reference<reference>::value,
+                                                     std::random_access_iterator_tag,
+                                                     std::input_iterator_tag>;
 
-        using shape_type = xshape<size_type>;
+        using shape_type = S;
 
-        xiterator(It it, const shape_type& shape);
+        xiterator(It it, const shape_type& shape, bool end = false);
 
         self_type& operator++();
         self_type operator++(int);
 
+        self_type& operator--();
+        self_type operator--(int);
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        self_type operator+(difference_type n) const;
+        self_type operator-(difference_type n) const;
+        difference_type operator-(const self_type& rhs) const;
+
         reference operator*() const;
+        reference operator[](difference_type n) const;
 
         bool equal(const xiterator& rhs) const;
+        bool less_than(const xiterator& rhs) const;
 
     private:
 
         subiterator_type m_it;
         shape_type m_shape;
         shape_type m_index;
+        size_type m_linear_index;
     };
 
-    template <class It>
-    bool operator==(const xiterator<It>& lhs,
-                    const xiterator<It>& rhs);
+    template <class It, class S>
+    bool operator==(const xiterator<It, S>& lhs,
+                    const xiterator<It, S>& rhs);
+
+    template <class It, class S>
+    bool operator!=(const xiterator<It, S>& lhs,
+                    const xiterator<It, S>& rhs);
+
+    template <class It, class S>
+    bool operator<(const xiterator<It, S>& lhs,
+                   const xiterator<It, S>& rhs);
+
+    template <class It, class S>
+    bool operator<=(const xiterator<It, S>& lhs,
+                    const xiterator<It, S>& rhs);
+
+    template <class It, class S>
+    bool operator>(const xiterator<It, S>& lhs,
+                   const xiterator<It, S>& rhs);
 
-    template <class It>
-    bool operator!=(const xiterator<It>& lhs,
-                    const xiterator<It>& rhs);
+    template <class It, class S>
+    bool operator>=(const xiterator<It, S>& lhs,
+                    const xiterator<It, S>& rhs);
+
+    template <class It, class S>
+    xiterator<It, S> operator+(typename xiterator<It, S>::difference_type n,
+                               const xiterator<It, S>& it);
 
     /**************************************
      * broadcast functions implementation *
      **************************************/
 
-    template <class S>
-    inline bool broadcast_shape(const xshape<S>& input, xshape<S>& output)
+    template <class S1, class S2>
+    inline bool broadcast_shape(const S1& input, S2& output)
     {
-        auto size = output.size();
+        using value_type = typename S2::value_type;
+        if(input.size() > output.size())
+        {
+            throw broadcast_error<value_type>(output, input);
+        }
         bool trivial_broadcast = (input.size() == output.size());
         auto output_iter = output.rbegin();
         auto input_rend = input.rend();
@@ -164,13 +222,165 @@ namespace xt
             }
             else if((*input_iter != 1) && (*output_iter != *input_iter))
             {
-                throw broadcast_error<S>(output, input);
+                throw broadcast_error<value_type>(output, input);
             }
             trivial_broadcast = trivial_broadcast && (*output_iter == *input_iter);
         }
         return trivial_broadcast;
     }
 
+    /***************************************
+     * mergeable_dimensions implementation *
+     ***************************************/
+
+    namespace detail
+    {
+        template <class E, class = void>
+        struct has_strides : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_strides<E, void_t<decltype(std::declval<const E&>().strides())>>
+            : std::true_type
+        {
+        };
+
+        template <class E, class = void>
+        struct has_mergeable_dimensions : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_mergeable_dimensions<E, void_t<decltype(std::declval<const E&>().mergeable_dimensions(
+                    std::size_t(0), std::size_t(0), std::size_t(0), std::size_t(0)))>>
+            : std::true_type
+        {
+        };
+
+        template <class E, class B>
+        inline bool mergeable_dimensions_impl(const E& e, std::size_t dim, std::size_t outer,
+                                              std::size_t inner, std::size_t size,
+                                              std::true_type /*member*/, B /*strides*/)
+        {
+            return e.mergeable_dimensions(dim, outer, inner, size);
+        }
+
+        // The steppers of expressions with strides move by the stride of
+        // the dimension they step along, and do not move along the leading
+        // dimensions they are broadcast to.
+        template <class E>
+        inline bool mergeable_dimensions_impl(const E& e, std::size_t dim, std::size_t outer,
+                                              std::size_t inner, std::size_t size,
+                                              std::false_type /*member*/, std::true_type /*strides*/)
+        {
+            const auto& strides = e.strides();
+            std::size_t offset = dim - strides.size();
+            auto stride = [&strides, offset](std::size_t d) {
+                return d < offset ? std::size_t(0) : static_cast<std::size_t>(strides[d - offset]);
+            };
+            return stride(outer) == size * stride(inner);
+        }
+
+        template <class E>
+        inline bool mergeable_dimensions_impl(const E& /*e*/, std::size_t /*dim*/, std::size_t /*outer*/,
+                                              std::size_t /*inner*/, std::size_t /*size*/,
+                                              std::false_type /*member*/, std::false_type /*strides*/)
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Returns true if stepping once along the dimension \c outer with a
+     * stepper of \c e, broadcast to \c dim dimensions, moves it as much
+     * as stepping \c size times along the dimension \c inner. Both
+     * dimensions can then be traversed by a single loop along \c inner.
+     * Expressions whose steppers cannot step beyond the shape, such as
+     * reducers and views, are never mergeable.
+     */
+    template <class E>
+    inline bool mergeable_dimensions(const E& e, std::size_t dim, std::size_t outer,
+                                     std::size_t inner, std::size_t size)
+    {
+        return detail::mergeable_dimensions_impl(e, dim, outer, inner, size,
+                detail::has_mergeable_dimensions<E>(), detail::has_strides<E>());
+    }
+
+    /***************************************
+     * contiguous_dimension implementation *
+     ***************************************/
+
+    namespace detail
+    {
+        // Dimension along which the elements of an expression are the
+        // closest in memory, or the dimension of the expression if all
+        // its elements are at the same address.
+        template <class S, class ST>
+        inline std::size_t min_stride_dimension(const S& shape, const ST& strides)
+        {
+            std::size_t dim = shape.size();
+            std::size_t res = dim;
+            std::ptrdiff_t min_stride = 0;
+            for(std::size_t d = 0; d != dim; ++d)
+            {
+                std::ptrdiff_t stride = std::abs(static_cast<std::ptrdiff_t>(strides[d]));
+                if(shape[d] != 1 && stride != 0 && (res == dim || stride < min_stride))
+                {
+                    res = d;
+                    min_stride = stride;
+                }
+            }
+            return res;
+        }
+
+        template <class E, class = void>
+        struct has_contiguous_dimension : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_contiguous_dimension<E, void_t<decltype(std::declval<const E&>().contiguous_dimension(std::size_t(0)))>>
+            : std::true_type
+        {
+        };
+
+        template <class E, class B>
+        inline std::size_t contiguous_dimension_impl(const E& e, std::size_t dim,
+                                                     std::true_type /*member*/, B /*strides*/)
+        {
+            return e.contiguous_dimension(dim);
+        }
+
+        template <class E>
+        inline std::size_t contiguous_dimension_impl(const E& e, std::size_t dim,
+                                                     std::false_type /*member*/, std::true_type /*strides*/)
+        {
+            std::size_t d = min_stride_dimension(e.shape(), e.strides());
+            return d == e.dimension() ? dim : d + dim - e.dimension();
+        }
+
+        template <class E>
+        inline std::size_t contiguous_dimension_impl(const E& /*e*/, std::size_t dim,
+                                                     std::false_type /*member*/, std::false_type /*strides*/)
+        {
+            return dim;
+        }
+    }
+
+    /**
+     * Returns the dimension along which the elements that \c e reads,
+     * broadcast to \c dim dimensions, are the closest in memory, or \c dim
+     * when \c e does not determine it, as for scalars or expressions whose
+     * elements are all at the same address.
+     */
+    template <class E>
+    inline std::size_t contiguous_dimension(const E& e, std::size_t dim)
+    {
+        return detail::contiguous_dimension_impl(e, dim,
+                detail::has_contiguous_dimension<E>(), detail::has_strides<E>());
+    }
+
     /***************************
      * xstepper implementation *
      ***************************/
@@ -234,23 +444,24 @@ namespace xt
         return !(lhs.equal(rhs));
     }
 
-    template <class S>
-    void increment_stepper(S& stepper,
-                           xshape<typename S::size_type>& index,
-                           const xshape<typename S::size_type>& shape)
+    template <class It, class I, class S>
+    void increment_stepper(It& stepper, I& index, const S& shape)
     {
-        using size_type = typename S::size_type;
+        using size_type = typename It::size_type;
         for(size_type j = index.size(); j != 0; --j)
         {
             size_type i = j-1;
+            // Past the last element, the index is one beyond the outermost
+            // dimension while the stepper stays on its last position, so
+            // that it never points outside of the expression.
             if(++index[i] != shape[i])
             {
                 stepper.step(i);
                 break;
             }
-            else if (i == 0)
+            else if(i == 0)
             {
-                stepper.to_end();
+                break;
             }
             else
             {
@@ -260,56 +471,236 @@ namespace xt
         }
     }
 
+    template <class It, class I, class S>
+    void decrement_stepper(It& stepper, I& index, const S& shape)
+    {
+        using size_type = typename It::size_type;
+        for(size_type j = index.size(); j != 0; --j)
+        {
+            size_type i = j-1;
+            if(i == 0 && index[i] == shape[i])
+            {
+                --index[i];
+                break;
+            }
+            else if(index[i] != 0)
+            {
+                --index[i];
+                stepper.step_back(i);
+                break;
+            }
+            else
+            {
+                index[i] = shape[i] - 1;
+                stepper.step(i, index[i]);
+            }
+        }
+    }
+
     /****************************
      * xiterator implementation *
      ****************************/
 
-    template <class It>
-    inline xiterator<It>::xiterator(It it, const shape_type& shape)
-        : m_it(it), m_shape(shape), m_index(shape.size(), size_type(0))
+    /**
+     * Builds an iterator from the stepper \c it at the beginning of an
+     * expression broadcast to \c shape. If \c end is true, the iterator
+     * is moved past the last element: its index is one beyond the
+     * outermost dimension, while the stepper is moved to the last
+     * position along that dimension.
+     */
+    template <class It, class S>
+    inline xiterator<It, S>::xiterator(It it, const shape_type& shape, bool end)
+        : m_it(it), m_shape(shape), m_index(make_sequence<shape_type>(shape.size(), size_type(0))),
+          m_linear_index(0)
     {
+        if(end)
+        {
+            m_linear_index = data_size(shape);
+            if(shape.size() != 0)
+            {
+                m_index[0] = shape[0];
+                if(shape[0] != 0)
+                {
+                    m_it.step(0, shape[0] - 1);
+                }
+            }
+        }
     }
 
-    template <class It>
-    inline auto xiterator<It>::operator++() -> self_type&
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator++() -> self_type&
     {
         increment_stepper(m_it, m_index, m_shape);
+        ++m_linear_index;
         return *this;
     }
 
-    template <class It>
-    inline auto xiterator<It>::operator++(int) -> self_type
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator++(int) -> self_type
     {
         self_type tmp(*this);
         ++(*this);
         return tmp;
     }
 
-    template <class It>
-    inline auto xiterator<It>::operator*() const -> reference
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator--() -> self_type&
+    {
+        decrement_stepper(m_it, m_index, m_shape);
+        --m_linear_index;
+        return *this;
+    }
+
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator--(int) -> self_type
+    {
+        self_type tmp(*this);
+        --(*this);
+        return tmp;
+    }
+
+    // Unravels the new position into an index and steps along each
+    // dimension by the difference of indices, in time proportional to
+    // the number of dimensions whatever the distance. Along the outermost
+    // dimension, the stepper does not go beyond the last position.
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator+=(difference_type n) -> self_type&
+    {
+        if(n == 0)
+        {
+            return *this;
+        }
+        m_linear_index = static_cast<size_type>(static_cast<difference_type>(m_linear_index) + n);
+        size_type remainder = m_linear_index;
+        for(size_type j = m_shape.size(); j != 0; --j)
+        {
+            size_type i = j - 1;
+            size_type index = remainder;
+            if(i != 0)
+            {
+                index = remainder % m_shape[i];
+                remainder /= m_shape[i];
+            }
+            size_type from = m_index[i];
+            size_type to = index;
+            if(i == 0 && m_shape[0] != 0)
+            {
+                from = std::min(from, m_shape[0] - 1);
+                to = std::min(to, m_shape[0] - 1);
+            }
+            if(to > from)
+            {
+                m_it.step(i, to - from);
+            }
+            else if(to < from)
+            {
+                m_it.step_back(i, from - to);
+            }
+            m_index[i] = index;
+        }
+        return *this;
+    }
+
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator-=(difference_type n) -> self_type&
+    {
+        return *this += -n;
+    }
+
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator+(difference_type n) const -> self_type
+    {
+        self_type tmp(*this);
+        tmp += n;
+        return tmp;
+    }
+
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator-(difference_type n) const -> self_type
+    {
+        self_type tmp(*this);
+        tmp -= n;
+        return tmp;
+    }
+
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator-(const self_type& rhs) const -> difference_type
+    {
+        return static_cast<difference_type>(m_linear_index) - static_cast<difference_type>(rhs.m_linear_index);
+    }
+
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator*() const -> reference
     {
         return *m_it;
     }
 
-    template <class It>
-    inline bool xiterator<It>::equal(const xiterator& rhs) const
+    template <class It, class S>
+    inline auto xiterator<It, S>::operator[](difference_type n) const -> reference
     {
-        return m_it == rhs.m_it && m_shape == rhs.m_shape;
+        return *(*this + n);
     }
 
-    template <class It>
-    inline bool operator==(const xiterator<It>& lhs,
-                           const xiterator<It>& rhs)
+    template <class It, class S>
+    inline bool xiterator<It, S>::equal(const xiterator& rhs) const
+    {
+        return m_linear_index == rhs.m_linear_index && m_shape == rhs.m_shape;
+    }
+
+    template <class It, class S>
+    inline bool xiterator<It, S>::less_than(const xiterator& rhs) const
+    {
+        return m_linear_index < rhs.m_linear_index;
+    }
+
+    template <class It, class S>
+    inline bool operator==(const xiterator<It, S>& lhs,
+                           const xiterator<It, S>& rhs)
     {
         return lhs.equal(rhs);
     }
 
-    template <class It>
-    inline bool operator!=(const xiterator<It>& lhs,
-                           const xiterator<It>& rhs)
+    template <class It, class S>
+    inline bool operator!=(const xiterator<It, S>& lhs,
+                           const xiterator<It, S>& rhs)
     {
         return !(lhs.equal(rhs));
     }
+
+    template <class It, class S>
+    inline bool operator<(const xiterator<It, S>& lhs,
+                          const xiterator<It, S>& rhs)
+    {
+        return lhs.less_than(rhs);
+    }
+
+    template <class It, class S>
+    inline bool operator<=(const xiterator<It, S>& lhs,
+                           const xiterator<It, S>& rhs)
+    {
+        return !(rhs.less_than(lhs));
+    }
+
+    template <class It, class S>
+    inline bool operator>(const xiterator<It, S>& lhs,
+                          const xiterator<It, S>& rhs)
+    {
+        return rhs.less_than(lhs);
+    }
+
+    template <class It, class S>
+    inline bool operator>=(const xiterator<It, S>& lhs,
+                           const xiterator<It, S>& rhs)
+    {
+        return !(lhs.less_than(rhs));
+    }
+
+    template <class It, class S>
+    inline xiterator<It, S> operator+(typename xiterator<It, S>::difference_type n,
+                                      const xiterator<It, S>& it)
+    {
+        return it + n;
+    }
 }
 
 #endif
@@ -14,32 +14,116 @@
 #define XMATH_HPP
 
 #include <cmath>
-#include "xfunction.hpp"
+
+#include "xbatch_math.hpp"
+#include "xoperation.hpp"
 
 namespace xt
 {
 
-    /***********
-     * Helpers *
-     ***********/
+    /************
+     * functors *
+     ************/
+
+    namespace math
+    {
+        // Functors wrapping the functions of <cmath>. Those having a
+        // vectorized implementation also provide a simd_apply method
+        // evaluating the function on batches of elements, see xbatch_math.hpp;
+        // expressions involving the others are evaluated element-wise.
+
+#define XTENSOR_UNARY_MATH_FUNCTOR(NAME)                                     \
+        template <class T>                                                   \
+        struct NAME##_fun                                                    \
+        {                                                                    \
+            using result_type = T;                                           \
+            T operator()(const T& arg) const                                 \
+            {                                                                \
+                return std::NAME(arg);                                       \
+            }                                                                \
+        }
 
-    namespace detail
-    {
-        template <class R, class... Args, class... E>
-        inline auto make_xfunction(R (*f) (Args...), const E&... e) noexcept
-        {
-            using type = xfunction<R (*) (Args...), R, get_xexpression_type<E>...>;
-            return type(f, get_xexpression(e)...);
+#define XTENSOR_UNARY_SIMD_MATH_FUNCTOR(NAME)                                \
+        template <class T>                                                   \
+        struct NAME##_fun                                                    \
+        {                                                                    \
+            using result_type = T;                                           \
+            T operator()(const T& arg) const                                 \
+            {                                                                \
+                return std::NAME(arg);                                       \
+            }                                                                \
+            template <class B>                                               \
+            B simd_apply(const B& arg) const                                 \
+            {                                                                \
+                return NAME(arg);                                            \
+            }                                                                \
         }
 
-        template <class... E>
-        using mf_type = common_value_type<E...> (*) (get_value_type<E>...);
+#define XTENSOR_BINARY_MATH_FUNCTOR(NAME)                                    \
+        template <class T>                                                   \
+        struct NAME##_fun                                                    \
+        {                                                                    \
+            using result_type = T;                                           \
+            T operator()(const T& arg1, const T& arg2) const                 \
+            {                                                                \
+                return std::NAME(arg1, arg2);                                \
+            }                                                                \
+        }
+
+#define XTENSOR_TERNARY_MATH_FUNCTOR(NAME)                                   \
+        template <class T>                                                   \
+        struct NAME##_fun                                                    \
+        {                                                                    \
+            using result_type = T;                                           \
+            T operator()(const T& arg1, const T& arg2, const T& arg3) const  \
+            {                                                                \
+                return std::NAME(arg1, arg2, arg3);                          \
+            }                                                                \
+        }
 
-        template <class... Args>
-        using get_xfunction_free_type = std::enable_if_t<has_xexpression<Args...>::value,
-                                                         xfunction<mf_type<Args...>,
-                                                                   common_value_type<Args...>,
-                                                                   get_xexpression_type<Args>...>>;
+        XTENSOR_UNARY_MATH_FUNCTOR(abs);
+        XTENSOR_UNARY_MATH_FUNCTOR(fabs);
+        XTENSOR_UNARY_SIMD_MATH_FUNCTOR(exp);
+        XTENSOR_UNARY_MATH_FUNCTOR(exp2);
+        XTENSOR_UNARY_MATH_FUNCTOR(expm1);
+        XTENSOR_UNARY_SIMD_MATH_FUNCTOR(log);
+        XTENSOR_UNARY_MATH_FUNCTOR(log10);
+        XTENSOR_UNARY_MATH_FUNCTOR(log2);
+        XTENSOR_UNARY_MATH_FUNCTOR(log1p);
+        XTENSOR_UNARY_SIMD_MATH_FUNCTOR(sqrt);
+        XTENSOR_UNARY_MATH_FUNCTOR(cbrt);
+        XTENSOR_UNARY_SIMD_MATH_FUNCTOR(sin);
+        XTENSOR_UNARY_SIMD_MATH_FUNCTOR(cos);
+        XTENSOR_UNARY_MATH_FUNCTOR(tan);
+        XTENSOR_UNARY_MATH_FUNCTOR(asin);
+        XTENSOR_UNARY_MATH_FUNCTOR(acos);
+        XTENSOR_UNARY_MATH_FUNCTOR(atan);
+        XTENSOR_UNARY_MATH_FUNCTOR(sinh);
+        XTENSOR_UNARY_MATH_FUNCTOR(cosh);
+        XTENSOR_UNARY_SIMD_MATH_FUNCTOR(tanh);
+        XTENSOR_UNARY_MATH_FUNCTOR(asinh);
+        XTENSOR_UNARY_MATH_FUNCTOR(acosh);
+        XTENSOR_UNARY_MATH_FUNCTOR(atanh);
+        XTENSOR_UNARY_SIMD_MATH_FUNCTOR(erf);
+        XTENSOR_UNARY_MATH_FUNCTOR(erfc);
+        XTENSOR_UNARY_MATH_FUNCTOR(tgamma);
+        XTENSOR_UNARY_MATH_FUNCTOR(lgamma);
+
+        XTENSOR_BINARY_MATH_FUNCTOR(fmod);
+        XTENSOR_BINARY_MATH_FUNCTOR(remainder);
+        XTENSOR_BINARY_MATH_FUNCTOR(fmax);
+        XTENSOR_BINARY_MATH_FUNCTOR(fmin);
+        XTENSOR_BINARY_MATH_FUNCTOR(fdim);
+        XTENSOR_BINARY_MATH_FUNCTOR(pow);
+        XTENSOR_BINARY_MATH_FUNCTOR(hypot);
+        XTENSOR_BINARY_MATH_FUNCTOR(atan2);
+
+        XTENSOR_TERNARY_MATH_FUNCTOR(fma);
+
+#undef XTENSOR_TERNARY_MATH_FUNCTOR
+#undef XTENSOR_BINARY_MATH_FUNCTOR
+#undef XTENSOR_UNARY_SIMD_MATH_FUNCTOR
+#undef XTENSOR_UNARY_MATH_FUNCTOR
     }
 
     /*******************
@@ -62,8 +146,7 @@ namespace xt
     template <class E>
     inline auto abs(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::abs, e.derived_cast());
+        return detail::make_xfunction<math::abs_fun>(e.derived_cast());
     }
 
     /**
@@ -78,8 +161,7 @@ namespace xt
     template <class E>
     inline auto fabs(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::fabs, e.derived_cast());
+        return detail::make_xfunction<math::fabs_fun>(e.derived_cast());
     }
 
     /**
@@ -95,10 +177,9 @@ namespace xt
      */
     template <class E1, class E2>
     inline auto fmod(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_free_type<E1, E2>
+        -> detail::get_xfunction_type<math::fmod_fun, E1, E2>
     {
-        using functor_type = detail::mf_type<E1, E2>;
-        return detail::make_xfunction((functor_type)std::fmod, e1, e2);
+        return detail::make_xfunction<math::fmod_fun>(e1, e2);
     }
 
     /**
@@ -114,10 +195,9 @@ namespace xt
      */
     template <class E1, class E2>
     inline auto remainder(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_free_type<E1, E2>
+        -> detail::get_xfunction_type<math::remainder_fun, E1, E2>
     {
-        using functor_type = detail::mf_type<E1, E2>;
-        return detail::make_xfunction((functor_type)std::remainder, e1, e2);
+        return detail::make_xfunction<math::remainder_fun>(e1, e2);
     }
 
     /**
@@ -134,10 +214,9 @@ namespace xt
      */
     template <class E1, class E2, class E3>
     inline auto fma(const E1& e1, const E2& e2, const E3& e3) noexcept
-        -> detail::get_xfunction_free_type<E1, E2, E3>
+        -> detail::get_xfunction_type<math::fma_fun, E1, E2, E3>
     {
-        using functor_type = detail::mf_type<E1, E2, E3>;
-        return detail::make_xfunction((functor_type)std::fma, e1, e2, e3);
+        return detail::make_xfunction<math::fma_fun>(e1, e2, e3);
     }
 
     /**
@@ -153,10 +232,9 @@ namespace xt
      */
     template <class E1, class E2>
     inline auto fmax(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_free_type<E1, E2>
+        -> detail::get_xfunction_type<math::fmax_fun, E1, E2>
     {
-        using functor_type = detail::mf_type<E1, E2>;
-        return detail::make_xfunction((functor_type)std::fmax, e1, e2);
+        return detail::make_xfunction<math::fmax_fun>(e1, e2);
     }
 
     /**
@@ -172,10 +250,9 @@ namespace xt
      */
     template <class E1, class E2>
     inline auto fmin(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_free_type<E1, E2>
+        -> detail::get_xfunction_type<math::fmin_fun, E1, E2>
     {
-        using functor_type = detail::mf_type<E1, E2>;
-        return detail::make_xfunction((functor_type)std::fmin, e1, e2);
+        return detail::make_xfunction<math::fmin_fun>(e1, e2);
     }
 
     /**
@@ -191,10 +268,9 @@ namespace xt
      */
     template <class E1, class E2>
     inline auto fdim(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_free_type<E1, E2>
+        -> detail::get_xfunction_type<math::fdim_fun, E1, E2>
     {
-        using functor_type = detail::mf_type<E1, E2>;
-        return detail::make_xfunction((functor_type)std::fdim, e1, e2);
+        return detail::make_xfunction<math::fdim_fun>(e1, e2);
     }
 
     /*************************
@@ -217,8 +293,7 @@ namespace xt
     template <class E>
     inline auto exp(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::exp, e.derived_cast());
+        return detail::make_xfunction<math::exp_fun>(e.derived_cast());
     }
 
     /**
@@ -233,8 +308,7 @@ namespace xt
     template <class E>
     inline auto exp2(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::exp2, e.derived_cast());
+        return detail::make_xfunction<math::exp2_fun>(e.derived_cast());
     }
 
     /**
@@ -249,8 +323,7 @@ namespace xt
     template <class E>
     inline auto expm1(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::expm1, e.derived_cast());
+        return detail::make_xfunction<math::expm1_fun>(e.derived_cast());
     }
 
     /**
@@ -265,8 +338,7 @@ namespace xt
     template <class E>
     inline auto log(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::log, e.derived_cast());
+        return detail::make_xfunction<math::log_fun>(e.derived_cast());
     }
 
     /**
@@ -281,8 +353,7 @@ namespace xt
     template <class E>
     inline auto log10(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::log10, e.derived_cast());
+        return detail::make_xfunction<math::log10_fun>(e.derived_cast());
     }
 
     /**
@@ -297,8 +368,7 @@ namespace xt
     template <class E>
     inline auto log2(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::log2, e.derived_cast());
+        return detail::make_xfunction<math::log2_fun>(e.derived_cast());
     }
 
     /**
@@ -313,8 +383,7 @@ namespace xt
     template <class E>
     inline auto log1p(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::log1p, e.derived_cast());
+        return detail::make_xfunction<math::log1p_fun>(e.derived_cast());
     }
 
     /*******************
@@ -338,10 +407,9 @@ namespace xt
      */
     template <class E1, class E2>
     inline auto pow(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_free_type<E1, E2>
+        -> detail::get_xfunction_type<math::pow_fun, E1, E2>
     {
-        using functor_type = detail::mf_type<E1, E2>;
-        return detail::make_xfunction((functor_type)std::pow, e1, e2);
+        return detail::make_xfunction<math::pow_fun>(e1, e2);
     }
 
     /**
@@ -356,8 +424,7 @@ namespace xt
     template <class E>
     inline auto sqrt(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::sqrt, e.derived_cast());
+        return detail::make_xfunction<math::sqrt_fun>(e.derived_cast());
     }
 
     /**
@@ -372,8 +439,7 @@ namespace xt
     template <class E>
     inline auto cbrt(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::cbrt, e.derived_cast());
+        return detail::make_xfunction<math::cbrt_fun>(e.derived_cast());
     }
 
     /**
@@ -390,10 +456,9 @@ namespace xt
      */
     template <class E1, class E2>
     inline auto hypot(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_free_type<E1, E2>
+        -> detail::get_xfunction_type<math::hypot_fun, E1, E2>
     {
-        using functor_type = detail::mf_type<E1, E2>;
-        return detail::make_xfunction((functor_type)std::hypot, e1, e2);
+        return detail::make_xfunction<math::hypot_fun>(e1, e2);
     }
 
     /***************************
@@ -416,8 +481,7 @@ namespace xt
     template <class E>
     inline auto sin(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::sin, e.derived_cast());
+        return detail::make_xfunction<math::sin_fun>(e.derived_cast());
     }
 
     /**
@@ -432,8 +496,7 @@ namespace xt
     template <class E>
     inline auto cos(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::cos, e.derived_cast());
+        return detail::make_xfunction<math::cos_fun>(e.derived_cast());
     }
 
     /**
@@ -448,8 +511,7 @@ namespace xt
     template <class E>
     inline auto tan(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::tan, e.derived_cast());
+        return detail::make_xfunction<math::tan_fun>(e.derived_cast());
     }
 
     /**
@@ -464,8 +526,7 @@ namespace xt
     template <class E>
     inline auto asin(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::asin, e.derived_cast());
+        return detail::make_xfunction<math::asin_fun>(e.derived_cast());
     }
 
     /**
@@ -480,8 +541,7 @@ namespace xt
     template <class E>
     inline auto acos(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::acos, e.derived_cast());
+        return detail::make_xfunction<math::acos_fun>(e.derived_cast());
     }
 
     /**
@@ -496,8 +556,7 @@ namespace xt
     template <class E>
     inline auto atan(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::atan, e.derived_cast());
+        return detail::make_xfunction<math::atan_fun>(e.derived_cast());
     }
 
     /**
@@ -514,10 +573,9 @@ namespace xt
      */
     template <class E1, class E2>
     inline auto atan2(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_free_type<E1, E2>
+        -> detail::get_xfunction_type<math::atan2_fun, E1, E2>
     {
-        using functor_type = detail::mf_type<E1, E2>;
-        return detail::make_xfunction((functor_type)std::atan2, e1, e2);
+        return detail::make_xfunction<math::atan2_fun>(e1, e2);
     }
 
     /************************
@@ -540,8 +598,7 @@ namespace xt
     template <class E>
     inline auto sinh(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::sinh, e.derived_cast());
+        return detail::make_xfunction<math::sinh_fun>(e.derived_cast());
     }
 
     /**
@@ -556,8 +613,7 @@ namespace xt
     template <class E>
     inline auto cosh(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::cosh, e.derived_cast());
+        return detail::make_xfunction<math::cosh_fun>(e.derived_cast());
     }
 
     /**
@@ -572,8 +628,7 @@ namespace xt
     template <class E>
     inline auto tanh(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::tanh, e.derived_cast());
+        return detail::make_xfunction<math::tanh_fun>(e.derived_cast());
     }
 
     /**
@@ -588,8 +643,7 @@ namespace xt
     template <class E>
     inline auto asinh(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::asinh, e.derived_cast());
+        return detail::make_xfunction<math::asinh_fun>(e.derived_cast());
     }
 
     /**
@@ -604,8 +658,7 @@ namespace xt
     template <class E>
     inline auto acosh(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::acosh, e.derived_cast());
+        return detail::make_xfunction<math::acosh_fun>(e.derived_cast());
     }
 
     /**
@@ -620,8 +673,7 @@ namespace xt
     template <class E>
     inline auto atanh(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::atanh, e.derived_cast());
+        return detail::make_xfunction<math::atanh_fun>(e.derived_cast());
     }
 
     /*****************************
@@ -644,8 +696,7 @@ namespace xt
     template <class E>
     inline auto erf(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::erf, e.derived_cast());
+        return detail::make_xfunction<math::erf_fun>(e.derived_cast());
     }
 
     /**
@@ -660,8 +711,7 @@ namespace xt
     template <class E>
     inline auto erfc(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::erfc, e.derived_cast());
+        return detail::make_xfunction<math::erfc_fun>(e.derived_cast());
     }
 
     /**
@@ -676,8 +726,7 @@ namespace xt
     template <class E>
     inline auto tgamma(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::tgamma, e.derived_cast());
+        return detail::make_xfunction<math::tgamma_fun>(e.derived_cast());
     }
 
     /**
@@ -692,8 +741,7 @@ namespace xt
     template <class E>
     inline auto lgamma(const xexpression<E>& e) noexcept
     {
-        using functor_type = detail::mf_type<E>;
-        return detail::make_xfunction((functor_type)std::lgamma, e.derived_cast());
+        return detail::make_xfunction<math::lgamma_fun>(e.derived_cast());
     }
 
 }
@@ -0,0 +1,850 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XMMAP_HPP
+#define XMMAP_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "xarray.hpp"
+#include "xbuffer_adaptor.hpp"
+
+namespace xt
+{
+
+    /**
+     * @enum mmap_mode
+     * @brief Access mode of a memory-mapped file.
+     */
+    enum class mmap_mode
+    {
+        /// The mapping can only be read: assigning to an xarray_mmap throws.
+        read_only,
+        /// Modifications are written back to the file.
+        read_write,
+        /// Modifications are private to the process and never reach the file.
+        copy_on_write
+    };
+
+    /**
+     * @enum mmap_advice
+     * @brief Expected access pattern of a memory-mapped file,
+     * forwarded to madvise.
+     */
+    enum class mmap_advice
+    {
+        normal,
+        sequential,
+        random,
+        will_need,
+        dont_need
+    };
+
+    /***************************
+     * mapped_file declaration *
+     ***************************/
+
+    /**
+     * @class mapped_file
+     * @brief Owner of a file mapped in memory.
+     *
+     * The mapped_file class maps a whole file in the address space of the
+     * process and unmaps it on destruction. Pages are loaded by the system
+     * when they are first accessed, so that only the touched parts of the
+     * file are read.
+     */
+    class mapped_file
+    {
+
+    public:
+
+        mapped_file() noexcept;
+        mapped_file(const std::string& path, mmap_mode mode);
+        mapped_file(const std::string& path, std::size_t size);
+
+        ~mapped_file();
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&& rhs) noexcept;
+        mapped_file& operator=(mapped_file&& rhs) noexcept;
+
+        char* data() noexcept;
+        const char* data() const noexcept;
+        std::size_t size() const noexcept;
+        mmap_mode mode() const noexcept;
+
+        void advise(mmap_advice advice, std::size_t offset = 0, std::size_t length = 0);
+        void sync();
+        void close() noexcept;
+
+    private:
+
+        char* p_data;
+        std::size_t m_size;
+        mmap_mode m_mode;
+
+        void map(int fd, const std::string& path, std::size_t size);
+        [[noreturn]] static void throw_error(const std::string& what, const std::string& path);
+    };
+
+    /***************************
+     * xarray_mmap declaration *
+     ***************************/
+
+    template <class T>
+    class xarray_mmap;
+
+    template <class T>
+    struct array_inner_types<xarray_mmap<T>>
+    {
+        using container_type = xbuffer_adaptor<T>;
+        using shape_type = xshape<typename container_type::size_type>;
+        using strides_type = xstrides<typename container_type::size_type>;
+        using temporary_type = xarray_container<temporary_container_t<container_type>>;
+    };
+
+    /**
+     * @class xarray_mmap
+     * @brief Dense multidimensional container stored in a memory-mapped file.
+     *
+     * The xarray_mmap class implements a dense multidimensional container
+     * with tensor semantic whose elements live in a file mapped in memory.
+     * The file starts with a header holding the size of the elements, the
+     * shape and the strides of the array, followed by the elements. Since
+     * the elements are accessed through the mapping, arrays larger than the
+     * available memory can be processed, and only the touched pages are
+     * loaded.
+     *
+     * The number of elements and the maximal dimension are fixed at creation:
+     * assigning an expression of another size throws std::runtime_error. The
+     * shape and strides are written back to the header by sync and on
+     * destruction when the file is mapped in read_write mode. Assigning to,
+     * reshaping or syncing a read_only mapping throws std::runtime_error;
+     * the elements of such a mapping are write-protected, so that writing
+     * them through operator(), an iterator or a view terminates the process.
+     *
+     * \code{.cpp}
+     * {
+     *     xt::xarray_mmap<double> a("data.xtm", {4096, 4096});
+     *     a = xt::ones<double>({4096, 4096});
+     * }
+     * xt::xarray_mmap<double> b("data.xtm", xt::mmap_mode::read_only);
+     * b.advise(xt::mmap_advice::sequential);
+     * xt::xarray<double> row = 2. * xt::make_xview(b, 12, xt::range(0, 4096));
+     * \endcode
+     *
+     * @tparam T The type of the elements; it must be trivially copyable.
+     */
+    template <class T>
+    class xarray_mmap : public xarray_base<xarray_mmap<T>>,
+                        public xadaptor_semantic<xarray_mmap<T>>
+    {
+
+    public:
+
+        using self_type = xarray_mmap<T>;
+        using base_type = xarray_base<self_type>;
+        using semantic_base = xadaptor_semantic<self_type>;
+        using container_type = typename base_type::container_type;
+        using shape_type = typename base_type::shape_type;
+        using strides_type = typename base_type::strides_type;
+        using size_type = typename base_type::size_type;
+
+        using temporary_type = typename array_inner_types<self_type>::temporary_type;
+
+        using closure_type = const self_type&;
+
+        static_assert(std::is_trivially_copyable<T>::value, "xarray_mmap requires trivially copyable elements");
+
+        xarray_mmap(const std::string& path, mmap_mode mode = mmap_mode::read_only);
+        xarray_mmap(const std::string& path, const shape_type& shape, layout l = layout::row_major);
+        xarray_mmap(const std::string& path, const shape_type& shape, const strides_type& strides);
+
+        ~xarray_mmap();
+
+        xarray_mmap(const xarray_mmap&) = delete;
+        xarray_mmap& operator=(const xarray_mmap&) = delete;
+
+        xarray_mmap(xarray_mmap&&) = default;
+        xarray_mmap& operator=(xarray_mmap&& rhs);
+
+        template <class E>
+        xarray_mmap& operator=(const xexpression<E>& e);
+
+        xarray_mmap& assign_temporary(temporary_type& tmp);
+
+        template <class E>
+        xarray_mmap& assign_xexpression(const xexpression<E>& e);
+
+        template <class E>
+        xarray_mmap& computed_assign(const xexpression<E>& e);
+
+        template <class E, class F>
+        xarray_mmap& scalar_computed_assign(const E& e, F&& f);
+
+        void reshape(const shape_type& shape);
+        void reshape(const shape_type& shape, layout l);
+        void reshape(const shape_type& shape, const strides_type& strides);
+
+        mmap_mode mode() const noexcept;
+        void advise(mmap_advice advice);
+        void sync();
+
+    private:
+
+        mapped_file m_file;
+        container_type m_data;
+
+        container_type& data_impl();
+        const container_type& data_impl() const;
+
+        void create(const std::string& path, const shape_type& shape);
+        bool write_header();
+        void check_writable(const char* what) const;
+
+        void assign_temporary_impl(temporary_type& tmp);
+
+        friend class xarray_base<xarray_mmap<T>>;
+        friend class xadaptor_semantic<xarray_mmap<T>>;
+    };
+
+    /******************************
+     * mapped_file implementation *
+     ******************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs a mapped_file that maps nothing.
+     */
+    inline mapped_file::mapped_file() noexcept
+        : p_data(nullptr), m_size(0), m_mode(mmap_mode::read_only)
+    {
+    }
+
+    /**
+     * Maps the existing file \c path with the specified mode.
+     * @param path the path of the file
+     * @param mode the access mode of the mapping
+     * @throw std::runtime_error if the file cannot be opened or mapped.
+     */
+    inline mapped_file::mapped_file(const std::string& path, mmap_mode mode)
+        : p_data(nullptr), m_size(0), m_mode(mode)
+    {
+        int fd = ::open(path.c_str(), mode == mmap_mode::read_write ? O_RDWR : O_RDONLY);
+        if (fd == -1)
+        {
+            throw_error("cannot open", path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == -1)
+        {
+            ::close(fd);
+            throw_error("cannot stat", path);
+        }
+        map(fd, path, static_cast<std::size_t>(st.st_size));
+    }
+
+    /**
+     * Creates or truncates the file \c path to \c size bytes and maps it
+     * in read_write mode. The content of the file is zero-filled.
+     * @param path the path of the file
+     * @param size the size of the file in bytes
+     * @throw std::runtime_error if the file cannot be created or mapped.
+     */
+    inline mapped_file::mapped_file(const std::string& path, std::size_t size)
+        : p_data(nullptr), m_size(0), m_mode(mmap_mode::read_write)
+    {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1)
+        {
+            throw_error("cannot create", path);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) == -1)
+        {
+            ::close(fd);
+            throw_error("cannot resize", path);
+        }
+        map(fd, path, size);
+    }
+    //@}
+
+    inline mapped_file::~mapped_file()
+    {
+        close();
+    }
+
+    inline mapped_file::mapped_file(mapped_file&& rhs) noexcept
+        : p_data(rhs.p_data), m_size(rhs.m_size), m_mode(rhs.m_mode)
+    {
+        rhs.p_data = nullptr;
+        rhs.m_size = 0;
+    }
+
+    inline mapped_file& mapped_file::operator=(mapped_file&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            close();
+            p_data = rhs.p_data;
+            m_size = rhs.m_size;
+            m_mode = rhs.m_mode;
+            rhs.p_data = nullptr;
+            rhs.m_size = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * Returns a pointer to the first byte of the mapping.
+     */
+    inline char* mapped_file::data() noexcept
+    {
+        return p_data;
+    }
+
+    /**
+     * Returns a constant pointer to the first byte of the mapping.
+     */
+    inline const char* mapped_file::data() const noexcept
+    {
+        return p_data;
+    }
+
+    /**
+     * Returns the size of the mapping in bytes.
+     */
+    inline std::size_t mapped_file::size() const noexcept
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns the access mode of the mapping.
+     */
+    inline mmap_mode mapped_file::mode() const noexcept
+    {
+        return m_mode;
+    }
+
+    /**
+     * Advises the system of the expected access pattern of the bytes
+     * [offset, offset + length) of the mapping; a null \c length stands
+     * for the end of the mapping. The range is extended to page boundaries.
+     * @throw std::runtime_error if madvise fails.
+     */
+    inline void mapped_file::advise(mmap_advice advice, std::size_t offset, std::size_t length)
+    {
+        if (p_data == nullptr)
+        {
+            return;
+        }
+        static const int advices[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED, MADV_DONTNEED };
+        std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        std::size_t first = offset - offset % page;
+        std::size_t last = length == 0 ? m_size : std::min(offset + length, m_size);
+        if (::madvise(p_data + first, last - first, advices[static_cast<int>(advice)]) == -1)
+        {
+            throw_error("madvise failed on", "mapped_file");
+        }
+    }
+
+    /**
+     * Writes the modified pages back to the file. Does nothing unless
+     * the mapping is in read_write mode.
+     * @throw std::runtime_error if msync fails.
+     */
+    inline void mapped_file::sync()
+    {
+        if (p_data != nullptr && m_mode == mmap_mode::read_write && ::msync(p_data, m_size, MS_SYNC) == -1)
+        {
+            throw_error("msync failed on", "mapped_file");
+        }
+    }
+
+    /**
+     * Unmaps the file. Modified pages of a read_write mapping are written
+     * back to the file by the system.
+     */
+    inline void mapped_file::close() noexcept
+    {
+        if (p_data != nullptr)
+        {
+            ::munmap(p_data, m_size);
+            p_data = nullptr;
+            m_size = 0;
+        }
+    }
+
+    inline void mapped_file::map(int fd, const std::string& path, std::size_t size)
+    {
+        if (size != 0)
+        {
+            int prot = m_mode == mmap_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            int flags = m_mode == mmap_mode::read_write ? MAP_SHARED : MAP_PRIVATE;
+            void* res = ::mmap(nullptr, size, prot, flags, fd, 0);
+            if (res == MAP_FAILED)
+            {
+                int err = errno;
+                ::close(fd);
+                errno = err;
+                throw_error("cannot map", path);
+            }
+            p_data = static_cast<char*>(res);
+            m_size = size;
+        }
+        // The mapping remains valid once the descriptor is closed.
+        ::close(fd);
+    }
+
+    inline void mapped_file::throw_error(const std::string& what, const std::string& path)
+    {
+        throw std::runtime_error("mapped_file: " + what + " " + path + ": " + std::strerror(errno));
+    }
+
+    /******************************
+     * xarray_mmap implementation *
+     ******************************/
+
+    namespace detail
+    {
+        // Layout of the header of an xarray_mmap file, made of 64 bits
+        // unsigned integers: magic number, size of the elements, dimension,
+        // then the shape and the strides. The elements start at the first
+        // multiple of mmap_data_alignment following the header.
+
+        constexpr std::uint64_t mmap_magic = 0x31504d4d5854ULL; // "XTMMP1"
+        constexpr std::size_t mmap_fixed_header = 3;
+        constexpr std::size_t mmap_data_alignment = 64;
+
+        inline std::size_t mmap_data_offset(std::size_t dimension)
+        {
+            std::size_t header = (mmap_fixed_header + 2 * dimension) * sizeof(std::uint64_t);
+            return (header + mmap_data_alignment - 1) / mmap_data_alignment * mmap_data_alignment;
+        }
+
+        inline std::uint64_t mmap_read(const char* header, std::size_t idx)
+        {
+            std::uint64_t res;
+            std::memcpy(&res, header + idx * sizeof(std::uint64_t), sizeof(std::uint64_t));
+            return res;
+        }
+
+        inline void mmap_write(char* header, std::size_t idx, std::uint64_t value)
+        {
+            std::memcpy(header + idx * sizeof(std::uint64_t), &value, sizeof(std::uint64_t));
+        }
+
+        // Overflow-checked arithmetic on the values read from a header,
+        // which cannot be trusted: they return false instead of wrapping.
+
+        inline bool mmap_checked_mul(std::size_t& res, std::size_t n) noexcept
+        {
+            if (n != 0 && res > std::numeric_limits<std::size_t>::max() / n)
+            {
+                return false;
+            }
+            res *= n;
+            return true;
+        }
+
+        inline bool mmap_checked_add(std::size_t& res, std::size_t n) noexcept
+        {
+            if (res > std::numeric_limits<std::size_t>::max() - n)
+            {
+                return false;
+            }
+            res += n;
+            return true;
+        }
+    }
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Maps the existing xarray_mmap file \c path with the specified mode.
+     * The shape and strides are read from the header of the file.
+     * @param path the path of the file
+     * @param mode the access mode of the mapping
+     * @throw std::runtime_error if the file cannot be mapped, or if it is
+     * not a valid xarray_mmap file for elements of type T.
+     */
+    template <class T>
+    inline xarray_mmap<T>::xarray_mmap(const std::string& path, mmap_mode mode)
+        : base_type(), m_file(path, mode), m_data()
+    {
+        const char* header = m_file.data();
+        std::size_t fixed_size = detail::mmap_fixed_header * sizeof(std::uint64_t);
+        if (m_file.size() < fixed_size || detail::mmap_read(header, 0) != detail::mmap_magic)
+        {
+            throw std::runtime_error("xarray_mmap: " + path + " is not an xarray_mmap file");
+        }
+        if (detail::mmap_read(header, 1) != sizeof(T))
+        {
+            throw std::runtime_error("xarray_mmap: element size mismatch in " + path);
+        }
+        // The dimension is bounded by the number of integers the file can
+        // hold, so that neither the offset nor the shape can overflow.
+        std::size_t max_dim = (m_file.size() / sizeof(std::uint64_t) - detail::mmap_fixed_header) / 2;
+        std::size_t dim = static_cast<std::size_t>(detail::mmap_read(header, 2));
+        if (detail::mmap_read(header, 2) > max_dim)
+        {
+            throw std::runtime_error("xarray_mmap: truncated header in " + path);
+        }
+        std::size_t offset = detail::mmap_data_offset(dim);
+        if (m_file.size() < offset)
+        {
+            throw std::runtime_error("xarray_mmap: truncated header in " + path);
+        }
+        shape_type shape(dim);
+        strides_type strides(dim);
+        for (std::size_t i = 0; i < dim; ++i)
+        {
+            shape[i] = static_cast<size_type>(detail::mmap_read(header, detail::mmap_fixed_header + i));
+            strides[i] = static_cast<size_type>(detail::mmap_read(header, detail::mmap_fixed_header + dim + i));
+        }
+        // Both the elements and the furthest element reachable through
+        // the strides must lie in the mapping.
+        std::size_t size = 1;
+        std::size_t extent = 1;
+        bool valid = true;
+        if (std::find(shape.cbegin(), shape.cend(), size_type(0)) != shape.cend())
+        {
+            size = 0;
+        }
+        else
+        {
+            for (std::size_t i = 0; valid && i < dim; ++i)
+            {
+                std::size_t last = shape[i] - 1;
+                valid = detail::mmap_checked_mul(size, shape[i]) &&
+                        detail::mmap_checked_mul(last, strides[i]) &&
+                        detail::mmap_checked_add(extent, last);
+            }
+        }
+        std::size_t bytes = std::max(size, extent);
+        valid = valid && detail::mmap_checked_mul(bytes, sizeof(T)) && detail::mmap_checked_add(bytes, offset);
+        if (!valid || m_file.size() < bytes)
+        {
+            throw std::runtime_error("xarray_mmap: truncated data in " + path);
+        }
+        m_data = container_type(reinterpret_cast<T*>(m_file.data() + offset), size);
+        base_type::reshape(shape, strides);
+    }
+
+    /**
+     * Creates the xarray_mmap file \c path for an array with the specified
+     * shape and layout, and maps it in read_write mode. An existing file is
+     * overwritten. The elements are initialized to zero.
+     * @param path the path of the file
+     * @param shape the shape of the xarray_mmap
+     * @param l the layout of the xarray_mmap
+     */
+    template <class T>
+    inline xarray_mmap<T>::xarray_mmap(const std::string& path, const shape_type& shape, layout l)
+        : base_type(), m_file(), m_data()
+    {
+        create(path, shape);
+        base_type::reshape(shape, l);
+        write_header();
+    }
+
+    /**
+     * Creates the xarray_mmap file \c path for an array with the specified
+     * shape and strides, and maps it in read_write mode. An existing file is
+     * overwritten. The elements are initialized to zero.
+     * @param path the path of the file
+     * @param shape the shape of the xarray_mmap
+     * @param strides the strides of the xarray_mmap
+     */
+    template <class T>
+    inline xarray_mmap<T>::xarray_mmap(const std::string& path, const shape_type& shape, const strides_type& strides)
+        : base_type(), m_file(), m_data()
+    {
+        create(path, shape);
+        base_type::reshape(shape, strides);
+        write_header();
+    }
+    //@}
+
+    /**
+     * Writes the shape and strides to the header of the file when it is
+     * mapped in read_write mode, and unmaps it.
+     */
+    template <class T>
+    inline xarray_mmap<T>::~xarray_mmap()
+    {
+        if (m_file.mode() == mmap_mode::read_write && m_file.data() != nullptr)
+        {
+            write_header();
+        }
+    }
+
+    /**
+     * Writes the shape and strides to the header of the file currently
+     * mapped when it is mapped in read_write mode, unmaps it, and takes
+     * over the mapping of \c rhs.
+     */
+    template <class T>
+    inline auto xarray_mmap<T>::operator=(xarray_mmap&& rhs) -> self_type&
+    {
+        if (this != &rhs)
+        {
+            if (m_file.mode() == mmap_mode::read_write && m_file.data() != nullptr)
+            {
+                write_header();
+            }
+            m_file.close();
+            base_type::operator=(std::move(rhs));
+            m_file = std::move(rhs.m_file);
+            m_data = std::move(rhs.m_data);
+        }
+        return *this;
+    }
+
+    /**
+     * @name Extended copy semantic
+     */
+    //@{
+    /**
+     * The extended assignment operator.
+     */
+    template <class T>
+    template <class E>
+    inline auto xarray_mmap<T>::operator=(const xexpression<E>& e) -> self_type&
+    {
+        // Checked before the temporary is evaluated.
+        check_writable("assign to");
+        return semantic_base::operator=(e);
+    }
+    //@}
+
+    /**
+     * @name Assign functions
+     *
+     * These functions shadow the ones of xadaptor_semantic so that a
+     * read_only mapping is never written.
+     * @throw std::runtime_error if the file is mapped in read_only mode.
+     */
+    //@{
+    /**
+     * Assigns the temporary \c tmp to \c *this.
+     */
+    template <class T>
+    inline auto xarray_mmap<T>::assign_temporary(temporary_type& tmp) -> self_type&
+    {
+        check_writable("assign to");
+        return semantic_base::assign_temporary(tmp);
+    }
+
+    /**
+     * Assigns the xexpression \c e to \c *this without temporary.
+     */
+    template <class T>
+    template <class E>
+    inline auto xarray_mmap<T>::assign_xexpression(const xexpression<E>& e) -> self_type&
+    {
+        check_writable("assign to");
+        return semantic_base::assign_xexpression(e);
+    }
+
+    /**
+     * Assigns the xexpression \c e, computed from \c *this, to \c *this.
+     */
+    template <class T>
+    template <class E>
+    inline auto xarray_mmap<T>::computed_assign(const xexpression<E>& e) -> self_type&
+    {
+        check_writable("assign to");
+        return semantic_base::computed_assign(e);
+    }
+
+    /**
+     * Applies \c f to each element of \c *this and the scalar \c e.
+     */
+    template <class T>
+    template <class E, class F>
+    inline auto xarray_mmap<T>::scalar_computed_assign(const E& e, F&& f) -> self_type&
+    {
+        check_writable("assign to");
+        xt::scalar_computed_assign(*this, e, std::forward<F>(f));
+        return *this;
+    }
+    //@}
+
+    /**
+     * @name Reshape
+     *
+     * The number of elements of the array cannot change. The new shape
+     * and strides reach the file header on sync or on destruction.
+     * @throw std::runtime_error if the file is mapped in read_only mode.
+     */
+    //@{
+    /**
+     * Reshapes the array in row_major layout if the shape changes.
+     */
+    template <class T>
+    inline void xarray_mmap<T>::reshape(const shape_type& shape)
+    {
+        check_writable("reshape");
+        base_type::reshape(shape);
+    }
+
+    /**
+     * Reshapes the array with the specified layout.
+     */
+    template <class T>
+    inline void xarray_mmap<T>::reshape(const shape_type& shape, layout l)
+    {
+        check_writable("reshape");
+        base_type::reshape(shape, l);
+    }
+
+    /**
+     * Reshapes the array with the specified strides.
+     */
+    template <class T>
+    inline void xarray_mmap<T>::reshape(const shape_type& shape, const strides_type& strides)
+    {
+        check_writable("reshape");
+        base_type::reshape(shape, strides);
+    }
+    //@}
+
+    /**
+     * @name Mapping
+     */
+    //@{
+    /**
+     * Returns the access mode of the mapping.
+     */
+    template <class T>
+    inline mmap_mode xarray_mmap<T>::mode() const noexcept
+    {
+        return m_file.mode();
+    }
+
+    /**
+     * Advises the system of the expected access pattern of the elements.
+     * @param advice the access pattern
+     */
+    template <class T>
+    inline void xarray_mmap<T>::advise(mmap_advice advice)
+    {
+        std::size_t offset = static_cast<std::size_t>(reinterpret_cast<char*>(m_data.data()) - m_file.data());
+        m_file.advise(advice, offset, m_data.size() * sizeof(T));
+    }
+
+    /**
+     * Writes the shape, the strides and the modified elements back to the
+     * file. Does nothing when the file is mapped in copy_on_write mode.
+     * @throw std::runtime_error if the file is mapped in read_only mode,
+     * or if the array has been reshaped to a higher dimension than the one
+     * it was created with.
+     */
+    template <class T>
+    inline void xarray_mmap<T>::sync()
+    {
+        check_writable("sync");
+        if (m_file.mode() == mmap_mode::read_write)
+        {
+            if (!write_header())
+            {
+                throw std::runtime_error("xarray_mmap: the dimension exceeds the one of the file header");
+            }
+            m_file.sync();
+        }
+    }
+    //@}
+
+    template <class T>
+    inline auto xarray_mmap<T>::data_impl() -> container_type&
+    {
+        return m_data;
+    }
+
+    template <class T>
+    inline auto xarray_mmap<T>::data_impl() const -> const container_type&
+    {
+        return m_data;
+    }
+
+    template <class T>
+    inline void xarray_mmap<T>::create(const std::string& path, const shape_type& shape)
+    {
+        std::size_t size = data_size(shape);
+        std::size_t offset = detail::mmap_data_offset(shape.size());
+        m_file = mapped_file(path, offset + size * sizeof(T));
+        detail::mmap_write(m_file.data(), 2, shape.size());
+        m_data = container_type(reinterpret_cast<T*>(m_file.data() + offset), size);
+    }
+
+    template <class T>
+    inline bool xarray_mmap<T>::write_header()
+    {
+        char* header = m_file.data();
+        // The dimension recorded in the header cannot change since it
+        // determines the offset of the elements: arrays reshaped to a
+        // lower dimension are stored with a shape padded with ones.
+        std::size_t dim = static_cast<std::size_t>(detail::mmap_read(header, 2));
+        if (this->dimension() > dim)
+        {
+            return false;
+        }
+        std::size_t pad = dim - this->dimension();
+        detail::mmap_write(header, 0, detail::mmap_magic);
+        detail::mmap_write(header, 1, sizeof(T));
+        for (std::size_t i = 0; i < dim; ++i)
+        {
+            bool padded = i < pad;
+            detail::mmap_write(header, detail::mmap_fixed_header + i, padded ? 1 : this->shape()[i - pad]);
+            detail::mmap_write(header, detail::mmap_fixed_header + dim + i, padded ? 0 : this->strides()[i - pad]);
+        }
+        return true;
+    }
+
+    template <class T>
+    inline void xarray_mmap<T>::check_writable(const char* what) const
+    {
+        if (m_file.mode() == mmap_mode::read_only)
+        {
+            throw std::runtime_error(std::string("xarray_mmap: cannot ") + what + " a read_only mapping");
+        }
+    }
+
+    template <class T>
+    inline void xarray_mmap<T>::assign_temporary_impl(temporary_type& tmp)
+    {
+        // The data are assigned first so that the array is left unchanged
+        // if the mapping cannot hold them.
+        detail::assign_temporary_container(m_data, tmp.data());
+        base_type::reshape(tmp.shape(), tmp.strides());
+    }
+}
+
+#endif
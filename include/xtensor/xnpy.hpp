@@ -0,0 +1,794 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XNPY_HPP
+#define XNPY_HPP
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "xarray.hpp"
+
+namespace xt
+{
+
+    /**
+     * @defgroup xnpy NPY and NPZ files
+     *
+     * Binary I/O in the NumPy file formats. Elements are read and written
+     * in a single block, straight from and into the storage of containers
+     * whose strides are row_major or column_major; the layout is recorded
+     * in the fortran_order field of the header so that no transposition
+     * is needed. Other expressions are evaluated in a row_major xarray
+     * before being written.
+     *
+     * NPZ archives are zip files of NPY entries; only uncompressed entries
+     * (numpy.savez, not numpy.savez_compressed) are supported.
+     */
+
+    template <class T>
+    xarray<T> load_npy(std::istream& in);
+
+    template <class T>
+    xarray<T> load_npy(const std::string& path);
+
+    template <class D>
+    void load_npy(std::istream& in, xarray_base<D>& a);
+
+    template <class D>
+    void load_npy(const std::string& path, xarray_base<D>& a);
+
+    template <class E>
+    void dump_npy(std::ostream& out, const xexpression<E>& e);
+
+    template <class E>
+    void dump_npy(const std::string& path, const xexpression<E>& e);
+
+    template <class T>
+    xarray<T> load_npz(const std::string& path, const std::string& name);
+
+    template <class D>
+    void load_npz(const std::string& path, const std::string& name, xarray_base<D>& a);
+
+    template <class E>
+    void dump_npz(const std::string& path, const std::string& name, const xexpression<E>& e, bool append = false);
+
+    /*****************************
+     * npy header implementation *
+     *****************************/
+
+    namespace detail
+    {
+        inline bool npy_little_endian() noexcept
+        {
+            const std::uint16_t one = 1;
+            return *reinterpret_cast<const unsigned char*>(&one) == 1;
+        }
+
+        template <class T, class = void>
+        struct npy_kind;
+
+        template <>
+        struct npy_kind<bool>
+        {
+            static constexpr char value = 'b';
+        };
+
+        template <class T>
+        struct npy_kind<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+        {
+            static constexpr char value = std::is_signed<T>::value ? 'i' : 'u';
+        };
+
+        template <class T>
+        struct npy_kind<T, std::enable_if_t<std::is_floating_point<T>::value>>
+        {
+            static constexpr char value = 'f';
+        };
+
+        template <class T>
+        struct npy_kind<std::complex<T>>
+        {
+            static constexpr char value = 'c';
+        };
+
+        // Type descriptor of T in the NumPy array-protocol format, e.g. "<f8".
+        template <class T>
+        inline std::string npy_descr()
+        {
+            char order = sizeof(T) == 1 ? '|' : (npy_little_endian() ? '<' : '>');
+            return std::string(1, order) + npy_kind<T>::value + std::to_string(sizeof(T));
+        }
+
+        struct npy_header
+        {
+            std::string descr;
+            bool fortran_order;
+            std::vector<std::size_t> shape;
+        };
+
+        template <class S>
+        inline std::string make_npy_header(const std::string& descr, bool fortran_order, const S& shape)
+        {
+            std::string dict = "{'descr': '" + descr + "', 'fortran_order': " + (fortran_order ? "True" : "False") + ", 'shape': (";
+            for (auto s : shape)
+            {
+                dict += std::to_string(s) + ", ";
+            }
+            if (shape.size() == 1)
+            {
+                dict.pop_back();
+            }
+            else if (shape.size() > 1)
+            {
+                dict.erase(dict.size() - 2);
+            }
+            dict += "), }";
+
+            // The header is padded with spaces and terminated by a newline
+            // so that the elements are 64 bytes aligned in the file.
+            std::size_t prefix = dict.size() + 11 < 65536 ? 10 : 12;
+            dict.append(63 - (prefix + dict.size()) % 64, ' ');
+            dict += '\n';
+
+            std::string res("\x93NUMPY", 6);
+            res += prefix == 10 ? '\x01' : '\x02';
+            res += '\x00';
+            for (std::size_t i = 0; i < prefix - 8; ++i)
+            {
+                res += static_cast<char>((dict.size() >> (8 * i)) & 0xff);
+            }
+            return res + dict;
+        }
+
+        [[noreturn]] inline void throw_npy_error(const std::string& what)
+        {
+            throw std::runtime_error("npy: " + what);
+        }
+
+        inline std::string npy_dict_value(const std::string& dict, const std::string& key)
+        {
+            std::size_t pos = dict.find("'" + key + "'");
+            if (pos == std::string::npos)
+            {
+                throw_npy_error("missing key '" + key + "' in header");
+            }
+            pos = dict.find(':', pos);
+            std::size_t first = dict.find_first_not_of(' ', pos + 1);
+            std::size_t last;
+            if (pos == std::string::npos || first == std::string::npos)
+            {
+                throw_npy_error("invalid header");
+            }
+            if (dict[first] == '(')
+            {
+                last = dict.find(')', first) + 1;
+            }
+            else if (dict[first] == '\'')
+            {
+                last = dict.find('\'', first + 1) + 1;
+            }
+            else
+            {
+                last = dict.find_first_of(",}", first);
+            }
+            if (last == std::string::npos || last == 0)
+            {
+                throw_npy_error("invalid header");
+            }
+            return dict.substr(first, last - first);
+        }
+
+        inline npy_header read_npy_header(std::istream& in)
+        {
+            char prefix[8];
+            if (!in.read(prefix, 8) || std::string(prefix, 6) != "\x93NUMPY")
+            {
+                throw_npy_error("not an npy stream");
+            }
+            std::size_t len_size = prefix[6] == 1 ? 2 : 4;
+            unsigned char len_bytes[4];
+            if (!in.read(reinterpret_cast<char*>(len_bytes), static_cast<std::streamsize>(len_size)))
+            {
+                throw_npy_error("truncated header");
+            }
+            std::size_t len = 0;
+            for (std::size_t i = len_size; i != 0; --i)
+            {
+                len = (len << 8) | len_bytes[i - 1];
+            }
+            std::string dict(len, ' ');
+            if (!in.read(&dict[0], static_cast<std::streamsize>(len)))
+            {
+                throw_npy_error("truncated header");
+            }
+
+            npy_header res;
+            std::string descr = npy_dict_value(dict, "descr");
+            res.descr = descr.substr(1, descr.size() - 2);
+            res.fortran_order = npy_dict_value(dict, "fortran_order") == "True";
+            std::string shape = npy_dict_value(dict, "shape");
+            for (std::size_t pos = 1; pos < shape.size() - 1;)
+            {
+                std::size_t next;
+                res.shape.push_back(static_cast<std::size_t>(std::stoull(shape.substr(pos), &next)));
+                pos = shape.find_first_of("0123456789", pos + next);
+            }
+            return res;
+        }
+
+        template <class T>
+        inline void check_npy_descr(const std::string& descr)
+        {
+            std::string expected = npy_descr<T>();
+            bool same_order = descr[0] == expected[0] || descr[0] == '=' || sizeof(T) == 1;
+            if (descr.size() != expected.size() || !same_order || descr.compare(1, std::string::npos, expected, 1, std::string::npos) != 0)
+            {
+                throw_npy_error("cannot read elements of type " + descr + " as " + expected);
+            }
+        }
+
+        // Returns true if the strides describe contiguous row_major or
+        // column_major storage of all the elements of the container. The
+        // strides of dimensions of length one are ignored since they are
+        // set to zero by xarray_base.
+        template <class S, class ST>
+        inline bool npy_contiguous(const S& shape, const ST& strides, std::size_t size, bool& fortran_order)
+        {
+            auto check = [&shape, &strides](std::size_t i, std::size_t& expected) {
+                bool res = shape[i] == 1 || strides[i] == expected;
+                expected *= shape[i];
+                return res;
+            };
+            if (data_size(shape) != size)
+            {
+                return false;
+            }
+            std::size_t expected = 1;
+            bool row_major = true;
+            for (std::size_t i = shape.size(); i != 0 && row_major; --i)
+            {
+                row_major = check(i - 1, expected);
+            }
+            if (row_major)
+            {
+                fortran_order = false;
+                return true;
+            }
+            expected = 1;
+            for (std::size_t i = 0; i < shape.size(); ++i)
+            {
+                if (!check(i, expected))
+                {
+                    return false;
+                }
+            }
+            fortran_order = true;
+            return true;
+        }
+
+        // Calls f with the npy header and the elements of e, evaluating e
+        // in a row_major xarray when its storage is not contiguous.
+
+        template <class E, class F>
+        inline void npy_buffer(const xexpression<E>& e, F&& f, std::false_type)
+        {
+            using value_type = std::remove_const_t<typename E::value_type>;
+            xarray<value_type> tmp = e;
+            const char* data = reinterpret_cast<const char*>(tmp.data().data());
+            f(make_npy_header(npy_descr<value_type>(), false, tmp.shape()), data, tmp.size() * sizeof(value_type));
+        }
+
+        template <class E, class F>
+        inline void npy_buffer(const xexpression<E>& e, F&& f, std::true_type)
+        {
+            using value_type = std::remove_const_t<typename E::value_type>;
+            const E& a = e.derived_cast();
+            bool fortran_order = false;
+            if (npy_contiguous(a.shape(), a.strides(), a.data().size(), fortran_order))
+            {
+                const char* data = reinterpret_cast<const char*>(a.data().data());
+                f(make_npy_header(npy_descr<value_type>(), fortran_order, a.shape()), data, a.data().size() * sizeof(value_type));
+            }
+            else
+            {
+                npy_buffer(e, std::forward<F>(f), std::false_type());
+            }
+        }
+
+        template <class D>
+        std::true_type has_npy_storage(const xarray_base<D>*);
+
+        std::false_type has_npy_storage(...);
+
+        template <class E, class F>
+        inline void npy_buffer(const xexpression<E>& e, F&& f)
+        {
+            npy_buffer(e, std::forward<F>(f), decltype(has_npy_storage(std::declval<const E*>()))());
+        }
+
+        template <class D>
+        inline void read_npy_data(std::istream& in, const npy_header& header, xarray_base<D>& a)
+        {
+            using value_type = typename D::value_type;
+            using shape_type = typename D::shape_type;
+            check_npy_descr<value_type>(header.descr);
+            shape_type shape = make_sequence<shape_type>(header.shape.size(), 0);
+            if (!resize_container(shape, header.shape.size()))
+            {
+                throw_npy_error("cannot read an array of dimension " + std::to_string(header.shape.size()) +
+                                " in a container of dimension " + std::to_string(shape.size()));
+            }
+            std::copy(header.shape.begin(), header.shape.end(), shape.begin());
+            a.reshape(shape, header.fortran_order ? layout::column_major : layout::row_major);
+            std::streamsize size = static_cast<std::streamsize>(a.size() * sizeof(value_type));
+            if (size != 0 && !in.read(reinterpret_cast<char*>(a.data().data()), size))
+            {
+                throw_npy_error("truncated data");
+            }
+        }
+
+        inline std::ifstream open_npy_input(const std::string& path)
+        {
+            std::ifstream in(path, std::ios::in | std::ios::binary);
+            if (!in)
+            {
+                throw_npy_error("cannot open " + path);
+            }
+            return in;
+        }
+    }
+
+    /**********************
+     * npy implementation *
+     **********************/
+
+    /**
+     * @ingroup xnpy
+     * Loads an xarray from an npy stream. The xarray has the layout
+     * recorded in the header.
+     * @param in the binary input stream
+     * @tparam T the type of the elements, which must match the type
+     * stored in the stream.
+     * @throw std::runtime_error if the stream is not a valid npy stream
+     * of elements of type T.
+     */
+    template <class T>
+    inline xarray<T> load_npy(std::istream& in)
+    {
+        xarray<T> res;
+        load_npy(in, res);
+        return res;
+    }
+
+    /**
+     * @ingroup xnpy
+     * Loads an xarray from the npy file \c path.
+     * @see load_npy(std::istream&)
+     */
+    template <class T>
+    inline xarray<T> load_npy(const std::string& path)
+    {
+        std::ifstream in = detail::open_npy_input(path);
+        return load_npy<T>(in);
+    }
+
+    /**
+     * @ingroup xnpy
+     * Reads an npy stream into the storage of an existing container,
+     * which is reshaped to the shape and layout recorded in the header.
+     * @param in the binary input stream
+     * @param a the container, e.g. an xarray, an xtensor of the same
+     * dimension or an xarray_adaptor.
+     * @throw std::runtime_error if the stream is not a valid npy stream
+     * of elements of the value type of the container.
+     */
+    template <class D>
+    inline void load_npy(std::istream& in, xarray_base<D>& a)
+    {
+        detail::read_npy_data(in, detail::read_npy_header(in), a);
+    }
+
+    /**
+     * @ingroup xnpy
+     * Reads the npy file \c path into the storage of an existing container.
+     * @see load_npy(std::istream&, xarray_base<D>&)
+     */
+    template <class D>
+    inline void load_npy(const std::string& path, xarray_base<D>& a)
+    {
+        std::ifstream in = detail::open_npy_input(path);
+        load_npy(in, a);
+    }
+
+    /**
+     * @ingroup xnpy
+     * Writes an expression to an npy stream.
+     * @param out the binary output stream
+     * @param e the expression to write
+     * @throw std::runtime_error if the stream cannot be written.
+     */
+    template <class E>
+    inline void dump_npy(std::ostream& out, const xexpression<E>& e)
+    {
+        detail::npy_buffer(e, [&out](const std::string& header, const char* data, std::size_t size) {
+            out.write(header.data(), static_cast<std::streamsize>(header.size()));
+            out.write(data, static_cast<std::streamsize>(size));
+        });
+        if (!out)
+        {
+            detail::throw_npy_error("cannot write the array");
+        }
+    }
+
+    /**
+     * @ingroup xnpy
+     * Writes an expression to the npy file \c path, which is overwritten.
+     * @see dump_npy(std::ostream&, const xexpression<E>&)
+     */
+    template <class E>
+    inline void dump_npy(const std::string& path, const xexpression<E>& e)
+    {
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            detail::throw_npy_error("cannot open " + path);
+        }
+        dump_npy(out, e);
+    }
+
+    /**********************
+     * npz implementation *
+     **********************/
+
+    namespace detail
+    {
+        inline std::uint32_t crc32(std::uint32_t crc, const char* data, std::size_t size) noexcept
+        {
+            static const std::vector<std::uint32_t> table = [] {
+                std::vector<std::uint32_t> res(256);
+                for (std::uint32_t i = 0; i < 256; ++i)
+                {
+                    std::uint32_t c = i;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                    }
+                    res[i] = c;
+                }
+                return res;
+            }();
+            crc = ~crc;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+            }
+            return ~crc;
+        }
+
+        inline void zip_put(std::string& buf, std::uint64_t value, std::size_t bytes)
+        {
+            for (std::size_t i = 0; i < bytes; ++i)
+            {
+                buf += static_cast<char>((value >> (8 * i)) & 0xff);
+            }
+        }
+
+        inline std::uint64_t zip_get(const char* buf, std::size_t bytes)
+        {
+            std::uint64_t res = 0;
+            for (std::size_t i = bytes; i != 0; --i)
+            {
+                res = (res << 8) | static_cast<unsigned char>(buf[i - 1]);
+            }
+            return res;
+        }
+
+        struct zip_entry
+        {
+            std::string name;
+            std::uint16_t method;
+            std::uint64_t size;
+            std::uint64_t offset;
+            std::string record;
+        };
+
+        struct zip_directory
+        {
+            std::vector<zip_entry> entries;
+            std::uint64_t offset;
+        };
+
+        [[noreturn]] inline void throw_npz_error(const std::string& what)
+        {
+            throw std::runtime_error("npz: " + what);
+        }
+
+        inline std::string zip_read(std::istream& in, std::uint64_t offset, std::size_t size)
+        {
+            std::string res(size, '\0');
+            in.seekg(static_cast<std::streamoff>(offset));
+            if (size != 0 && !in.read(&res[0], static_cast<std::streamsize>(size)))
+            {
+                throw_npz_error("truncated archive");
+            }
+            return res;
+        }
+
+        // Reads the central directory of a zip archive, following the
+        // zip64 records written by numpy.savez for large archives.
+        inline zip_directory read_zip_directory(std::istream& in)
+        {
+            in.seekg(0, std::ios::end);
+            std::uint64_t file_size = static_cast<std::uint64_t>(in.tellg());
+            std::size_t tail_size = static_cast<std::size_t>(std::min<std::uint64_t>(file_size, 65535 + 22));
+            std::string tail = zip_read(in, file_size - tail_size, tail_size);
+            std::size_t eocd = tail.rfind(std::string("PK\x05\x06", 4));
+            if (eocd == std::string::npos || eocd + 22 > tail.size())
+            {
+                throw_npz_error("not a zip archive");
+            }
+            const char* rec = tail.data() + eocd;
+            std::uint64_t count = zip_get(rec + 10, 2);
+            std::uint64_t dir_size = zip_get(rec + 12, 4);
+            std::uint64_t dir_offset = zip_get(rec + 16, 4);
+            if (count == 0xffff || dir_size == 0xffffffff || dir_offset == 0xffffffff)
+            {
+                if (eocd < 20 || tail.compare(eocd - 20, 4, std::string("PK\x06\x07", 4)) != 0)
+                {
+                    throw_npz_error("missing zip64 end of central directory locator");
+                }
+                std::uint64_t eocd64_offset = zip_get(tail.data() + eocd - 12, 8);
+                std::string eocd64 = zip_read(in, eocd64_offset, 56);
+                if (eocd64.compare(0, 4, std::string("PK\x06\x06", 4)) != 0)
+                {
+                    throw_npz_error("invalid zip64 end of central directory");
+                }
+                count = zip_get(eocd64.data() + 32, 8);
+                dir_size = zip_get(eocd64.data() + 40, 8);
+                dir_offset = zip_get(eocd64.data() + 48, 8);
+            }
+
+            zip_directory res;
+            res.offset = dir_offset;
+            std::string dir = zip_read(in, dir_offset, static_cast<std::size_t>(dir_size));
+            std::size_t pos = 0;
+            for (std::uint64_t i = 0; i < count; ++i)
+            {
+                if (pos + 46 > dir.size() || dir.compare(pos, 4, std::string("PK\x01\x02", 4)) != 0)
+                {
+                    throw_npz_error("invalid central directory");
+                }
+                const char* h = dir.data() + pos;
+                std::size_t name_len = static_cast<std::size_t>(zip_get(h + 28, 2));
+                std::size_t extra_len = static_cast<std::size_t>(zip_get(h + 30, 2));
+                std::size_t comment_len = static_cast<std::size_t>(zip_get(h + 32, 2));
+                std::size_t record_len = 46 + name_len + extra_len + comment_len;
+                if (pos + record_len > dir.size())
+                {
+                    throw_npz_error("invalid central directory");
+                }
+                zip_entry entry;
+                entry.name = dir.substr(pos + 46, name_len);
+                entry.method = static_cast<std::uint16_t>(zip_get(h + 10, 2));
+                entry.size = zip_get(h + 24, 4);
+                std::uint64_t compressed_size = zip_get(h + 20, 4);
+                entry.offset = zip_get(h + 42, 4);
+                entry.record = dir.substr(pos, record_len);
+
+                // The zip64 extra field only holds the values that
+                // overflow the central directory record, in this order.
+                const char* extra = h + 46 + name_len;
+                for (std::size_t e = 0; e + 4 <= extra_len;)
+                {
+                    std::size_t id = static_cast<std::size_t>(zip_get(extra + e, 2));
+                    std::size_t len = static_cast<std::size_t>(zip_get(extra + e + 2, 2));
+                    if (id == 1)
+                    {
+                        const char* field = extra + e + 4;
+                        for (std::uint64_t* value : { &entry.size, &compressed_size, &entry.offset })
+                        {
+                            if (*value == 0xffffffff && field + 8 <= extra + e + 4 + len)
+                            {
+                                *value = zip_get(field, 8);
+                                field += 8;
+                            }
+                        }
+                    }
+                    e += 4 + len;
+                }
+                res.entries.push_back(std::move(entry));
+                pos += record_len;
+            }
+            return res;
+        }
+
+        // Positions the stream on the npy data of the entry \c name of the
+        // archive; the ".npy" suffix added by numpy.savez may be omitted.
+        inline void seek_npz_entry(std::istream& in, const std::string& name)
+        {
+            zip_directory dir = read_zip_directory(in);
+            for (const zip_entry& entry : dir.entries)
+            {
+                if (entry.name == name || entry.name == name + ".npy")
+                {
+                    if (entry.method != 0)
+                    {
+                        throw_npz_error("entry " + name + " is compressed, which is not supported");
+                    }
+                    std::string local = zip_read(in, entry.offset, 30);
+                    if (local.compare(0, 4, std::string("PK\x03\x04", 4)) != 0)
+                    {
+                        throw_npz_error("invalid local header for " + name);
+                    }
+                    std::uint64_t data_offset = entry.offset + 30 + zip_get(local.data() + 26, 2) + zip_get(local.data() + 28, 2);
+                    in.seekg(static_cast<std::streamoff>(data_offset));
+                    return;
+                }
+            }
+            throw_npz_error("no entry " + name + " in archive");
+        }
+
+        inline std::string zip_record(std::uint32_t signature, bool central, const std::string& name,
+                                      std::uint32_t crc, std::uint64_t size, std::uint64_t offset)
+        {
+            std::string res;
+            zip_put(res, signature, 4);
+            if (central)
+            {
+                zip_put(res, 20, 2); // version made by
+            }
+            zip_put(res, 20, 2);     // version needed to extract
+            zip_put(res, 0, 2);      // flags
+            zip_put(res, 0, 2);      // stored, no compression
+            zip_put(res, 0, 2);      // modification time
+            zip_put(res, 0x21, 2);   // modification date, 1980-01-01
+            zip_put(res, crc, 4);
+            zip_put(res, size, 4);   // compressed size
+            zip_put(res, size, 4);   // uncompressed size
+            zip_put(res, name.size(), 2);
+            zip_put(res, 0, 2);      // extra field length
+            if (central)
+            {
+                zip_put(res, 0, 2);  // comment length
+                zip_put(res, 0, 2);  // disk number
+                zip_put(res, 0, 2);  // internal attributes
+                zip_put(res, 0, 4);  // external attributes
+                zip_put(res, offset, 4);
+            }
+            return res + name;
+        }
+    }
+
+    /**
+     * @ingroup xnpy
+     * Loads the array \c name of the npz archive \c path in an xarray.
+     * @param path the path of the archive
+     * @param name the name of the array, with or without the .npy suffix
+     * @throw std::runtime_error if the archive has no uncompressed entry
+     * \c name holding elements of type T.
+     */
+    template <class T>
+    inline xarray<T> load_npz(const std::string& path, const std::string& name)
+    {
+        xarray<T> res;
+        load_npz(path, name, res);
+        return res;
+    }
+
+    /**
+     * @ingroup xnpy
+     * Reads the array \c name of the npz archive \c path into the storage
+     * of an existing container.
+     * @see load_npy(std::istream&, xarray_base<D>&)
+     */
+    template <class D>
+    inline void load_npz(const std::string& path, const std::string& name, xarray_base<D>& a)
+    {
+        std::ifstream in = detail::open_npy_input(path);
+        detail::seek_npz_entry(in, name);
+        load_npy(in, a);
+    }
+
+    /**
+     * @ingroup xnpy
+     * Writes an expression as the uncompressed entry \c name of the npz
+     * archive \c path. The archive is overwritten unless \c append is true,
+     * in which case the entry is added to the existing archive.
+     * @param path the path of the archive
+     * @param name the name of the array; the .npy suffix is appended as
+     * numpy.savez does.
+     * @param e the expression to write
+     * @param append whether the entry is added to an existing archive
+     * @throw std::runtime_error if the archive cannot be written, if it
+     * already holds an entry \c name, or if it would exceed 4 GiB, which
+     * requires zip64 records.
+     */
+    template <class E>
+    inline void dump_npz(const std::string& path, const std::string& name, const xexpression<E>& e, bool append)
+    {
+        std::string entry_name = name + ".npy";
+        detail::zip_directory dir;
+        dir.offset = 0;
+        std::fstream out;
+        if (append)
+        {
+            out.open(path, std::ios::in | std::ios::out | std::ios::binary);
+            if (!out)
+            {
+                detail::throw_npz_error("cannot open " + path);
+            }
+            dir = detail::read_zip_directory(out);
+            for (const detail::zip_entry& entry : dir.entries)
+            {
+                if (entry.name == entry_name)
+                {
+                    detail::throw_npz_error("entry " + name + " already exists in " + path);
+                }
+            }
+        }
+        else
+        {
+            out.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                detail::throw_npz_error("cannot open " + path);
+            }
+        }
+
+        detail::npy_buffer(e, [&](const std::string& header, const char* data, std::size_t size) {
+            std::uint64_t entry_size = header.size() + size;
+            if (dir.offset + entry_size > 0xfffffffful)
+            {
+                detail::throw_npz_error("archives larger than 4 GiB are not supported");
+            }
+            std::uint32_t crc = detail::crc32(detail::crc32(0, header.data(), header.size()), data, size);
+
+            // The new entry overwrites the central directory, which is
+            // written again after it.
+            out.seekp(static_cast<std::streamoff>(dir.offset));
+            std::string local = detail::zip_record(0x04034b50, false, entry_name, crc, entry_size, 0);
+            out.write(local.data(), static_cast<std::streamsize>(local.size()));
+            out.write(header.data(), static_cast<std::streamsize>(header.size()));
+            out.write(data, static_cast<std::streamsize>(size));
+
+            std::string central;
+            for (const detail::zip_entry& entry : dir.entries)
+            {
+                central += entry.record;
+            }
+            central += detail::zip_record(0x02014b50, true, entry_name, crc, entry_size, dir.offset);
+            std::uint64_t central_offset = dir.offset + local.size() + entry_size;
+
+            std::string eocd;
+            detail::zip_put(eocd, 0x06054b50, 4);
+            detail::zip_put(eocd, 0, 4); // disk numbers
+            detail::zip_put(eocd, dir.entries.size() + 1, 2);
+            detail::zip_put(eocd, dir.entries.size() + 1, 2);
+            detail::zip_put(eocd, central.size(), 4);
+            detail::zip_put(eocd, central_offset, 4);
+            detail::zip_put(eocd, 0, 2); // comment length
+            out.write(central.data(), static_cast<std::streamsize>(central.size()));
+            out.write(eocd.data(), static_cast<std::streamsize>(eocd.size()));
+        });
+        if (!out)
+        {
+            detail::throw_npz_error("cannot write " + path);
+        }
+    }
+}
+
+#endif
@@ -30,10 +30,104 @@ namespace xt
         {
             return +t;
         }
+
+        template <class B>
+        constexpr B simd_apply(const B& b) const
+        {
+            return b;
+        }
     };
 
     namespace detail
     {
+        // Counterparts of the functors of <functional> that can also be
+        // applied to batches of elements, see xbatch.hpp.
+
+        template <class T>
+        struct negate
+        {
+            using result_type = T;
+
+            constexpr T operator()(const T& t) const
+            {
+                return -t;
+            }
+
+            template <class B>
+            constexpr B simd_apply(const B& b) const
+            {
+                return -b;
+            }
+        };
+
+        template <class T>
+        struct plus
+        {
+            using result_type = T;
+
+            constexpr T operator()(const T& t1, const T& t2) const
+            {
+                return t1 + t2;
+            }
+
+            template <class B>
+            constexpr B simd_apply(const B& b1, const B& b2) const
+            {
+                return b1 + b2;
+            }
+        };
+
+        template <class T>
+        struct minus
+        {
+            using result_type = T;
+
+            constexpr T operator()(const T& t1, const T& t2) const
+            {
+                return t1 - t2;
+            }
+
+            template <class B>
+            constexpr B simd_apply(const B& b1, const B& b2) const
+            {
+                return b1 - b2;
+            }
+        };
+
+        template <class T>
+        struct multiplies
+        {
+            using result_type = T;
+
+            constexpr T operator()(const T& t1, const T& t2) const
+            {
+                return t1 * t2;
+            }
+
+            template <class B>
+            constexpr B simd_apply(const B& b1, const B& b2) const
+            {
+                return b1 * b2;
+            }
+        };
+
+        template <class T>
+        struct divides
+        {
+            using result_type = T;
+
+            constexpr T operator()(const T& t1, const T& t2) const
+            {
+                return t1 / t2;
+            }
+
+            template <class B>
+            constexpr B simd_apply(const B& b1, const B& b2) const
+            {
+                return b1 / b2;
+            }
+        };
+
         template <template <class...> class F, class... E>
         inline auto make_xfunction(const E&... e) noexcept
         {
@@ -63,35 +157,35 @@ namespace xt
     template <class E>
     inline auto operator-(const xexpression<E>& e) noexcept
     {
-        return detail::make_xfunction<std::negate>(e.derived_cast());
+        return detail::make_xfunction<detail::negate>(e.derived_cast());
     }
 
     template <class E1, class E2>
     inline auto operator+(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_type<std::plus, E1, E2>
+        -> detail::get_xfunction_type<detail::plus, E1, E2>
     {
-        return detail::make_xfunction<std::plus>(e1, e2);
+        return detail::make_xfunction<detail::plus>(e1, e2);
     }
 
     template <class E1, class E2>
     inline auto operator-(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_type<std::minus, E1, E2>
+        -> detail::get_xfunction_type<detail::minus, E1, E2>
     {
-        return detail::make_xfunction<std::minus>(e1, e2);
+        return detail::make_xfunction<detail::minus>(e1, e2);
     }
 
     template <class E1, class E2>
     inline auto operator*(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_type<std::multiplies, E1, E2>
+        -> detail::get_xfunction_type<detail::multiplies, E1, E2>
     {
-        return detail::make_xfunction<std::multiplies>(e1, e2);
+        return detail::make_xfunction<detail::multiplies>(e1, e2);
     }
 
     template <class E1, class E2>
     inline auto operator/(const E1& e1, const E2& e2) noexcept
-        -> detail::get_xfunction_type<std::divides, E1, E2>
+        -> detail::get_xfunction_type<detail::divides, E1, E2>
     {
-        return detail::make_xfunction<std::divides>(e1, e2);
+        return detail::make_xfunction<detail::divides>(e1, e2);
     }
 }
 
@@ -0,0 +1,569 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XPARALLEL_HPP
+#define XPARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace xt
+{
+
+    /*************************
+     * xexecutor declaration *
+     *************************/
+
+    /**
+     * @class xexecutor
+     * @brief Interface of the executors running the parallel loops of xtensor.
+     *
+     * Parallel assignments split their work into chunks and hand them to
+     * an executor as a loop of independent tasks. Implementing this
+     * interface lets xtensor run these tasks on an existing scheduler
+     * instead of starting its own threads.
+     *
+     * parallel_for must call the task once for each index and return once
+     * all the calls have returned. If a call throws, the remaining tasks
+     * may be skipped and the first exception must be rethrown to the caller.
+     */
+    class xexecutor
+    {
+
+    public:
+
+        using task_type = std::function<void(std::size_t)>;
+
+        virtual ~xexecutor() = default;
+
+        /// Number of tasks the executor can run concurrently.
+        virtual std::size_t concurrency() const noexcept = 0;
+
+        /// Calls \c task(i) for each \c i in <tt>[0, task_count)</tt>.
+        virtual void parallel_for(std::size_t task_count, const task_type& task) = 0;
+    };
+
+    /********************************
+     * xserial_executor declaration *
+     ********************************/
+
+    /**
+     * @class xserial_executor
+     * @brief Executor running the tasks in order on the calling thread.
+     */
+    class xserial_executor : public xexecutor
+    {
+
+    public:
+
+        std::size_t concurrency() const noexcept override;
+        void parallel_for(std::size_t task_count, const task_type& task) override;
+    };
+
+    /****************************
+     * xthread_pool declaration *
+     ****************************/
+
+    /**
+     * @class xthread_pool
+     * @brief Work-stealing pool of threads.
+     *
+     * The tasks of a loop are split into contiguous ranges, one per
+     * thread, the calling thread included. Each thread runs the tasks
+     * of its range in order; a thread whose range is exhausted steals
+     * the second half of the range of another thread, so that threads
+     * finishing early take over the work of the slower ones.
+     *
+     * A pool runs one loop at a time: a loop started while the pool is
+     * busy, or from inside a task, runs on the calling thread.
+     */
+    class xthread_pool : public xexecutor
+    {
+
+    public:
+
+        explicit xthread_pool(std::size_t num_threads = std::thread::hardware_concurrency());
+        ~xthread_pool() override;
+
+        xthread_pool(const xthread_pool&) = delete;
+        xthread_pool& operator=(const xthread_pool&) = delete;
+
+        xthread_pool(xthread_pool&&) = delete;
+        xthread_pool& operator=(xthread_pool&&) = delete;
+
+        std::size_t concurrency() const noexcept override;
+        void parallel_for(std::size_t task_count, const task_type& task) override;
+
+    private:
+
+        struct task_range
+        {
+            std::mutex m_mutex;
+            std::size_t m_first = 0;
+            std::size_t m_last = 0;
+        };
+
+        std::vector<std::thread> m_workers;
+        std::vector<task_range> m_ranges;
+
+        std::mutex m_loop_mutex;
+        std::mutex m_mutex;
+        std::condition_variable m_start;
+        std::condition_variable m_done;
+
+        const task_type* p_task;
+        std::size_t m_generation;
+        std::size_t m_busy_workers;
+        std::exception_ptr m_exception;
+        std::atomic<bool> m_cancelled;
+        bool m_stop;
+
+        void work(std::size_t index);
+        void run_tasks(std::size_t index) noexcept;
+        bool pop_task(std::size_t index, std::size_t& task) noexcept;
+        bool steal_tasks(std::size_t index) noexcept;
+
+        static bool& in_task() noexcept;
+    };
+
+#if defined(_OPENMP)
+    /********************************
+     * xopenmp_executor declaration *
+     ********************************/
+
+    /**
+     * @class xopenmp_executor
+     * @brief Executor running the tasks in OpenMP parallel regions.
+     *
+     * Only available when compiling with OpenMP enabled.
+     */
+    class xopenmp_executor : public xexecutor
+    {
+
+    public:
+
+        explicit xopenmp_executor(std::size_t num_threads = 0);
+
+        std::size_t concurrency() const noexcept override;
+        void parallel_for(std::size_t task_count, const task_type& task) override;
+
+    private:
+
+        int m_num_threads;
+    };
+#endif
+
+    template <class F>
+    void parallel_chunks(xexecutor& executor, std::size_t size, std::size_t alignment, F&& f);
+
+    /*********************************
+     * Parallel settings declaration *
+     *********************************/
+
+    /// Default number of elements below which evaluation remains serial.
+    constexpr std::size_t default_parallel_threshold = std::size_t(1) << 16;
+
+    void set_default_executor(xexecutor* executor) noexcept;
+    xexecutor* default_executor() noexcept;
+
+    void set_parallel_threshold(std::size_t threshold) noexcept;
+    std::size_t parallel_threshold() noexcept;
+
+    void enable_parallel_assign(std::size_t num_threads = std::thread::hardware_concurrency(),
+                                std::size_t threshold = default_parallel_threshold);
+    void disable_parallel_assign();
+
+    /***********************************
+     * xserial_executor implementation *
+     ***********************************/
+
+    inline std::size_t xserial_executor::concurrency() const noexcept
+    {
+        return 1;
+    }
+
+    inline void xserial_executor::parallel_for(std::size_t task_count, const task_type& task)
+    {
+        for(std::size_t i = 0; i < task_count; ++i)
+        {
+            task(i);
+        }
+    }
+
+    /*******************************
+     * xthread_pool implementation *
+     *******************************/
+
+    /**
+     * Builds a pool running its loops on \c num_threads threads, the
+     * calling thread included. A pool of zero or one thread runs its
+     * loops on the calling thread only.
+     */
+    inline xthread_pool::xthread_pool(std::size_t num_threads)
+        : m_ranges(std::max(num_threads, std::size_t(1))), p_task(nullptr),
+          m_generation(0), m_busy_workers(0), m_cancelled(false), m_stop(false)
+    {
+        m_workers.reserve(m_ranges.size() - 1);
+        for(std::size_t i = 1; i < m_ranges.size(); ++i)
+        {
+            m_workers.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+    inline xthread_pool::~xthread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for(auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * Returns the number of threads running the loops, the calling
+     * thread included.
+     */
+    inline std::size_t xthread_pool::concurrency() const noexcept
+    {
+        return m_ranges.size();
+    }
+
+    inline void xthread_pool::parallel_for(std::size_t task_count, const task_type& task)
+    {
+        std::unique_lock<std::mutex> loop_lock(m_loop_mutex, std::defer_lock);
+        if(task_count < 2 || m_workers.empty() || in_task() || !loop_lock.try_lock())
+        {
+            for(std::size_t i = 0; i < task_count; ++i)
+            {
+                task(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::size_t thread_count = m_ranges.size();
+            for(std::size_t i = 0; i < thread_count; ++i)
+            {
+                std::lock_guard<std::mutex> range_lock(m_ranges[i].m_mutex);
+                m_ranges[i].m_first = task_count * i / thread_count;
+                m_ranges[i].m_last = task_count * (i + 1) / thread_count;
+            }
+            p_task = &task;
+            m_exception = nullptr;
+            m_cancelled = false;
+            m_busy_workers = m_workers.size();
+            ++m_generation;
+        }
+        m_start.notify_all();
+        run_tasks(0);
+
+        std::exception_ptr exception;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this]() { return m_busy_workers == 0; });
+            p_task = nullptr;
+            exception = m_exception;
+            m_exception = nullptr;
+        }
+        if(exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    inline void xthread_pool::work(std::size_t index)
+    {
+        std::size_t generation = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(true)
+        {
+            m_start.wait(lock, [this, generation]() { return m_stop || m_generation != generation; });
+            if(m_stop)
+            {
+                return;
+            }
+            generation = m_generation;
+            lock.unlock();
+            run_tasks(index);
+            lock.lock();
+            if(--m_busy_workers == 0)
+            {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    inline void xthread_pool::run_tasks(std::size_t index) noexcept
+    {
+        bool& inside = in_task();
+        inside = true;
+        std::size_t i = 0;
+        while(!m_cancelled)
+        {
+            if(!pop_task(index, i))
+            {
+                if(!steal_tasks(index))
+                {
+                    break;
+                }
+                continue;
+            }
+            try
+            {
+                (*p_task)(i);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(!m_exception)
+                {
+                    m_exception = std::current_exception();
+                }
+                m_cancelled = true;
+            }
+        }
+        inside = false;
+    }
+
+    inline bool xthread_pool::pop_task(std::size_t index, std::size_t& task) noexcept
+    {
+        task_range& range = m_ranges[index];
+        std::lock_guard<std::mutex> lock(range.m_mutex);
+        if(range.m_first == range.m_last)
+        {
+            return false;
+        }
+        task = range.m_first++;
+        return true;
+    }
+
+    // Moves the second half of the first non empty range found after
+    // the one of the thread to the range of the thread; returns false
+    // if all the ranges are empty.
+    inline bool xthread_pool::steal_tasks(std::size_t index) noexcept
+    {
+        std::size_t thread_count = m_ranges.size();
+        for(std::size_t k = 1; k < thread_count; ++k)
+        {
+            task_range& victim = m_ranges[(index + k) % thread_count];
+            std::size_t first, last;
+            {
+                std::lock_guard<std::mutex> lock(victim.m_mutex);
+                std::size_t remaining = victim.m_last - victim.m_first;
+                if(remaining == 0)
+                {
+                    continue;
+                }
+                last = victim.m_last;
+                first = last - (remaining + 1) / 2;
+                victim.m_last = first;
+            }
+            task_range& range = m_ranges[index];
+            std::lock_guard<std::mutex> lock(range.m_mutex);
+            range.m_first = first;
+            range.m_last = last;
+            return true;
+        }
+        return false;
+    }
+
+    inline bool& xthread_pool::in_task() noexcept
+    {
+        static thread_local bool inside = false;
+        return inside;
+    }
+
+#if defined(_OPENMP)
+    /***********************************
+     * xopenmp_executor implementation *
+     ***********************************/
+
+    /**
+     * Builds an executor running its loops on \c num_threads OpenMP
+     * threads, or on the default number of OpenMP threads if
+     * \c num_threads is 0.
+     */
+    inline xopenmp_executor::xopenmp_executor(std::size_t num_threads)
+        : m_num_threads(num_threads == 0 ? omp_get_max_threads() : static_cast<int>(num_threads))
+    {
+    }
+
+    inline std::size_t xopenmp_executor::concurrency() const noexcept
+    {
+        return static_cast<std::size_t>(m_num_threads);
+    }
+
+    inline void xopenmp_executor::parallel_for(std::size_t task_count, const task_type& task)
+    {
+        // Exceptions must not leave a parallel region: the first one is
+        // kept and rethrown once the region has completed.
+        std::exception_ptr exception;
+        std::atomic<bool> cancelled(false);
+        std::ptrdiff_t count = static_cast<std::ptrdiff_t>(task_count);
+#pragma omp parallel for schedule(dynamic) num_threads(m_num_threads)
+        for(std::ptrdiff_t i = 0; i < count; ++i)
+        {
+            if(!cancelled)
+            {
+                try
+                {
+                    task(static_cast<std::size_t>(i));
+                }
+                catch(...)
+                {
+#pragma omp critical(xtensor_executor_exception)
+                    {
+                        if(!exception)
+                        {
+                            exception = std::current_exception();
+                        }
+                    }
+                    cancelled = true;
+                }
+            }
+        }
+        if(exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+#endif
+
+    /**
+     * Splits <tt>[0, size)</tt> into contiguous chunks and calls
+     * \c f(first, last) on each of them through \c executor. The bounds
+     * of the chunks are multiples of \c alignment, except the end of the
+     * last chunk. A few chunks per thread are made so that threads
+     * finishing early can pick the remaining work.
+     */
+    template <class F>
+    inline void parallel_chunks(xexecutor& executor, std::size_t size, std::size_t alignment, F&& f)
+    {
+        std::size_t units = (size + alignment - 1) / alignment;
+        std::size_t chunk_count = std::min(units, 4 * executor.concurrency());
+        executor.parallel_for(chunk_count, [&f, size, alignment, units, chunk_count](std::size_t i) {
+            std::size_t first = units * i / chunk_count * alignment;
+            std::size_t last = std::min(size, units * (i + 1) / chunk_count * alignment);
+            f(first, last);
+        });
+    }
+
+    /************************************
+     * Parallel settings implementation *
+     ************************************/
+
+    namespace detail
+    {
+        struct parallel_settings
+        {
+            std::unique_ptr<xexecutor> p_owned_executor;
+            xexecutor* p_executor = nullptr;
+            std::size_t m_threshold = default_parallel_threshold;
+        };
+
+        inline parallel_settings& parallel_settings_ref() noexcept
+        {
+            static parallel_settings settings;
+            return settings;
+        }
+
+        // Returns true if the evaluation of size elements should be
+        // dispatched to executor.
+        inline bool use_executor(const xexecutor* executor, std::size_t size) noexcept
+        {
+            return executor != nullptr && executor->concurrency() > 1 && size >= parallel_threshold();
+        }
+    }
+
+    /**
+     * Sets the executor running the parallel evaluations of the calls that
+     * do not specify one; a null pointer makes them serial. The executor
+     * is not owned and must outlive its use.
+     *
+     * The parallel settings are global; they must not be changed while
+     * an evaluation is running.
+     */
+    inline void set_default_executor(xexecutor* executor) noexcept
+    {
+        auto& settings = detail::parallel_settings_ref();
+        settings.p_executor = executor;
+        if(settings.p_owned_executor.get() != executor)
+        {
+            settings.p_owned_executor.reset();
+        }
+    }
+
+    /**
+     * Returns the default executor, or a null pointer if evaluation
+     * is serial by default.
+     */
+    inline xexecutor* default_executor() noexcept
+    {
+        return detail::parallel_settings_ref().p_executor;
+    }
+
+    /**
+     * Sets the number of elements below which evaluation remains serial.
+     */
+    inline void set_parallel_threshold(std::size_t threshold) noexcept
+    {
+        detail::parallel_settings_ref().m_threshold = threshold;
+    }
+
+    /**
+     * Returns the number of elements below which evaluation remains serial.
+     */
+    inline std::size_t parallel_threshold() noexcept
+    {
+        return detail::parallel_settings_ref().m_threshold;
+    }
+
+    /**
+     * Makes a pool of \c num_threads threads, the assigning thread
+     * included, the default executor and sets the threshold: assignments
+     * of at least \c threshold elements are then evaluated in parallel.
+     * Assignments whose broadcast is trivial are split along the linear
+     * storage, the others along their outermost dimension.
+     */
+    inline void enable_parallel_assign(std::size_t num_threads, std::size_t threshold)
+    {
+        auto& settings = detail::parallel_settings_ref();
+        std::unique_ptr<xexecutor> pool = std::make_unique<xthread_pool>(num_threads);
+        settings.p_executor = pool.get();
+        settings.p_owned_executor = std::move(pool);
+        settings.m_threshold = threshold;
+    }
+
+    /**
+     * Makes evaluation serial by default and stops the threads started
+     * by enable_parallel_assign.
+     */
+    inline void disable_parallel_assign()
+    {
+        set_default_executor(nullptr);
+    }
+}
+
+#endif
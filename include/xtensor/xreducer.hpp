@@ -0,0 +1,2055 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XREDUCER_HPP
+#define XREDUCER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xbatch.hpp"
+#include "xexpression.hpp"
+#include "xindex.hpp"
+#include "xiterator.hpp"
+#include "xparallel.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /*********************
+     * reducing functors *
+     *********************/
+
+    namespace reducers
+    {
+        // A reducing functor provides the type of the accumulator and of
+        // the result, and four methods:
+        //  - init() returns the initial value of the accumulator;
+        //  - accumulate(acc, v, i) returns the accumulator updated with the
+        //    value v, i being the flat index of v among the reduced elements,
+        //    in row-major order;
+        //  - merge(lhs, rhs) returns the accumulator of the elements of lhs
+        //    followed by those of rhs;
+        //  - result(acc, count) returns the result of the reduction of count
+        //    elements.
+        // Functors whose accumulator type is the value type may also provide
+        // simd_accumulate(lhs, rhs), accumulating or merging batches lane by
+        // lane. The accumulator type A defaults to a type wide enough for the
+        // reduction when void.
+
+        template <class T>
+        using sum_accumulator_t = std::conditional_t<std::is_integral<T>::value,
+                                                     std::conditional_t<std::is_signed<T>::value, long long, unsigned long long>,
+                                                     T>;
+
+        template <class T>
+        using mean_accumulator_t = std::conditional_t<std::is_integral<T>::value, double, T>;
+
+        template <class T, class A>
+        using accumulator_or_t = std::conditional_t<std::is_void<A>::value, T, A>;
+
+        template <class T>
+        inline bool is_nan(const T& v)
+        {
+            return std::isnan(v);
+        }
+
+        template <class T, class A = void>
+        struct sum_fun
+        {
+            using value_type = T;
+            using accumulator_type = accumulator_or_t<sum_accumulator_t<T>, A>;
+            using result_type = accumulator_type;
+
+            accumulator_type init() const
+            {
+                return accumulator_type(0);
+            }
+
+            accumulator_type accumulate(const accumulator_type& acc, const T& v, std::size_t /*index*/) const
+            {
+                return acc + accumulator_type(v);
+            }
+
+            accumulator_type merge(const accumulator_type& lhs, const accumulator_type& rhs) const
+            {
+                return lhs + rhs;
+            }
+
+            template <class B>
+            B simd_accumulate(const B& lhs, const B& rhs) const
+            {
+                return lhs + rhs;
+            }
+
+            result_type result(const accumulator_type& acc, std::size_t /*count*/) const
+            {
+                return acc;
+            }
+        };
+
+        template <class T, class A = void>
+        struct prod_fun
+        {
+            using value_type = T;
+            using accumulator_type = accumulator_or_t<sum_accumulator_t<T>, A>;
+            using result_type = accumulator_type;
+
+            accumulator_type init() const
+            {
+                return accumulator_type(1);
+            }
+
+            accumulator_type accumulate(const accumulator_type& acc, const T& v, std::size_t /*index*/) const
+            {
+                return acc * accumulator_type(v);
+            }
+
+            accumulator_type merge(const accumulator_type& lhs, const accumulator_type& rhs) const
+            {
+                return lhs * rhs;
+            }
+
+            template <class B>
+            B simd_accumulate(const B& lhs, const B& rhs) const
+            {
+                return lhs * rhs;
+            }
+
+            result_type result(const accumulator_type& acc, std::size_t /*count*/) const
+            {
+                return acc;
+            }
+        };
+
+        template <class T, class A = void>
+        struct mean_fun
+        {
+            using value_type = T;
+            using accumulator_type = accumulator_or_t<mean_accumulator_t<T>, A>;
+            using result_type = accumulator_type;
+
+            accumulator_type init() const
+            {
+                return accumulator_type(0);
+            }
+
+            accumulator_type accumulate(const accumulator_type& acc, const T& v, std::size_t /*index*/) const
+            {
+                return acc + accumulator_type(v);
+            }
+
+            accumulator_type merge(const accumulator_type& lhs, const accumulator_type& rhs) const
+            {
+                return lhs + rhs;
+            }
+
+            template <class B>
+            B simd_accumulate(const B& lhs, const B& rhs) const
+            {
+                return lhs + rhs;
+            }
+
+            result_type result(const accumulator_type& acc, std::size_t count) const
+            {
+                return acc / accumulator_type(count);
+            }
+        };
+
+        // The minimum and maximum of no element are the identities of
+        // the comparison, and NaNs propagate to the result.
+
+        template <class T, class A = void>
+        struct amin_fun
+        {
+            using value_type = T;
+            using accumulator_type = accumulator_or_t<T, A>;
+            using result_type = accumulator_type;
+
+            accumulator_type init() const
+            {
+                using limits = std::numeric_limits<accumulator_type>;
+                return limits::has_infinity ? limits::infinity() : (limits::max)();
+            }
+
+            accumulator_type accumulate(const accumulator_type& acc, const T& v, std::size_t /*index*/) const
+            {
+                accumulator_type value(v);
+                return (value < acc || is_nan(value)) ? value : acc;
+            }
+
+            accumulator_type merge(const accumulator_type& lhs, const accumulator_type& rhs) const
+            {
+                return (rhs < lhs || is_nan(rhs)) && !is_nan(lhs) ? rhs : lhs;
+            }
+
+            result_type result(const accumulator_type& acc, std::size_t /*count*/) const
+            {
+                return acc;
+            }
+        };
+
+        template <class T, class A = void>
+        struct amax_fun
+        {
+            using value_type = T;
+            using accumulator_type = accumulator_or_t<T, A>;
+            using result_type = accumulator_type;
+
+            accumulator_type init() const
+            {
+                using limits = std::numeric_limits<accumulator_type>;
+                return limits::has_infinity ? -limits::infinity() : limits::lowest();
+            }
+
+            accumulator_type accumulate(const accumulator_type& acc, const T& v, std::size_t /*index*/) const
+            {
+                accumulator_type value(v);
+                return (acc < value || is_nan(value)) ? value : acc;
+            }
+
+            accumulator_type merge(const accumulator_type& lhs, const accumulator_type& rhs) const
+            {
+                return (lhs < rhs || is_nan(rhs)) && !is_nan(lhs) ? rhs : lhs;
+            }
+
+            result_type result(const accumulator_type& acc, std::size_t /*count*/) const
+            {
+                return acc;
+            }
+        };
+
+        // The index reducers return the flat index of the first extremum
+        // among the reduced elements, or of the first NaN if any.
+
+        template <class T, class A = void>
+        struct argmin_fun
+        {
+            using value_type = T;
+            using compared_type = accumulator_or_t<T, A>;
+            using accumulator_type = std::pair<compared_type, std::size_t>;
+            using result_type = std::size_t;
+
+            accumulator_type init() const
+            {
+                return accumulator_type(amin_fun<T, A>().init(), std::size_t(0));
+            }
+
+            accumulator_type accumulate(const accumulator_type& acc, const T& v, std::size_t index) const
+            {
+                compared_type value(v);
+                bool replace = value < acc.first || (is_nan(value) && !is_nan(acc.first));
+                return replace ? accumulator_type(value, index) : acc;
+            }
+
+            accumulator_type merge(const accumulator_type& lhs, const accumulator_type& rhs) const
+            {
+                bool replace = rhs.first < lhs.first || (is_nan(rhs.first) && !is_nan(lhs.first));
+                return replace ? rhs : lhs;
+            }
+
+            result_type result(const accumulator_type& acc, std::size_t /*count*/) const
+            {
+                return acc.second;
+            }
+        };
+
+        template <class T, class A = void>
+        struct argmax_fun
+        {
+            using value_type = T;
+            using compared_type = accumulator_or_t<T, A>;
+            using accumulator_type = std::pair<compared_type, std::size_t>;
+            using result_type = std::size_t;
+
+            accumulator_type init() const
+            {
+                return accumulator_type(amax_fun<T, A>().init(), std::size_t(0));
+            }
+
+            accumulator_type accumulate(const accumulator_type& acc, const T& v, std::size_t index) const
+            {
+                compared_type value(v);
+                bool replace = acc.first < value || (is_nan(value) && !is_nan(acc.first));
+                return replace ? accumulator_type(value, index) : acc;
+            }
+
+            accumulator_type merge(const accumulator_type& lhs, const accumulator_type& rhs) const
+            {
+                bool replace = lhs.first < rhs.first || (is_nan(rhs.first) && !is_nan(lhs.first));
+                return replace ? rhs : lhs;
+            }
+
+            result_type result(const accumulator_type& acc, std::size_t /*count*/) const
+            {
+                return acc.second;
+            }
+        };
+    }
+
+    /************************
+     * xreducer declaration *
+     ************************/
+
+    template <class F, class E, class X>
+    class xreducer_stepper;
+
+    namespace detail
+    {
+        // Reducing an expression with a fixed-size shape over a fixed
+        // number of axes gives a fixed-size shape.
+        template <class S, class X>
+        struct xreducer_shape_type
+        {
+            using type = xshape<typename S::value_type>;
+        };
+
+        template <class I, std::size_t N, std::size_t K>
+        struct xreducer_shape_type<std::array<I, N>, std::array<std::size_t, K>>
+        {
+            static_assert(K <= N, "cannot reduce more axes than the expression has dimensions");
+            using type = std::array<I, N - K>;
+        };
+
+        // The elements of each reduction are accumulated by blocks of
+        // reduction_block_size elements, in row-major order, and the blocks
+        // are combined pairwise. A block is accumulated from left to right,
+        // unless the reduction is a contiguous range of a storage read by
+        // SIMD batches: it is then accumulated in independent lanes merged
+        // pairwise, followed by the remaining elements from left to right.
+        // The blocks only depend on the shape and the storage of the reduced
+        // expression, so that the result of a reduction depends neither on
+        // how its evaluation is split between threads, nor on whether it is
+        // assigned or accessed element-wise.
+        constexpr std::size_t reduction_block_size = 1024;
+
+        // Number of levels of the pairwise combination of count blocks.
+        inline std::size_t pairwise_depth(std::size_t count) noexcept
+        {
+            std::size_t depth = 0;
+            for(; count != 0; count >>= 1)
+            {
+                ++depth;
+            }
+            return depth;
+        }
+
+        // Pushes the count-th block into the levels of a pairwise combination,
+        // the level l being stored at levels[l * stride]: the block is merged
+        // with the pending levels of the set low bits of count, as in a binary
+        // counter.
+        template <class F, class A>
+        inline void pairwise_push(const F& f, A* levels, std::size_t stride, std::size_t count, A block)
+        {
+            std::size_t level = 0;
+            for(; count & 1; count >>= 1, ++level)
+            {
+                block = f.merge(levels[level * stride], block);
+            }
+            levels[level * stride] = std::move(block);
+        }
+
+        // Combines the pending levels of count pushed blocks, followed by
+        // last if has_last is true.
+        template <class F, class A>
+        inline A pairwise_result(const F& f, const A* levels, std::size_t stride, std::size_t count,
+                                 const A& last, bool has_last)
+        {
+            A res = has_last ? last : f.init();
+            bool empty = !has_last;
+            for(std::size_t level = 0; count != 0; count >>= 1, ++level)
+            {
+                if(count & 1)
+                {
+                    res = empty ? levels[level * stride] : f.merge(levels[level * stride], res);
+                    empty = false;
+                }
+            }
+            return res;
+        }
+
+        template <class F, class V, class = void_t<>>
+        struct has_simd_accumulate : std::false_type
+        {
+        };
+
+        template <class F, class V>
+        struct has_simd_accumulate<F, V, void_t<decltype(std::declval<const F&>().simd_accumulate(std::declval<const simd_type_t<V>&>(),
+                                                                                                 std::declval<const simd_type_t<V>&>()))>>
+            : std::integral_constant<bool, std::is_same<typename F::accumulator_type, V>::value && (simd_traits<V>::size > 1)>
+        {
+        };
+
+        // Accumulates the elements of a single reduction, for the
+        // element-wise evaluation of an xreducer.
+        template <class F>
+        class xpairwise_accumulator
+        {
+
+        public:
+
+            using accumulator_type = typename F::accumulator_type;
+
+            explicit xpairwise_accumulator(const F& f);
+
+            template <class V>
+            void accumulate(const V& value, std::size_t index);
+
+            accumulator_type result() const;
+
+        private:
+
+            const F& m_f;
+            std::array<accumulator_type, 64> m_levels;
+            accumulator_type m_block;
+            std::size_t m_block_size;
+            std::size_t m_count;
+        };
+
+        template <class F>
+        inline xpairwise_accumulator<F>::xpairwise_accumulator(const F& f)
+            : m_f(f), m_block(f.init()), m_block_size(0), m_count(0)
+        {
+        }
+
+        template <class F>
+        template <class V>
+        inline void xpairwise_accumulator<F>::accumulate(const V& value, std::size_t index)
+        {
+            m_block = m_f.accumulate(m_block, value, index);
+            if(++m_block_size == reduction_block_size)
+            {
+                pairwise_push(m_f, m_levels.data(), 1, m_count++, m_block);
+                m_block = m_f.init();
+                m_block_size = 0;
+            }
+        }
+
+        template <class F>
+        inline auto xpairwise_accumulator<F>::result() const -> accumulator_type
+        {
+            return pairwise_result(m_f, m_levels.data(), 1, m_count, m_block, m_block_size != 0);
+        }
+
+        // Strides of a row-major container of the given shape, null
+        // along the dimensions of size 1.
+        template <class S>
+        inline xshape<std::size_t> row_major_strides(const S& shape)
+        {
+            std::size_t dim = shape.size();
+            xshape<std::size_t> strides(dim, std::size_t(0));
+            std::size_t stride = 1;
+            for(std::size_t d = dim; d != 0; --d)
+            {
+                strides[d - 1] = shape[d - 1] == 1 ? std::size_t(0) : stride;
+                stride *= shape[d - 1];
+            }
+            return strides;
+        }
+
+        // Cursors traverse an expression row by row for the evaluation
+        // of an xreducer or an xaccumulator as a whole: step and step_back
+        // move the cursor to another row, reduce accumulates consecutive
+        // elements of the current row into a single accumulator, scan does
+        // the same and passes the accumulator to a callback after each
+        // element, and accumulate accumulates them into consecutive
+        // accumulators. end_row must be called before moving to another row.
+
+        template <class S>
+        class xreducer_stepper_cursor
+        {
+
+        public:
+
+            using size_type = std::size_t;
+
+            xreducer_stepper_cursor(const S& it, size_type inner);
+
+            void step(size_type dim, size_type n);
+            void step_back(size_type dim, size_type n);
+
+            template <class F, class A>
+            A reduce(const F& f, A acc, size_type first, size_type size, size_type index);
+
+            template <class F, class A, class G>
+            A scan(const F& f, A acc, size_type size, size_type index, G&& g);
+
+            template <class F, class A>
+            void accumulate(const F& f, A* row, size_type size, size_type index);
+
+            void end_row();
+
+        private:
+
+            void move_to(size_type position);
+
+            S m_it;
+            size_type m_inner;
+            size_type m_position;
+        };
+
+        template <class E>
+        class xreducer_linear_cursor
+        {
+
+        public:
+
+            using size_type = std::size_t;
+            using value_type = typename E::value_type;
+
+            xreducer_linear_cursor(const E& e, const xshape<size_type>& strides);
+
+            void step(size_type dim, size_type n);
+            void step_back(size_type dim, size_type n);
+
+            template <class F, class A>
+            A reduce(const F& f, A acc, size_type first, size_type size, size_type index) const;
+
+            template <class F, class A, class G>
+            A scan(const F& f, A acc, size_type size, size_type index, G&& g) const;
+
+            template <class F, class A>
+            void accumulate(const F& f, A* row, size_type size, size_type index) const;
+
+            void end_row() const noexcept;
+
+        private:
+
+            template <class F, class A>
+            void accumulate_impl(const F& f, A* row, size_type size, size_type index, std::true_type /*simd*/) const;
+            template <class F, class A>
+            void accumulate_impl(const F& f, A* row, size_type size, size_type index, std::false_type /*simd*/) const;
+
+            const E* p_e;
+            xshape<size_type> m_strides;
+            size_type m_offset;
+        };
+
+        template <class S>
+        inline xreducer_stepper_cursor<S>::xreducer_stepper_cursor(const S& it, size_type inner)
+            : m_it(it), m_inner(inner), m_position(0)
+        {
+        }
+
+        template <class S>
+        inline void xreducer_stepper_cursor<S>::step(size_type dim, size_type n)
+        {
+            m_it.step(dim, n);
+        }
+
+        template <class S>
+        inline void xreducer_stepper_cursor<S>::step_back(size_type dim, size_type n)
+        {
+            m_it.step_back(dim, n);
+        }
+
+        template <class S>
+        template <class F, class A>
+        inline A xreducer_stepper_cursor<S>::reduce(const F& f, A acc, size_type first, size_type size, size_type index)
+        {
+            move_to(first);
+            acc = f.accumulate(acc, *m_it, index);
+            for(size_type k = 1; k != size; ++k)
+            {
+                m_it.step(m_inner);
+                acc = f.accumulate(acc, *m_it, index + k);
+            }
+            m_position += size - 1;
+            return acc;
+        }
+
+        template <class S>
+        template <class F, class A, class G>
+        inline A xreducer_stepper_cursor<S>::scan(const F& f, A acc, size_type size, size_type index, G&& g)
+        {
+            move_to(0);
+            acc = f.accumulate(acc, *m_it, index);
+            g(acc);
+            for(size_type k = 1; k != size; ++k)
+            {
+                m_it.step(m_inner);
+                acc = f.accumulate(acc, *m_it, index + k);
+                g(acc);
+            }
+            m_position = size - 1;
+            return acc;
+        }
+
+        template <class S>
+        template <class F, class A>
+        inline void xreducer_stepper_cursor<S>::accumulate(const F& f, A* row, size_type size, size_type index)
+        {
+            move_to(0);
+            row[0] = f.accumulate(row[0], *m_it, index);
+            for(size_type k = 1; k != size; ++k)
+            {
+                m_it.step(m_inner);
+                row[k] = f.accumulate(row[k], *m_it, index);
+            }
+            m_position = size - 1;
+        }
+
+        template <class S>
+        inline void xreducer_stepper_cursor<S>::end_row()
+        {
+            move_to(0);
+        }
+
+        template <class S>
+        inline void xreducer_stepper_cursor<S>::move_to(size_type position)
+        {
+            if(position > m_position)
+            {
+                m_it.step(m_inner, position - m_position);
+            }
+            else if(position < m_position)
+            {
+                m_it.step_back(m_inner, m_position - position);
+            }
+            m_position = position;
+        }
+
+        template <class E>
+        inline xreducer_linear_cursor<E>::xreducer_linear_cursor(const E& e, const xshape<size_type>& strides)
+            : p_e(&e), m_strides(strides), m_offset(0)
+        {
+        }
+
+        template <class E>
+        inline void xreducer_linear_cursor<E>::step(size_type dim, size_type n)
+        {
+            m_offset += n * m_strides[dim];
+        }
+
+        template <class E>
+        inline void xreducer_linear_cursor<E>::step_back(size_type dim, size_type n)
+        {
+            m_offset -= n * m_strides[dim];
+        }
+
+        template <class E>
+        template <class F, class A>
+        inline A xreducer_linear_cursor<E>::reduce(const F& f, A acc, size_type first, size_type size, size_type index) const
+        {
+            for(size_type k = 0; k != size; ++k)
+            {
+                acc = f.accumulate(acc, p_e->data_element(m_offset + first + k), index + k);
+            }
+            return acc;
+        }
+
+        template <class E>
+        template <class F, class A, class G>
+        inline A xreducer_linear_cursor<E>::scan(const F& f, A acc, size_type size, size_type index, G&& g) const
+        {
+            for(size_type k = 0; k != size; ++k)
+            {
+                acc = f.accumulate(acc, p_e->data_element(m_offset + k), index + k);
+                g(acc);
+            }
+            return acc;
+        }
+
+        template <class E>
+        template <class F, class A>
+        inline void xreducer_linear_cursor<E>::accumulate(const F& f, A* row, size_type size, size_type index) const
+        {
+            accumulate_impl(f, row, size, index, has_simd_accumulate<F, value_type>());
+        }
+
+        template <class E>
+        inline void xreducer_linear_cursor<E>::end_row() const noexcept
+        {
+        }
+
+        template <class E>
+        template <class F, class A>
+        inline void xreducer_linear_cursor<E>::accumulate_impl(const F& f, A* row, size_type size, size_type index, std::true_type) const
+        {
+            using batch_type = simd_type_t<value_type>;
+            constexpr size_type simd_size = batch_type::size;
+            size_type simd_end = size - size % simd_size;
+            for(size_type k = 0; k != simd_end; k += simd_size)
+            {
+                batch_type acc = batch_type::load_unaligned(row + k);
+                acc = f.simd_accumulate(acc, p_e->template load_simd<value_type>(m_offset + k));
+                acc.store_unaligned(row + k);
+            }
+            for(size_type k = simd_end; k != size; ++k)
+            {
+                row[k] = f.accumulate(row[k], p_e->data_element(m_offset + k), index);
+            }
+        }
+
+        template <class E>
+        template <class F, class A>
+        inline void xreducer_linear_cursor<E>::accumulate_impl(const F& f, A* row, size_type size, size_type index, std::false_type) const
+        {
+            for(size_type k = 0; k != size; ++k)
+            {
+                row[k] = f.accumulate(row[k], p_e->data_element(m_offset + k), index);
+            }
+        }
+    }
+
+    /**
+     * @class xreducer
+     * @brief Lazy reduction of an xexpression over a set of axes.
+     *
+     * The xreducer class implements an xexpression whose elements are
+     * the reductions of the elements of another xexpression along the
+     * specified axes; its shape is the shape of the reduced expression
+     * without the reduced axes. Elements are computed on access, so that
+     * an xreducer can be used in an \ref xfunction like any other
+     * expression. When an xreducer is assigned as a whole, the reduced
+     * expression is traversed once in row-major order, so that its
+     * innermost dimension is read contiguously whether it is reduced
+     * or not, possibly in parallel. The elements of each reduction are
+     * accumulated by blocks combined pairwise, which bounds the rounding
+     * errors and makes the results independent of the number of threads.
+     * The blocks are the same whether the xreducer is assigned or accessed
+     * element-wise, so that both give the same results.
+     *
+     * @tparam F the reducing functor type
+     * @tparam E the type of the reduced expression
+     * @tparam X the type of the container of axes
+     */
+    template <class F, class E, class X>
+    class xreducer : public xexpression<xreducer<F, E, X>>
+    {
+
+    public:
+
+        using self_type = xreducer<F, E, X>;
+        using functor_type = F;
+        using expression_type = E;
+        using axes_type = X;
+
+        using value_type = typename F::result_type;
+        using reference = value_type;
+        using const_reference = value_type;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = typename E::size_type;
+        using difference_type = typename E::difference_type;
+
+        using shape_type = typename detail::xreducer_shape_type<typename E::shape_type, X>::type;
+        using strides_type = shape_type;
+
+        using closure_type = const self_type;
+
+        using const_stepper = xreducer_stepper<F, E, X>;
+        using const_iterator = xiterator<const_stepper, shape_type>;
+        template <class S>
+        using const_broadcast_iterator = xiterator<const_stepper, S>;
+        using const_storage_iterator = const_iterator;
+
+        template <class Func, class AX>
+        xreducer(Func&& f, const E& e, AX&& axes);
+
+        size_type dimension() const noexcept;
+        const shape_type& shape() const noexcept;
+        const axes_type& axes() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+
+        template <class S>
+        bool broadcast_shape(S& shape) const;
+
+        template <class S>
+        bool is_trivial_broadcast(const S& strides) const noexcept;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        template <class S>
+        const_broadcast_iterator<S> xbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> xend(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxend(const S& shape) const;
+
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const;
+        template <class S>
+        const_stepper stepper_end(const S& shape) const;
+
+        const_storage_iterator storage_begin() const;
+        const_storage_iterator storage_end() const;
+
+        template <class E1>
+        void assign_to(E1& e1, xexecutor* executor = default_executor()) const;
+
+    private:
+
+        using substepper_type = typename E::const_stepper;
+        using accumulator_type = typename F::accumulator_type;
+        using accumulator_vector = std::vector<accumulator_type>;
+        using linear_cursor = detail::xreducer_linear_cursor<E>;
+        using stepper_cursor = detail::xreducer_stepper_cursor<substepper_type>;
+
+        typename E::closure_type m_e;
+        F m_f;
+        axes_type m_axes;
+        typename E::shape_type m_arg_shape;
+        shape_type m_shape;
+        shape_type m_dim_mapping;
+        axes_type m_reduced_shape;
+        size_type m_reduced_size;
+        xshape<size_type> m_out_strides;
+
+        bool is_linear() const;
+        bool is_linear(std::true_type /*simd interface*/) const;
+        bool is_linear(std::false_type /*simd interface*/) const;
+
+        value_type reduce(substepper_type it) const;
+        value_type reduce_linear(size_type out_index) const;
+        accumulator_type reduce_linear(size_type out_index, std::true_type /*simd interface*/) const;
+        accumulator_type reduce_linear(size_type out_index, std::false_type /*simd interface*/) const;
+        void reduce_impl(size_type level, substepper_type& it, detail::xpairwise_accumulator<F>& acc, size_type& index) const;
+
+        accumulator_vector reduce_all(size_type out_size, xexecutor* executor, std::true_type /*linear*/) const;
+        accumulator_vector reduce_all(size_type out_size, xexecutor* executor, std::false_type /*linear*/) const;
+
+        accumulator_vector reduce_blocks(size_type out_size, xexecutor* executor) const;
+        accumulator_type reduce_block(size_type first, size_type size, size_type index, std::true_type /*simd*/) const;
+        accumulator_type reduce_block(size_type first, size_type size, size_type index, std::false_type /*simd*/) const;
+
+        template <class C>
+        accumulator_vector reduce_rows(const C& cursor, size_type out_size, xexecutor* executor) const;
+        template <class C>
+        void reduce_rows_impl(C cursor, accumulator_type* buffer, size_type out_size,
+                              size_type restricted_dim, size_type first, size_type last) const;
+
+        friend class xreducer_stepper<F, E, X>;
+    };
+
+    /********************************
+     * xreducer_stepper declaration *
+     ********************************/
+
+    template <class F, class E, class X>
+    class xreducer_stepper
+    {
+
+    public:
+
+        using self_type = xreducer_stepper<F, E, X>;
+        using xreducer_type = xreducer<F, E, X>;
+
+        using value_type = typename xreducer_type::value_type;
+        using reference = typename xreducer_type::const_reference;
+        using pointer = typename xreducer_type::const_pointer;
+        using size_type = typename xreducer_type::size_type;
+        using difference_type = typename xreducer_type::difference_type;
+
+        using substepper_type = typename E::const_stepper;
+
+        xreducer_stepper(const xreducer_type* r, substepper_type it, size_type offset, bool linear);
+
+        reference operator*() const;
+
+        void step(size_type dim, size_type n = 1);
+        void step_back(size_type dim, size_type n = 1);
+        void reset(size_type dim);
+
+        void to_end();
+
+        bool equal(const self_type& rhs) const;
+
+    private:
+
+        const xreducer_type* p_r;
+        substepper_type m_it;
+        size_type m_offset;
+        bool m_linear;
+        size_type m_index;
+    };
+
+    template <class F, class E, class X>
+    bool operator==(const xreducer_stepper<F, E, X>& lhs,
+                    const xreducer_stepper<F, E, X>& rhs);
+
+    template <class F, class E, class X>
+    bool operator!=(const xreducer_stepper<F, E, X>& lhs,
+                    const xreducer_stepper<F, E, X>& rhs);
+
+    /***************************
+     * xreducer implementation *
+     ***************************/
+
+    /**
+     * @name Constructor
+     */
+    //@{
+    /**
+     * Constructs an xreducer reducing \c e along \c axes with the
+     * reducing functor \c f.
+     * @param f the reducing functor
+     * @param e the expression to reduce
+     * @param axes the axes along which \c e is reduced
+     * @throw std::out_of_range if an axis is not less than the dimension of \c e
+     * @throw std::invalid_argument if an axis is specified more than once
+     */
+    template <class F, class E, class X>
+    template <class Func, class AX>
+    inline xreducer<F, E, X>::xreducer(Func&& f, const E& e, AX&& axes)
+        : m_e(e), m_f(std::forward<Func>(f)), m_axes(std::forward<AX>(axes)),
+          m_arg_shape(m_e.shape()), m_reduced_shape(m_axes), m_reduced_size(1)
+    {
+        size_type dim = m_arg_shape.size();
+        std::sort(m_axes.begin(), m_axes.end());
+        for(size_type i = 0; i != m_axes.size(); ++i)
+        {
+            if(m_axes[i] >= dim)
+            {
+                throw std::out_of_range("reduction axis out of range");
+            }
+            if(i != 0 && m_axes[i] == m_axes[i - 1])
+            {
+                throw std::invalid_argument("reduction axis specified more than once");
+            }
+        }
+
+        m_shape = make_sequence<shape_type>(dim - m_axes.size(), size_type(0));
+        m_dim_mapping = m_shape;
+        size_type j = 0;
+        size_type k = 0;
+        for(size_type d = 0; d != dim; ++d)
+        {
+            if(k != m_axes.size() && m_axes[k] == d)
+            {
+                m_reduced_shape[k] = m_arg_shape[d];
+                m_reduced_size *= m_arg_shape[d];
+                ++k;
+            }
+            else
+            {
+                m_shape[j] = m_arg_shape[d];
+                m_dim_mapping[j] = d;
+                ++j;
+            }
+        }
+        m_out_strides = detail::row_major_strides(m_shape);
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of dimensions of the xreducer.
+     */
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the xreducer.
+     */
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the reduced axes, in increasing order.
+     */
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::axes() const noexcept -> const axes_type&
+    {
+        return m_axes;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the reduction of the elements of the reduced expression
+     * matching the specified position.
+     * @param args a list of indices specifying the position in the xreducer. Indices
+     * must be unsigned integers, the number of indices should be equal or greater than
+     * the number of dimensions of the xreducer.
+     */
+    template <class F, class E, class X>
+    template <class... Args>
+    inline auto xreducer<F, E, X>::operator()(Args... args) const -> const_reference
+    {
+        std::array<size_type, sizeof...(Args)> index = {{ static_cast<size_type>(args)... }};
+        size_type dim = dimension();
+        size_type count = std::min(dim, index.size());
+        if(is_linear())
+        {
+            size_type out_index = 0;
+            for(size_type i = 0; i != count; ++i)
+            {
+                out_index += m_out_strides[dim - count + i] * index[index.size() - count + i];
+            }
+            return reduce_linear(out_index);
+        }
+        substepper_type it = m_e.stepper_begin(m_arg_shape);
+        for(size_type i = 0; i != count; ++i)
+        {
+            it.step(m_dim_mapping[dim - count + i], index[index.size() - count + i]);
+        }
+        return reduce(it);
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the xreducer to the specified parameter.
+     * @param shape the result shape
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class F, class E, class X>
+    template <class S>
+    inline bool xreducer<F, E, X>::broadcast_shape(S& shape) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Compares the specified strides with those of the xreducer to see
+     * whether the broadcasting is trivial. Since the elements of an xreducer
+     * are not stored, the broadcasting is never trivial.
+     * @return false
+     */
+    template <class F, class E, class X>
+    template <class S>
+    inline bool xreducer<F, E, X>::is_trivial_broadcast(const S& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    /**
+     * @name Iterators
+     */
+    //@{
+    /**
+     * Returns a constant iterator to the first element of the xreducer.
+     */
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::begin() const -> const_iterator
+    {
+        return xbegin(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last
+     * element of the xreducer.
+     */
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::end() const -> const_iterator
+    {
+        return xend(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the xreducer.
+     */
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::cbegin() const -> const_iterator
+    {
+        return begin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last
+     * element of the xreducer.
+     */
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::cend() const -> const_iterator
+    {
+        return end();
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the xreducer.
+     * The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class F, class E, class X>
+    template <class S>
+    inline auto xreducer<F, E, X>::xbegin(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the xreducer. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class F, class E, class X>
+    template <class S>
+    inline auto xreducer<F, E, X>::xend(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape, true);
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the xreducer.
+     * The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class F, class E, class X>
+    template <class S>
+    inline auto xreducer<F, E, X>::cxbegin(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return xbegin(shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the xreducer. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class F, class E, class X>
+    template <class S>
+    inline auto xreducer<F, E, X>::cxend(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return xend(shape);
+    }
+    //@}
+
+    /***************
+     * stepper api *
+     ***************/
+
+    template <class F, class E, class X>
+    template <class S>
+    inline auto xreducer<F, E, X>::stepper_begin(const S& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, m_e.stepper_begin(m_arg_shape), offset, is_linear());
+    }
+
+    template <class F, class E, class X>
+    template <class S>
+    inline auto xreducer<F, E, X>::stepper_end(const S& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, m_e.stepper_end(m_arg_shape), offset, false);
+    }
+
+    /************************
+     * storage_iterator api *
+     ************************/
+
+    /**
+     * @name Storage iterators
+     */
+    //@{
+    /**
+     * Returns a constant iterator to the first element of the xreducer,
+     * its elements being traversed in row-major order.
+     */
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::storage_begin() const -> const_storage_iterator
+    {
+        return begin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last
+     * element of the xreducer.
+     */
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::storage_end() const -> const_storage_iterator
+    {
+        return end();
+    }
+    //@}
+
+    /**
+     * Evaluates the xreducer into \c e1, whose shape must be the shape of
+     * the xreducer. The results are accumulated in a buffer before being
+     * written to \c e1, which may therefore be aliased by the reduced
+     * expression.
+     *
+     * When the reduced expression can be read along its linear storage
+     * and the reduced axes are its innermost ones, the elements of each
+     * reduction are contiguous and are accumulated by SIMD batches;
+     * otherwise the reduced expression is traversed once, row by row.
+     * Large expressions are evaluated in parallel on \c executor; the
+     * blocks the reductions are split into do not depend on it, so that
+     * the results do not depend on the number of threads.
+     * @param e1 the expression to assign the results to
+     * @param executor the executor running the evaluation, or a null
+     * pointer for a serial evaluation
+     */
+    template <class F, class E, class X>
+    template <class E1>
+    inline void xreducer<F, E, X>::assign_to(E1& e1, xexecutor* executor) const
+    {
+        size_type out_size = data_size(m_shape);
+        accumulator_vector acc;
+        if(out_size == 0 || m_reduced_size == 0)
+        {
+            acc.assign(out_size, m_f.init());
+        }
+        else
+        {
+            acc = reduce_all(out_size, executor, has_simd_interface<E, typename E::value_type>());
+        }
+        std::transform(acc.cbegin(), acc.cend(), e1.begin(),
+                [this](const accumulator_type& a) { return m_f.result(a, m_reduced_size); });
+    }
+
+    // Whether the reductions are contiguous ranges of the linear storage
+    // of the reduced expression, which are then evaluated by reduce_blocks.
+    template <class F, class E, class X>
+    inline bool xreducer<F, E, X>::is_linear() const
+    {
+        return is_linear(has_simd_interface<E, typename E::value_type>());
+    }
+
+    template <class F, class E, class X>
+    inline bool xreducer<F, E, X>::is_linear(std::true_type) const
+    {
+        size_type dim = m_arg_shape.size();
+        return (m_axes.size() == 0 || m_axes[0] == dim - m_axes.size()) &&
+               m_e.is_trivial_broadcast(detail::row_major_strides(m_arg_shape));
+    }
+
+    template <class F, class E, class X>
+    inline bool xreducer<F, E, X>::is_linear(std::false_type) const
+    {
+        return false;
+    }
+
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::reduce_linear(size_type out_index) const -> value_type
+    {
+        return m_f.result(reduce_linear(out_index, has_simd_interface<E, typename E::value_type>()), m_reduced_size);
+    }
+
+    // Evaluates the out_index-th reduction with the blocks and the pairwise
+    // combination of reduce_blocks, so that both give the same result.
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::reduce_linear(size_type out_index, std::true_type) const -> accumulator_type
+    {
+        using simd = detail::has_simd_accumulate<F, typename E::value_type>;
+        constexpr size_type block_size = detail::reduction_block_size;
+        size_type full_blocks = m_reduced_size / block_size;
+        size_type rest = m_reduced_size % block_size;
+        size_type first = out_index * m_reduced_size;
+
+        accumulator_vector levels(detail::pairwise_depth(full_blocks), m_f.init());
+        for(size_type k = 0; k != full_blocks; ++k)
+        {
+            size_type index = k * block_size;
+            detail::pairwise_push(m_f, levels.data(), 1, k, reduce_block(first + index, block_size, index, simd()));
+        }
+        size_type index = full_blocks * block_size;
+        accumulator_type last = rest != 0 ? reduce_block(first + index, rest, index, simd()) : m_f.init();
+        return detail::pairwise_result(m_f, levels.data(), 1, full_blocks, last, rest != 0);
+    }
+
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::reduce_linear(size_type /*out_index*/, std::false_type) const -> accumulator_type
+    {
+        return m_f.init();
+    }
+
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::reduce(substepper_type it) const -> value_type
+    {
+        detail::xpairwise_accumulator<F> acc(m_f);
+        if(m_axes.size() == 0)
+        {
+            acc.accumulate(*it, size_type(0));
+        }
+        else if(m_reduced_size != 0)
+        {
+            size_type index = 0;
+            reduce_impl(0, it, acc, index);
+        }
+        return m_f.result(acc.result(), m_reduced_size);
+    }
+
+    // Accumulates the elements along the reduced axes from the level-th
+    // one, then moves the stepper back to its initial position.
+    template <class F, class E, class X>
+    inline void xreducer<F, E, X>::reduce_impl(size_type level, substepper_type& it,
+                                               detail::xpairwise_accumulator<F>& acc, size_type& index) const
+    {
+        size_type axis = m_axes[level];
+        size_type size = m_reduced_shape[level];
+        if(level + 1 == m_axes.size())
+        {
+            acc.accumulate(*it, index++);
+            for(size_type k = 1; k != size; ++k)
+            {
+                it.step(axis);
+                acc.accumulate(*it, index++);
+            }
+        }
+        else
+        {
+            reduce_impl(level + 1, it, acc, index);
+            for(size_type k = 1; k != size; ++k)
+            {
+                it.step(axis);
+                reduce_impl(level + 1, it, acc, index);
+            }
+        }
+        it.reset(axis);
+    }
+
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::reduce_all(size_type out_size, xexecutor* executor, std::true_type) const -> accumulator_vector
+    {
+        xshape<size_type> strides = detail::row_major_strides(m_arg_shape);
+        if(!m_e.is_trivial_broadcast(strides))
+        {
+            return reduce_all(out_size, executor, std::false_type());
+        }
+        size_type dim = m_arg_shape.size();
+        if(m_axes.size() == 0 || m_axes[0] == dim - m_axes.size())
+        {
+            return reduce_blocks(out_size, executor);
+        }
+        return reduce_rows(linear_cursor(m_e, strides), out_size, executor);
+    }
+
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::reduce_all(size_type out_size, xexecutor* executor, std::false_type) const -> accumulator_vector
+    {
+        substepper_type it = m_e.stepper_begin(m_arg_shape);
+        size_type dim = m_arg_shape.size();
+        if(dim == 0)
+        {
+            return accumulator_vector(1, m_f.accumulate(m_f.init(), *it, size_type(0)));
+        }
+        return reduce_rows(stepper_cursor(it, dim - 1), out_size, executor);
+    }
+
+    // Reduces an expression whose reductions are contiguous ranges of its
+    // linear storage: the blocks of all the reductions are computed first,
+    // possibly in parallel, then combined pairwise.
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::reduce_blocks(size_type out_size, xexecutor* executor) const -> accumulator_vector
+    {
+        using simd = detail::has_simd_accumulate<F, typename E::value_type>;
+        constexpr size_type block_size = detail::reduction_block_size;
+        size_type full_blocks = m_reduced_size / block_size;
+        size_type block_count = (m_reduced_size + block_size - 1) / block_size;
+
+        accumulator_vector blocks(out_size * block_count, m_f.init());
+        auto run = [this, &blocks, block_count](size_type first, size_type last) {
+            for(size_type i = first; i != last; ++i)
+            {
+                size_type index = i % block_count * detail::reduction_block_size;
+                size_type size = std::min(detail::reduction_block_size, m_reduced_size - index);
+                blocks[i] = reduce_block(i / block_count * m_reduced_size + index, size, index, simd());
+            }
+        };
+        if(detail::use_executor(executor, data_size(m_arg_shape)))
+        {
+            parallel_chunks(*executor, blocks.size(), 1, run);
+        }
+        else
+        {
+            run(0, blocks.size());
+        }
+        if(block_count == 1)
+        {
+            return blocks;
+        }
+
+        accumulator_vector res(out_size, m_f.init());
+        accumulator_vector levels(detail::pairwise_depth(full_blocks), m_f.init());
+        bool partial = block_count != full_blocks;
+        for(size_type i = 0; i != out_size; ++i)
+        {
+            const accumulator_type* first = blocks.data() + i * block_count;
+            for(size_type k = 0; k != full_blocks; ++k)
+            {
+                detail::pairwise_push(m_f, levels.data(), 1, k, first[k]);
+            }
+            res[i] = detail::pairwise_result(m_f, levels.data(), 1, full_blocks, first[block_count - 1], partial);
+        }
+        return res;
+    }
+
+    // Accumulates size contiguous elements from the first-th one of the
+    // linear storage, in four batches of independent lanes merged pairwise.
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::reduce_block(size_type first, size_type size, size_type index, std::true_type) const -> accumulator_type
+    {
+        using arg_value_type = typename E::value_type;
+        using batch_type = simd_type_t<arg_value_type>;
+        constexpr size_type simd_size = batch_type::size;
+
+        batch_type acc0(m_f.init());
+        batch_type acc1(m_f.init());
+        batch_type acc2(m_f.init());
+        batch_type acc3(m_f.init());
+        size_type last = first + size;
+        size_type i = first;
+        for(; i + 4 * simd_size <= last; i += 4 * simd_size)
+        {
+            acc0 = m_f.simd_accumulate(acc0, m_e.template load_simd<arg_value_type>(i));
+            acc1 = m_f.simd_accumulate(acc1, m_e.template load_simd<arg_value_type>(i + simd_size));
+            acc2 = m_f.simd_accumulate(acc2, m_e.template load_simd<arg_value_type>(i + 2 * simd_size));
+            acc3 = m_f.simd_accumulate(acc3, m_e.template load_simd<arg_value_type>(i + 3 * simd_size));
+        }
+        for(; i + simd_size <= last; i += simd_size)
+        {
+            acc0 = m_f.simd_accumulate(acc0, m_e.template load_simd<arg_value_type>(i));
+        }
+        batch_type acc = m_f.simd_accumulate(m_f.simd_accumulate(acc0, acc1), m_f.simd_accumulate(acc2, acc3));
+
+        accumulator_type lanes[simd_size];
+        for(size_type j = 0; j != simd_size; ++j)
+        {
+            lanes[j] = acc[j];
+        }
+        for(size_type width = simd_size / 2; width != 0; width /= 2)
+        {
+            for(size_type j = 0; j != width; ++j)
+            {
+                lanes[j] = m_f.merge(lanes[j], lanes[j + width]);
+            }
+        }
+        accumulator_type res = lanes[0];
+        for(; i != last; ++i)
+        {
+            res = m_f.accumulate(res, m_e.data_element(i), index + i - first);
+        }
+        return res;
+    }
+
+    template <class F, class E, class X>
+    inline auto xreducer<F, E, X>::reduce_block(size_type first, size_type size, size_type index, std::false_type) const -> accumulator_type
+    {
+        accumulator_type res = m_f.init();
+        for(size_type i = 0; i != size; ++i)
+        {
+            res = m_f.accumulate(res, m_e.data_element(first + i), index + i);
+        }
+        return res;
+    }
+
+    // Reduces the expression row by row into a buffer holding the current
+    // block of each reduction, followed by the levels of their pairwise
+    // combinations of blocks. The parallel evaluation splits the outermost
+    // dimension that is not reduced, so that the reductions are not split.
+    template <class F, class E, class X>
+    template <class C>
+    inline auto xreducer<F, E, X>::reduce_rows(const C& cursor, size_type out_size, xexecutor* executor) const -> accumulator_vector
+    {
+        size_type full_blocks = m_reduced_size / detail::reduction_block_size;
+        size_type depth = detail::pairwise_depth(full_blocks);
+        accumulator_vector buffer(out_size * (depth + 1), m_f.init());
+        size_type dim = m_arg_shape.size();
+        if(dimension() != 0 && detail::use_executor(executor, data_size(m_arg_shape)))
+        {
+            size_type outer = m_dim_mapping[0];
+            parallel_chunks(*executor, m_arg_shape[outer], 1, [this, &cursor, &buffer, out_size, outer](size_type first, size_type last) {
+                reduce_rows_impl(cursor, buffer.data(), out_size, outer, first, last);
+            });
+        }
+        else
+        {
+            reduce_rows_impl(cursor, buffer.data(), out_size, dim, 0, 0);
+        }
+        if(depth == 0)
+        {
+            return buffer;
+        }
+
+        accumulator_vector res(out_size, m_f.init());
+        bool partial = m_reduced_size % detail::reduction_block_size != 0;
+        for(size_type i = 0; i != out_size; ++i)
+        {
+            res[i] = detail::pairwise_result(m_f, buffer.data() + out_size + i, out_size, full_blocks, buffer[i], partial);
+        }
+        return res;
+    }
+
+    // Traverses the rows of the expression whose index along the restricted
+    // dimension is in [first, last), or all the rows if restricted_dim is the
+    // dimension of the expression.
+    template <class F, class E, class X>
+    template <class C>
+    inline void xreducer<F, E, X>::reduce_rows_impl(C cursor, accumulator_type* buffer, size_type out_size,
+                                                    size_type restricted_dim, size_type first, size_type last) const
+    {
+        constexpr size_type block_size = detail::reduction_block_size;
+        size_type dim = m_arg_shape.size();
+        xshape<size_type> lower(dim, size_type(0));
+        xshape<size_type> upper(m_arg_shape.cbegin(), m_arg_shape.cend());
+        if(restricted_dim != dim)
+        {
+            lower[restricted_dim] = first;
+            upper[restricted_dim] = last;
+        }
+
+        // Offsets of the accumulator and of the flat reduced index
+        // for a step along each dimension of the reduced expression.
+        xshape<size_type> acc_strides(dim, size_type(0));
+        xshape<size_type> index_strides(dim, size_type(0));
+        xshape<char> reduced(dim, char(0));
+        for(size_type k = 0; k != m_axes.size(); ++k)
+        {
+            reduced[m_axes[k]] = 1;
+        }
+        size_type acc_stride = 1;
+        size_type index_stride = 1;
+        for(size_type d = dim; d != 0; --d)
+        {
+            if(reduced[d - 1])
+            {
+                index_strides[d - 1] = index_stride;
+                index_stride *= m_arg_shape[d - 1];
+            }
+            else
+            {
+                acc_strides[d - 1] = acc_stride;
+                acc_stride *= m_arg_shape[d - 1];
+            }
+        }
+
+        xshape<size_type> index(lower);
+        size_type acc_offset = 0;
+        size_type index_offset = 0;
+        for(size_type d = 0; d != dim; ++d)
+        {
+            cursor.step(d, lower[d]);
+            acc_offset += acc_strides[d] * lower[d];
+            index_offset += index_strides[d] * lower[d];
+        }
+
+        size_type inner = dim - 1;
+        size_type row_size = upper[inner] - lower[inner];
+        bool done = row_size == 0;
+        while(!done)
+        {
+            accumulator_type* row = buffer + acc_offset;
+            if(reduced[inner])
+            {
+                // The elements of the row belong to the same reduction and
+                // have consecutive reduced indices.
+                accumulator_type acc = *row;
+                for(size_type k = 0; k != row_size;)
+                {
+                    size_type i = index_offset + k;
+                    size_type size = std::min(row_size - k, block_size - i % block_size);
+                    acc = cursor.reduce(m_f, acc, k, size, i);
+                    k += size;
+                    if((i + size) % block_size == 0)
+                    {
+                        detail::pairwise_push(m_f, row + out_size, out_size, (i + size) / block_size - 1, acc);
+                        acc = m_f.init();
+                    }
+                }
+                *row = acc;
+            }
+            else
+            {
+                // The elements of the row belong to consecutive reductions
+                // and have the same reduced index.
+                cursor.accumulate(m_f, row, row_size, index_offset);
+                if((index_offset + 1) % block_size == 0)
+                {
+                    for(size_type k = 0; k != row_size; ++k)
+                    {
+                        detail::pairwise_push(m_f, row + k + out_size, out_size, (index_offset + 1) / block_size - 1, row[k]);
+                        row[k] = m_f.init();
+                    }
+                }
+            }
+            cursor.end_row();
+
+            done = true;
+            for(size_type i = inner; i != 0; --i)
+            {
+                size_type d = i - 1;
+                if(++index[d] != upper[d])
+                {
+                    cursor.step(d, 1);
+                    acc_offset += acc_strides[d];
+                    index_offset += index_strides[d];
+                    done = false;
+                    break;
+                }
+                size_type n = upper[d] - lower[d] - 1;
+                index[d] = lower[d];
+                cursor.step_back(d, n);
+                acc_offset -= acc_strides[d] * n;
+                index_offset -= index_strides[d] * n;
+            }
+        }
+    }
+
+    /***********************************
+     * xreducer_stepper implementation *
+     ***********************************/
+
+    // The row-major index of the current reduction is tracked for the
+    // evaluation of contiguous reductions.
+    template <class F, class E, class X>
+    inline xreducer_stepper<F, E, X>::xreducer_stepper(const xreducer_type* r, substepper_type it,
+                                                        size_type offset, bool linear)
+        : p_r(r), m_it(it), m_offset(offset), m_linear(linear), m_index(0)
+    {
+    }
+
+    template <class F, class E, class X>
+    inline auto xreducer_stepper<F, E, X>::operator*() const -> reference
+    {
+        return m_linear ? p_r->reduce_linear(m_index) : p_r->reduce(m_it);
+    }
+
+    template <class F, class E, class X>
+    inline void xreducer_stepper<F, E, X>::step(size_type dim, size_type n)
+    {
+        if(dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            m_it.step(p_r->m_dim_mapping[d], n);
+            m_index += n * p_r->m_out_strides[d];
+        }
+    }
+
+    template <class F, class E, class X>
+    inline void xreducer_stepper<F, E, X>::step_back(size_type dim, size_type n)
+    {
+        if(dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            m_it.step_back(p_r->m_dim_mapping[d], n);
+            m_index -= n * p_r->m_out_strides[d];
+        }
+    }
+
+    template <class F, class E, class X>
+    inline void xreducer_stepper<F, E, X>::reset(size_type dim)
+    {
+        if(dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            m_it.reset(p_r->m_dim_mapping[d]);
+            m_index -= (p_r->m_shape[d] - 1) * p_r->m_out_strides[d];
+        }
+    }
+
+    template <class F, class E, class X>
+    inline void xreducer_stepper<F, E, X>::to_end()
+    {
+        m_it.to_end();
+    }
+
+    template <class F, class E, class X>
+    inline bool xreducer_stepper<F, E, X>::equal(const self_type& rhs) const
+    {
+        return p_r == rhs.p_r && m_it == rhs.m_it && m_offset == rhs.m_offset;
+    }
+
+    template <class F, class E, class X>
+    inline bool operator==(const xreducer_stepper<F, E, X>& lhs,
+                           const xreducer_stepper<F, E, X>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class F, class E, class X>
+    inline bool operator!=(const xreducer_stepper<F, E, X>& lhs,
+                           const xreducer_stepper<F, E, X>& rhs)
+    {
+        return !(lhs.equal(rhs));
+    }
+
+    /**********************
+     * reducing functions *
+     **********************/
+
+    namespace detail
+    {
+        template <std::size_t K>
+        inline std::array<std::size_t, K> make_axes(const std::size_t (&axes)[K])
+        {
+            std::array<std::size_t, K> res;
+            std::copy(axes, axes + K, res.begin());
+            return res;
+        }
+
+        template <class X>
+        inline std::enable_if_t<std::is_integral<X>::value, std::array<std::size_t, 1>>
+        make_axes(X axis)
+        {
+            return {{ static_cast<std::size_t>(axis) }};
+        }
+
+        template <class X>
+        inline std::enable_if_t<!std::is_integral<X>::value, xshape<std::size_t>>
+        make_axes(const X& axes)
+        {
+            return xshape<std::size_t>(std::begin(axes), std::end(axes));
+        }
+
+        // All the axes of an expression; their number is known at compile
+        // time when the expression has a fixed-size shape.
+        template <class S>
+        struct all_axes
+        {
+            using type = xshape<std::size_t>;
+
+            static type make(std::size_t dim)
+            {
+                type res(dim);
+                for(std::size_t i = 0; i != dim; ++i)
+                {
+                    res[i] = i;
+                }
+                return res;
+            }
+        };
+
+        template <class I, std::size_t N>
+        struct all_axes<std::array<I, N>>
+        {
+            using type = std::array<std::size_t, N>;
+
+            static type make(std::size_t /*dim*/)
+            {
+                type res;
+                for(std::size_t i = 0; i != N; ++i)
+                {
+                    res[i] = i;
+                }
+                return res;
+            }
+        };
+
+        template <template <class, class> class F, class A, class E, class X>
+        inline auto make_xreducer(const E& e, X&& axes)
+        {
+            using functor_type = F<typename E::value_type, A>;
+            using axes_type = std::decay_t<X>;
+            return xreducer<functor_type, E, axes_type>(functor_type(), e, std::forward<X>(axes));
+        }
+
+        template <template <class, class> class F, class A, class E>
+        inline auto make_full_xreducer(const E& e)
+        {
+            using axes_builder = all_axes<typename E::shape_type>;
+            return make_xreducer<F, A>(e, axes_builder::make(e.dimension()));
+        }
+    }
+
+    /**
+     * @brief Reduces an expression with a custom reducing functor.
+     *
+     * Returns an \ref xreducer applying \em f to the elements of \em e
+     * along the specified axes. See xreducer.hpp for the requirements
+     * on the reducing functor.
+     * @param f the reducing functor
+     * @param e an \ref xexpression
+     * @param axes the axes along which \em e is reduced
+     * @return an \ref xreducer
+     */
+    template <class F, class E, class X>
+    inline auto reduce(F&& f, const xexpression<E>& e, const X& axes)
+    {
+        using functor_type = std::decay_t<F>;
+        auto ax = detail::make_axes(axes);
+        return xreducer<functor_type, E, decltype(ax)>(std::forward<F>(f), e.derived_cast(), std::move(ax));
+    }
+
+    /**
+     * @defgroup reducing_functions Reducing functions
+     */
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Sum of elements over given axes.
+     *
+     * Returns an \ref xreducer for the sum of the elements of \em e
+     * along \em axes. Integral elements are summed in 64-bit integers
+     * unless another accumulator type \em A is specified.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the sum is performed
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E, std::size_t K>
+    inline auto sum(const xexpression<E>& e, const std::size_t (&axes)[K])
+    {
+        return detail::make_xreducer<reducers::sum_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    template <class A = void, class E, class X>
+    inline auto sum(const xexpression<E>& e, const X& axes)
+    {
+        return detail::make_xreducer<reducers::sum_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Sum of all the elements.
+     *
+     * Returns a 0-D \ref xreducer for the sum of all the elements of \em e.
+     * @param e an \ref xexpression
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E>
+    inline auto sum(const xexpression<E>& e)
+    {
+        return detail::make_full_xreducer<reducers::sum_fun, A>(e.derived_cast());
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Product of elements over given axes.
+     *
+     * Returns an \ref xreducer for the product of the elements of \em e
+     * along \em axes. Integral elements are multiplied in 64-bit integers
+     * unless another accumulator type \em A is specified.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the product is performed
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E, std::size_t K>
+    inline auto prod(const xexpression<E>& e, const std::size_t (&axes)[K])
+    {
+        return detail::make_xreducer<reducers::prod_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    template <class A = void, class E, class X>
+    inline auto prod(const xexpression<E>& e, const X& axes)
+    {
+        return detail::make_xreducer<reducers::prod_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Product of all the elements.
+     *
+     * Returns a 0-D \ref xreducer for the product of all the elements of \em e.
+     * @param e an \ref xexpression
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E>
+    inline auto prod(const xexpression<E>& e)
+    {
+        return detail::make_full_xreducer<reducers::prod_fun, A>(e.derived_cast());
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Mean of elements over given axes.
+     *
+     * Returns an \ref xreducer for the arithmetic mean of the elements
+     * of \em e along \em axes. Integral elements are averaged in double
+     * precision unless another accumulator type \em A is specified.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the mean is computed
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E, std::size_t K>
+    inline auto mean(const xexpression<E>& e, const std::size_t (&axes)[K])
+    {
+        return detail::make_xreducer<reducers::mean_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    template <class A = void, class E, class X>
+    inline auto mean(const xexpression<E>& e, const X& axes)
+    {
+        return detail::make_xreducer<reducers::mean_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Mean of all the elements.
+     *
+     * Returns a 0-D \ref xreducer for the mean of all the elements of \em e.
+     * @param e an \ref xexpression
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E>
+    inline auto mean(const xexpression<E>& e)
+    {
+        return detail::make_full_xreducer<reducers::mean_fun, A>(e.derived_cast());
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Minimum of elements over given axes.
+     *
+     * Returns an \ref xreducer for the minimum of the elements of \em e
+     * along \em axes. NaNs are propagated.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the minimum is searched
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E, std::size_t K>
+    inline auto amin(const xexpression<E>& e, const std::size_t (&axes)[K])
+    {
+        return detail::make_xreducer<reducers::amin_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    template <class A = void, class E, class X>
+    inline auto amin(const xexpression<E>& e, const X& axes)
+    {
+        return detail::make_xreducer<reducers::amin_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Minimum of all the elements.
+     *
+     * Returns a 0-D \ref xreducer for the minimum of all the elements of \em e.
+     * @param e an \ref xexpression
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E>
+    inline auto amin(const xexpression<E>& e)
+    {
+        return detail::make_full_xreducer<reducers::amin_fun, A>(e.derived_cast());
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Maximum of elements over given axes.
+     *
+     * Returns an \ref xreducer for the maximum of the elements of \em e
+     * along \em axes. NaNs are propagated.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the maximum is searched
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E, std::size_t K>
+    inline auto amax(const xexpression<E>& e, const std::size_t (&axes)[K])
+    {
+        return detail::make_xreducer<reducers::amax_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    template <class A = void, class E, class X>
+    inline auto amax(const xexpression<E>& e, const X& axes)
+    {
+        return detail::make_xreducer<reducers::amax_fun, A>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Maximum of all the elements.
+     *
+     * Returns a 0-D \ref xreducer for the maximum of all the elements of \em e.
+     * @param e an \ref xexpression
+     * @return an \ref xreducer
+     */
+    template <class A = void, class E>
+    inline auto amax(const xexpression<E>& e)
+    {
+        return detail::make_full_xreducer<reducers::amax_fun, A>(e.derived_cast());
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Indices of the minimum elements over given axes.
+     *
+     * Returns an \ref xreducer for the flat index, in row-major order
+     * among the reduced elements, of the first minimum of the elements
+     * of \em e along \em axes, or of the first NaN if any.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the minimum is searched
+     * @return an \ref xreducer
+     */
+    template <class E, std::size_t K>
+    inline auto argmin(const xexpression<E>& e, const std::size_t (&axes)[K])
+    {
+        return detail::make_xreducer<reducers::argmin_fun, void>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    template <class E, class X>
+    inline auto argmin(const xexpression<E>& e, const X& axes)
+    {
+        return detail::make_xreducer<reducers::argmin_fun, void>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Flat index of the minimum element.
+     *
+     * Returns a 0-D \ref xreducer for the flat index, in row-major order,
+     * of the first minimum element of \em e.
+     * @param e an \ref xexpression
+     * @return an \ref xreducer
+     */
+    template <class E>
+    inline auto argmin(const xexpression<E>& e)
+    {
+        return detail::make_full_xreducer<reducers::argmin_fun, void>(e.derived_cast());
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Indices of the maximum elements over given axes.
+     *
+     * Returns an \ref xreducer for the flat index, in row-major order
+     * among the reduced elements, of the first maximum of the elements
+     * of \em e along \em axes, or of the first NaN if any.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the maximum is searched
+     * @return an \ref xreducer
+     */
+    template <class E, std::size_t K>
+    inline auto argmax(const xexpression<E>& e, const std::size_t (&axes)[K])
+    {
+        return detail::make_xreducer<reducers::argmax_fun, void>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    template <class E, class X>
+    inline auto argmax(const xexpression<E>& e, const X& axes)
+    {
+        return detail::make_xreducer<reducers::argmax_fun, void>(e.derived_cast(), detail::make_axes(axes));
+    }
+
+    /**
+     * @ingroup reducing_functions
+     * @brief Flat index of the maximum element.
+     *
+     * Returns a 0-D \ref xreducer for the flat index, in row-major order,
+     * of the first maximum element of \em e.
+     * @param e an \ref xexpression
+     * @return an \ref xreducer
+     */
+    template <class E>
+    inline auto argmax(const xexpression<E>& e)
+    {
+        return detail::make_full_xreducer<reducers::argmax_fun, void>(e.derived_cast());
+    }
+}
+
+#endif
@@ -11,7 +11,9 @@
 
 #include <utility>
 #include <cstddef>
+#include <array>
 
+#include "xbatch.hpp"
 #include "xexpression.hpp"
 #include "xindex.hpp"
 
@@ -45,8 +47,8 @@ namespace xt
         using difference_type = std::ptrdiff_t;
 
         using self_type = xscalar<T>;
-        using shape_type = xshape<size_type>;
-        using strides_type = xstrides<size_type>;
+        using shape_type = std::array<size_type, 0>;
+        using strides_type = std::array<size_type, 0>;
 
         using closure_type = const self_type;
         using const_stepper = xscalar_stepper<T>;
@@ -64,15 +66,29 @@ namespace xt
         template <class... Args>
         const_reference operator()(Args... args) const;
 
-        bool broadcast_shape(shape_type& shape) const;
-        bool is_trivial_broadcast(const strides_type& strides) const;
+        template <class S>
+        bool broadcast_shape(S& shape) const;
 
-        const_stepper stepper_begin(const shape_type& shape) const;
-        const_stepper stepper_end(const shape_type& shape) const;
+        template <class S>
+        bool is_trivial_broadcast(const S& strides) const;
+
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const;
+        template <class S>
+        const_stepper stepper_end(const S& shape) const;
 
         const_storage_iterator storage_begin() const;
         const_storage_iterator storage_end() const;
 
+        template <class V>
+        using simd_enabled = std::integral_constant<bool, simd_traits<V>::size != 1 &&
+                                                          std::is_convertible<T, V>::value>;
+
+        template <class V = value_type>
+        simd_type_t<V> load_simd(size_type i) const;
+
+        const_reference data_element(size_type i) const;
+
     private:
 
         const T& m_value;
@@ -211,25 +227,29 @@ namespace xt
     }
 
     template <class T>
-    inline bool xscalar<T>::broadcast_shape(shape_type&) const
+    template <class S>
+    inline bool xscalar<T>::broadcast_shape(S&) const
     {
         return true;
     }
 
     template <class T>
-    inline bool xscalar<T>::is_trivial_broadcast(const strides_type&) const
+    template <class S>
+    inline bool xscalar<T>::is_trivial_broadcast(const S&) const
     {
         return true;
     }
 
     template <class T>
-    inline auto xscalar<T>::stepper_begin(const shape_type&) const -> const_stepper
+    template <class S>
+    inline auto xscalar<T>::stepper_begin(const S&) const -> const_stepper
     {
         return const_stepper(this);
     }
 
     template <class T>
-    inline auto xscalar<T>::stepper_end(const shape_type& shape) const -> const_stepper
+    template <class S>
+    inline auto xscalar<T>::stepper_end(const S&) const -> const_stepper
     {
         return const_stepper(this);
     }
@@ -246,6 +266,19 @@ namespace xt
         return const_storage_iterator(this);
     }
 
+    template <class T>
+    template <class V>
+    inline auto xscalar<T>::load_simd(size_type) const -> simd_type_t<V>
+    {
+        return simd_type_t<V>(static_cast<V>(m_value));
+    }
+
+    template <class T>
+    inline auto xscalar<T>::data_element(size_type) const -> const_reference
+    {
+        return m_value;
+    }
+
     /**********************************
      * xscalar_stepper implementation *
      **********************************/
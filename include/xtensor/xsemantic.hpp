@@ -410,7 +410,7 @@ namespace xt
     template <class E>
     inline auto xsemantic_base<D>::operator=(const xexpression<E>& e) -> derived_type&
     {
-        temporary_type tmp(e);
+        temporary_type tmp = make_temporary(this->derived_cast(), e);
         return this->derived_cast().assign_temporary(tmp);
     }
 
@@ -524,12 +524,18 @@ namespace xt
         this->derived_cast().assign_temporary_impl(tmp);
         return this->derived_cast();
     }
+
+    // The broadcast is trivial when e has the shape of the view and is
+    // itself trivially broadcast; assign_data then checks that the view is
+    // contiguous and has the strides of e to assign it along its storage.
     template <class D>
     template <class E>
     inline auto xview_semantic<D>::assign_xexpression(const xexpression<E>& e) -> derived_type&
     {
         xt::assert_compatible_shape(*this, e);
-        xt::assign_data(*this, e, false);
+        auto shape = this->derived_cast().shape();
+        bool trivial_broadcast = e.derived_cast().broadcast_shape(shape);
+        xt::assign_data(*this, e, trivial_broadcast);
         return this->derived_cast();
     }
 
@@ -538,7 +544,9 @@ namespace xt
     inline auto xview_semantic<D>::computed_assign(const xexpression<E>& e) -> derived_type&
     {
         xt::assert_compatible_shape(*this, e);
-        xt::assign_data(*this, e, false);
+        auto shape = this->derived_cast().shape();
+        bool trivial_broadcast = e.derived_cast().broadcast_shape(shape);
+        xt::assign_data(*this, e, trivial_broadcast);
         return this->derived_cast();
     }
 
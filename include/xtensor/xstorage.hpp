@@ -0,0 +1,1482 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSTORAGE_HPP
+#define XSTORAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <new>
+#include <iterator>
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "xarena.hpp"
+
+namespace xt
+{
+
+#ifndef XTENSOR_DEFAULT_ALIGNMENT
+#define XTENSOR_DEFAULT_ALIGNMENT 64
+#endif
+
+    /*********************************
+     * aligned_allocator declaration *
+     *********************************/
+
+    /**
+     * @class aligned_allocator
+     * @brief Allocator returning memory aligned on a given boundary.
+     *
+     * The aligned_allocator class implements an allocator whose
+     * allocations are aligned on \c Align bytes, so that vectorized
+     * loops can use aligned loads and stores and do not split cache
+     * lines.
+     *
+     * @tparam T The type of the allocated objects.
+     * @tparam Align The alignment in bytes, a power of 2 greater than or
+     * equal to the alignment of \c T.
+     */
+    template <class T, std::size_t Align = XTENSOR_DEFAULT_ALIGNMENT>
+    class aligned_allocator
+    {
+
+    public:
+
+        static_assert((Align & (Align - 1)) == 0, "alignment must be a power of 2");
+        static_assert(Align >= alignof(T), "alignment must not be lower than the alignment of T");
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        template <class U>
+        struct rebind
+        {
+            using other = aligned_allocator<U, Align>;
+        };
+
+        static constexpr std::size_t alignment = Align;
+
+        aligned_allocator() noexcept = default;
+
+        template <class U>
+        aligned_allocator(const aligned_allocator<U, Align>&) noexcept;
+
+        pointer allocate(size_type n, const void* hint = nullptr);
+        void deallocate(pointer p, size_type n) noexcept;
+
+        size_type max_size() const noexcept;
+    };
+
+    template <class T1, std::size_t A1, class T2, std::size_t A2>
+    bool operator==(const aligned_allocator<T1, A1>& lhs, const aligned_allocator<T2, A2>& rhs) noexcept;
+
+    template <class T1, std::size_t A1, class T2, std::size_t A2>
+    bool operator!=(const aligned_allocator<T1, A1>& lhs, const aligned_allocator<T2, A2>& rhs) noexcept;
+
+    /***********************
+     * uvector declaration *
+     ***********************/
+
+    /**
+     * @class uvector
+     * @brief Contiguous container with uninitialized storage.
+     *
+     * The uvector class implements a contiguous sequence container
+     * whose elements are default-initialized instead of
+     * value-initialized: for trivial types, allocating or growing a
+     * uvector leaves the new elements uninitialized rather than
+     * zeroing them. It is the storage of xarray and xtensor, whose
+     * elements are always written by an assignment before they are
+     * read, so that memory is touched only once.
+     *
+     * @tparam T The type of the elements.
+     * @tparam A The allocator of the container.
+     */
+    template <class T, class A = aligned_allocator<T>>
+    class uvector
+    {
+
+    public:
+
+        using self_type = uvector<T, A>;
+        using allocator_type = A;
+        using value_type = T;
+        using size_type = typename std::allocator_traits<A>::size_type;
+        using difference_type = typename std::allocator_traits<A>::difference_type;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+
+        using iterator = pointer;
+        using const_iterator = const_pointer;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        uvector() noexcept;
+        explicit uvector(const allocator_type& alloc) noexcept;
+        explicit uvector(size_type n, const allocator_type& alloc = allocator_type());
+        uvector(size_type n, const value_type& v, const allocator_type& alloc = allocator_type());
+        uvector(std::initializer_list<T> il, const allocator_type& alloc = allocator_type());
+
+        template <class It, class = std::enable_if_t<!std::is_integral<It>::value>>
+        uvector(It first, It last, const allocator_type& alloc = allocator_type());
+
+        ~uvector();
+
+        uvector(const uvector& rhs);
+        uvector& operator=(const uvector& rhs);
+
+        uvector(uvector&& rhs) noexcept;
+        uvector& operator=(uvector&& rhs) noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type max_size() const noexcept;
+
+        void resize(size_type n);
+        void resize(size_type n, const value_type& v);
+        void clear() noexcept;
+
+        reference operator[](size_type idx);
+        const_reference operator[](size_type idx) const;
+
+        reference at(size_type idx);
+        const_reference at(size_type idx) const;
+
+        reference front();
+        const_reference front() const;
+
+        reference back();
+        const_reference back() const;
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        void swap(uvector& rhs) noexcept;
+
+        allocator_type get_allocator() const noexcept;
+
+    private:
+
+        allocator_type m_allocator;
+        pointer p_begin;
+        pointer p_end;
+
+        pointer allocate_init(size_type n);
+        void destroy_deallocate(pointer p, size_type n) noexcept;
+    };
+
+    template <class T, class A>
+    bool operator==(const uvector<T, A>& lhs, const uvector<T, A>& rhs);
+
+    template <class T, class A>
+    bool operator!=(const uvector<T, A>& lhs, const uvector<T, A>& rhs);
+
+    template <class T, class A>
+    bool operator<(const uvector<T, A>& lhs, const uvector<T, A>& rhs);
+
+    template <class T, class A>
+    bool operator<=(const uvector<T, A>& lhs, const uvector<T, A>& rhs);
+
+    template <class T, class A>
+    bool operator>(const uvector<T, A>& lhs, const uvector<T, A>& rhs);
+
+    template <class T, class A>
+    bool operator>=(const uvector<T, A>& lhs, const uvector<T, A>& rhs);
+
+    template <class T, class A>
+    void swap(uvector<T, A>& lhs, uvector<T, A>& rhs) noexcept;
+
+    /***********************
+     * svector declaration *
+     ***********************/
+
+    /**
+     * @class svector
+     * @brief Sequence container with small buffer optimization.
+     *
+     * The svector class implements a sequence container that stores up
+     * to N elements inline and falls back to dynamic allocation beyond
+     * that. It is used for the shape and strides of containers with
+     * dynamic dimension, so that typical expressions can be evaluated
+     * without allocating memory for their metadata.
+     *
+     * @tparam T The type of the elements.
+     * @tparam N The number of elements stored inline.
+     * @tparam A The allocator used when the elements do not fit inline.
+     */
+    template <class T, std::size_t N = 4, class A = std::allocator<T>>
+    class svector
+    {
+
+    public:
+
+        using self_type = svector<T, N, A>;
+        using allocator_type = A;
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+
+        using iterator = pointer;
+        using const_iterator = const_pointer;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        svector() noexcept;
+        ~svector();
+
+        explicit svector(const allocator_type& alloc) noexcept;
+        explicit svector(size_type n, const allocator_type& alloc = allocator_type());
+        svector(size_type n, const value_type& v, const allocator_type& alloc = allocator_type());
+        svector(std::initializer_list<T> il, const allocator_type& alloc = allocator_type());
+
+        template <class It, class = std::enable_if_t<!std::is_integral<It>::value>>
+        svector(It first, It last, const allocator_type& alloc = allocator_type());
+
+        svector(const svector& rhs);
+        svector& operator=(const svector& rhs);
+
+        svector(svector&& rhs) noexcept(std::is_nothrow_move_constructible<value_type>::value);
+        svector& operator=(svector&& rhs) noexcept(std::is_nothrow_move_assignable<value_type>::value);
+
+        svector& operator=(std::initializer_list<T> il);
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type capacity() const noexcept;
+        size_type max_size() const noexcept;
+        bool on_stack() const noexcept;
+
+        void reserve(size_type new_cap);
+        void resize(size_type n);
+        void resize(size_type n, const value_type& v);
+        void clear() noexcept;
+
+        void push_back(const value_type& v);
+        void push_back(value_type&& v);
+        void pop_back();
+
+        iterator insert(const_iterator pos, const value_type& v);
+        iterator erase(const_iterator pos);
+
+        reference operator[](size_type idx);
+        const_reference operator[](size_type idx) const;
+
+        reference at(size_type idx);
+        const_reference at(size_type idx) const;
+
+        reference front();
+        const_reference front() const;
+
+        reference back();
+        const_reference back() const;
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        void swap(svector& rhs);
+
+        allocator_type get_allocator() const noexcept;
+
+    private:
+
+        allocator_type m_allocator;
+        std::array<T, N> m_inline;
+        pointer m_begin;
+        pointer m_end;
+        pointer m_capacity;
+
+        void grow(size_type min_capacity);
+        void release();
+        void steal(svector& rhs);
+    };
+
+    template <class T, std::size_t N, class A>
+    bool operator==(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs);
+
+    template <class T, std::size_t N, class A>
+    bool operator!=(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs);
+
+    template <class T, std::size_t N, class A>
+    bool operator<(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs);
+
+    template <class T, std::size_t N, class A>
+    bool operator<=(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs);
+
+    template <class T, std::size_t N, class A>
+    bool operator>(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs);
+
+    template <class T, std::size_t N, class A>
+    bool operator>=(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs);
+
+    template <class T, std::size_t N, class A>
+    void swap(svector<T, N, A>& lhs, svector<T, N, A>& rhs);
+
+    /***********************
+     * temporary_container *
+     ***********************/
+
+    /**
+     * @struct temporary_container
+     * @brief Storage of the temporaries built for an adapted container.
+     *
+     * When an xexpression is assigned to an xarray_adaptor, it is first
+     * evaluated into a temporary whose elements are stored in a container
+     * of type temporary_container<C>::type. It defaults to C, so that
+     * the storage of the temporary can be moved into the adapted
+     * container; containers that do not own their memory specialize it.
+     *
+     * @tparam C The adapted container type.
+     */
+    template <class C>
+    struct temporary_container
+    {
+        using type = C;
+    };
+
+    template <class C>
+    using temporary_container_t = typename temporary_container<C>::type;
+
+    /************************************
+     * aligned_allocator implementation *
+     ************************************/
+
+    template <class T, std::size_t Align>
+    constexpr std::size_t aligned_allocator<T, Align>::alignment;
+
+    template <class T, std::size_t Align>
+    template <class U>
+    inline aligned_allocator<T, Align>::aligned_allocator(const aligned_allocator<U, Align>&) noexcept
+    {
+    }
+
+    /**
+     * Allocates uninitialized memory for \c n objects of type \c T,
+     * aligned on \c Align bytes. If a temporary_arena is active on the
+     * current thread, the memory is taken from it.
+     * @throw std::bad_alloc if the allocation fails.
+     */
+    template <class T, std::size_t Align>
+    inline auto aligned_allocator<T, Align>::allocate(size_type n, const void*) -> pointer
+    {
+        if (n > max_size())
+        {
+            throw std::bad_alloc();
+        }
+        std::size_t size = n * sizeof(T);
+        temporary_arena* arena = temporary_arena::current();
+        void* res = arena != nullptr ? arena->allocate(size, Align) : detail::aligned_malloc(size, Align);
+        return reinterpret_cast<pointer>(res);
+    }
+
+    /**
+     * Deallocates memory previously allocated with allocate. If a
+     * temporary_arena is active on the current thread, the memory
+     * is cached in it for later allocations.
+     */
+    template <class T, std::size_t Align>
+    inline void aligned_allocator<T, Align>::deallocate(pointer p, size_type n) noexcept
+    {
+        temporary_arena* arena = temporary_arena::current();
+        if (arena != nullptr)
+        {
+            arena->deallocate(p, n * sizeof(T), Align);
+        }
+        else
+        {
+            detail::aligned_free(p);
+        }
+    }
+
+    template <class T, std::size_t Align>
+    inline auto aligned_allocator<T, Align>::max_size() const noexcept -> size_type
+    {
+        return (size_type(-1) - Align - sizeof(void*)) / sizeof(T);
+    }
+
+    template <class T1, std::size_t A1, class T2, std::size_t A2>
+    inline bool operator==(const aligned_allocator<T1, A1>&, const aligned_allocator<T2, A2>&) noexcept
+    {
+        return A1 == A2;
+    }
+
+    template <class T1, std::size_t A1, class T2, std::size_t A2>
+    inline bool operator!=(const aligned_allocator<T1, A1>& lhs, const aligned_allocator<T2, A2>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /**************************
+     * uvector implementation *
+     **************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs an empty uvector.
+     */
+    template <class T, class A>
+    inline uvector<T, A>::uvector() noexcept
+        : uvector(allocator_type())
+    {
+    }
+
+    /**
+     * Constructs an empty uvector with the given allocator.
+     */
+    template <class T, class A>
+    inline uvector<T, A>::uvector(const allocator_type& alloc) noexcept
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+    {
+    }
+
+    /**
+     * Constructs a uvector holding \c n default-initialized elements.
+     * Elements of trivial types are left uninitialized.
+     */
+    template <class T, class A>
+    inline uvector<T, A>::uvector(size_type n, const allocator_type& alloc)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+    {
+        p_begin = allocate_init(n);
+        p_end = p_begin + n;
+    }
+
+    /**
+     * Constructs a uvector holding \c n copies of \c v.
+     */
+    template <class T, class A>
+    inline uvector<T, A>::uvector(size_type n, const value_type& v, const allocator_type& alloc)
+        : uvector(n, alloc)
+    {
+        std::fill(p_begin, p_end, v);
+    }
+
+    /**
+     * Constructs a uvector with the elements of the initializer list.
+     */
+    template <class T, class A>
+    inline uvector<T, A>::uvector(std::initializer_list<T> il, const allocator_type& alloc)
+        : uvector(il.begin(), il.end(), alloc)
+    {
+    }
+
+    /**
+     * Constructs a uvector with the elements of the range [first, last).
+     */
+    template <class T, class A>
+    template <class It, class>
+    inline uvector<T, A>::uvector(It first, It last, const allocator_type& alloc)
+        : uvector(static_cast<size_type>(std::distance(first, last)), alloc)
+    {
+        std::copy(first, last, p_begin);
+    }
+    //@}
+
+    template <class T, class A>
+    inline uvector<T, A>::~uvector()
+    {
+        destroy_deallocate(p_begin, size());
+    }
+
+    template <class T, class A>
+    inline uvector<T, A>::uvector(const uvector& rhs)
+        : uvector(rhs.size(), std::allocator_traits<allocator_type>::select_on_container_copy_construction(rhs.m_allocator))
+    {
+        std::copy(rhs.p_begin, rhs.p_end, p_begin);
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::operator=(const uvector& rhs) -> self_type&
+    {
+        if (this != &rhs)
+        {
+            if (size() != rhs.size())
+            {
+                pointer tmp = allocate_init(rhs.size());
+                destroy_deallocate(p_begin, size());
+                p_begin = tmp;
+                p_end = p_begin + rhs.size();
+            }
+            std::copy(rhs.p_begin, rhs.p_end, p_begin);
+        }
+        return *this;
+    }
+
+    template <class T, class A>
+    inline uvector<T, A>::uvector(uvector&& rhs) noexcept
+        : m_allocator(std::move(rhs.m_allocator)), p_begin(rhs.p_begin), p_end(rhs.p_end)
+    {
+        rhs.p_begin = nullptr;
+        rhs.p_end = nullptr;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::operator=(uvector&& rhs) noexcept -> self_type&
+    {
+        using std::swap;
+        uvector tmp(std::move(rhs));
+        swap(m_allocator, tmp.m_allocator);
+        swap(p_begin, tmp.p_begin);
+        swap(p_end, tmp.p_end);
+        return *this;
+    }
+
+    /**
+     * @name Size
+     */
+    //@{
+    template <class T, class A>
+    inline bool uvector<T, A>::empty() const noexcept
+    {
+        return p_begin == p_end;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::size() const noexcept -> size_type
+    {
+        return static_cast<size_type>(p_end - p_begin);
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::max_size() const noexcept -> size_type
+    {
+        return std::allocator_traits<allocator_type>::max_size(m_allocator);
+    }
+
+    /**
+     * Resizes the uvector to \c n elements. Existing elements are kept
+     * up to the new size; new elements are default-initialized, that is
+     * left uninitialized for trivial types.
+     */
+    template <class T, class A>
+    inline void uvector<T, A>::resize(size_type n)
+    {
+        size_type old_size = size();
+        if (n != old_size)
+        {
+            pointer tmp = allocate_init(n);
+            std::move(p_begin, p_begin + std::min(n, old_size), tmp);
+            destroy_deallocate(p_begin, old_size);
+            p_begin = tmp;
+            p_end = p_begin + n;
+        }
+    }
+
+    /**
+     * Resizes the uvector to \c n elements. New elements are copies of \c v.
+     */
+    template <class T, class A>
+    inline void uvector<T, A>::resize(size_type n, const value_type& v)
+    {
+        size_type old_size = size();
+        resize(n);
+        if (n > old_size)
+        {
+            std::fill(p_begin + old_size, p_end, v);
+        }
+    }
+
+    /**
+     * Destroys all the elements and releases the memory.
+     */
+    template <class T, class A>
+    inline void uvector<T, A>::clear() noexcept
+    {
+        destroy_deallocate(p_begin, size());
+        p_begin = nullptr;
+        p_end = nullptr;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    template <class T, class A>
+    inline auto uvector<T, A>::operator[](size_type idx) -> reference
+    {
+        return p_begin[idx];
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::operator[](size_type idx) const -> const_reference
+    {
+        return p_begin[idx];
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::at(size_type idx) -> reference
+    {
+        if (idx >= size())
+        {
+            throw std::out_of_range("uvector::at: index out of range");
+        }
+        return p_begin[idx];
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::at(size_type idx) const -> const_reference
+    {
+        if (idx >= size())
+        {
+            throw std::out_of_range("uvector::at: index out of range");
+        }
+        return p_begin[idx];
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::front() -> reference
+    {
+        return *p_begin;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::front() const -> const_reference
+    {
+        return *p_begin;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::back() -> reference
+    {
+        return *(p_end - 1);
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::back() const -> const_reference
+    {
+        return *(p_end - 1);
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::data() noexcept -> pointer
+    {
+        return p_begin;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::data() const noexcept -> const_pointer
+    {
+        return p_begin;
+    }
+    //@}
+
+    /**
+     * @name Iterators
+     */
+    //@{
+    template <class T, class A>
+    inline auto uvector<T, A>::begin() noexcept -> iterator
+    {
+        return p_begin;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::end() noexcept -> iterator
+    {
+        return p_end;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::begin() const noexcept -> const_iterator
+    {
+        return p_begin;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::end() const noexcept -> const_iterator
+    {
+        return p_end;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::cbegin() const noexcept -> const_iterator
+    {
+        return p_begin;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::cend() const noexcept -> const_iterator
+    {
+        return p_end;
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(p_end);
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(p_begin);
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(p_end);
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(p_begin);
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return rbegin();
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::crend() const noexcept -> const_reverse_iterator
+    {
+        return rend();
+    }
+    //@}
+
+    template <class T, class A>
+    inline void uvector<T, A>::swap(uvector& rhs) noexcept
+    {
+        using std::swap;
+        swap(m_allocator, rhs.m_allocator);
+        swap(p_begin, rhs.p_begin);
+        swap(p_end, rhs.p_end);
+    }
+
+    template <class T, class A>
+    inline auto uvector<T, A>::get_allocator() const noexcept -> allocator_type
+    {
+        return m_allocator;
+    }
+
+    // Elements are default-initialized with a placement new rather than
+    // constructed through the allocator, which would value-initialize them.
+    template <class T, class A>
+    inline auto uvector<T, A>::allocate_init(size_type n) -> pointer
+    {
+        if (n == 0)
+        {
+            return nullptr;
+        }
+        pointer res = std::allocator_traits<allocator_type>::allocate(m_allocator, n);
+        if (!std::is_trivially_default_constructible<value_type>::value)
+        {
+            size_type i = 0;
+            try
+            {
+                for (; i != n; ++i)
+                {
+                    ::new (static_cast<void*>(res + i)) value_type;
+                }
+            }
+            catch (...)
+            {
+                destroy_deallocate(res, i);
+                throw;
+            }
+        }
+        return res;
+    }
+
+    template <class T, class A>
+    inline void uvector<T, A>::destroy_deallocate(pointer p, size_type n) noexcept
+    {
+        if (p != nullptr)
+        {
+            if (!std::is_trivially_destructible<value_type>::value)
+            {
+                for (pointer it = p; it != p + n; ++it)
+                {
+                    std::allocator_traits<allocator_type>::destroy(m_allocator, it);
+                }
+            }
+            std::allocator_traits<allocator_type>::deallocate(m_allocator, p, n);
+        }
+    }
+
+    template <class T, class A>
+    inline bool operator==(const uvector<T, A>& lhs, const uvector<T, A>& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, class A>
+    inline bool operator!=(const uvector<T, A>& lhs, const uvector<T, A>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, class A>
+    inline bool operator<(const uvector<T, A>& lhs, const uvector<T, A>& rhs)
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T, class A>
+    inline bool operator<=(const uvector<T, A>& lhs, const uvector<T, A>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, class A>
+    inline bool operator>(const uvector<T, A>& lhs, const uvector<T, A>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, class A>
+    inline bool operator>=(const uvector<T, A>& lhs, const uvector<T, A>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    template <class T, class A>
+    inline void swap(uvector<T, A>& lhs, uvector<T, A>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /**************************
+     * svector implementation *
+     **************************/
+
+    // Whether the elements live inline or on the heap, the whole range
+    // [m_begin, m_capacity) holds constructed objects, so that resizing
+    // within the capacity only requires assignments.
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs an empty svector.
+     */
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector() noexcept
+        : svector(allocator_type())
+    {
+    }
+
+    /**
+     * Constructs an empty svector with the given allocator.
+     */
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(const allocator_type& alloc) noexcept
+        : m_allocator(alloc), m_inline(), m_begin(m_inline.data()), m_end(m_inline.data()), m_capacity(m_inline.data() + N)
+    {
+    }
+
+    /**
+     * Constructs an svector holding \c n value-initialized elements.
+     */
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(size_type n, const allocator_type& alloc)
+        : svector(alloc)
+    {
+        resize(n);
+    }
+
+    /**
+     * Constructs an svector holding \c n copies of \c v.
+     */
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(size_type n, const value_type& v, const allocator_type& alloc)
+        : svector(alloc)
+    {
+        resize(n, v);
+    }
+
+    /**
+     * Constructs an svector with the elements of the initializer list.
+     */
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(std::initializer_list<T> il, const allocator_type& alloc)
+        : svector(il.begin(), il.end(), alloc)
+    {
+    }
+
+    /**
+     * Constructs an svector with the elements of the range [first, last).
+     */
+    template <class T, std::size_t N, class A>
+    template <class It, class>
+    inline svector<T, N, A>::svector(It first, It last, const allocator_type& alloc)
+        : svector(alloc)
+    {
+        size_type n = static_cast<size_type>(std::distance(first, last));
+        reserve(n);
+        m_end = std::copy(first, last, m_begin);
+    }
+    //@}
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::~svector()
+    {
+        release();
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(const svector& rhs)
+        : svector(std::allocator_traits<allocator_type>::select_on_container_copy_construction(rhs.m_allocator))
+    {
+        reserve(rhs.size());
+        m_end = std::copy(rhs.begin(), rhs.end(), m_begin);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::operator=(const svector& rhs) -> self_type&
+    {
+        if (this != &rhs)
+        {
+            size_type n = rhs.size();
+            if (n > capacity())
+            {
+                clear();
+                grow(n);
+            }
+            m_end = std::copy(rhs.begin(), rhs.end(), m_begin);
+        }
+        return *this;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(svector&& rhs) noexcept(std::is_nothrow_move_constructible<value_type>::value)
+        : svector(rhs.m_allocator)
+    {
+        steal(rhs);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::operator=(svector&& rhs) noexcept(std::is_nothrow_move_assignable<value_type>::value) -> self_type&
+    {
+        if (this != &rhs)
+        {
+            release();
+            steal(rhs);
+        }
+        return *this;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::operator=(std::initializer_list<T> il) -> self_type&
+    {
+        return operator=(self_type(il));
+    }
+
+    /**
+     * @name Size and capacity
+     */
+    //@{
+    /**
+     * Returns true if the svector holds no element.
+     */
+    template <class T, std::size_t N, class A>
+    inline bool svector<T, N, A>::empty() const noexcept
+    {
+        return m_begin == m_end;
+    }
+
+    /**
+     * Returns the number of elements held by the svector.
+     */
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::size() const noexcept -> size_type
+    {
+        return static_cast<size_type>(m_end - m_begin);
+    }
+
+    /**
+     * Returns the number of elements the svector can hold without
+     * allocating memory.
+     */
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::capacity() const noexcept -> size_type
+    {
+        return static_cast<size_type>(m_capacity - m_begin);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::max_size() const noexcept -> size_type
+    {
+        return std::allocator_traits<allocator_type>::max_size(m_allocator);
+    }
+
+    /**
+     * Returns true if the elements are stored inline.
+     */
+    template <class T, std::size_t N, class A>
+    inline bool svector<T, N, A>::on_stack() const noexcept
+    {
+        return m_begin == m_inline.data();
+    }
+
+    /**
+     * Increases the capacity of the svector to at least \c new_cap.
+     */
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::reserve(size_type new_cap)
+    {
+        if (new_cap > capacity())
+        {
+            grow(new_cap);
+        }
+    }
+
+    /**
+     * Resizes the svector to \c n elements. New elements are
+     * value-initialized.
+     */
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::resize(size_type n)
+    {
+        resize(n, value_type());
+    }
+
+    /**
+     * Resizes the svector to \c n elements. New elements are
+     * copies of \c v.
+     */
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::resize(size_type n, const value_type& v)
+    {
+        size_type old_size = size();
+        reserve(n);
+        if (n > old_size)
+        {
+            std::fill(m_begin + old_size, m_begin + n, v);
+        }
+        m_end = m_begin + n;
+    }
+
+    /**
+     * Removes all the elements. The capacity is left unchanged.
+     */
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::clear() noexcept
+    {
+        m_end = m_begin;
+    }
+    //@}
+
+    /**
+     * @name Modifiers
+     */
+    //@{
+    /**
+     * Appends a copy of \c v at the end of the svector.
+     */
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::push_back(const value_type& v)
+    {
+        if (m_end == m_capacity)
+        {
+            value_type tmp(v);
+            grow(2 * capacity() + 1);
+            *m_end++ = std::move(tmp);
+        }
+        else
+        {
+            *m_end++ = v;
+        }
+    }
+
+    /**
+     * Appends \c v at the end of the svector.
+     */
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::push_back(value_type&& v)
+    {
+        if (m_end == m_capacity)
+        {
+            value_type tmp(std::move(v));
+            grow(2 * capacity() + 1);
+            *m_end++ = std::move(tmp);
+        }
+        else
+        {
+            *m_end++ = std::move(v);
+        }
+    }
+
+    /**
+     * Removes the last element of the svector.
+     */
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::pop_back()
+    {
+        --m_end;
+    }
+
+    /**
+     * Inserts a copy of \c v before \c pos.
+     * @return an iterator to the inserted element.
+     */
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::insert(const_iterator pos, const value_type& v) -> iterator
+    {
+        size_type idx = static_cast<size_type>(pos - m_begin);
+        push_back(v);
+        iterator it = m_begin + idx;
+        std::rotate(it, m_end - 1, m_end);
+        return it;
+    }
+
+    /**
+     * Removes the element at \c pos.
+     * @return an iterator following the removed element.
+     */
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::erase(const_iterator pos) -> iterator
+    {
+        iterator it = m_begin + (pos - m_begin);
+        std::move(it + 1, m_end, it);
+        --m_end;
+        return it;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::swap(svector& rhs)
+    {
+        self_type tmp(std::move(rhs));
+        rhs = std::move(*this);
+        *this = std::move(tmp);
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::operator[](size_type idx) -> reference
+    {
+        return m_begin[idx];
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::operator[](size_type idx) const -> const_reference
+    {
+        return m_begin[idx];
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::at(size_type idx) -> reference
+    {
+        if (idx >= size())
+        {
+            throw std::out_of_range("svector::at: index out of range");
+        }
+        return m_begin[idx];
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::at(size_type idx) const -> const_reference
+    {
+        if (idx >= size())
+        {
+            throw std::out_of_range("svector::at: index out of range");
+        }
+        return m_begin[idx];
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::front() -> reference
+    {
+        return *m_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::front() const -> const_reference
+    {
+        return *m_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::back() -> reference
+    {
+        return *(m_end - 1);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::back() const -> const_reference
+    {
+        return *(m_end - 1);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::data() noexcept -> pointer
+    {
+        return m_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::data() const noexcept -> const_pointer
+    {
+        return m_begin;
+    }
+    //@}
+
+    /**
+     * @name Iterators
+     */
+    //@{
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::begin() noexcept -> iterator
+    {
+        return m_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::end() noexcept -> iterator
+    {
+        return m_end;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::begin() const noexcept -> const_iterator
+    {
+        return m_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::end() const noexcept -> const_iterator
+    {
+        return m_end;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::cbegin() const noexcept -> const_iterator
+    {
+        return m_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::cend() const noexcept -> const_iterator
+    {
+        return m_end;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(m_end);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(m_begin);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(m_end);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(m_begin);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return rbegin();
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::crend() const noexcept -> const_reverse_iterator
+    {
+        return rend();
+    }
+    //@}
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::get_allocator() const noexcept -> allocator_type
+    {
+        return m_allocator;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::grow(size_type min_capacity)
+    {
+        using traits = std::allocator_traits<allocator_type>;
+        size_type new_cap = std::max(min_capacity, 2 * capacity());
+        pointer new_begin = traits::allocate(m_allocator, new_cap);
+        size_type n = size();
+        pointer it = new_begin;
+        try
+        {
+            for (pointer src = m_begin; src != m_end; ++src, ++it)
+            {
+                traits::construct(m_allocator, it, std::move_if_noexcept(*src));
+            }
+            for (; it != new_begin + new_cap; ++it)
+            {
+                traits::construct(m_allocator, it);
+            }
+        }
+        catch (...)
+        {
+            for (pointer p = new_begin; p != it; ++p)
+            {
+                traits::destroy(m_allocator, p);
+            }
+            traits::deallocate(m_allocator, new_begin, new_cap);
+            throw;
+        }
+        release();
+        m_begin = new_begin;
+        m_end = new_begin + n;
+        m_capacity = new_begin + new_cap;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::release()
+    {
+        if (!on_stack())
+        {
+            using traits = std::allocator_traits<allocator_type>;
+            for (pointer p = m_begin; p != m_capacity; ++p)
+            {
+                traits::destroy(m_allocator, p);
+            }
+            traits::deallocate(m_allocator, m_begin, capacity());
+            m_begin = m_inline.data();
+            m_capacity = m_begin + N;
+        }
+        m_end = m_begin;
+    }
+
+    // Expects *this to be empty and inline; leaves rhs empty and inline.
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::steal(svector& rhs)
+    {
+        if (rhs.on_stack())
+        {
+            m_end = std::move(rhs.m_begin, rhs.m_end, m_begin);
+        }
+        else
+        {
+            m_begin = rhs.m_begin;
+            m_end = rhs.m_end;
+            m_capacity = rhs.m_capacity;
+            rhs.m_begin = rhs.m_inline.data();
+            rhs.m_capacity = rhs.m_begin + N;
+        }
+        rhs.m_end = rhs.m_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool operator==(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool operator!=(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool operator<(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs)
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool operator<=(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool operator>(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool operator>=(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void swap(svector<T, N, A>& lhs, svector<T, N, A>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
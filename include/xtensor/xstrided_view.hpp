@@ -0,0 +1,706 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSTRIDED_VIEW_HPP
+#define XSTRIDED_VIEW_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "xarray.hpp"
+#include "xbatch.hpp"
+#include "xiterator.hpp"
+#include "xslice.hpp"
+#include "xview.hpp"
+
+namespace xt
+{
+
+    /*****************************
+     * xstrided_view declaration *
+     *****************************/
+
+    template <class E, class... S>
+    class xstrided_view;
+
+    template <class E, class... S>
+    struct array_inner_types<xstrided_view<E, S...>>
+    {
+        using temporary_type = xarray<typename E::value_type>;
+    };
+
+    /**
+     * @class xstrided_view
+     * @brief Multidimensional view on the elements of a container, described
+     * by strides and an offset.
+     *
+     * The xstrided_view class implements a view on a container, or on another
+     * strided view, sliced by integers, xrange, xstepped_range or xall. Unlike
+     * xview, which maps each index through the slices, the strides and offset of
+     * the view in the storage of the underlying container are computed once at
+     * construction: the view is traversed with the same steppers as containers
+     * and exposes its strides and its storage, so that assignments involving it
+     * take the same paths as assignments of containers.
+     *
+     * The linear storage of the view, given by storage_begin() and storage_end(),
+     * and the SIMD interface are only meaningful when the view is contiguous,
+     * which is_trivial_broadcast checks.
+     *
+     * @tparam E the container type to adapt, providing strides and a random access
+     * storage iterator
+     * @tparam S the slices type describing the shape adaptation
+     */
+    template <class E, class... S>
+    class xstrided_view : public xview_semantic<xstrided_view<E, S...>>
+    {
+
+    public:
+
+        using self_type = xstrided_view<E, S...>;
+        using expression_type = E;
+        using semantic_base = xview_semantic<self_type>;
+
+        using value_type = typename E::value_type;
+        using reference = std::conditional_t<std::is_const<E>::value,
+                                             typename E::const_reference,
+                                             typename E::reference>;
+        using const_reference = typename E::const_reference;
+        using pointer = typename E::pointer;
+        using const_pointer = typename E::const_pointer;
+        using size_type = typename E::size_type;
+        using difference_type = typename E::difference_type;
+
+        using shape_type = typename detail::xview_shape_type<typename E::shape_type, S...>::type;
+        using strides_type = shape_type;
+
+        using stepper = xstepper<self_type>;
+        using const_stepper = xstepper<const self_type>;
+
+        using iterator = xiterator<stepper, shape_type>;
+        using const_iterator = xiterator<const_stepper, shape_type>;
+
+        template <class ST>
+        using broadcast_iterator = xiterator<stepper, ST>;
+        template <class ST>
+        using const_broadcast_iterator = xiterator<const_stepper, ST>;
+
+        using storage_iterator = get_storage_iterator<E>;
+        using const_storage_iterator = typename std::remove_const_t<E>::const_storage_iterator;
+
+        using closure_type = const self_type&;
+
+        template <class... SL>
+        xstrided_view(E& e, SL&&... slices) noexcept;
+
+        template <class OE>
+        self_type& operator=(const xexpression<OE>& e);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+
+        const shape_type& shape() const noexcept;
+        const strides_type& strides() const noexcept;
+        const strides_type& backstrides() const noexcept;
+        size_type data_offset() const noexcept;
+
+        bool is_contiguous() const noexcept;
+
+        template <class... Args>
+        reference operator()(Args... args);
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+
+        template <class ST>
+        bool broadcast_shape(ST& shape) const;
+
+        template <class ST>
+        bool is_trivial_broadcast(const ST& strides) const;
+
+        iterator begin();
+        iterator end();
+
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        template <class ST>
+        broadcast_iterator<ST> xbegin(const ST& shape);
+        template <class ST>
+        broadcast_iterator<ST> xend(const ST& shape);
+
+        template <class ST>
+        const_broadcast_iterator<ST> xbegin(const ST& shape) const;
+        template <class ST>
+        const_broadcast_iterator<ST> xend(const ST& shape) const;
+        template <class ST>
+        const_broadcast_iterator<ST> cxbegin(const ST& shape) const;
+        template <class ST>
+        const_broadcast_iterator<ST> cxend(const ST& shape) const;
+
+        template <class ST>
+        stepper stepper_begin(const ST& shape);
+        template <class ST>
+        stepper stepper_end(const ST& shape);
+
+        template <class ST>
+        const_stepper stepper_begin(const ST& shape) const;
+        template <class ST>
+        const_stepper stepper_end(const ST& shape) const;
+
+        storage_iterator storage_begin();
+        storage_iterator storage_end();
+
+        const_storage_iterator storage_begin() const;
+        const_storage_iterator storage_end() const;
+
+        // The view can be evaluated by batches when its underlying
+        // container can.
+        template <class V>
+        using simd_enabled = has_simd_interface<std::remove_const_t<E>, V>;
+
+        template <class V = value_type>
+        simd_type_t<V> load_simd(size_type i) const;
+        void store_simd(size_type i, const simd_type_t<value_type>& batch);
+
+        reference data_element(size_type i);
+        const_reference data_element(size_type i) const;
+
+    private:
+
+        E& m_e;
+        shape_type m_shape;
+        strides_type m_strides;
+        strides_type m_backstrides;
+        size_type m_offset;
+        bool m_contiguous;
+
+        template <class T>
+        void add_slice(size_type axis, size_type& dim, const xslice<T>& slice) noexcept;
+
+        template <class T>
+        disable_xslice<T, void> add_slice(size_type axis, size_type& dim, const T& index) noexcept;
+
+        using temporary_type = typename array_inner_types<self_type>::temporary_type;
+        void assign_temporary_impl(temporary_type& tmp);
+
+        friend class xview_semantic<xstrided_view<E, S...>>;
+    };
+
+    template <class E, class... S>
+    xstrided_view<E, std::remove_reference_t<S>...> make_xstrided_view(E& e, S&&... slices);
+
+    /********************************
+     * xstrided_view implementation *
+     ********************************/
+
+    /**
+     * @name Constructor
+     */
+    //@{
+    /**
+     * Constructs a strided view on the specified container.
+     * @param e the container to adapt
+     * @param slices the slices list describing the view
+     */
+    template <class E, class... S>
+    template <class... SL>
+    inline xstrided_view<E, S...>::xstrided_view(E& e, SL&&... slices) noexcept
+        : m_e(e), m_shape(make_sequence<shape_type>(e.dimension() - integral_count<S...>(), size_type(0))),
+          m_strides(m_shape), m_backstrides(m_shape), m_offset(0), m_contiguous(false)
+    {
+        std::tuple<const std::remove_reference_t<SL>&...> slice_refs(slices...);
+        size_type axis = 0;
+        size_type dim = 0;
+        for_each([this, &axis, &dim](const auto& s) { this->add_slice(axis++, dim, s); }, slice_refs);
+        for(; axis != m_e.dimension(); ++axis, ++dim)
+        {
+            m_shape[dim] = m_e.shape()[axis];
+            m_strides[dim] = m_e.strides()[axis];
+        }
+        for(size_type i = 0; i != m_shape.size(); ++i)
+        {
+            if(m_shape[i] == 1)
+            {
+                m_strides[i] = 0;
+            }
+            m_backstrides[i] = m_shape[i] == 0 ? 0 : m_strides[i] * (m_shape[i] - 1);
+        }
+        m_contiguous = detail::is_contiguous(m_shape, m_strides);
+    }
+    //@}
+
+    /**
+     * @name Extended copy semantic
+     */
+    //@{
+    /**
+     * The extended assignment operator.
+     */
+    template <class E, class... S>
+    template <class OE>
+    inline auto xstrided_view<E, S...>::operator=(const xexpression<OE>& e) -> self_type&
+    {
+        return semantic_base::operator=(e);
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of elements in the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::size() const noexcept -> size_type
+    {
+        return data_size(m_shape);
+    }
+
+    /**
+     * Returns the number of dimensions of the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the strides of the view, in the storage of the underlying container.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::strides() const noexcept -> const strides_type&
+    {
+        return m_strides;
+    }
+
+    /**
+     * Returns the backstrides of the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::backstrides() const noexcept -> const strides_type&
+    {
+        return m_backstrides;
+    }
+
+    /**
+     * Returns the offset of the first element of the view in the storage of
+     * the underlying container.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::data_offset() const noexcept -> size_type
+    {
+        return m_offset;
+    }
+
+    /**
+     * Returns true if the elements of the view fill a contiguous block of the
+     * storage of the underlying container.
+     */
+    template <class E, class... S>
+    inline bool xstrided_view<E, S...>::is_contiguous() const noexcept
+    {
+        return m_contiguous;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns a reference to the element at the specified position in the view.
+     * @param args a list of indices specifying the position in the view. Indices
+     * must be unsigned integers, the number of indices should be equal or greater
+     * than the number of dimensions of the view.
+     */
+    template <class E, class... S>
+    template <class... Args>
+    inline auto xstrided_view<E, S...>::operator()(Args... args) -> reference
+    {
+        return storage_begin()[xt::data_offset(m_strides, args...)];
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the view.
+     * @param args a list of indices specifying the position in the view. Indices must be
+     * unsigned integers, the number of indices should be equal or greater than the number
+     * of dimensions of the view.
+     */
+    template <class E, class... S>
+    template <class... Args>
+    inline auto xstrided_view<E, S...>::operator()(Args... args) const -> const_reference
+    {
+        return storage_begin()[xt::data_offset(m_strides, args...)];
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the view to the specified parameter.
+     * @param shape the result shape
+     * @return a boolean indicating whether the broadcast is trivial
+     */
+    template <class E, class... S>
+    template <class ST>
+    inline bool xstrided_view<E, S...>::broadcast_shape(ST& shape) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Compares the specified strides with those of the view to see wether
+     * the broadcast is trivial, i.e. whether the view is contiguous and can
+     * be traversed along its linear storage together with an expression of
+     * the specified strides.
+     * @return a boolean indicating whether the broadcast is trivial
+     */
+    template <class E, class... S>
+    template <class ST>
+    inline bool xstrided_view<E, S...>::is_trivial_broadcast(const ST& str) const
+    {
+        return m_contiguous && str.size() == m_strides.size() &&
+            std::equal(str.cbegin(), str.cend(), m_strides.cbegin());
+    }
+    //@}
+
+    template <class E, class... S>
+    template <class T>
+    inline void xstrided_view<E, S...>::add_slice(size_type axis, size_type& dim, const xslice<T>& slice) noexcept
+    {
+        size_type stride = m_e.strides()[axis];
+        m_offset += static_cast<size_type>(first_value(slice)) * stride;
+        m_shape[dim] = static_cast<size_type>(get_size(slice));
+        m_strides[dim] = static_cast<size_type>(step_size(slice)) * stride;
+        ++dim;
+    }
+
+    template <class E, class... S>
+    template <class T>
+    inline auto xstrided_view<E, S...>::add_slice(size_type axis, size_type& /*dim*/, const T& index) noexcept
+        -> disable_xslice<T, void>
+    {
+        m_offset += static_cast<size_type>(index) * m_e.strides()[axis];
+    }
+
+    template <class E, class... S>
+    inline void xstrided_view<E, S...>::assign_temporary_impl(temporary_type& tmp)
+    {
+        if(is_trivial_broadcast(tmp.strides()))
+        {
+            std::copy(tmp.storage_begin(), tmp.storage_end(), storage_begin());
+        }
+        else
+        {
+            std::copy(tmp.storage_begin(), tmp.storage_end(), begin());
+        }
+    }
+
+    /**
+     * Constructs a strided view on the container \c e, sliced by \c slices.
+     * @param e the container to adapt
+     * @param slices the slices list describing the view, integers, xrange,
+     * xstepped_range or xall
+     */
+    template <class E, class... S>
+    inline xstrided_view<E, std::remove_reference_t<S>...> make_xstrided_view(E& e, S&&... slices)
+    {
+        return xstrided_view<E, std::remove_reference_t<S>...>(e, std::forward<S>(slices)...);
+    }
+
+    /****************
+     * iterator api *
+     ****************/
+
+    /**
+     * @name Iterators
+     */
+    //@{
+    /**
+     * Returns an iterator to the first element of the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::begin() -> iterator
+    {
+        return xbegin(shape());
+    }
+
+    /**
+     * Returns an iterator to the element following the last element
+     * of the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::end() -> iterator
+    {
+        return xend(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::begin() const -> const_iterator
+    {
+        return xbegin(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::end() const -> const_iterator
+    {
+        return xend(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::cbegin() const -> const_iterator
+    {
+        return begin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::cend() const -> const_iterator
+    {
+        return end();
+    }
+
+    /**
+     * Returns an iterator to the first element of the view. The
+     * iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::xbegin(const ST& shape) -> broadcast_iterator<ST>
+    {
+        return broadcast_iterator<ST>(stepper_begin(shape), shape);
+    }
+
+    /**
+     * Returns an iterator to the element following the last element of the
+     * view. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::xend(const ST& shape) -> broadcast_iterator<ST>
+    {
+        return broadcast_iterator<ST>(stepper_begin(shape), shape, true);
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the view. The
+     * iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::xbegin(const ST& shape) const -> const_broadcast_iterator<ST>
+    {
+        return const_broadcast_iterator<ST>(stepper_begin(shape), shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element of the
+     * view. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::xend(const ST& shape) const -> const_broadcast_iterator<ST>
+    {
+        return const_broadcast_iterator<ST>(stepper_begin(shape), shape, true);
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the view. The
+     * iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::cxbegin(const ST& shape) const -> const_broadcast_iterator<ST>
+    {
+        return xbegin(shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element of the
+     * view. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::cxend(const ST& shape) const -> const_broadcast_iterator<ST>
+    {
+        return xend(shape);
+    }
+    //@}
+
+    /***************
+     * stepper api *
+     ***************/
+
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::stepper_begin(const ST& shape) -> stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return stepper(this, storage_begin(), offset);
+    }
+
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::stepper_end(const ST& shape) -> stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return stepper(this, storage_end(), offset);
+    }
+
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::stepper_begin(const ST& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, storage_begin(), offset);
+    }
+
+    template <class E, class... S>
+    template <class ST>
+    inline auto xstrided_view<E, S...>::stepper_end(const ST& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, storage_end(), offset);
+    }
+
+    /************************
+     * storage_iterator api *
+     ************************/
+
+    /**
+     * @name Storage iterators
+     */
+    //@{
+    /**
+     * Returns an iterator to the first element of the view in the storage
+     * of the underlying container.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::storage_begin() -> storage_iterator
+    {
+        return m_e.storage_begin() + static_cast<difference_type>(m_offset);
+    }
+
+    /**
+     * Returns an iterator to the element following the last element of a
+     * contiguous view in the storage of the underlying container.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::storage_end() -> storage_iterator
+    {
+        return storage_begin() + static_cast<difference_type>(size());
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the view in the
+     * storage of the underlying container.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::storage_begin() const -> const_storage_iterator
+    {
+        const E& e = m_e;
+        return e.storage_begin() + static_cast<difference_type>(m_offset);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of a contiguous view in the storage of the underlying container.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::storage_end() const -> const_storage_iterator
+    {
+        return storage_begin() + static_cast<difference_type>(size());
+    }
+    //@}
+
+    /**
+     * @name SIMD interface
+     */
+    //@{
+    /**
+     * Loads a batch of elements starting at the i-th element of the linear
+     * storage of a contiguous view.
+     */
+    template <class E, class... S>
+    template <class V>
+    inline auto xstrided_view<E, S...>::load_simd(size_type i) const -> simd_type_t<V>
+    {
+        return m_e.template load_simd<V>(m_offset + i);
+    }
+
+    /**
+     * Stores \c batch to the elements of the linear storage of a contiguous
+     * view starting at the i-th one.
+     */
+    template <class E, class... S>
+    inline void xstrided_view<E, S...>::store_simd(size_type i, const simd_type_t<value_type>& batch)
+    {
+        m_e.store_simd(m_offset + i, batch);
+    }
+
+    /**
+     * Returns a reference to the i-th element of the linear storage of a
+     * contiguous view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::data_element(size_type i) -> reference
+    {
+        return m_e.data_element(m_offset + i);
+    }
+
+    /**
+     * Returns a constant reference to the i-th element of the linear storage
+     * of a contiguous view.
+     */
+    template <class E, class... S>
+    inline auto xstrided_view<E, S...>::data_element(size_type i) const -> const_reference
+    {
+        const E& e = m_e;
+        return e.data_element(m_offset + i);
+    }
+    //@}
+}
+
+#endif
@@ -0,0 +1,233 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_HPP
+#define XTENSOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+#include "xarray_base.hpp"
+#include "xsemantic.hpp"
+
+namespace xt
+{
+
+    /***********************
+     * xtensor declaration *
+     ***********************/
+
+    template <class T, std::size_t N>
+    class xtensor;
+
+    template <class T, std::size_t N>
+    struct array_inner_types<xtensor<T, N>>
+    {
+        using container_type = uvector<T>;
+        using shape_type = std::array<typename container_type::size_type, N>;
+        using strides_type = shape_type;
+        using temporary_type = xtensor<T, N>;
+    };
+
+    /**
+     * @class xtensor
+     * @brief Dense multidimensional container with tensor
+     * semantic and fixed dimension.
+     *
+     * The xtensor class implements a dense multidimensional container
+     * with tensor semantic and fixed dimension. Its shape, strides and
+     * backstrides are stored in std::array objects, so that no dynamic
+     * allocation is performed for them and loops over the dimensions can
+     * be unrolled by the compiler.
+     *
+     * @tparam T The type of objects stored in the container.
+     * @tparam N The dimension of the container.
+     */
+    template <class T, std::size_t N>
+    class xtensor : public xarray_base<xtensor<T, N>>,
+                    public xarray_semantic<xtensor<T, N>>
+    {
+
+    public:
+
+        using self_type = xtensor<T, N>;
+        using base_type = xarray_base<self_type>;
+        using semantic_base = xarray_semantic<self_type>;
+        using container_type = typename base_type::container_type;
+        using value_type = typename base_type::value_type;
+        using reference = typename base_type::reference;
+        using const_reference = typename base_type::const_reference;
+        using pointer = typename base_type::pointer;
+        using const_pointer = typename base_type::const_pointer;
+        using size_type = typename base_type::size_type;
+        using shape_type = typename base_type::shape_type;
+        using strides_type = typename base_type::strides_type;
+
+        using closure_type = const self_type&;
+
+        xtensor();
+        xtensor(nested_initializer_list_t<value_type, N> t);
+        explicit xtensor(const shape_type& shape, layout l = layout::row_major);
+        explicit xtensor(const shape_type& shape, const_reference value, layout l = layout::row_major);
+        explicit xtensor(const shape_type& shape, const strides_type& strides);
+        explicit xtensor(const shape_type& shape, const strides_type& strides, const_reference value);
+
+        ~xtensor() = default;
+
+        xtensor(const xtensor&) = default;
+        xtensor& operator=(const xtensor&) = default;
+
+        xtensor(xtensor&&) = default;
+        xtensor& operator=(xtensor&&) = default;
+
+        template <class E>
+        xtensor(const xexpression<E>& e);
+
+        template <class E>
+        xtensor& operator=(const xexpression<E>& e);
+
+    private:
+
+        container_type m_data;
+
+        container_type& data_impl();
+        const container_type& data_impl() const;
+
+        friend class xarray_base<xtensor<T, N>>;
+    };
+
+    /**************************
+     * xtensor implementation *
+     **************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Allocates an uninitialized xtensor whose dimensions all have
+     * a size of 0. If N is 0, the xtensor holds a single element.
+     */
+    template <class T, std::size_t N>
+    inline xtensor<T, N>::xtensor()
+        : base_type(), m_data()
+    {
+        base_type::reshape(make_sequence<shape_type>(N, size_type(0)), layout::row_major);
+    }
+
+    /**
+     * Allocates an xtensor with nested initializer lists. The depth
+     * of the nested lists must be N.
+     * @param t the elements of the xtensor
+     */
+    template <class T, std::size_t N>
+    inline xtensor<T, N>::xtensor(nested_initializer_list_t<value_type, N> t)
+        : base_type()
+    {
+        base_type::reshape(xt::shape<shape_type>(t), layout::row_major);
+        nested_copy(m_data.begin(), t);
+    }
+
+    /**
+     * Allocates an uninitialized xtensor with the specified shape and
+     * layout.
+     * @param shape the shape of the xtensor
+     * @param l the layout of the xtensor
+     */
+    template <class T, std::size_t N>
+    inline xtensor<T, N>::xtensor(const shape_type& shape, layout l)
+        : base_type()
+    {
+        base_type::reshape(shape, l);
+    }
+
+    /**
+     * Allocates an xtensor with the specified shape and layout. Elements
+     * are initialized to the specified value.
+     * @param shape the shape of the xtensor
+     * @param value the value of the elements
+     * @param l the layout of the xtensor
+     */
+    template <class T, std::size_t N>
+    inline xtensor<T, N>::xtensor(const shape_type& shape, const_reference value, layout l)
+        : base_type()
+    {
+        base_type::reshape(shape, l);
+        std::fill(m_data.begin(), m_data.end(), value);
+    }
+
+    /**
+     * Allocates an uninitialized xtensor with the specified shape and strides.
+     * @param shape the shape of the xtensor
+     * @param strides the strides of the xtensor
+     */
+    template <class T, std::size_t N>
+    inline xtensor<T, N>::xtensor(const shape_type& shape, const strides_type& strides)
+        : base_type()
+    {
+        base_type::reshape(shape, strides);
+    }
+
+    /**
+     * Allocates an uninitialized xtensor with the specified shape and strides.
+     * Elements are initialized to the specified value.
+     * @param shape the shape of the xtensor
+     * @param strides the strides of the xtensor
+     * @param value the value of the elements
+     */
+    template <class T, std::size_t N>
+    inline xtensor<T, N>::xtensor(const shape_type& shape, const strides_type& strides, const_reference value)
+        : base_type()
+    {
+        base_type::reshape(shape, strides);
+        std::fill(m_data.begin(), m_data.end(), value);
+    }
+    //@}
+
+    /**
+     * @name Extended copy semantic
+     */
+    //@{
+    /**
+     * The extended copy constructor.
+     */
+    template <class T, std::size_t N>
+    template <class E>
+    inline xtensor<T, N>::xtensor(const xexpression<E>& e)
+        : base_type()
+    {
+        semantic_base::assign(e);
+    }
+
+    /**
+     * The extended assignment operator.
+     */
+    template <class T, std::size_t N>
+    template <class E>
+    inline auto xtensor<T, N>::operator=(const xexpression<E>& e) -> self_type&
+    {
+        return semantic_base::operator=(e);
+    }
+    //@}
+
+    template <class T, std::size_t N>
+    inline auto xtensor<T, N>::data_impl() -> container_type&
+    {
+        return m_data;
+    }
+
+    template <class T, std::size_t N>
+    inline auto xtensor<T, N>::data_impl() const -> const container_type&
+    {
+        return m_data;
+    }
+}
+
+#endif
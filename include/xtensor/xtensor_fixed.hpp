@@ -0,0 +1,773 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_FIXED_HPP
+#define XTENSOR_FIXED_HPP
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+
+#include "xbatch.hpp"
+#include "xindex.hpp"
+#include "xiterator.hpp"
+#include "xexception.hpp"
+#include "xoperation.hpp"
+#include "xmath.hpp"
+#include "xsemantic.hpp"
+
+namespace xt
+{
+
+    /***********************************
+     * fixed shape computation helpers *
+     ***********************************/
+
+    namespace detail
+    {
+        template <std::size_t... X>
+        constexpr std::size_t fixed_data_size()
+        {
+            const std::size_t s[] = { X..., 1 };
+            std::size_t res = 1;
+            for(std::size_t i = 0; i < sizeof...(X); ++i)
+            {
+                res *= s[i];
+            }
+            return res;
+        }
+
+        // Row-major stride of dimension i; dimensions of size 1 get a stride
+        // of 0 so that they are broadcastable, as for dynamic containers.
+        template <std::size_t... X>
+        constexpr std::size_t fixed_stride(std::size_t i)
+        {
+            const std::size_t s[] = { X..., 1 };
+            std::size_t res = 1;
+            for(std::size_t j = i + 1; j < sizeof...(X); ++j)
+            {
+                res *= s[j];
+            }
+            return s[i] == 1 ? 0 : res;
+        }
+
+        template <std::size_t... X>
+        constexpr std::size_t fixed_backstride(std::size_t i)
+        {
+            const std::size_t s[] = { X..., 1 };
+            return s[i] == 0 ? 0 : fixed_stride<X...>(i) * (s[i] - 1);
+        }
+
+        template <std::size_t... X, std::size_t... J>
+        constexpr std::array<std::size_t, sizeof...(X)> fixed_strides(std::index_sequence<J...>)
+        {
+            return {{ fixed_stride<X...>(J)... }};
+        }
+
+        template <std::size_t... X, std::size_t... J>
+        constexpr std::array<std::size_t, sizeof...(X)> fixed_backstrides(std::index_sequence<J...>)
+        {
+            return {{ fixed_backstride<X...>(J)... }};
+        }
+    }
+
+    /*****************************
+     * xtensor_fixed declaration *
+     *****************************/
+
+    template <class T, std::size_t... I>
+    class xtensor_fixed;
+
+    template <class T, std::size_t... I>
+    struct array_inner_types<xtensor_fixed<T, I...>>
+    {
+        using container_type = std::array<T, detail::fixed_data_size<I...>()>;
+        using shape_type = std::array<typename container_type::size_type, sizeof...(I)>;
+        using strides_type = shape_type;
+        using temporary_type = xtensor_fixed<T, I...>;
+    };
+
+    /**
+     * @class xtensor_fixed
+     * @brief Dense multidimensional container with tensor
+     * semantic and shape fixed at compile time.
+     *
+     * The xtensor_fixed class implements a dense multidimensional
+     * container whose shape is given by its template parameters.
+     * The shape, the strides (row-major layout), the size and the
+     * offsets of the elements are computed at compile time, and the
+     * elements are stored inline in a std::array; no dynamic allocation
+     * is ever performed.
+     *
+     * @tparam T The type of objects stored in the container.
+     * @tparam I The size of each dimension of the container.
+     */
+    template <class T, std::size_t... I>
+    class xtensor_fixed : public xarray_semantic<xtensor_fixed<T, I...>>
+    {
+
+    public:
+
+        using self_type = xtensor_fixed<T, I...>;
+        using semantic_base = xarray_semantic<self_type>;
+
+        using inner_types = array_inner_types<self_type>;
+        using container_type = typename inner_types::container_type;
+        using value_type = typename container_type::value_type;
+        using reference = typename container_type::reference;
+        using const_reference = typename container_type::const_reference;
+        using pointer = typename container_type::pointer;
+        using const_pointer = typename container_type::const_pointer;
+        using size_type = typename container_type::size_type;
+        using difference_type = typename container_type::difference_type;
+
+        using shape_type = typename inner_types::shape_type;
+        using strides_type = typename inner_types::strides_type;
+
+        using stepper = xstepper<self_type>;
+        using const_stepper = xstepper<const self_type>;
+
+        using iterator = xiterator<stepper, shape_type>;
+        using const_iterator = xiterator<const_stepper, shape_type>;
+
+        template <class S>
+        using broadcast_iterator = xiterator<stepper, S>;
+        template <class S>
+        using const_broadcast_iterator = xiterator<const_stepper, S>;
+
+        using storage_iterator = typename container_type::iterator;
+        using const_storage_iterator = typename container_type::const_iterator;
+
+        using closure_type = const self_type&;
+
+        xtensor_fixed() = default;
+        xtensor_fixed(nested_initializer_list_t<value_type, sizeof...(I)> t);
+        explicit xtensor_fixed(const shape_type& shape);
+
+        ~xtensor_fixed() = default;
+
+        xtensor_fixed(const xtensor_fixed&) = default;
+        xtensor_fixed& operator=(const xtensor_fixed&) = default;
+
+        xtensor_fixed(xtensor_fixed&&) = default;
+        xtensor_fixed& operator=(xtensor_fixed&&) = default;
+
+        template <class E>
+        xtensor_fixed(const xexpression<E>& e);
+
+        template <class E>
+        xtensor_fixed& operator=(const xexpression<E>& e);
+
+        static constexpr size_type size() noexcept;
+        static constexpr size_type dimension() noexcept;
+
+        static constexpr const shape_type& shape() noexcept;
+        static constexpr const strides_type& strides() noexcept;
+        static constexpr const strides_type& backstrides() noexcept;
+
+        void reshape(const shape_type& shape);
+
+        template <class... Args>
+        static constexpr size_type data_offset(Args... args) noexcept;
+
+        template <class... Args>
+        reference operator()(Args... args);
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+
+        container_type& data() noexcept;
+        const container_type& data() const noexcept;
+
+        template <class S>
+        bool broadcast_shape(S& shape) const;
+
+        template <class S>
+        bool is_trivial_broadcast(const S& strides) const;
+
+        iterator begin();
+        iterator end();
+
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        template <class S>
+        broadcast_iterator<S> xbegin(const S& shape);
+        template <class S>
+        broadcast_iterator<S> xend(const S& shape);
+
+        template <class S>
+        const_broadcast_iterator<S> xbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> xend(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxbegin(const S& shape) const;
+        template <class S>
+        const_broadcast_iterator<S> cxend(const S& shape) const;
+
+        template <class S>
+        stepper stepper_begin(const S& shape);
+        template <class S>
+        stepper stepper_end(const S& shape);
+
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const;
+        template <class S>
+        const_stepper stepper_end(const S& shape) const;
+
+        storage_iterator storage_begin();
+        storage_iterator storage_end();
+
+        const_storage_iterator storage_begin() const;
+        const_storage_iterator storage_end() const;
+
+        template <class V>
+        using simd_enabled = std::integral_constant<bool, std::is_same<V, value_type>::value &&
+                                                          simd_traits<V>::size != 1>;
+
+        template <class V = value_type>
+        simd_type_t<V> load_simd(size_type i) const;
+        void store_simd(size_type i, const simd_type_t<value_type>& batch);
+
+        reference data_element(size_type i);
+        const_reference data_element(size_type i) const;
+
+    private:
+
+        static constexpr shape_type m_shape = {{ I... }};
+        static constexpr strides_type m_strides = detail::fixed_strides<I...>(std::make_index_sequence<sizeof...(I)>());
+        static constexpr strides_type m_backstrides = detail::fixed_backstrides<I...>(std::make_index_sequence<sizeof...(I)>());
+
+        container_type m_data;
+    };
+
+    template <class T, std::size_t... I>
+    bool operator==(const xtensor_fixed<T, I...>& lhs, const xtensor_fixed<T, I...>& rhs);
+
+    template <class T, std::size_t... I>
+    bool operator!=(const xtensor_fixed<T, I...>& lhs, const xtensor_fixed<T, I...>& rhs);
+
+    /********************************
+     * xtensor_fixed implementation *
+     ********************************/
+
+    template <class T, std::size_t... I>
+    constexpr typename xtensor_fixed<T, I...>::shape_type xtensor_fixed<T, I...>::m_shape;
+
+    template <class T, std::size_t... I>
+    constexpr typename xtensor_fixed<T, I...>::strides_type xtensor_fixed<T, I...>::m_strides;
+
+    template <class T, std::size_t... I>
+    constexpr typename xtensor_fixed<T, I...>::strides_type xtensor_fixed<T, I...>::m_backstrides;
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Allocates an xtensor_fixed with nested initializer lists. The shape
+     * of the nested lists must match the shape of the container.
+     * @param t the elements of the xtensor_fixed
+     */
+    template <class T, std::size_t... I>
+    inline xtensor_fixed<T, I...>::xtensor_fixed(nested_initializer_list_t<value_type, sizeof...(I)> t)
+    {
+        reshape(xt::shape<shape_type>(t));
+        nested_copy(m_data.begin(), t);
+    }
+
+    /**
+     * Allocates an uninitialized xtensor_fixed. This constructor is provided
+     * for compatibility with the dynamic containers; the specified shape must
+     * be the shape of the container.
+     * @param shape the shape of the xtensor_fixed
+     */
+    template <class T, std::size_t... I>
+    inline xtensor_fixed<T, I...>::xtensor_fixed(const shape_type& shape)
+    {
+        reshape(shape);
+    }
+    //@}
+
+    /**
+     * @name Extended copy semantic
+     */
+    //@{
+    /**
+     * The extended copy constructor.
+     */
+    template <class T, std::size_t... I>
+    template <class E>
+    inline xtensor_fixed<T, I...>::xtensor_fixed(const xexpression<E>& e)
+    {
+        semantic_base::assign(e);
+    }
+
+    /**
+     * The extended assignment operator.
+     */
+    template <class T, std::size_t... I>
+    template <class E>
+    inline auto xtensor_fixed<T, I...>::operator=(const xexpression<E>& e) -> self_type&
+    {
+        return semantic_base::operator=(e);
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of element in the container.
+     */
+    template <class T, std::size_t... I>
+    constexpr auto xtensor_fixed<T, I...>::size() noexcept -> size_type
+    {
+        return detail::fixed_data_size<I...>();
+    }
+
+    /**
+     * Returns the number of dimensions of the container.
+     */
+    template <class T, std::size_t... I>
+    constexpr auto xtensor_fixed<T, I...>::dimension() noexcept -> size_type
+    {
+        return sizeof...(I);
+    }
+
+    /**
+     * Returns the shape of the container.
+     */
+    template <class T, std::size_t... I>
+    constexpr auto xtensor_fixed<T, I...>::shape() noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the strides of the container.
+     */
+    template <class T, std::size_t... I>
+    constexpr auto xtensor_fixed<T, I...>::strides() noexcept -> const strides_type&
+    {
+        return m_strides;
+    }
+
+    /**
+     * Returns the backstrides of the container.
+     */
+    template <class T, std::size_t... I>
+    constexpr auto xtensor_fixed<T, I...>::backstrides() noexcept -> const strides_type&
+    {
+        return m_backstrides;
+    }
+
+    /**
+     * Checks that the specified shape is the shape of the container; since
+     * the shape of an xtensor_fixed cannot change, a broadcast_error is
+     * thrown otherwise.
+     * @param shape the new shape
+     */
+    template <class T, std::size_t... I>
+    inline void xtensor_fixed<T, I...>::reshape(const shape_type& shape)
+    {
+        if(shape != m_shape)
+        {
+            throw broadcast_error<size_type>(m_shape, shape);
+        }
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the offset in the buffer of the element at the specified
+     * position. The offset is computed at compile time when the indices
+     * are constant expressions.
+     * @param args a list of indices specifying the position in the container.
+     */
+    template <class T, std::size_t... I>
+    template <class... Args>
+    constexpr auto xtensor_fixed<T, I...>::data_offset(Args... args) noexcept -> size_type
+    {
+        return xt::data_offset(m_strides, args...);
+    }
+
+    /**
+     * Returns a reference to the element at the specified position in the container.
+     * @param args a list of indices specifying the position in the container. Indices
+     * must be unsigned integers, the number of indices should be equal or greater than
+     * the number of dimensions of the container.
+     */
+    template <class T, std::size_t... I>
+    template <class... Args>
+    inline auto xtensor_fixed<T, I...>::operator()(Args... args) -> reference
+    {
+        return m_data[data_offset(args...)];
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the container.
+     * @param args a list of indices specifying the position in the container. Indices
+     * must be unsigned integers, the number of indices should be equal or greater than
+     * the number of dimensions of the container.
+     */
+    template <class T, std::size_t... I>
+    template <class... Args>
+    inline auto xtensor_fixed<T, I...>::operator()(Args... args) const -> const_reference
+    {
+        return m_data[data_offset(args...)];
+    }
+
+    /**
+     * Returns a reference to the buffer containing the elements of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::data() noexcept -> container_type&
+    {
+        return m_data;
+    }
+
+    /**
+     * Returns a constant reference to the buffer containing the elements of the
+     * container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::data() const noexcept -> const container_type&
+    {
+        return m_data;
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the container to the specified parameter.
+     * @param shape the result shape
+     * @return a boolean indicating whether the broadcast is trivial
+     */
+    template <class T, std::size_t... I>
+    template <class S>
+    inline bool xtensor_fixed<T, I...>::broadcast_shape(S& shape) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Compares the specified strides with those of the container to see wether
+     * the broadcast is trivial.
+     * @return a boolean indicating whether the broadcast is trivial
+     */
+    template <class T, std::size_t... I>
+    template <class S>
+    inline bool xtensor_fixed<T, I...>::is_trivial_broadcast(const S& str) const
+    {
+        return str.size() == m_strides.size() &&
+            std::equal(str.cbegin(), str.cend(), m_strides.cbegin());
+    }
+    //@}
+
+    /**
+     * @name Iterators
+     */
+    //@{
+    /**
+     * Returns an iterator to the first element of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::begin() -> iterator
+    {
+        return xbegin(shape());
+    }
+
+    /**
+     * Returns an iterator to the element following the last element
+     * of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::end() -> iterator
+    {
+        return xend(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::begin() const -> const_iterator
+    {
+        return xbegin(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::end() const -> const_iterator
+    {
+        return xend(shape());
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::cbegin() const -> const_iterator
+    {
+        return begin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::cend() const -> const_iterator
+    {
+        return end();
+    }
+
+    /**
+     * Returns an iterator to the first element of the container. The
+     * iteration is broadcasted to the specified shape.
+     * @param shape the shape used for braodcasting
+     */
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::xbegin(const S& shape) -> broadcast_iterator<S>
+    {
+        return broadcast_iterator<S>(stepper_begin(shape), shape);
+    }
+
+    /**
+     * Returns an iterator to the element following the last element of the
+     * container. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::xend(const S& shape) -> broadcast_iterator<S>
+    {
+        return broadcast_iterator<S>(stepper_begin(shape), shape, true);
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the container. The
+     * iteration is broadcasted to the specified shape.
+     * @param shape the shape used for braodcasting
+     */
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::xbegin(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element of the
+     * container. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::xend(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return const_broadcast_iterator<S>(stepper_begin(shape), shape, true);
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the container. The
+     * iteration is broadcasted to the specified shape.
+     * @param shape the shape used for braodcasting
+     */
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::cxbegin(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return xbegin(shape);
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element of the
+     * container. The iteration is broadcasted to the specified shape.
+     * @param shape the shape used for broadcasting
+     */
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::cxend(const S& shape) const -> const_broadcast_iterator<S>
+    {
+        return xend(shape);
+    }
+    //@}
+
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::stepper_begin(const S& shape) -> stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return stepper(this, m_data.begin(), offset);
+    }
+
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::stepper_end(const S& shape) -> stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return stepper(this, m_data.end(), offset);
+    }
+
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::stepper_begin(const S& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, m_data.begin(), offset);
+    }
+
+    template <class T, std::size_t... I>
+    template <class S>
+    inline auto xtensor_fixed<T, I...>::stepper_end(const S& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, m_data.end(), offset);
+    }
+
+    /**
+     * @name Storage iterators
+     */
+    //@{
+    /**
+     * Returns an iterator to the first element of the buffer containing
+     * the elements of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::storage_begin() -> storage_iterator
+    {
+        return m_data.begin();
+    }
+
+    /**
+     * Returns an iterator to the element following the last element of
+     * the buffer containing the elements of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::storage_end() -> storage_iterator
+    {
+        return m_data.end();
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the buffer
+     * containing the elements of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::storage_begin() const -> const_storage_iterator
+    {
+        return m_data.begin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last
+     * element of the buffer containing the elements of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::storage_end() const -> const_storage_iterator
+    {
+        return m_data.end();
+    }
+    //@}
+
+    /**
+     * @name SIMD interface
+     */
+    //@{
+    /**
+     * Loads the batch of elements starting at the i-th element of the
+     * buffer containing the elements of the container.
+     * @tparam V the type of the elements of the batch, which must be the
+     * value type of the container
+     */
+    template <class T, std::size_t... I>
+    template <class V>
+    inline auto xtensor_fixed<T, I...>::load_simd(size_type i) const -> simd_type_t<V>
+    {
+        return simd_type_t<V>::load_unaligned(m_data.data() + i);
+    }
+
+    /**
+     * Stores \c batch to the elements of the buffer starting at the i-th one.
+     */
+    template <class T, std::size_t... I>
+    inline void xtensor_fixed<T, I...>::store_simd(size_type i, const simd_type_t<value_type>& batch)
+    {
+        batch.store_unaligned(m_data.data() + i);
+    }
+
+    /**
+     * Returns a reference to the i-th element of the buffer containing
+     * the elements of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::data_element(size_type i) -> reference
+    {
+        return m_data[i];
+    }
+
+    /**
+     * Returns a constant reference to the i-th element of the buffer
+     * containing the elements of the container.
+     */
+    template <class T, std::size_t... I>
+    inline auto xtensor_fixed<T, I...>::data_element(size_type i) const -> const_reference
+    {
+        return m_data[i];
+    }
+    //@}
+
+    /**************
+     * comparison *
+     **************/
+
+    /**
+     * @memberof xtensor_fixed
+     * Compares the content of two containers.
+     * @param lhs the first container
+     * @param rhs the second container
+     * @return true if the container are equals
+     */
+    template <class T, std::size_t... I>
+    inline bool operator==(const xtensor_fixed<T, I...>& lhs, const xtensor_fixed<T, I...>& rhs)
+    {
+        return lhs.data() == rhs.data();
+    }
+
+    /**
+     * @memberof xtensor_fixed
+     * Compares the content of two containers.
+     * @param lhs the first container
+     * @param rhs the second container
+     * @return true if the container are different
+     */
+    template <class T, std::size_t... I>
+    inline bool operator!=(const xtensor_fixed<T, I...>& lhs, const xtensor_fixed<T, I...>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
@@ -16,6 +16,7 @@
 #include <type_traits>
 #include <initializer_list>
 #include <algorithm>
+#include <memory>
 
 namespace xt
 {
@@ -32,6 +33,9 @@ namespace xt
     template <class... T>
     struct or_;
 
+    template <class... T>
+    struct and_;
+
     template <std::size_t I, class... Args>
     constexpr decltype(auto) argument(Args&&... args) noexcept;
 
@@ -41,6 +45,24 @@ namespace xt
     template <class U>
     struct initializer_dimension;
 
+    template <class S>
+    S make_sequence(typename S::size_type size, typename S::value_type v);
+
+    template <class C>
+    bool resize_container(C& c, typename C::size_type size);
+
+    template <class T, std::size_t N>
+    bool resize_container(std::array<T, N>& a, typename std::array<T, N>::size_type size);
+
+    template <class... S>
+    struct promote_shape;
+
+    template <class T, std::size_t I>
+    struct nested_initializer_list;
+
+    template <class C, class = void>
+    struct container_allocator;
+
     /*******************************
      * remove_class implementation *
      *******************************/
@@ -135,6 +157,21 @@ namespace xt
     {
     };
 
+    /***********************
+     * and_ implementation *
+     ***********************/
+
+    template <>
+    struct and_<> : std::true_type
+    {
+    };
+
+    template <class T, class... Ts>
+    struct and_<T, Ts...>
+        : std::integral_constant<bool, T::value && and_<Ts...>::value>
+    {
+    };
+
     /***************************
      * argument implementation *
      ***************************/
@@ -321,6 +358,169 @@ namespace xt
     {
         return detail::predshape<decltype(t), S>(first, last)(t);
     } 
+
+    /******************************************
+     * nested_initializer_list implementation *
+     ******************************************/
+
+    template <class T, std::size_t I>
+    struct nested_initializer_list
+    {
+        using type = std::initializer_list<typename nested_initializer_list<T, I - 1>::type>;
+    };
+
+    template <class T>
+    struct nested_initializer_list<T, 0>
+    {
+        using type = T;
+    };
+
+    template <class T, std::size_t I>
+    using nested_initializer_list_t = typename nested_initializer_list<T, I>::type;
+
+    /********************************
+     * make_sequence implementation *
+     ********************************/
+
+    namespace detail
+    {
+        template <class S>
+        struct sequence_builder
+        {
+            using sequence_type = S;
+            using value_type = typename S::value_type;
+            using size_type = typename S::size_type;
+
+            inline static sequence_type make(size_type size, value_type v)
+            {
+                return sequence_type(size, v);
+            }
+        };
+
+        template <class T, std::size_t N>
+        struct sequence_builder<std::array<T, N>>
+        {
+            using sequence_type = std::array<T, N>;
+            using value_type = typename sequence_type::value_type;
+            using size_type = typename sequence_type::size_type;
+
+            inline static sequence_type make(size_type /*size*/, value_type v)
+            {
+                sequence_type s;
+                s.fill(v);
+                return s;
+            }
+        };
+    }
+
+    /**
+     * Builds a sequence of type S holding \c size elements equal to \c v.
+     * For fixed-size sequences, the size argument is ignored and all
+     * the elements are set to \c v.
+     */
+    template <class S>
+    inline S make_sequence(typename S::size_type size, typename S::value_type v)
+    {
+        return detail::sequence_builder<S>::make(size, v);
+    }
+
+    /***********************************
+     * resize_container implementation *
+     ***********************************/
+
+    template <class C>
+    inline bool resize_container(C& c, typename C::size_type size)
+    {
+        c.resize(size);
+        return true;
+    }
+
+    template <class T, std::size_t N>
+    inline bool resize_container(std::array<T, N>& /*a*/, typename std::array<T, N>::size_type size)
+    {
+        return size == N;
+    }
+
+    /********************************
+     * promote_shape implementation *
+     ********************************/
+
+    // The promoted shape of fixed-size shapes is a fixed-size shape
+    // whose size is the maximum of the sizes; as soon as a dynamic
+    // shape is involved, the promoted shape is dynamic.
+
+    namespace detail
+    {
+        template <class S1, class S2>
+        struct promote_shape_pair
+        {
+            using type = S1;
+        };
+
+        template <class T, std::size_t N, class S2>
+        struct promote_shape_pair<std::array<T, N>, S2>
+        {
+            using type = S2;
+        };
+
+        template <class T1, std::size_t N1, class T2, std::size_t N2>
+        struct promote_shape_pair<std::array<T1, N1>, std::array<T2, N2>>
+        {
+            using type = std::array<std::common_type_t<T1, T2>, (N1 > N2 ? N1 : N2)>;
+        };
+    }
+
+    template <class S>
+    struct promote_shape<S>
+    {
+        using type = S;
+    };
+
+    template <class S1, class S2, class... S>
+    struct promote_shape<S1, S2, S...>
+    {
+        using type = typename promote_shape<typename detail::promote_shape_pair<S1, S2>::type, S...>::type;
+    };
+
+    template <class... S>
+    using promote_shape_t = typename promote_shape<S...>::type;
+
+    template <class... S>
+    using promote_strides_t = promote_shape_t<S...>;
+
+    /**************************************
+     * container_allocator implementation *
+     **************************************/
+
+    // The allocator type of a container, or std::allocator for
+    // containers that do not expose one.
+
+    namespace detail
+    {
+        template <class... T>
+        struct make_void
+        {
+            using type = void;
+        };
+
+        template <class... T>
+        using void_t = typename make_void<T...>::type;
+    }
+
+    template <class C, class>
+    struct container_allocator
+    {
+        using type = std::allocator<typename C::value_type>;
+    };
+
+    template <class C>
+    struct container_allocator<C, detail::void_t<typename C::allocator_type>>
+    {
+        using type = typename C::allocator_type;
+    };
+
+    template <class C>
+    using container_allocator_t = typename container_allocator<C>::type;
 }
 
 #endif
@@ -12,6 +12,7 @@
 #include <utility>
 #include <type_traits>
 #include <tuple>
+#include <array>
 #include <algorithm>
 
 #include "xarray.hpp"
@@ -36,6 +37,53 @@ namespace xt
         using temporary_type = xarray<typename E::value_type>;
     };
 
+    /********************************
+     * helper functions declaration *
+     ********************************/
+
+    // number of integral types in the specified sequence of types
+    template <class... S>
+    constexpr std::size_t integral_count();
+
+    // number of integral types in the specified sequence of types before specified index.
+    template <class... S>
+    constexpr std::size_t integral_count_before(std::size_t i);
+
+    // index in the specified sequence of types of the ith non-integral type.
+    template <class... S>
+    constexpr std::size_t integral_skip(std::size_t i);
+
+    namespace detail
+    {
+        // A view on an expression with a fixed-size shape has a fixed-size
+        // shape too, integral slices removing one dimension each.
+        template <class ST, class... S>
+        struct xview_shape_type
+        {
+            using type = ST;
+        };
+
+        template <class I, std::size_t L, class... S>
+        struct xview_shape_type<std::array<I, L>, S...>
+        {
+            using type = std::array<I, L - integral_count<S...>()>;
+        };
+
+        // A view on an expression with strides refers to a part of the
+        // storage of this expression; other views only provide iterators.
+        template <class E, class It, bool = has_strides<E>::value>
+        struct xview_data_iterator
+        {
+            using type = It;
+        };
+
+        template <class E, class It>
+        struct xview_data_iterator<E, It, true>
+        {
+            using type = get_storage_iterator<E>;
+        };
+    }
+
     /**
      * @class xview
      * @brief Multidimensional view with tensor semantic.
@@ -44,6 +92,14 @@ namespace xt
      * semantic. It is used to adapt the shape of an xexpression without
      * changing it.
      *
+     * When the underlying expression has strides, as containers do, the
+     * view computes its own strides and the offset of its first element in
+     * the storage of the expression. The assignment functions use them to
+     * traverse a contiguous view along this storage, through data_xbegin()
+     * and the SIMD interface, once is_trivial_broadcast has checked that the
+     * view is contiguous; storage_begin() and storage_end() always iterate
+     * over the elements of the view.
+     *
      * @tparam E the expression type to adapt
      * @tparam S the slices type describing the shape adaptation
      */
@@ -65,19 +121,27 @@ namespace xt
         using size_type = typename E::size_type;
         using difference_type = typename E::difference_type;
 
-        using shape_type = xshape<size_type>;
-        using strides_type = xstrides<size_type>;
+        using shape_type = typename detail::xview_shape_type<typename E::shape_type, S...>::type;
+        using strides_type = shape_type;
         using slice_type = std::tuple<S...>;
 
         using stepper = xview_stepper<E, S...>;
         using const_stepper = xview_stepper<const E, S...>;
 
-        using iterator = xiterator<stepper>;
-        using const_iterator = xiterator<const_stepper>;
+        using iterator = xiterator<stepper, shape_type>;
+        using const_iterator = xiterator<const_stepper, shape_type>;
+
+        template <class ST>
+        using broadcast_iterator = xiterator<stepper, ST>;
+        template <class ST>
+        using const_broadcast_iterator = xiterator<const_stepper, ST>;
         
         using storage_iterator = iterator;
         using const_storage_iterator = const_iterator;
 
+        using data_iterator = typename detail::xview_data_iterator<E, iterator>::type;
+        using const_data_iterator = typename detail::xview_data_iterator<const E, const_iterator>::type;
+
         using closure_type = const self_type&;
 
         template <class... SL>
@@ -86,19 +150,30 @@ namespace xt
         template <class OE>
         self_type& operator=(const xexpression<OE>& e);
 
+        size_type size() const noexcept;
         size_type dimension() const noexcept;
 
         const shape_type& shape() const noexcept;
         const slice_type& slices() const noexcept;
 
+        template <class T = E>
+        std::enable_if_t<detail::has_strides<T>::value, const strides_type&> strides() const noexcept;
+        template <class T = E>
+        std::enable_if_t<detail::has_strides<T>::value, size_type> data_offset() const noexcept;
+
+        bool is_contiguous() const noexcept;
+
         template <class... Args>
         reference operator()(Args... args);
 
         template <class... Args>
         const_reference operator()(Args... args) const;
 
-        bool broadcast_shape(shape_type& shape) const;
-        bool is_trivial_broadcast(const strides_type& strides) const;
+        template <class ST>
+        bool broadcast_shape(ST& shape) const;
+
+        template <class ST>
+        bool is_trivial_broadcast(const ST& strides) const;
 
         iterator begin();
         iterator end();
@@ -108,19 +183,29 @@ namespace xt
         const_iterator cbegin() const;
         const_iterator cend() const;
 
-        iterator xbegin(const shape_type& shape);
-        iterator xend(const shape_type& shape);
-
-        const_iterator xbegin(const shape_type& shape) const;
-        const_iterator xend(const shape_type& shape) const;
-        const_iterator cxbegin(const shape_type& shape) const;
-        const_iterator cxend(const shape_type& shape) const;
-
-        stepper stepper_begin(const shape_type& shape);
-        stepper stepper_end(const shape_type& shape);
-
-        const_stepper stepper_begin(const shape_type& shape) const;
-        const_stepper stepper_end(const shape_type& shape) const;
+        template <class ST>
+        broadcast_iterator<ST> xbegin(const ST& shape);
+        template <class ST>
+        broadcast_iterator<ST> xend(const ST& shape);
+
+        template <class ST>
+        const_broadcast_iterator<ST> xbegin(const ST& shape) const;
+        template <class ST>
+        const_broadcast_iterator<ST> xend(const ST& shape) const;
+        template <class ST>
+        const_broadcast_iterator<ST> cxbegin(const ST& shape) const;
+        template <class ST>
+        const_broadcast_iterator<ST> cxend(const ST& shape) const;
+
+        template <class ST>
+        stepper stepper_begin(const ST& shape);
+        template <class ST>
+        stepper stepper_end(const ST& shape);
+
+        template <class ST>
+        const_stepper stepper_begin(const ST& shape) const;
+        template <class ST>
+        const_stepper stepper_end(const ST& shape) const;
 
         storage_iterator storage_begin();
         storage_iterator storage_end();
@@ -128,11 +213,42 @@ namespace xt
         const_storage_iterator storage_begin() const;
         const_storage_iterator storage_end() const;
 
+        data_iterator data_xbegin();
+        data_iterator data_xend();
+
+        const_data_iterator data_xbegin() const;
+        const_data_iterator data_xend() const;
+
+        // Views with strides can be evaluated by batches when their
+        // underlying expression can.
+        template <class V>
+        using simd_enabled = std::integral_constant<bool, detail::has_strides<E>::value &&
+                                                          has_simd_interface<std::remove_const_t<E>, V>::value>;
+
+        template <class V = value_type>
+        simd_type_t<V> load_simd(size_type i) const;
+        void store_simd(size_type i, const simd_type_t<value_type>& batch);
+
+        reference data_element(size_type i);
+        const_reference data_element(size_type i) const;
+
     private:
 
         E& m_e;
         slice_type m_slices;
         shape_type m_shape;
+        strides_type m_strides;
+        size_type m_data_offset;
+        bool m_contiguous;
+
+        void compute_strides(std::true_type);
+        void compute_strides(std::false_type);
+
+        data_iterator data_xbegin_impl(std::true_type);
+        data_iterator data_xbegin_impl(std::false_type);
+
+        const_data_iterator data_xbegin_impl(std::true_type) const;
+        const_data_iterator data_xbegin_impl(std::false_type) const;
 
         template <size_type... I, class... Args>
         reference access_impl(std::index_sequence<I...>, Args... args);
@@ -230,22 +346,6 @@ namespace xt
     bool operator!=(const xview_stepper<E, S...>& lhs,
                     const xview_stepper<E, S...>& rhs);
 
-    /********************************
-     * helper functions declaration *
-     ********************************/
-
-    // number of integral types in the specified sequence of types
-    template <class... S>
-    constexpr std::size_t integral_count();
-
-    // number of integral types in the specified sequence of types before specified index.
-    template <class... S>
-    constexpr std::size_t integral_count_before(std::size_t i);
-
-    // index in the specified sequence of types of the ith non-integral type.
-    template <class... S>
-    constexpr std::size_t integral_skip(std::size_t i);
-
     /************************
      * xview implementation *
      ************************/
@@ -262,10 +362,10 @@ namespace xt
     template <class E, class... S>
     template <class... SL>
     inline xview<E, S...>::xview(E& e, SL&&... slices) noexcept
-        : m_e(e), m_slices(std::forward<SL>(slices)...)
+        : m_e(e), m_slices(std::forward<SL>(slices)...), m_strides(), m_data_offset(0), m_contiguous(false)
     {
         auto func = [](const auto& s) { return get_size(s); };
-        m_shape.resize(dimension());
+        m_shape = make_sequence<shape_type>(dimension(), size_type(0));
         for (size_type i = 0; i != dimension(); ++i)
         {
             size_type index = integral_skip<S...>(i);
@@ -278,6 +378,7 @@ namespace xt
                 m_shape[i] = m_e.shape()[index];
             }
         }
+        compute_strides(detail::has_strides<E>());
     }
     //@}
 
@@ -300,6 +401,15 @@ namespace xt
      * @name Size and shape
      */
     //@{
+    /**
+     * Returns the number of elements in the view.
+     */
+    template <class E, class... S>
+    inline auto xview<E, S...>::size() const noexcept -> size_type
+    {
+        return data_size(m_shape);
+    }
+
     /**
      * Returns the number of dimensions of the view.
      */
@@ -326,6 +436,41 @@ namespace xt
     {
         return m_slices;
     }
+
+    /**
+     * Returns the strides of the view in the storage of the underlying
+     * expression. Only available when this expression has strides.
+     */
+    template <class E, class... S>
+    template <class T>
+    inline auto xview<E, S...>::strides() const noexcept
+        -> std::enable_if_t<detail::has_strides<T>::value, const strides_type&>
+    {
+        return m_strides;
+    }
+
+    /**
+     * Returns the offset of the first element of the view in the storage
+     * of the underlying expression. Only available when this expression
+     * has strides.
+     */
+    template <class E, class... S>
+    template <class T>
+    inline auto xview<E, S...>::data_offset() const noexcept
+        -> std::enable_if_t<detail::has_strides<T>::value, size_type>
+    {
+        return m_data_offset;
+    }
+
+    /**
+     * Returns true if the underlying expression has strides and the elements
+     * of the view fill a contiguous block of its storage.
+     */
+    template <class E, class... S>
+    inline bool xview<E, S...>::is_contiguous() const noexcept
+    {
+        return m_contiguous;
+    }
     //@}
 
     /**
@@ -369,20 +514,25 @@ namespace xt
      * @return a boolean indicating whether the broadcast is trivial
      */
     template <class E, class... S>
-    inline bool xview<E, S...>::broadcast_shape(shape_type& shape) const
+    template <class ST>
+    inline bool xview<E, S...>::broadcast_shape(ST& shape) const
     {
         return xt::broadcast_shape(m_shape, shape);
     }
 
     /**
      * Compares the specified strides with those of the view to see wether
-     * the broadcast is trivial.
+     * the broadcast is trivial, i.e. whether the view is contiguous and can
+     * be traversed along its linear storage together with an expression of
+     * the specified strides.
      * @return a boolean indicating whether the broadcast is trivial
      */
     template <class E, class... S>
-    inline bool xview<E, S...>::is_trivial_broadcast(const strides_type& strides) const
+    template <class ST>
+    inline bool xview<E, S...>::is_trivial_broadcast(const ST& str) const
     {
-        return false;
+        return m_contiguous && str.size() == m_strides.size() &&
+            std::equal(str.cbegin(), str.cend(), m_strides.cbegin());
     }
     //@}
 
@@ -428,10 +578,45 @@ namespace xt
         return squeeze;
     }
 
+    template <class E, class... S>
+    inline void xview<E, S...>::compute_strides(std::true_type)
+    {
+        auto step_func = [](const auto& s) { return step_size(s); };
+        m_strides = make_sequence<strides_type>(dimension(), size_type(0));
+        for (size_type i = 0; i != dimension(); ++i)
+        {
+            size_type index = integral_skip<S...>(i);
+            size_type stride = m_e.strides()[index];
+            if (index < sizeof...(S))
+            {
+                stride *= apply<size_type>(index, step_func, m_slices);
+            }
+            m_strides[i] = m_shape[i] == 1 ? size_type(0) : stride;
+        }
+        auto first_func = [](const auto& s) { return static_cast<std::size_t>(xt::first_value(s)); };
+        for (size_type i = 0; i != sizeof...(S); ++i)
+        {
+            m_data_offset += apply<size_type>(i, first_func, m_slices) * m_e.strides()[i];
+        }
+        m_contiguous = detail::is_contiguous(m_shape, m_strides);
+    }
+
+    template <class E, class... S>
+    inline void xview<E, S...>::compute_strides(std::false_type)
+    {
+    }
+
     template <class E, class... S>
     inline void xview<E, S...>::assign_temporary_impl(temporary_type& tmp)
     {
-        std::copy(tmp.storage_begin(), tmp.storage_end(), begin());
+        if (is_trivial_broadcast(tmp.strides()))
+        {
+            std::copy(tmp.storage_begin(), tmp.storage_end(), data_xbegin());
+        }
+        else
+        {
+            std::copy(tmp.storage_begin(), tmp.storage_end(), begin());
+        }
     }
 
     template <class E, class... S>
@@ -511,9 +696,10 @@ namespace xt
      * @param shape the shape used for braodcasting
      */
     template <class E, class... S>
-    inline auto xview<E, S...>::xbegin(const shape_type& shape) -> iterator
+    template <class ST>
+    inline auto xview<E, S...>::xbegin(const ST& shape) -> broadcast_iterator<ST>
     {
-        return iterator(stepper_begin(shape), shape);
+        return broadcast_iterator<ST>(stepper_begin(shape), shape);
     }
 
     /**
@@ -522,9 +708,10 @@ namespace xt
      * @param shape the shape used for broadcasting
      */
     template <class E, class... S>
-    inline auto xview<E, S...>::xend(const shape_type& shape) -> iterator
+    template <class ST>
+    inline auto xview<E, S...>::xend(const ST& shape) -> broadcast_iterator<ST>
     {
-        return iterator(stepper_end(shape), shape);
+        return broadcast_iterator<ST>(stepper_begin(shape), shape, true);
     }
 
     /**
@@ -533,9 +720,10 @@ namespace xt
      * @param shape the shape used for braodcasting
      */
     template <class E, class... S>
-    inline auto xview<E, S...>::xbegin(const shape_type& shape) const -> const_iterator
+    template <class ST>
+    inline auto xview<E, S...>::xbegin(const ST& shape) const -> const_broadcast_iterator<ST>
     {
-        return const_iterator(stepper_begin(shape), shape);
+        return const_broadcast_iterator<ST>(stepper_begin(shape), shape);
     }
 
     /**
@@ -544,9 +732,10 @@ namespace xt
      * @param shape the shape used for broadcasting
      */
     template <class E, class... S>
-    inline auto xview<E, S...>::xend(const shape_type& shape) const -> const_iterator
+    template <class ST>
+    inline auto xview<E, S...>::xend(const ST& shape) const -> const_broadcast_iterator<ST>
     {
-        return const_iterator(stepper_end(shape), shape);
+        return const_broadcast_iterator<ST>(stepper_begin(shape), shape, true);
     }
 
     /**
@@ -555,7 +744,8 @@ namespace xt
      * @param shape the shape used for braodcasting
      */
     template <class E, class... S>
-    inline auto xview<E, S...>::cxbegin(const shape_type& shape) const -> const_iterator
+    template <class ST>
+    inline auto xview<E, S...>::cxbegin(const ST& shape) const -> const_broadcast_iterator<ST>
     {
         return xbegin(shape);
     }
@@ -566,7 +756,8 @@ namespace xt
      * @param shape the shape used for broadcasting
      */
     template <class E, class... S>
-    inline auto xview<E, S...>::cxend(const shape_type& shape) const -> const_iterator
+    template <class ST>
+    inline auto xview<E, S...>::cxend(const ST& shape) const -> const_broadcast_iterator<ST>
     {
         return xend(shape);
     }
@@ -577,21 +768,24 @@ namespace xt
      ***************/
 
     template <class E, class... S>
-    inline auto xview<E, S...>::stepper_begin(const shape_type& shape) -> stepper
+    template <class ST>
+    inline auto xview<E, S...>::stepper_begin(const ST& shape) -> stepper
     {
         size_type offset = shape.size() - dimension();
         return stepper(this, m_e.stepper_begin(m_e.shape()), offset);
     }
 
     template <class E, class... S>
-    inline auto xview<E, S...>::stepper_end(const shape_type& shape) -> stepper
+    template <class ST>
+    inline auto xview<E, S...>::stepper_end(const ST& shape) -> stepper
     {
         size_type offset = shape.size() - dimension();
         return stepper(this, m_e.stepper_end(m_e.shape()), offset, true);
     }
 
     template <class E, class... S>
-    inline auto xview<E, S...>::stepper_begin(const shape_type& shape) const -> const_stepper
+    template <class ST>
+    inline auto xview<E, S...>::stepper_begin(const ST& shape) const -> const_stepper
     {
         size_type offset = shape.size() - dimension();
         const E& e = m_e;
@@ -599,7 +793,8 @@ namespace xt
     }
 
     template <class E, class... S>
-    inline auto xview<E, S...>::stepper_end(const shape_type& shape) const -> const_stepper
+    template <class ST>
+    inline auto xview<E, S...>::stepper_end(const ST& shape) const -> const_stepper
     {
         size_type offset = shape.size() - dimension();
         const E& e = m_e;
@@ -655,6 +850,106 @@ namespace xt
     }
     //@}
 
+    // The data iterators refer to the storage of the underlying expression
+    // when it has strides, starting at the first element of the view, and
+    // are used by the assignment functions once they have checked that the
+    // view is contiguous; they are the iterators of the view otherwise.
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_xbegin() -> data_iterator
+    {
+        return data_xbegin_impl(detail::has_strides<E>());
+    }
+
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_xend() -> data_iterator
+    {
+        return data_xbegin() + static_cast<difference_type>(size());
+    }
+
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_xbegin() const -> const_data_iterator
+    {
+        return data_xbegin_impl(detail::has_strides<E>());
+    }
+
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_xend() const -> const_data_iterator
+    {
+        return data_xbegin() + static_cast<difference_type>(size());
+    }
+
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_xbegin_impl(std::true_type) -> data_iterator
+    {
+        return m_e.storage_begin() + static_cast<difference_type>(m_data_offset);
+    }
+
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_xbegin_impl(std::false_type) -> data_iterator
+    {
+        return begin();
+    }
+
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_xbegin_impl(std::true_type) const -> const_data_iterator
+    {
+        const E& e = m_e;
+        return e.storage_begin() + static_cast<difference_type>(m_data_offset);
+    }
+
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_xbegin_impl(std::false_type) const -> const_data_iterator
+    {
+        return begin();
+    }
+
+    /**
+     * @name SIMD interface
+     */
+    //@{
+    /**
+     * Loads a batch of elements starting at the i-th element of the linear
+     * storage of a contiguous view.
+     */
+    template <class E, class... S>
+    template <class V>
+    inline auto xview<E, S...>::load_simd(size_type i) const -> simd_type_t<V>
+    {
+        return m_e.template load_simd<V>(m_data_offset + i);
+    }
+
+    /**
+     * Stores \c batch to the elements of the linear storage of a contiguous
+     * view starting at the i-th one.
+     */
+    template <class E, class... S>
+    inline void xview<E, S...>::store_simd(size_type i, const simd_type_t<value_type>& batch)
+    {
+        m_e.store_simd(m_data_offset + i, batch);
+    }
+
+    /**
+     * Returns a reference to the i-th element of the linear storage of a
+     * contiguous view.
+     */
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_element(size_type i) -> reference
+    {
+        return m_e.data_element(m_data_offset + i);
+    }
+
+    /**
+     * Returns a constant reference to the i-th element of the linear storage
+     * of a contiguous view.
+     */
+    template <class E, class... S>
+    inline auto xview<E, S...>::data_element(size_type i) const -> const_reference
+    {
+        const E& e = m_e;
+        return e.data_element(m_data_offset + i);
+    }
+    //@}
+
     /********************************
      * xview_stepper implementation *
      ********************************/
@@ -687,8 +982,8 @@ namespace xt
         if(dim >= m_offset)
         {
             auto func = [](const auto& s) { return step_size(s); };
-            size_type index = integral_skip<S...>(dim);
-            size_type step_size = apply<size_type>(index, func, p_view->slices());
+            size_type index = integral_skip<S...>(dim - m_offset);
+            size_type step_size = index < sizeof...(S) ? apply<size_type>(index, func, p_view->slices()) : 1;
             m_it.step(index, step_size * n);
         }
     }
@@ -699,8 +994,8 @@ namespace xt
         if(dim >= m_offset)
         {
             auto func = [](const auto& s) { return step_size(s); };
-            size_type index = integral_skip<S...>(dim);
-            size_type step_size = apply<size_type>(index, func, p_view->slices());
+            size_type index = integral_skip<S...>(dim - m_offset);
+            size_type step_size = index < sizeof...(S) ? apply<size_type>(index, func, p_view->slices()) : 1;
             m_it.step_back(index, step_size * n);
         }
     }
@@ -710,12 +1005,11 @@ namespace xt
     {
         if(dim >= m_offset)
         {
-            auto size_func = [](const auto& s) { return get_size(s); };
             auto step_func = [](const auto& s) { return step_size(s); };
-            size_type index = integral_skip<S...>(dim);
-            size_type size = apply<size_type>(index, size_func, p_view->slices());
+            size_type index = integral_skip<S...>(dim - m_offset);
+            size_type size = p_view->shape()[dim - m_offset];
             if(size != 0) size = size - 1;
-            size_type step_size = apply<size_type>(index, step_func, p_view->slices());
+            size_type step_size = index < sizeof...(S) ? apply<size_type>(index, step_func, p_view->slices()) : 1;
             m_it.step_back(index, step_size * size);
         }
     }
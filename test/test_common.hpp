@@ -9,8 +9,55 @@
 #ifndef TEST_COMMON_HPP
 #define TEST_COMMON_HPP
 
+#include <cstddef>
+#include <memory>
+
 namespace xt
 {
+    // Allocator counting the allocations performed through any of its copies.
+    template <class T>
+    struct counting_allocator : std::allocator<T>
+    {
+        using value_type = T;
+
+        template <class U>
+        struct rebind
+        {
+            using other = counting_allocator<U>;
+        };
+
+        counting_allocator(std::size_t* count)
+            : p_count(count)
+        {
+        }
+
+        template <class U>
+        counting_allocator(const counting_allocator<U>& rhs)
+            : p_count(rhs.p_count)
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            ++(*p_count);
+            return std::allocator<T>::allocate(n);
+        }
+
+        std::size_t* p_count;
+    };
+
+    template <class T, class U>
+    inline bool operator==(const counting_allocator<T>& lhs, const counting_allocator<U>& rhs)
+    {
+        return lhs.p_count == rhs.p_count;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const counting_allocator<T>& lhs, const counting_allocator<U>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
     struct layout_result
     {
         using vector_type = std::vector<int>;
@@ -180,6 +227,14 @@ namespace xt
         }
     }
 
+    // Copies the expected data into the container type of V, so that
+    // they can be compared with its storage.
+    template <class V, class C>
+    inline typename V::container_type to_container(const C& data)
+    {
+        return typename V::container_type(data.cbegin(), data.cend());
+    }
+
     template <class V>
     void test_access(V& vec)
     {
@@ -188,7 +243,7 @@ namespace xt
             row_major_result rm;
             vec.reshape(rm.m_shape, layout::row_major);
             assign_array(vec, rm.m_assigner);
-            EXPECT_EQ(vec.data(), rm.m_data);
+            EXPECT_EQ(vec.data(), to_container<V>(rm.m_data));
         }
 
         {
@@ -196,7 +251,7 @@ namespace xt
             column_major_result cm;
             vec.reshape(cm.m_shape, layout::column_major);
             assign_array(vec, cm.m_assigner);
-            EXPECT_EQ(vec.data(), cm.m_data);
+            EXPECT_EQ(vec.data(), to_container<V>(cm.m_data));
         }
 
         {
@@ -204,7 +259,7 @@ namespace xt
             central_major_result cem;
             vec.reshape(cem.m_shape, cem.m_strides);
             assign_array(vec, cem.m_assigner);
-            EXPECT_EQ(vec.data(), cem.m_data);
+            EXPECT_EQ(vec.data(), to_container<V>(cem.m_data));
         }
 
         {
@@ -212,7 +267,7 @@ namespace xt
             unit_shape_result usr;
             vec.reshape(usr.m_shape, layout::row_major);
             assign_array(vec, usr.m_assigner);
-            EXPECT_EQ(vec.data(), usr.m_data);
+            EXPECT_EQ(vec.data(), to_container<V>(usr.m_data));
         }
     }
 
@@ -275,7 +330,7 @@ namespace xt
             row_major_result rm;
             vec.reshape(rm.m_shape, layout::row_major);
             std::copy(rm.data().begin(), rm.data().end(), vec.storage_begin());
-            EXPECT_EQ(rm.data(), vec.data());
+            EXPECT_EQ(to_container<V>(rm.data()), vec.data());
             EXPECT_EQ(vec.storage_end(), vec.data().end());
         }
 
@@ -284,7 +339,7 @@ namespace xt
             column_major_result cm;
             vec.reshape(cm.m_shape, layout::column_major);
             std::copy(cm.data().begin(), cm.data().end(), vec.storage_begin());
-            EXPECT_EQ(cm.data(), vec.data());
+            EXPECT_EQ(to_container<V>(cm.data()), vec.data());
             EXPECT_EQ(vec.storage_end(), vec.data().end());
         }
 
@@ -293,7 +348,7 @@ namespace xt
             central_major_result cem;
             vec.reshape(cem.m_shape, cem.m_strides);
             std::copy(cem.data().begin(), cem.data().end(), vec.storage_begin());
-            EXPECT_EQ(cem.data(), vec.data());
+            EXPECT_EQ(to_container<V>(cem.data()), vec.data());
             EXPECT_EQ(vec.storage_end(), vec.data().end());
         }
 
@@ -302,7 +357,7 @@ namespace xt
             unit_shape_result usr;
             vec.reshape(usr.m_shape, layout::row_major);
             std::copy(usr.data().begin(), usr.data().end(), vec.storage_begin());
-            EXPECT_EQ(usr.data(), vec.data());
+            EXPECT_EQ(to_container<V>(usr.data()), vec.data());
             EXPECT_EQ(vec.storage_end(), vec.data().end());
         }
     }
@@ -0,0 +1,223 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "xtensor/xaccumulator.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using std::size_t;
+
+    xarray<double> make_accumulator_array()
+    {
+        xarray<double> a(xshape<size_t>({ 3, 4, 5 }));
+        for(size_t i = 0; i < 3; ++i)
+        {
+            for(size_t j = 0; j < 4; ++j)
+            {
+                for(size_t k = 0; k < 5; ++k)
+                {
+                    a(i, j, k) = double((i * 7 + j * 3 + k * 11) % 13) - 4.;
+                }
+            }
+        }
+        return a;
+    }
+
+    // Cumulative sum of a along axis, computed with indices.
+    xarray<double> reference_cumsum(const xarray<double>& a, size_t axis)
+    {
+        xarray<double> res = a;
+        for(size_t i = 0; i < 3; ++i)
+        {
+            for(size_t j = 0; j < 4; ++j)
+            {
+                for(size_t k = 0; k < 5; ++k)
+                {
+                    size_t index[] = { i, j, k };
+                    if(index[axis] != 0)
+                    {
+                        --index[axis];
+                        res(i, j, k) += res(index[0], index[1], index[2]);
+                    }
+                }
+            }
+        }
+        return res;
+    }
+
+    TEST(xaccumulator, shape)
+    {
+        xarray<double> a = make_accumulator_array();
+        auto c = cumsum(a, 1);
+        EXPECT_EQ(a.shape(), c.shape());
+        EXPECT_EQ(1, c.axis());
+        EXPECT_THROW(cumsum(a, 3), std::out_of_range);
+    }
+
+    TEST(xaccumulator, cumsum)
+    {
+        xarray<double> a = make_accumulator_array();
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+            xarray<double> ref = reference_cumsum(a, axis);
+
+            // Whole evaluation
+            xarray<double> res = cumsum(a, axis);
+            EXPECT_EQ(ref, res);
+
+            // Element-wise evaluation
+            xarray<double> res2 = cumsum(a, axis) + 0.;
+            EXPECT_EQ(ref, res2);
+            EXPECT_EQ(ref(2, 3, 4), cumsum(a, axis)(2, 3, 4));
+            EXPECT_EQ(ref(1, 2), cumsum(a, axis)(1, 2));
+
+            // Expressions read with steppers
+            auto v = make_xview(a, range(0, 3), range(0, 4), range(0, 5));
+            xarray<double> res3 = cumsum(v, axis);
+            EXPECT_EQ(ref, res3);
+            xarray<double> res4 = cumsum(a * 2., axis);
+            EXPECT_EQ(xarray<double>(ref * 2.), res4);
+        }
+    }
+
+    TEST(xaccumulator, cumprod)
+    {
+        xarray<int> a(xshape<size_t>({ 2, 3 }));
+        a(0, 0) = 1; a(0, 1) = 2; a(0, 2) = 3;
+        a(1, 0) = 4; a(1, 1) = 5; a(1, 2) = 6;
+        xarray<long long> p0 = cumprod(a, 0);
+        xarray<long long> p1 = cumprod(a, 1);
+        EXPECT_EQ(18, p0(1, 2));
+        EXPECT_EQ(2, p0(0, 1));
+        EXPECT_EQ(120, p1(1, 2));
+        EXPECT_EQ(6, p1(0, 2));
+
+        xarray<int8_t> b(xshape<size_t>({ 300 }), int8_t(100));
+        auto s = cumsum(b, 0);
+        bool wide = std::is_same<decltype(s)::value_type, long long>::value;
+        EXPECT_TRUE(wide);
+        xarray<long long> sb = s;
+        EXPECT_EQ(30000, sb(299));
+    }
+
+    TEST(xaccumulator, noalias)
+    {
+        xarray<double> a = make_accumulator_array();
+        xarray<double> res(a.shape());
+        noalias(res) = cumsum(a, 0);
+        EXPECT_EQ(reference_cumsum(a, 0), res);
+
+        xarray<double> col(a.shape(), layout::column_major);
+        noalias(col) = cumsum(a, 2);
+        xarray<double> ref = reference_cumsum(a, 2);
+        EXPECT_TRUE(std::equal(ref.cbegin(), ref.cend(), col.cbegin()));
+
+        xtensor<double, 3> t = a;
+        xtensor<double, 3> rt = cumsum(t, 1);
+        EXPECT_EQ(reference_cumsum(a, 1), rt);
+
+        // contiguous view written along the storage it refers to
+        xarray<double> big(xshape<size_t>({ 5, 4, 5 }), -1.);
+        auto inner = make_xview(big, range(1, 4));
+        noalias(inner) = cumsum(a, 1);
+        EXPECT_EQ(reference_cumsum(a, 1), xarray<double>(inner));
+        EXPECT_EQ(-1., big(0, 3, 4));
+        EXPECT_EQ(-1., big(4, 0, 0));
+
+        // broadcasting along a dimension of size 1
+        xarray<double> b(xshape<size_t>({ 1, 5 }), 1.);
+        xarray<double> c = cumsum(b, 0) + xarray<double>(xshape<size_t>({ 3, 5 }), 0.);
+        EXPECT_EQ(1., c(2, 4));
+    }
+
+    TEST(xaccumulator, parallel)
+    {
+        xarray<double> a = make_accumulator_array();
+        xthread_pool pool(3);
+        set_parallel_threshold(1);
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+            xarray<double> res(a.shape());
+            assign_xexpression(res, cumsum(a, axis), pool);
+            EXPECT_EQ(reference_cumsum(a, axis), res);
+        }
+        set_parallel_threshold(default_parallel_threshold);
+    }
+
+    // Sum counting the elements it accumulates.
+    struct counting_sum : reducers::sum_fun<double>
+    {
+        explicit counting_sum(size_t* count)
+            : p_count(count)
+        {
+        }
+
+        double accumulate(double acc, double v, size_t index) const
+        {
+            ++*p_count;
+            return reducers::sum_fun<double>::accumulate(acc, v, index);
+        }
+
+        size_t* p_count;
+    };
+
+    TEST(xaccumulator, nested)
+    {
+        xarray<double> a = make_accumulator_array();
+        for(size_t axis = 0; axis < 3; ++axis)
+        {
+            xarray<double> ref = reference_cumsum(a, axis);
+            xarray<double> res = cumsum(a, axis) * 2.;
+            EXPECT_EQ(xarray<double>(ref * 2.), res);
+
+            auto c = cumsum(a, axis);
+            EXPECT_TRUE(std::equal(c.cbegin(), c.cend(), ref.cbegin()));
+            EXPECT_EQ(ref(2, 3, 4), c(2, 3, 4));
+
+            // The elements are accumulated once per traversal, whether the
+            // accumulator is assigned or used as an operand, and not once
+            // per access.
+            size_t whole = 0;
+            xarray<double> res2 = accumulate(counting_sum(&whole), a, axis);
+            EXPECT_EQ(ref, res2);
+            size_t nested = 0;
+            auto acc = accumulate(counting_sum(&nested), a, axis);
+            xarray<double> res3 = acc * 2.;
+            EXPECT_EQ(xarray<double>(ref * 2.), res3);
+            EXPECT_EQ(whole, nested);
+            EXPECT_EQ(a.size(), nested);
+            EXPECT_EQ(acc(1, 2, 3), ref(1, 2, 3));
+        }
+    }
+
+    TEST(xaccumulator, operand_change)
+    {
+        xarray<double> a = { 1., 2., 3. };
+        auto c = cumsum(a, 0);
+        EXPECT_EQ(6., c(2));
+        xarray<double> r = c * 1.;
+        EXPECT_EQ(6., r(2));
+        a(0) = 100.;
+        EXPECT_EQ(105., c(2));
+        xarray<double> r2 = c * 1.;
+        EXPECT_EQ(105., r2(2));
+        EXPECT_EQ(105., *(c.cbegin() + 2));
+        EXPECT_EQ(6., r(2));
+    }
+}
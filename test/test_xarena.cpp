@@ -0,0 +1,111 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "xtensor/xarena.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+
+namespace xt
+{
+    using std::size_t;
+    using shape_type = xarray<double>::shape_type;
+
+    TEST(temporary_arena, scope)
+    {
+        EXPECT_EQ(nullptr, temporary_arena::current());
+        {
+            temporary_arena outer;
+            EXPECT_EQ(&outer, temporary_arena::current());
+            {
+                temporary_arena inner;
+                EXPECT_EQ(&inner, temporary_arena::current());
+            }
+            EXPECT_EQ(&outer, temporary_arena::current());
+        }
+        EXPECT_EQ(nullptr, temporary_arena::current());
+    }
+
+    TEST(temporary_arena, assign)
+    {
+        xarray<double> a(shape_type({4, 8}), 1.);
+        xarray<double> b(shape_type({4, 8}), 2.);
+        xarray<double> res(shape_type({4, 8}), 0.);
+
+        temporary_arena scope;
+        for (size_t i = 0; i < 10; ++i)
+        {
+            res = res + a * b;
+        }
+        EXPECT_EQ(20., res(3, 7));
+
+        // The first temporary is allocated while the arena is empty; each
+        // following one reuses the storage released by the previous swap.
+        const auto& stats = scope.stats();
+        size_t bytes = 32 * sizeof(double);
+        EXPECT_EQ(10, stats.allocation_count);
+        EXPECT_EQ(9, stats.recycled_count);
+        EXPECT_EQ(9 * bytes, stats.recycled_bytes);
+        EXPECT_EQ(bytes, stats.cached_bytes);
+
+        scope.release();
+        EXPECT_EQ(0, scope.stats().cached_bytes);
+    }
+
+    TEST(temporary_arena, computed_assign)
+    {
+        xarray<double> a(shape_type({4, 8}), 1.);
+
+        temporary_arena scope;
+        for (size_t i = 0; i < 5; ++i)
+        {
+            xarray<double> res(shape_type({8}), double(i));
+            noalias(res) += a;
+            EXPECT_EQ(double(i + 1), res(3, 7));
+        }
+
+        // The first iteration allocates the initial storage of res and
+        // the temporary, which are then recycled by the next iterations.
+        const auto& stats = scope.stats();
+        EXPECT_EQ(10, stats.allocation_count);
+        EXPECT_EQ(8, stats.recycled_count);
+    }
+
+    TEST(temporary_arena, bounded_cache)
+    {
+        size_t max_bytes = 256 * sizeof(double);
+        temporary_arena scope(max_bytes, 2);
+        const auto& stats = scope.stats();
+        for (size_t i = 1; i < 64; ++i)
+        {
+            xarray<double> a(shape_type({i, 3}), 1.);
+            xarray<double> res = a + a;
+            EXPECT_EQ(2., res(i - 1, 2));
+            EXPECT_LE(stats.cached_bytes, max_bytes);
+        }
+        EXPECT_LT(0, stats.discarded_count);
+
+        // At most two blocks of a given size are kept.
+        scope.release();
+        size_t bytes = 16 * sizeof(double);
+        {
+            xarray<double> a(shape_type({16}), 1.);
+            xarray<double> b(shape_type({16}), 2.);
+            xarray<double> c(shape_type({16}), 3.);
+        }
+        EXPECT_EQ(2 * bytes, stats.cached_bytes);
+        for (size_t i = 0; i < 32; ++i)
+        {
+            xarray<double> a(shape_type({16}), 1.);
+            xarray<double> b(shape_type({16}), 2.);
+            xarray<double> c(shape_type({16}), 3.);
+            EXPECT_LE(stats.cached_bytes, 2 * bytes);
+        }
+        EXPECT_EQ(2 * bytes, stats.cached_bytes);
+    }
+}
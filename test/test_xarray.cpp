@@ -8,6 +8,7 @@
 
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
 #include "test_common.hpp"
 
 namespace xt
@@ -158,5 +159,34 @@ namespace xt
         xarray<int> a;
         EXPECT_EQ(0, a());
     }
-}
 
+    TEST(xarray, allocator)
+    {
+        using array_type = xarray<int, counting_allocator<int>>;
+        std::size_t count = 0;
+        counting_allocator<int> alloc(&count);
+
+        array_type a({2, 3}, 1, layout::row_major, alloc);
+        EXPECT_EQ(1, count);
+        array_type b({2, 3}, 2, layout::row_major, alloc);
+        EXPECT_EQ(2, count);
+
+        {
+            SCOPED_TRACE("assignment temporary");
+            a = a + b;
+            EXPECT_EQ(3, count);
+            EXPECT_EQ(3, a(1, 2));
+            EXPECT_EQ(&count, a.get_allocator().p_count);
+        }
+
+        {
+            SCOPED_TRACE("computed assignment temporary");
+            array_type c({3}, 1, layout::row_major, alloc);
+            count = 0;
+            noalias(c) += a;
+            EXPECT_EQ(1, count);
+            EXPECT_EQ(4, c(1, 2));
+            EXPECT_EQ(&count, c.get_allocator().p_count);
+        }
+    }
+}
@@ -123,5 +123,29 @@ namespace xt
         adaptor_type a(v);
         test_storage_iterator(a);
     }
-}
 
+    TEST(xarray_adaptor, assign_temporary)
+    {
+        using counted_vector = std::vector<int, counting_allocator<int>>;
+        std::size_t count = 0;
+        counting_allocator<int> alloc(&count);
+
+        counted_vector v({1, 2, 3, 4, 5, 6}, alloc);
+        xarray_adaptor<counted_vector> a(v, {2, 3});
+        xarray<int> b(xarray<int>::shape_type({4, 1, 1}));
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            b(i, 0, 0) = int(i + 1);
+        }
+        count = 0;
+
+        // The temporary holding the result is built with the allocator of v
+        // and its buffer is moved into v instead of being copied.
+        a = a + b;
+        EXPECT_EQ(1, count);
+        EXPECT_EQ(24, v.size());
+        EXPECT_EQ(4, a.shape()[0]);
+        EXPECT_EQ(10, a(3, 1, 2));
+        EXPECT_EQ(&count, v.get_allocator().p_count);
+    }
+}
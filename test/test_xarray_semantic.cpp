@@ -8,6 +8,9 @@
 
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xreducer.hpp"
 #include "test_xsemantic.hpp"
 
 namespace xt
@@ -391,5 +394,223 @@ namespace xt
             EXPECT_EQ(tester.res_ru, b);
         }
     }
-}
 
+    TEST(xarray_semantic, broadcast_rows)
+    {
+        using shape_type = xarray<int>::shape_type;
+        xarray<int> a = {{1, 2, 3}, {4, 5, 6}};
+
+        {
+            SCOPED_TRACE("row broadcast");
+            xarray<int> b = {10, 20, 30};
+            xarray<int> res = a + b;
+            xarray<int> expected = {{11, 22, 33}, {14, 25, 36}};
+            EXPECT_EQ(expected, res);
+        }
+
+        {
+            SCOPED_TRACE("column broadcast");
+            xarray<int> c(shape_type({2, 1}));
+            c(0, 0) = 10;
+            c(1, 0) = 20;
+            xarray<int> res = a + c;
+            xarray<int> expected = {{11, 12, 13}, {24, 25, 26}};
+            EXPECT_EQ(expected, res);
+        }
+
+        {
+            SCOPED_TRACE("rows of one element");
+            xarray<int> d(shape_type({3, 1}), 2);
+            xarray<int> res = d + xarray<int>(shape_type({2, 3, 1}), 1);
+            EXPECT_EQ(shape_type({2, 3, 1}), res.shape());
+            EXPECT_EQ(3, res(1, 2, 0));
+        }
+
+        {
+            SCOPED_TRACE("empty array");
+            xarray<int> e(shape_type({2, 0, 3}));
+            xarray<int> res = e + xarray<int>(shape_type({3}), 1);
+            EXPECT_EQ(0, res.size());
+        }
+    }
+
+    bool equal_elements(const xarray<double>& lhs, const xarray<double>& rhs)
+    {
+        return lhs.shape() == rhs.shape() && std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+    }
+
+    TEST(xarray_semantic, transposing_assign)
+    {
+        using shape_type = xarray<double>::shape_type;
+        shape_type shape = { 5, 70, 100 };
+        xarray<double> col(shape, layout::column_major);
+        for(std::size_t i = 0; i < col.size(); ++i)
+        {
+            col.data_element(i) = double(i);
+        }
+        xarray<double> row(shape);
+        EXPECT_EQ(0u, detail::tiled_dimension(row, col));
+        EXPECT_EQ(3u, detail::tiled_dimension(row, row));
+
+        {
+            SCOPED_TRACE("row_major <- column_major");
+            noalias(row) = col;
+            EXPECT_TRUE(equal_elements(col, row));
+            EXPECT_EQ(col(4, 69, 99), row(4, 69, 99));
+        }
+
+        {
+            SCOPED_TRACE("column_major <- row_major");
+            // the traversal runs along the columns, too short to be tiled
+            xarray<double> res(shape, layout::column_major);
+            EXPECT_EQ(3u, detail::tiled_dimension(res, row));
+            noalias(res) = row;
+            EXPECT_TRUE(equal_elements(row, res));
+        }
+
+        {
+            SCOPED_TRACE("broadcast column_major");
+            xarray<double> b(shape_type({ 70, 100 }), layout::column_major);
+            for(std::size_t i = 0; i < b.size(); ++i)
+            {
+                b.data_element(i) = double(i);
+            }
+            EXPECT_EQ(1u, detail::tiled_dimension(row, b));
+            noalias(row) = b;
+            EXPECT_EQ(b(12, 34), row(3, 12, 34));
+            EXPECT_EQ(b(69, 99), row(4, 69, 99));
+        }
+
+        {
+            SCOPED_TRACE("parallel");
+            xthread_pool pool(3);
+            set_parallel_threshold(1);
+            xarray<double> res(shape);
+            assign_xexpression(res, col, pool);
+            set_parallel_threshold(default_parallel_threshold);
+            EXPECT_TRUE(equal_elements(col, res));
+        }
+    }
+
+    TEST(xarray_semantic, column_major_function_assign)
+    {
+        using shape_type = xarray<double>::shape_type;
+        shape_type shape = { 100, 70 };
+        xarray<double> a(shape, layout::column_major);
+        xarray<double> b(shape, layout::column_major);
+        xarray<double> row(shape);
+        for(std::size_t i = 0; i < a.size(); ++i)
+        {
+            a.data_element(i) = double(i);
+            b.data_element(i) = 2. * double(i);
+            row.data_element(i) = double(i);
+        }
+        xarray<double> res(shape, layout::column_major);
+
+        // functions are read in the order of their arguments
+        EXPECT_EQ(0u, contiguous_dimension(a + b, 2));
+        EXPECT_EQ(2u, detail::tiled_dimension(res, a + b));
+        EXPECT_EQ(2u, detail::tiled_dimension(res, 2. * a + 1.));
+        EXPECT_EQ(1u, detail::tiled_dimension(res, row + 1.));
+        EXPECT_EQ(2u, detail::tiled_dimension(row, row * 2.));
+
+        noalias(res) = a + b;
+        EXPECT_EQ(3. * a(99, 69), res(99, 69));
+        EXPECT_EQ(3. * a(12, 34), res(12, 34));
+
+        noalias(res) = row + 1.;
+        EXPECT_EQ(row(99, 69) + 1., res(99, 69));
+        EXPECT_EQ(row(12, 34) + 1., res(12, 34));
+    }
+
+    TEST(xarray_semantic, traversal_order)
+    {
+        using shape_type = xarray<double>::shape_type;
+        xarray<double> row(shape_type({ 4, 1, 3 }));
+        xarray<double> col(shape_type({ 4, 1, 3 }), layout::column_major);
+        EXPECT_EQ(xshape<std::size_t>({ 1, 0, 2 }), detail::traversal_order(row));
+        EXPECT_EQ(xshape<std::size_t>({ 1, 2, 0 }), detail::traversal_order(col));
+
+        // non-trivial broadcasts into column-major containers
+        xarray<double> a(shape_type({ 4, 5, 3 }), layout::column_major);
+        for(std::size_t i = 0; i < a.size(); ++i)
+        {
+            a.data_element(i) = double(i);
+        }
+        xarray<double> b = {1., 2., 3.};
+        xarray<double> res(a.shape(), layout::column_major);
+        noalias(res) = a + b;
+        for(std::size_t i = 0; i < 4; ++i)
+        {
+            for(std::size_t j = 0; j < 5; ++j)
+            {
+                for(std::size_t k = 0; k < 3; ++k)
+                {
+                    EXPECT_EQ(a(i, j, k) + b(k), res(i, j, k));
+                }
+            }
+        }
+
+        xthread_pool pool(2);
+        set_parallel_threshold(1);
+        xarray<double> res2(a.shape(), layout::column_major);
+        assign_xexpression(res2, a + b, pool);
+        set_parallel_threshold(default_parallel_threshold);
+        EXPECT_EQ(res, res2);
+    }
+
+    TEST(xarray_semantic, mergeable_dimensions)
+    {
+        using shape_type = xarray<double>::shape_type;
+        xarray<double> row(shape_type({ 2, 3, 4 }));
+        xarray<double> col(shape_type({ 2, 3, 4 }), layout::column_major);
+        xarray<double> vec(shape_type({ 4 }));
+        EXPECT_TRUE(mergeable_dimensions(row, 3, 1, 2, 4));
+        EXPECT_TRUE(mergeable_dimensions(row, 3, 0, 2, 12));
+        EXPECT_FALSE(mergeable_dimensions(row, 3, 0, 2, 4));
+        EXPECT_FALSE(mergeable_dimensions(col, 3, 1, 2, 4));
+        EXPECT_TRUE(mergeable_dimensions(col, 3, 1, 0, 2));
+        EXPECT_FALSE(mergeable_dimensions(vec, 3, 1, 2, 4));
+        EXPECT_TRUE(mergeable_dimensions(vec, 3, 0, 1, 3));
+        EXPECT_TRUE(mergeable_dimensions(row + 2., 3, 1, 2, 4));
+        EXPECT_FALSE(mergeable_dimensions(row + vec, 3, 1, 2, 4));
+        EXPECT_FALSE(mergeable_dimensions(sum(row, { 0 }), 2, 0, 1, 4));
+    }
+
+    TEST(xarray_semantic, merged_assign)
+    {
+        using shape_type = xarray<double>::shape_type;
+        xarray<double> a(shape_type({ 2, 3, 2, 3, 4, 5 }));
+        for(std::size_t i = 0; i < a.size(); ++i)
+        {
+            a.data_element(i) = double(i);
+        }
+        xarray<double> b(shape_type({ 3, 4, 5 }));
+        for(std::size_t i = 0; i < b.size(); ++i)
+        {
+            b.data_element(i) = double(i) * 0.5;
+        }
+
+        // b is broadcast along the three outermost dimensions, the three
+        // innermost ones are assigned as rows of 60 elements
+        xarray<double> res(a.shape());
+        noalias(res) = a + b;
+        for(std::size_t i = 0; i < res.size(); ++i)
+        {
+            EXPECT_EQ(a.data_element(i) + b.data_element(i % b.size()), res.data_element(i));
+        }
+
+        // a + a is trivial in row-major order but not in column-major
+        // order, all the dimensions but the outermost one are merged
+        xarray<double> col(a.shape(), layout::column_major);
+        noalias(col) = a + a;
+        EXPECT_TRUE(std::equal(col.cbegin(), col.cend(), (a + a).cbegin()));
+
+        xthread_pool pool(2);
+        set_parallel_threshold(1);
+        xarray<double> res2(a.shape());
+        assign_xexpression(res2, a + b, pool);
+        set_parallel_threshold(default_parallel_threshold);
+        EXPECT_EQ(res, res2);
+    }
+}
@@ -0,0 +1,154 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbatch.hpp"
+#include "xtensor/xvectorize.hpp"
+
+namespace xt
+{
+    template <class T>
+    xarray<T> make_test_array(std::size_t size, T offset)
+    {
+        xarray<T> res(typename xarray<T>::shape_type({ size }));
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            res(i) = offset + T(i) / T(7);
+        }
+        return res;
+    }
+
+    TEST(xbatch, simd_interface)
+    {
+        using array_type = xarray<double>;
+        array_type a(array_type::shape_type({ 4 }));
+        xarray<int> b(xarray<int>::shape_type({ 4 }));
+
+        bool simd = simd_traits<double>::size != 1;
+        EXPECT_EQ(simd, (has_simd_interface<array_type, double>::value));
+        EXPECT_EQ(simd, (has_simd_interface<decltype(a + a * 2.), double>::value));
+        EXPECT_EQ(simd, (has_simd_interface<decltype(sqrt(a) * 2.), double>::value));
+        EXPECT_EQ(simd, (has_simd_interface<decltype(exp(a) * sin(a)), double>::value));
+        EXPECT_FALSE((has_simd_interface<decltype(cbrt(a)), double>::value));
+        EXPECT_FALSE((has_simd_interface<array_type, float>::value));
+        EXPECT_FALSE((has_simd_interface<xarray<int>, int>::value));
+        EXPECT_FALSE((has_simd_interface<decltype(a + b), double>::value));
+
+        auto f = vectorize([](double x) { return x + 1.; });
+        EXPECT_FALSE((has_simd_interface<decltype(f(a)), double>::value));
+    }
+
+#if defined(XTENSOR_SIMD_BYTES)
+    template <class T>
+    void test_batch_operations()
+    {
+        using batch_type = simd_type_t<T>;
+        constexpr std::size_t size = batch_type::size;
+        T lhs[size];
+        T rhs[size];
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            lhs[i] = T(i) + T(1.5);
+            rhs[i] = T(2) - T(i);
+        }
+        batch_type b1 = batch_type::load_unaligned(lhs);
+        batch_type b2 = batch_type::load_unaligned(rhs);
+        batch_type sum = b1 + b2;
+        batch_type diff = b1 - b2;
+        batch_type prod = b1 * b2;
+        batch_type quot = b1 / b2;
+        batch_type neg = -b1;
+        batch_type mn = min(b1, b2);
+        batch_type mx = max(b1, b2);
+        batch_type root = sqrt(b1);
+        batch_type mapped = simd_map([](T x, T y) { return std::pow(x, y); }, b1, b2);
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            EXPECT_EQ(lhs[i] + rhs[i], sum[i]);
+            EXPECT_EQ(lhs[i] - rhs[i], diff[i]);
+            EXPECT_EQ(lhs[i] * rhs[i], prod[i]);
+            EXPECT_EQ(lhs[i] / rhs[i], quot[i]);
+            EXPECT_EQ(-lhs[i], neg[i]);
+            EXPECT_EQ(std::min(lhs[i], rhs[i]), mn[i]);
+            EXPECT_EQ(std::max(lhs[i], rhs[i]), mx[i]);
+            EXPECT_EQ(std::sqrt(lhs[i]), root[i]);
+            EXPECT_EQ(std::pow(lhs[i], rhs[i]), mapped[i]);
+        }
+
+        batch_type acc(T(1));
+        acc += b1;
+        acc *= b2;
+        acc -= b1;
+        acc /= b1;
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            EXPECT_EQ(((T(1) + lhs[i]) * rhs[i] - lhs[i]) / lhs[i], acc[i]);
+        }
+    }
+
+    TEST(xbatch, float_operations)
+    {
+        test_batch_operations<float>();
+    }
+
+    TEST(xbatch, double_operations)
+    {
+        test_batch_operations<double>();
+    }
+#endif
+
+    // Sizes around multiples of the batch size exercise both the
+    // vectorized loop and the scalar tail of the trivial assignment.
+    template <class T>
+    void test_simd_assign()
+    {
+        constexpr std::size_t batch_size = simd_traits<T>::size;
+        for(std::size_t size = 0; size < 3 * batch_size + 2; ++size)
+        {
+            xarray<T> a = make_test_array<T>(size, T(0.5));
+            xarray<T> b = make_test_array<T>(size, T(-1));
+            xarray<T> c = make_test_array<T>(size, T(2));
+
+            xarray<T> res1 = a + b * c;
+            xarray<T> res2 = exp(a) * sin(b);
+            xarray<T> res3 = T(2) * sqrt(c) - a / 3;
+            xarray<T> res4 = -fma(a, b, c);
+            ASSERT_EQ(size, res1.size());
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                EXPECT_EQ(a(i) + b(i) * c(i), res1(i));
+                T ref2 = std::exp(a(i)) * std::sin(b(i));
+                EXPECT_NEAR(ref2, res2(i), std::abs(ref2) * 4 * std::numeric_limits<T>::epsilon());
+                EXPECT_EQ(T(2) * std::sqrt(c(i)) - a(i) / 3, res3(i));
+                EXPECT_EQ(-std::fma(a(i), b(i), c(i)), res4(i));
+            }
+
+            xarray<T> d = a;
+            d += b;
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                EXPECT_EQ(a(i) + b(i), d(i));
+            }
+        }
+    }
+
+    TEST(xbatch, float_assign)
+    {
+        test_simd_assign<float>();
+    }
+
+    TEST(xbatch, double_assign)
+    {
+        test_simd_assign<double>();
+    }
+}
@@ -0,0 +1,200 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbatch_math.hpp"
+
+namespace xt
+{
+#if defined(XTENSOR_SIMD_BYTES)
+    // Distance between a computed value and the reference value returned
+    // by the standard library, in units in the last place of the reference.
+    template <class T>
+    double ulp_distance(T value, T ref)
+    {
+        if(std::isnan(ref))
+        {
+            return std::isnan(value) ? 0. : std::numeric_limits<double>::infinity();
+        }
+        if(std::isinf(ref) || ref == T(0))
+        {
+            return value == ref ? 0. : std::numeric_limits<double>::infinity();
+        }
+        int exponent;
+        std::frexp(ref, &exponent);
+        int min_exponent = std::numeric_limits<T>::min_exponent - std::numeric_limits<T>::digits;
+        double ulp = std::ldexp(1., std::max(exponent - std::numeric_limits<T>::digits, min_exponent));
+        return std::abs(double(value) - double(ref)) / ulp;
+    }
+
+    // Applies the batch function to the inputs and checks the results
+    // against the standard function, allowing one more ulp than the
+    // documented bound for the error of the reference.
+    template <class T, class F, class G>
+    void check_ulp(F&& f, G&& ref, const std::vector<T>& inputs, double max_ulp)
+    {
+        using batch_type = simd_type_t<T>;
+        constexpr std::size_t size = batch_type::size;
+        T buffer[size];
+        for(std::size_t i = 0; i < inputs.size(); i += size)
+        {
+            for(std::size_t j = 0; j < size; ++j)
+            {
+                buffer[j] = inputs[(i + j) % inputs.size()];
+            }
+            batch_type res = f(batch_type::load_unaligned(buffer));
+            for(std::size_t j = 0; j < size; ++j)
+            {
+                EXPECT_LE(ulp_distance(res[j], ref(buffer[j])), max_ulp + 1.) << "x = " << buffer[j];
+            }
+        }
+    }
+
+    template <class T>
+    std::vector<T> make_inputs(T low, T high, std::size_t count)
+    {
+        std::vector<T> res(count);
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            res[i] = low + (high - low) * T(i) / T(count - 1);
+        }
+        return res;
+    }
+
+    template <class T>
+    std::vector<T> special_inputs()
+    {
+        using limits = std::numeric_limits<T>;
+        return { T(0), -T(0), limits::infinity(), -limits::infinity(), limits::quiet_NaN(),
+                 limits::min(), limits::denorm_min(), -limits::min(), limits::max(), -limits::max() };
+    }
+
+    template <class T>
+    void test_exp()
+    {
+        auto f = [](const simd_type_t<T>& b) { return exp(b); };
+        auto ref = [](T x) { return std::exp(x); };
+        T high = std::log(std::numeric_limits<T>::max()) + T(1);
+        check_ulp<T>(f, ref, make_inputs<T>(-high - T(30), high, 10007), 1.);
+        check_ulp<T>(f, ref, make_inputs<T>(T(-1), T(1), 1001), 1.);
+        check_ulp<T>(f, ref, special_inputs<T>(), 1.);
+    }
+
+    template <class T>
+    void test_log()
+    {
+        auto f = [](const simd_type_t<T>& b) { return log(b); };
+        auto ref = [](T x) { return std::log(x); };
+        check_ulp<T>(f, ref, make_inputs<T>(T(0.5), T(2), 1001), 1.);
+        check_ulp<T>(f, ref, make_inputs<T>(T(-10), std::numeric_limits<T>::max(), 10007), 1.);
+        check_ulp<T>(f, ref, make_inputs<T>(T(0), T(100) * std::numeric_limits<T>::min(), 1001), 1.);
+        check_ulp<T>(f, ref, special_inputs<T>(), 1.);
+    }
+
+    template <class T>
+    void test_sin_cos(double max_ulp)
+    {
+        auto fsin = [](const simd_type_t<T>& b) { return sin(b); };
+        auto rsin = [](T x) { return std::sin(x); };
+        auto fcos = [](const simd_type_t<T>& b) { return cos(b); };
+        auto rcos = [](T x) { return std::cos(x); };
+        std::vector<T> inputs = make_inputs<T>(T(-100), T(100), 10007);
+        std::vector<T> large = make_inputs<T>(T(-1e6), T(1e6), 10007);
+        check_ulp<T>(fsin, rsin, inputs, max_ulp);
+        check_ulp<T>(fcos, rcos, inputs, max_ulp);
+        check_ulp<T>(fsin, rsin, large, max_ulp);
+        check_ulp<T>(fcos, rcos, large, max_ulp);
+        check_ulp<T>(fsin, rsin, special_inputs<T>(), max_ulp);
+        check_ulp<T>(fcos, rcos, special_inputs<T>(), max_ulp);
+    }
+
+    template <class T>
+    void test_tanh()
+    {
+        auto f = [](const simd_type_t<T>& b) { return tanh(b); };
+        auto ref = [](T x) { return std::tanh(x); };
+        check_ulp<T>(f, ref, make_inputs<T>(T(-1), T(1), 1001), 2.);
+        check_ulp<T>(f, ref, make_inputs<T>(T(-30), T(30), 10007), 2.);
+        check_ulp<T>(f, ref, special_inputs<T>(), 2.);
+    }
+
+    template <class T>
+    void test_erf(double max_ulp)
+    {
+        auto f = [](const simd_type_t<T>& b) { return erf(b); };
+        auto ref = [](T x) { return std::erf(x); };
+        check_ulp<T>(f, ref, make_inputs<T>(T(-1), T(1), 1001), max_ulp);
+        check_ulp<T>(f, ref, make_inputs<T>(T(-8), T(8), 10007), max_ulp);
+        check_ulp<T>(f, ref, special_inputs<T>(), max_ulp);
+    }
+
+    TEST(xbatch_math, exp)
+    {
+        test_exp<float>();
+        test_exp<double>();
+    }
+
+    TEST(xbatch_math, log)
+    {
+        test_log<float>();
+        test_log<double>();
+    }
+
+    TEST(xbatch_math, sin_cos)
+    {
+        test_sin_cos<float>(0.5);
+        test_sin_cos<double>(2.);
+    }
+
+    TEST(xbatch_math, tanh)
+    {
+        test_tanh<float>();
+        test_tanh<double>();
+    }
+
+    TEST(xbatch_math, erf)
+    {
+        test_erf<float>(0.5);
+        test_erf<double>(2.);
+    }
+
+    TEST(xbatch_math, signed_zeros)
+    {
+        using batch_type = simd_type_t<double>;
+        batch_type zero(-0.);
+        EXPECT_TRUE(std::signbit(sin(zero)[0]));
+        EXPECT_TRUE(std::signbit(tanh(zero)[0]));
+        EXPECT_TRUE(std::signbit(erf(zero)[0]));
+        EXPECT_EQ(1., cos(zero)[0]);
+        EXPECT_EQ(1., exp(zero)[0]);
+    }
+#endif
+
+    TEST(xbatch_math, xfunction)
+    {
+        using shape_type = xarray<double>::shape_type;
+        xarray<double> a(shape_type({ 37 }));
+        for(std::size_t i = 0; i < a.size(); ++i)
+        {
+            a(i) = 0.25 * double(i) - 4.;
+        }
+        xarray<double> res = exp(a) + log(a * a + 1.) + sin(a) * cos(a) + tanh(a) - erf(a);
+        for(std::size_t i = 0; i < a.size(); ++i)
+        {
+            double x = a(i);
+            double ref = std::exp(x) + std::log(x * x + 1.) + std::sin(x) * std::cos(x) + std::tanh(x) - std::erf(x);
+            EXPECT_NEAR(ref, res(i), 1e-13 * std::abs(std::exp(x)) + 1e-14);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbroadcast.hpp"
+#include "xtensor/xexception.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using std::size_t;
+
+    template <class T>
+    xarray<T> make_broadcast_column(T first, T second)
+    {
+        xarray<T> c(xshape<size_t>({2, 1}));
+        c(0, 0) = first;
+        c(1, 0) = second;
+        return c;
+    }
+
+    TEST(xbroadcast, shape)
+    {
+        xarray<double> v = {1., 2., 3.};
+        auto b = broadcast(v, {2, 3});
+        EXPECT_EQ(2, b.dimension());
+        EXPECT_EQ(6, b.size());
+        std::array<size_t, 2> expected_shape = {2, 3};
+        EXPECT_EQ(expected_shape, b.shape());
+        std::array<size_t, 2> expected_strides = {0, 1};
+        EXPECT_EQ(expected_strides, b.strides());
+
+        xshape<size_t> shape = {4, 2, 3};
+        auto b2 = broadcast(v, shape);
+        EXPECT_EQ(shape, b2.shape());
+
+        EXPECT_THROW(broadcast(v, {3, 2}), broadcast_error<size_t>);
+        EXPECT_THROW(broadcast(v, {3, 1}), broadcast_error<size_t>);
+    }
+
+    TEST(xbroadcast, access)
+    {
+        xarray<double> v = {1., 2., 3.};
+        auto b = broadcast(v, {2, 3});
+        EXPECT_EQ(3., b(0, 2));
+        EXPECT_EQ(2., b(1, 1));
+        EXPECT_EQ(2., b(5, 1, 1));
+
+        xarray<double> c = make_broadcast_column(1., 2.);
+        auto bc = broadcast(c, {2, 3});
+        EXPECT_EQ(1., bc(0, 2));
+        EXPECT_EQ(2., bc(1, 0));
+        EXPECT_EQ(2., bc(1, 2));
+    }
+
+    TEST(xbroadcast, iterator)
+    {
+        xarray<int> c = make_broadcast_column(1, 2);
+        auto b = broadcast(c, {2, 2, 3});
+        EXPECT_EQ(b.size(), static_cast<size_t>(std::distance(b.cbegin(), b.cend())));
+        std::vector<int> expected = {1, 1, 1, 2, 2, 2, 1, 1, 1, 2, 2, 2};
+        EXPECT_TRUE(std::equal(b.cbegin(), b.cend(), expected.cbegin()));
+    }
+
+    TEST(xbroadcast, assign)
+    {
+        xarray<double> v = {1., 2., 3.};
+        xarray<double> res = broadcast(v, {2, 3});
+        xarray<double> expected = {{1., 2., 3.}, {1., 2., 3.}};
+        EXPECT_EQ(expected, res);
+
+        xarray<double> cres(xshape<size_t>({2, 3}), layout::column_major);
+        cres = broadcast(v, {2, 3});
+        EXPECT_TRUE(std::equal(cres.cbegin(), cres.cend(), expected.cbegin()));
+
+        xarray<double> c = make_broadcast_column(1., 2.);
+        xarray<double> res2 = broadcast(c * 2., {2, 3});
+        xarray<double> expected2 = {{2., 2., 2.}, {4., 4., 4.}};
+        EXPECT_EQ(expected2, res2);
+    }
+
+    TEST(xbroadcast, operand)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> c = make_broadcast_column(1., 2.);
+        xarray<double> v = {1., 2., 3.};
+        xarray<double> res = a * broadcast(c, {2, 3}) + broadcast(v, {1, 3});
+        xarray<double> expected = {{2., 4., 6.}, {9., 12., 15.}};
+        EXPECT_EQ(expected, res);
+
+        xarray<double> res3 = broadcast(v, {3, 2, 3}) + a;
+        EXPECT_EQ(3, res3.dimension());
+        EXPECT_EQ(9., res3(2, 1, 2));
+
+        auto row = make_xview(a, 1);
+        xarray<double> res4 = broadcast(row, {2, 3}) - a;
+        xarray<double> expected4 = {{3., 3., 3.}, {0., 0., 0.}};
+        EXPECT_EQ(expected4, res4);
+    }
+}
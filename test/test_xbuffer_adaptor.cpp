@@ -0,0 +1,67 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "xtensor/xbuffer_adaptor.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "test_common.hpp"
+
+namespace xt
+{
+    using buffer_type = xbuffer_adaptor<int>;
+    using adaptor_type = xarray_adaptor<buffer_type>;
+
+    TEST(xbuffer_adaptor, container)
+    {
+        int data[6] = {1, 2, 3, 4, 5, 6};
+        buffer_type buf(data, 6);
+        EXPECT_EQ(6, buf.size());
+        EXPECT_EQ(data, buf.data());
+        EXPECT_EQ(3, buf[2]);
+        EXPECT_EQ(6, buf.back());
+        EXPECT_EQ(data + 6, buf.end());
+
+        buf.resize(6);
+        EXPECT_THROW(buf.resize(4), std::runtime_error);
+
+        buffer_type copy(buf);
+        EXPECT_EQ(buf.data(), copy.data());
+    }
+
+    TEST(xbuffer_adaptor, access)
+    {
+        row_major_result rm;
+        std::vector<int> data(rm.size());
+        buffer_type buf(data.data(), data.size());
+        adaptor_type a(buf, rm.shape());
+        compare_shape(a, rm);
+        assign_array(a, rm.m_assigner);
+        EXPECT_TRUE(std::equal(data.cbegin(), data.cend(), rm.m_data.cbegin()));
+    }
+
+    TEST(xbuffer_adaptor, assign)
+    {
+        int data[6] = {1, 2, 3, 4, 5, 6};
+        buffer_type buf(data, 6);
+        adaptor_type a(buf, {2, 3});
+        xarray<int> b = {1, 2, 3};
+
+        a = a + b;
+        EXPECT_EQ(data, a.data().data());
+        EXPECT_EQ(9, data[5]);
+
+        noalias(a) += b;
+        EXPECT_EQ(12, data[5]);
+
+        xarray<int> c(xarray<int>::shape_type({2, 2, 3}), 1);
+        EXPECT_THROW(a = a + c, std::runtime_error);
+        EXPECT_EQ(2, a.dimension());
+        EXPECT_EQ(12, a(1, 2));
+    }
+}
@@ -6,6 +6,10 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <array>
+#include <numeric>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
 #include "test_common.hpp"
@@ -193,5 +197,216 @@ namespace xt
         }
     }
 
-}
+    template <class R>
+    void test_decrement(const R& result)
+    {
+        using size_type = typename R::size_type;
+        using vector_type = typename R::vector_type;
+        vector_type data = result.data();
+        xarray_adaptor<typename R::vector_type> a(data, result.shape(), result.strides());
+
+        std::vector<int> forward(a.cbegin(), a.cend());
+        auto iter = a.end();
+        for(size_type i = a.size(); i != 0; --i)
+        {
+            --iter;
+            EXPECT_EQ(forward[i - 1], *iter) << "predecrement operator doesn't give expected result";
+        }
+        EXPECT_EQ(a.begin(), iter) << "iterator doesn't reach the beginning";
+        iter++;
+        EXPECT_EQ(forward[1], *(iter--)) << "postdecrement operator doesn't give expected result";
+        EXPECT_EQ(a.begin(), iter);
+    }
+
+    TEST(xiterator, decrement)
+    {
+        {
+            SCOPED_TRACE("row_major");
+            test_decrement(row_major_result());
+        }
+        {
+            SCOPED_TRACE("column_major");
+            test_decrement(column_major_result());
+        }
+        {
+            SCOPED_TRACE("central_major");
+            test_decrement(central_major_result());
+        }
+        {
+            SCOPED_TRACE("unit_shape");
+            test_decrement(unit_shape_result());
+        }
+    }
+
+    template <class R>
+    void test_random_access(const R& result)
+    {
+        using difference_type = std::ptrdiff_t;
+        using vector_type = typename R::vector_type;
+        vector_type data = result.data();
+        xarray_adaptor<typename R::vector_type> a(data, result.shape(), result.strides());
+
+        using iterator = decltype(a.begin());
+        bool random_access = std::is_same<typename std::iterator_traits<iterator>::iterator_category,
+                                          std::random_access_iterator_tag>::value;
+        EXPECT_TRUE(random_access);
+
+        std::vector<int> forward(a.cbegin(), a.cend());
+        difference_type size = static_cast<difference_type>(a.size());
+        EXPECT_EQ(size, a.end() - a.begin());
+        for(difference_type i = 0; i < size; ++i)
+        {
+            auto iter = a.begin() + i;
+            EXPECT_EQ(forward[std::size_t(i)], *iter) << "operator+ doesn't give expected result";
+            EXPECT_EQ(forward[std::size_t(i)], a.begin()[i]) << "operator[] doesn't give expected result";
+            EXPECT_EQ(i, iter - a.begin());
+            EXPECT_EQ(iter, a.end() - (size - i)) << "operator- doesn't give expected result";
+            iter += size - 1 - i;
+            EXPECT_EQ(forward.back(), *iter) << "operator+= doesn't give expected result";
+            iter -= size - 1 - i;
+            EXPECT_EQ(forward[std::size_t(i)], *iter) << "operator-= doesn't give expected result";
+            EXPECT_TRUE(iter < a.end());
+            EXPECT_TRUE(a.begin() <= iter);
+        }
+        auto last = a.begin();
+        last += size;
+        EXPECT_EQ(a.end(), last);
+        EXPECT_EQ(forward.back(), *(--last));
+    }
+
+    TEST(xiterator, random_access)
+    {
+        {
+            SCOPED_TRACE("row_major");
+            test_random_access(row_major_result());
+        }
+        {
+            SCOPED_TRACE("column_major");
+            test_random_access(column_major_result());
+        }
+        {
+            SCOPED_TRACE("central_major");
+            test_random_access(central_major_result());
+        }
+        {
+            SCOPED_TRACE("unit_shape");
+            test_random_access(unit_shape_result());
+        }
+    }
 
+    TEST(xiterator, sort)
+    {
+        using shape_type = xarray<double>::shape_type;
+        xarray<double> a(shape_type({ 3, 4, 5 }), layout::column_major);
+        for(std::size_t i = 0; i < a.size(); ++i)
+        {
+            a.data_element(i) = double((i * 37) % a.size());
+        }
+        std::sort(a.begin(), a.end());
+        EXPECT_TRUE(std::is_sorted(a.cbegin(), a.cend()));
+        EXPECT_EQ(0., a(0, 0, 0));
+        EXPECT_EQ(1., a(0, 0, 1));
+        EXPECT_EQ(5., a(0, 1, 0));
+        EXPECT_EQ(59., a(2, 3, 4));
+        auto iter = std::lower_bound(a.cbegin(), a.cend(), 42.);
+        EXPECT_EQ(42, iter - a.cbegin());
+
+        // function iterators remain input iterators
+        using iterator = decltype((a + a).cbegin());
+        bool input = std::is_same<typename std::iterator_traits<iterator>::iterator_category,
+                                  std::input_iterator_tag>::value;
+        EXPECT_TRUE(input);
+        EXPECT_EQ(84., *((a + a).cbegin() + 42));
+    }
+
+    // Stepper over the padded rows of a 3 x 4 array stored with a row
+    // stride of 6, recording whether it leaves the elements of the array.
+    class bounded_stepper
+    {
+
+    public:
+
+        using value_type = int;
+        using reference = int;
+        using pointer = const int*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        explicit bounded_stepper(bool* out_of_bounds)
+            : m_position(0), p_out_of_bounds(out_of_bounds)
+        {
+        }
+
+        reference operator*() const
+        {
+            return int(m_position / 6 * 4 + m_position % 6);
+        }
+
+        void step(size_type dim, size_type n = 1)
+        {
+            move(static_cast<difference_type>(n * stride(dim)));
+        }
+
+        void step_back(size_type dim, size_type n = 1)
+        {
+            move(-static_cast<difference_type>(n * stride(dim)));
+        }
+
+        void reset(size_type dim)
+        {
+            move(-static_cast<difference_type>((dim == 0 ? 2 : 3) * stride(dim)));
+        }
+
+        void to_end()
+        {
+        }
+
+    private:
+
+        static size_type stride(size_type dim)
+        {
+            return dim == 0 ? 6 : 1;
+        }
+
+        void move(difference_type n)
+        {
+            m_position = static_cast<size_type>(static_cast<difference_type>(m_position) + n);
+            if(m_position > 15 || m_position % 6 > 3)
+            {
+                *p_out_of_bounds = true;
+            }
+        }
+
+        size_type m_position;
+        bool* p_out_of_bounds;
+    };
+
+    TEST(xiterator, end_in_bounds)
+    {
+        using shape_type = std::array<std::size_t, 2>;
+        using iterator = xiterator<bounded_stepper, shape_type>;
+        shape_type shape = {{ 3, 4 }};
+        bool out_of_bounds = false;
+        iterator first(bounded_stepper(&out_of_bounds), shape);
+        iterator last(bounded_stepper(&out_of_bounds), shape, true);
+
+        std::vector<int> expected(12);
+        std::iota(expected.begin(), expected.end(), 0);
+        EXPECT_TRUE(std::equal(first, last, expected.cbegin()));
+        EXPECT_EQ(11, *(last - 1));
+        iterator it = last;
+        --it;
+        EXPECT_EQ(11, *it);
+        it = first + 12;
+        EXPECT_EQ(last, it);
+        it -= 5;
+        EXPECT_EQ(7, *it);
+        it = first;
+        for(std::size_t i = 0; i < 12; ++i, ++it)
+        {
+        }
+        EXPECT_EQ(last, it);
+        EXPECT_EQ(11, *(--it));
+        EXPECT_FALSE(out_of_bounds);
+    }
+}
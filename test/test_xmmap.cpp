@@ -0,0 +1,244 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "xtensor/xmmap.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xview.hpp"
+#include "test_common.hpp"
+
+namespace xt
+{
+    using mmap_type = xarray_mmap<int>;
+
+    class temporary_file
+    {
+
+    public:
+
+        temporary_file()
+            : m_path(std::string("xtensor_test_") + std::to_string(counter()++) + ".xtm")
+        {
+        }
+
+        ~temporary_file()
+        {
+            std::remove(m_path.c_str());
+        }
+
+        const std::string& path() const
+        {
+            return m_path;
+        }
+
+    private:
+
+        std::string m_path;
+
+        static int& counter()
+        {
+            static int c = 0;
+            return c;
+        }
+    };
+
+    void patch_header(const std::string& path, std::size_t idx, std::uint64_t value)
+    {
+        std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+        out.seekp(static_cast<std::streamoff>(idx * sizeof(std::uint64_t)));
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    TEST(xarray_mmap, create)
+    {
+        temporary_file f;
+        row_major_result rm;
+        mmap_type a(f.path(), rm.shape());
+        compare_shape(a, rm);
+        EXPECT_EQ(mmap_mode::read_write, a.mode());
+        EXPECT_EQ(0, a(1, 2, 3));
+        assign_array(a, rm.m_assigner);
+        EXPECT_TRUE(std::equal(a.data().cbegin(), a.data().cend(), rm.m_data.cbegin()));
+    }
+
+    TEST(xarray_mmap, reopen)
+    {
+        temporary_file f;
+        column_major_result cm;
+        {
+            mmap_type a(f.path(), cm.shape(), layout::column_major);
+            assign_array(a, cm.m_assigner);
+        }
+
+        mmap_type b(f.path());
+        EXPECT_EQ(mmap_mode::read_only, b.mode());
+        compare_shape(b, cm);
+        EXPECT_TRUE(std::equal(b.data().cbegin(), b.data().cend(), cm.m_data.cbegin()));
+        b.advise(mmap_advice::sequential);
+
+        EXPECT_THROW(xarray_mmap<double> c(f.path()), std::runtime_error);
+        EXPECT_THROW(mmap_type c("xtensor_test_missing.xtm"), std::runtime_error);
+    }
+
+    TEST(xarray_mmap, expression)
+    {
+        temporary_file f;
+        {
+            mmap_type a(f.path(), {2, 3});
+            xarray<int> b = {{1, 2, 3}, {4, 5, 6}};
+            a = b + 1;
+            noalias(a) += b;
+            auto v = make_xview(a, 1, range(0, 3));
+            EXPECT_EQ(13, v(2));
+            v = v * 2;
+            EXPECT_THROW(a = xarray<int>({1, 2}), std::runtime_error);
+        }
+
+        mmap_type c(f.path(), mmap_mode::copy_on_write);
+        EXPECT_EQ(26, c(1, 2));
+        c(1, 2) = 0;
+
+        mmap_type d(f.path(), mmap_mode::read_write);
+        EXPECT_EQ(26, d(1, 2));
+        xarray<int> e = d * 2;
+        EXPECT_EQ(6, e(0, 0));
+    }
+
+    TEST(xarray_mmap, reshape)
+    {
+        temporary_file f;
+        {
+            mmap_type a(f.path(), {2, 3});
+            a.reshape({6});
+            a.sync();
+            a.reshape({1, 2, 3});
+            EXPECT_THROW(a.sync(), std::runtime_error);
+            a.reshape({3, 2});
+        }
+
+        mmap_type b(f.path());
+        EXPECT_EQ(2, b.dimension());
+        EXPECT_EQ(3, b.shape()[0]);
+        EXPECT_EQ(2, b.shape()[1]);
+    }
+
+    TEST(xarray_mmap, move_assign)
+    {
+        temporary_file f1;
+        temporary_file f2;
+        {
+            mmap_type a(f1.path(), {2, 3});
+            a(1, 2) = 5;
+            a.reshape({3, 2});
+            a = mmap_type(f2.path(), {4});
+            EXPECT_EQ(1, a.dimension());
+            a(3) = 7;
+
+            // The header of the first file was written when it was unmapped.
+            mmap_type b(f1.path());
+            EXPECT_EQ(3, b.shape()[0]);
+            EXPECT_EQ(2, b.shape()[1]);
+            EXPECT_EQ(5, b(2, 1));
+        }
+
+        mmap_type c(f2.path());
+        EXPECT_EQ(1, c.dimension());
+        EXPECT_EQ(4, c.shape()[0]);
+        EXPECT_EQ(7, c(3));
+    }
+
+    TEST(xarray_mmap, invalid_file)
+    {
+        temporary_file f;
+        {
+            std::ofstream out(f.path());
+            out << "not an array";
+        }
+        EXPECT_THROW(mmap_type a(f.path()), std::runtime_error);
+    }
+
+    TEST(xarray_mmap, read_only)
+    {
+        temporary_file f;
+        {
+            mmap_type a(f.path(), {2, 3});
+            a = xarray<int>({{1, 2, 3}, {4, 5, 6}});
+        }
+
+        mmap_type b(f.path());
+        xarray<int> c = {{1, 1, 1}, {1, 1, 1}};
+        EXPECT_THROW(b = c, std::runtime_error);
+        EXPECT_THROW(b += c, std::runtime_error);
+        EXPECT_THROW(b += 1, std::runtime_error);
+        EXPECT_THROW(noalias(b) = c, std::runtime_error);
+        EXPECT_THROW(noalias(b) += c, std::runtime_error);
+        EXPECT_THROW(b.reshape({3, 2}), std::runtime_error);
+        EXPECT_THROW(b.sync(), std::runtime_error);
+        EXPECT_EQ(2, b.shape()[0]);
+        EXPECT_EQ(6, b(1, 2));
+
+        mmap_type d(f.path(), mmap_mode::copy_on_write);
+        d += c;
+        EXPECT_EQ(7, d(1, 2));
+        EXPECT_EQ(6, b(1, 2));
+    }
+
+    TEST(xarray_mmap, invalid_header)
+    {
+        // Header of a {2, 3} array: magic, element size, dimension,
+        // shape at 3 and 4, strides at 5 and 6.
+        const std::uint64_t huge = std::numeric_limits<std::uint64_t>::max();
+        auto check = [](std::size_t idx, std::uint64_t value) {
+            temporary_file f;
+            {
+                mmap_type a(f.path(), {2, 3});
+            }
+            patch_header(f.path(), idx, value);
+            EXPECT_THROW(mmap_type b(f.path()), std::runtime_error);
+        };
+        check(2, huge);
+        check(2, 5);
+        check(3, huge);
+        check(4, std::uint64_t(1) << 62);
+        check(5, huge);
+        check(5, std::uint64_t(1) << 61);
+        check(6, 100);
+
+        temporary_file f;
+        {
+            mmap_type a(f.path(), {2, 3});
+        }
+        patch_header(f.path(), 3, 0);
+        mmap_type empty(f.path());
+        EXPECT_EQ(0, empty.size());
+    }
+
+    TEST(xarray_mmap, truncated_data)
+    {
+        temporary_file f;
+        {
+            mmap_type a(f.path(), {2, 3});
+        }
+        std::string content;
+        {
+            std::ifstream in(f.path(), std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream out(f.path(), std::ios::binary | std::ios::trunc);
+            out.write(content.data(), static_cast<std::streamsize>(content.size() - sizeof(int)));
+        }
+        EXPECT_THROW(mmap_type b(f.path()), std::runtime_error);
+    }
+}
@@ -0,0 +1,147 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "xtensor/xnpy.hpp"
+#include "xtensor/xbuffer_adaptor.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+#include "test_common.hpp"
+
+namespace xt
+{
+    TEST(xnpy, header)
+    {
+        xarray<int> a = {{1, 2, 3}, {4, 5, 6}};
+        std::ostringstream out;
+        dump_npy(out, a);
+        std::string res = out.str();
+
+        std::string dict = "{'descr': '<i4', 'fortran_order': False, 'shape': (2, 3), }";
+        EXPECT_EQ(std::string("\x93NUMPY\x01\x00", 8), res.substr(0, 8));
+        EXPECT_EQ(118, static_cast<unsigned char>(res[8]));
+        EXPECT_EQ(dict, res.substr(10, dict.size()));
+        EXPECT_EQ('\n', res[127]);
+        EXPECT_EQ(128 + 6 * sizeof(int), res.size());
+
+        xarray<double> b = {1., 2.};
+        std::ostringstream out2;
+        dump_npy(out2, b);
+        EXPECT_NE(std::string::npos, out2.str().find("'descr': '<f8', 'fortran_order': False, 'shape': (2,), }"));
+    }
+
+    TEST(xnpy, round_trip)
+    {
+        row_major_result rm;
+        xarray<int> a(rm.shape());
+        assign_array(a, rm.m_assigner);
+        std::stringstream s1;
+        dump_npy(s1, a);
+        xarray<int> b = load_npy<int>(s1);
+        EXPECT_EQ(a, b);
+
+        column_major_result cm;
+        xarray<int> c(cm.shape(), layout::column_major);
+        assign_array(c, cm.m_assigner);
+        std::stringstream s2;
+        dump_npy(s2, c);
+        EXPECT_NE(std::string::npos, s2.str().find("'fortran_order': True"));
+        xarray<int> d = load_npy<int>(s2);
+        EXPECT_EQ(c, d);
+        EXPECT_EQ(c.strides(), d.strides());
+        EXPECT_EQ(c.data(), d.data());
+
+        std::stringstream s3;
+        dump_npy(s3, a);
+        EXPECT_THROW(load_npy<double>(s3), std::runtime_error);
+    }
+
+    TEST(xnpy, expression)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        std::stringstream s1;
+        dump_npy(s1, 2. * a + 1.);
+        xarray<double> b = load_npy<double>(s1);
+        xarray<double> expected = 2. * a + 1.;
+        EXPECT_EQ(expected, b);
+
+        std::stringstream s2;
+        dump_npy(s2, make_xview(a, range(0, 2), 1));
+        xarray<double> c = load_npy<double>(s2);
+        xarray<double> expected2 = {2., 5.};
+        EXPECT_EQ(expected2, c);
+    }
+
+    TEST(xnpy, existing_container)
+    {
+        xarray<int> a = {{1, 2, 3}, {4, 5, 6}};
+        std::stringstream s;
+        dump_npy(s, a);
+        std::string content = s.str();
+
+        std::istringstream in1(content);
+        xtensor<int, 2> t;
+        load_npy(in1, t);
+        EXPECT_EQ(5, t(1, 1));
+
+        std::istringstream in2(content);
+        xtensor<int, 3> t3;
+        EXPECT_THROW(load_npy(in2, t3), std::runtime_error);
+
+        int data[6] = {0};
+        xbuffer_adaptor<int> buf(data, 6);
+        xarray_adaptor<xbuffer_adaptor<int>> ad(buf);
+        std::istringstream in3(content);
+        load_npy(in3, ad);
+        EXPECT_EQ(6, data[5]);
+        EXPECT_EQ(a, ad);
+
+        int small[4] = {0};
+        xbuffer_adaptor<int> buf2(small, 4);
+        xarray_adaptor<xbuffer_adaptor<int>> ad2(buf2);
+        std::istringstream in4(content);
+        EXPECT_THROW(load_npy(in4, ad2), std::runtime_error);
+    }
+
+    TEST(xnpy, file)
+    {
+        std::string path = "xtensor_test_xnpy.npy";
+        xarray<float> a = {{1.f, 2.f}, {3.f, 4.f}};
+        dump_npy(path, a);
+        xarray<float> b = load_npy<float>(path);
+        EXPECT_EQ(a, b);
+        std::remove(path.c_str());
+        EXPECT_THROW(load_npy<float>(path), std::runtime_error);
+    }
+
+    TEST(xnpz, round_trip)
+    {
+        std::string path = "xtensor_test_xnpz.npz";
+        xarray<int> a = {{1, 2, 3}, {4, 5, 6}};
+        xarray<double> b(xarray<double>::shape_type({2, 2}), 2.5, layout::column_major);
+        dump_npz(path, "a", a);
+        dump_npz(path, "b", b, true);
+        EXPECT_THROW(dump_npz(path, "a", a, true), std::runtime_error);
+
+        xarray<int> ra = load_npz<int>(path, "a");
+        xarray<double> rb = load_npz<double>(path, "b.npy");
+        EXPECT_EQ(a, ra);
+        EXPECT_EQ(b, rb);
+        EXPECT_THROW(load_npz<int>(path, "c"), std::runtime_error);
+
+        dump_npz(path, "c", a + 1);
+        EXPECT_THROW(load_npz<int>(path, "a"), std::runtime_error);
+        xarray<int> rc = load_npz<int>(path, "c");
+        EXPECT_EQ(7, rc(1, 2));
+        std::remove(path.c_str());
+    }
+}
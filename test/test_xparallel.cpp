@@ -0,0 +1,303 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    // Enables parallel assignment for the lifetime of the guard, with a
+    // threshold low enough for the small arrays of the tests.
+    struct parallel_assign_guard
+    {
+        parallel_assign_guard(std::size_t threshold = 1)
+        {
+            enable_parallel_assign(4, threshold);
+        }
+
+        ~parallel_assign_guard()
+        {
+            disable_parallel_assign();
+            set_parallel_threshold(default_parallel_threshold);
+        }
+    };
+
+    template <class T>
+    xarray<T> make_parallel_array(const typename xarray<T>::shape_type& shape)
+    {
+        xarray<T> res(shape);
+        std::size_t i = 0;
+        std::for_each(res.storage_begin(), res.storage_end(), [&i](T& v) { v = T(i++ % 97) / T(3); });
+        return res;
+    }
+
+    TEST(xparallel, parallel_for)
+    {
+        xthread_pool pool(4);
+        EXPECT_EQ(4u, pool.concurrency());
+        std::vector<std::atomic<int>> counts(1000);
+        for(int n = 0; n < 3; ++n)
+        {
+            pool.parallel_for(counts.size(), [&counts](std::size_t i) { ++counts[i]; });
+        }
+        for(const auto& c : counts)
+        {
+            EXPECT_EQ(3, c.load());
+        }
+    }
+
+    TEST(xparallel, nested_parallel_for)
+    {
+        xthread_pool pool(3);
+        std::atomic<std::size_t> count(0);
+        pool.parallel_for(10, [&pool, &count](std::size_t) {
+            pool.parallel_for(10, [&count](std::size_t) { ++count; });
+        });
+        EXPECT_EQ(100u, count.load());
+    }
+
+    TEST(xparallel, exception)
+    {
+        xthread_pool pool(4);
+        auto f = [](std::size_t i) {
+            if(i == 17)
+            {
+                throw std::runtime_error("task failed");
+            }
+        };
+        EXPECT_THROW(pool.parallel_for(100, f), std::runtime_error);
+        std::atomic<std::size_t> count(0);
+        pool.parallel_for(100, [&count](std::size_t) { ++count; });
+        EXPECT_EQ(100u, count.load());
+    }
+
+    TEST(xparallel, parallel_chunks)
+    {
+        xthread_pool pool(4);
+        for(std::size_t size : { 0, 1, 7, 8, 9, 1000, 1003 })
+        {
+            std::vector<std::atomic<int>> counts(size);
+            parallel_chunks(pool, size, 8, [&counts, size](std::size_t first, std::size_t last) {
+                EXPECT_EQ(0u, first % 8);
+                EXPECT_TRUE(last % 8 == 0 || last == size);
+                for(std::size_t i = first; i < last; ++i)
+                {
+                    ++counts[i];
+                }
+            });
+            for(const auto& c : counts)
+            {
+                EXPECT_EQ(1, c.load());
+            }
+        }
+    }
+
+    TEST(xparallel, unbalanced_tasks)
+    {
+        // The first tasks are much longer than the others, so that the
+        // threads owning the last ones have to steal the remaining work.
+        xthread_pool pool(4);
+        std::vector<std::atomic<int>> counts(64);
+        pool.parallel_for(counts.size(), [&counts](std::size_t i) {
+            if(i < 4)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            ++counts[i];
+        });
+        for(const auto& c : counts)
+        {
+            EXPECT_EQ(1, c.load());
+        }
+    }
+
+    TEST(xparallel, serial_executor)
+    {
+        xserial_executor executor;
+        EXPECT_EQ(1u, executor.concurrency());
+        std::vector<std::size_t> order;
+        executor.parallel_for(5, [&order](std::size_t i) { order.push_back(i); });
+        EXPECT_EQ(std::vector<std::size_t>({ 0, 1, 2, 3, 4 }), order);
+    }
+
+#if defined(_OPENMP)
+    TEST(xparallel, openmp_executor)
+    {
+        xopenmp_executor executor(4);
+        EXPECT_EQ(4u, executor.concurrency());
+        std::vector<std::atomic<int>> counts(1000);
+        executor.parallel_for(counts.size(), [&counts](std::size_t i) { ++counts[i]; });
+        for(const auto& c : counts)
+        {
+            EXPECT_EQ(1, c.load());
+        }
+        auto f = [](std::size_t i) {
+            if(i == 17)
+            {
+                throw std::runtime_error("task failed");
+            }
+        };
+        EXPECT_THROW(executor.parallel_for(100, f), std::runtime_error);
+    }
+#endif
+
+    // Executor standing for the scheduler of an application: it counts
+    // the loops it runs and runs them with a pool.
+    class counting_executor : public xexecutor
+    {
+
+    public:
+
+        counting_executor()
+            : m_pool(3), m_loop_count(0)
+        {
+        }
+
+        std::size_t concurrency() const noexcept override
+        {
+            return m_pool.concurrency();
+        }
+
+        void parallel_for(std::size_t task_count, const task_type& task) override
+        {
+            ++m_loop_count;
+            m_pool.parallel_for(task_count, task);
+        }
+
+        std::size_t loop_count() const noexcept
+        {
+            return m_loop_count;
+        }
+
+    private:
+
+        xthread_pool m_pool;
+        std::size_t m_loop_count;
+    };
+
+    TEST(xparallel, settings)
+    {
+        EXPECT_EQ(nullptr, default_executor());
+        EXPECT_EQ(default_parallel_threshold, parallel_threshold());
+        {
+            parallel_assign_guard guard(100);
+            ASSERT_NE(nullptr, default_executor());
+            EXPECT_EQ(4u, default_executor()->concurrency());
+            EXPECT_EQ(100u, parallel_threshold());
+        }
+        EXPECT_EQ(nullptr, default_executor());
+    }
+
+    TEST(xparallel, default_executor)
+    {
+        using shape_type = xarray<double>::shape_type;
+        xarray<double> a = make_parallel_array<double>(shape_type({ 50, 20 }));
+        xarray<double> ref = a * a + 1.;
+        counting_executor executor;
+        set_default_executor(&executor);
+        set_parallel_threshold(1);
+        xarray<double> res = a * a + 1.;
+        res += 2.;
+        set_default_executor(nullptr);
+        set_parallel_threshold(default_parallel_threshold);
+        EXPECT_EQ(2u, executor.loop_count());
+        EXPECT_EQ(xarray<double>(ref + 2.), res);
+    }
+
+    TEST(xparallel, executor_per_call)
+    {
+        using shape_type = xarray<int>::shape_type;
+        xarray<int> a = make_parallel_array<int>(shape_type({ 50, 20 }));
+        xarray<int> b = make_parallel_array<int>(shape_type({ 20 }));
+        counting_executor executor;
+        set_parallel_threshold(1);
+        xarray<int> res;
+        assign_xexpression(res, a - b, executor);
+        set_parallel_threshold(default_parallel_threshold);
+        EXPECT_EQ(1u, executor.loop_count());
+        EXPECT_EQ(xarray<int>(a - b), res);
+    }
+
+    TEST(xparallel, trivial_assign)
+    {
+        using shape_type = xarray<double>::shape_type;
+        for(std::size_t size : { 1, 7, 8, 9, 63, 1003 })
+        {
+            xarray<double> a = make_parallel_array<double>(shape_type({ size, 3 }));
+            xarray<double> b = make_parallel_array<double>(shape_type({ size, 3 })) + 1.;
+            xarray<double> ref = a * b - a;
+            parallel_assign_guard guard;
+            xarray<double> res = a * b - a;
+            EXPECT_EQ(ref, res);
+        }
+    }
+
+    TEST(xparallel, broadcast_assign)
+    {
+        using shape_type = xarray<int>::shape_type;
+        xarray<int> a = make_parallel_array<int>(shape_type({ 13, 5, 7 }));
+        xarray<int> b = make_parallel_array<int>(shape_type({ 5, 1 }));
+        xarray<int> c = make_parallel_array<int>(shape_type({ 1, 7 }));
+        xarray<int> ref = a + b * c;
+        xarray<int> row_ref = b * c;
+        xarray<int> vec_ref = a + 2;
+        parallel_assign_guard guard;
+        xarray<int> res = a + b * c;
+        EXPECT_EQ(ref, res);
+        xarray<int> row_res = b * c;
+        EXPECT_EQ(row_ref, row_res);
+        xarray<int> vec_res = a + 2;
+        EXPECT_EQ(vec_ref, vec_res);
+    }
+
+    TEST(xparallel, view_assign)
+    {
+        using shape_type = xarray<double>::shape_type;
+        xarray<double> a = make_parallel_array<double>(shape_type({ 11, 9 }));
+        xarray<double> ref = a;
+        xarray<double> res = a;
+        auto v_ref = make_xview(ref, range(1, 10), range(2, 8));
+        v_ref = v_ref * 2. + 1.;
+        parallel_assign_guard guard;
+        auto v_res = make_xview(res, range(1, 10), range(2, 8));
+        v_res = v_res * 2. + 1.;
+        EXPECT_EQ(ref, res);
+    }
+
+    TEST(xparallel, computed_assign)
+    {
+        xtensor<float, 2> a = make_parallel_array<float>({ 37, 41 });
+        xtensor<float, 2> ref = a;
+        ref += a;
+        ref *= 3.f;
+        parallel_assign_guard guard;
+        xtensor<float, 2> res = a;
+        res += a;
+        res *= 3.f;
+        EXPECT_EQ(ref, res);
+    }
+
+    TEST(xparallel, threshold)
+    {
+        using shape_type = xarray<double>::shape_type;
+        xarray<double> a = make_parallel_array<double>(shape_type({ 10, 10 }));
+        parallel_assign_guard guard(101);
+        xarray<double> res = a + a;
+        EXPECT_EQ(xarray<double>(2. * a), res);
+    }
+}
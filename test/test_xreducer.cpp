@@ -0,0 +1,369 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using std::size_t;
+
+    xarray<double> make_reducer_array()
+    {
+        xarray<double> a(xshape<size_t>({ 3, 4, 5 }));
+        for(size_t i = 0; i < 3; ++i)
+        {
+            for(size_t j = 0; j < 4; ++j)
+            {
+                for(size_t k = 0; k < 5; ++k)
+                {
+                    a(i, j, k) = double((i * 7 + j * 3 + k * 11) % 13) - 4.;
+                }
+            }
+        }
+        return a;
+    }
+
+    // Sums a over the axes flagged in reduced, the result having the
+    // remaining dimensions of a.
+    xarray<double> reference_sum(const xarray<double>& a, const std::vector<bool>& reduced)
+    {
+        xshape<size_t> shape;
+        for(size_t d = 0; d < 3; ++d)
+        {
+            if(!reduced[d])
+            {
+                shape.push_back(a.shape()[d]);
+            }
+        }
+        xarray<double> res(shape, 0.);
+        for(size_t i = 0; i < 3; ++i)
+        {
+            for(size_t j = 0; j < 4; ++j)
+            {
+                for(size_t k = 0; k < 5; ++k)
+                {
+                    size_t full[] = { i, j, k };
+                    size_t offset = 0;
+                    for(size_t d = 0; d < 3; ++d)
+                    {
+                        if(!reduced[d])
+                        {
+                            offset = offset * a.shape()[d] + full[d];
+                        }
+                    }
+                    res.data_element(offset) += a(i, j, k);
+                }
+            }
+        }
+        return res;
+    }
+
+    void check_equal(const xarray<double>& ref, const xarray<double>& res)
+    {
+        ASSERT_EQ(ref.shape(), res.shape());
+        EXPECT_TRUE(std::equal(ref.storage_begin(), ref.storage_end(), res.storage_begin()));
+    }
+
+    TEST(xreducer, shape)
+    {
+        xarray<double> a = make_reducer_array();
+        auto r = sum(a, { 2, 0 });
+        EXPECT_EQ(1, r.dimension());
+        EXPECT_EQ(4, r.shape()[0]);
+        EXPECT_EQ(0, r.axes()[0]);
+        EXPECT_EQ(2, r.axes()[1]);
+
+        xtensor<double, 3> t = a;
+        auto rt = sum(t, { 1 });
+        bool fixed = std::is_same<decltype(rt)::shape_type, std::array<size_t, 2>>::value;
+        EXPECT_TRUE(fixed);
+
+        EXPECT_THROW(sum(a, { 3 }), std::out_of_range);
+        EXPECT_THROW(sum(a, { 1, 1 }), std::invalid_argument);
+    }
+
+    TEST(xreducer, sum_axes)
+    {
+        xarray<double> a = make_reducer_array();
+        for(size_t mask = 0; mask < 8; ++mask)
+        {
+            std::vector<bool> reduced = { (mask & 1) != 0, (mask & 2) != 0, (mask & 4) != 0 };
+            std::vector<size_t> axes;
+            for(size_t d = 0; d < 3; ++d)
+            {
+                if(reduced[d])
+                {
+                    axes.push_back(d);
+                }
+            }
+            xarray<double> ref = reference_sum(a, reduced);
+
+            // Whole evaluation
+            xarray<double> res = sum(a, axes);
+            check_equal(ref, res);
+
+            // Element-wise evaluation
+            auto r = sum(a, axes);
+            xarray<double> res2 = r + 0.;
+            check_equal(ref, res2);
+        }
+    }
+
+    TEST(xreducer, access)
+    {
+        xarray<double> a = make_reducer_array();
+        auto r = sum(a, { 1 });
+        xarray<double> ref = reference_sum(a, { false, true, false });
+        for(size_t i = 0; i < 3; ++i)
+        {
+            for(size_t k = 0; k < 5; ++k)
+            {
+                EXPECT_EQ(ref(i, k), r(i, k));
+                EXPECT_EQ(ref(i, k), r(0, i, k));
+            }
+        }
+        auto it = r.begin();
+        for(size_t i = 0; i < ref.size(); ++i, ++it)
+        {
+            EXPECT_EQ(ref.data_element(i), *it);
+        }
+        EXPECT_TRUE(it == r.end());
+
+        double total = sum(a)();
+        EXPECT_EQ(reference_sum(a, { true, true, true })(), total);
+    }
+
+    TEST(xreducer, expressions)
+    {
+        xarray<double> a = make_reducer_array();
+        xarray<double> b = a * 2. - 1.;
+
+        xarray<double> res = sum(a + b, { 0, 2 });
+        xarray<double> ref = reference_sum(a, { true, false, true });
+        for(size_t j = 0; j < 4; ++j)
+        {
+            EXPECT_EQ(3. * ref(j) - 15., res(j));
+        }
+
+        auto v = make_xview(a, 1, range(1, 4), range(0, 5));
+        xarray<double> rv = sum(v, { 0 });
+        for(size_t k = 0; k < 5; ++k)
+        {
+            EXPECT_EQ(a(1, 1, k) + a(1, 2, k) + a(1, 3, k), rv(k));
+        }
+
+        xtensor<double, 3> t = a;
+        xtensor<double, 2> rt = sum(t, { 1 });
+        check_equal(reference_sum(a, { false, true, false }), rt);
+    }
+
+    TEST(xreducer, fusion)
+    {
+        xarray<double> a = make_reducer_array();
+        xarray<double> c = xarray<double>(xshape<size_t>({ 5 }), 1.5);
+        xarray<double> ref = reference_sum(a, { true, true, false });
+
+        xarray<double> res = sum(a, { 0, 1 }) * 2. + c;
+        for(size_t k = 0; k < 5; ++k)
+        {
+            EXPECT_EQ(ref(k) * 2. + 1.5, res(k));
+        }
+
+        // broadcasting a reduction against its argument
+        xarray<double> centered = a - mean(a, { 0 });
+        for(size_t k = 0; k < 5; ++k)
+        {
+            double m = (a(0, 2, k) + a(1, 2, k) + a(2, 2, k)) / 3.;
+            EXPECT_DOUBLE_EQ(a(1, 2, k) - m, centered(1, 2, k));
+        }
+
+        // the argument may be aliased by the result
+        xarray<double> d = a;
+        d = sum(d, { 1 });
+        check_equal(reference_sum(a, { false, true, false }), d);
+    }
+
+    TEST(xreducer, accumulator)
+    {
+        xarray<int8_t> a(xshape<size_t>({ 2, 100 }), int8_t(100));
+        xarray<long long> s = sum(a, { 1 });
+        EXPECT_EQ(10000, s(0));
+        bool wide = std::is_same<decltype(sum(a, { 1 }))::value_type, long long>::value;
+        EXPECT_TRUE(wide);
+
+        xarray<float> f(xshape<size_t>({ 3, 1000 }), 0.1f);
+        auto sf = sum<double>(f, { 1 });
+        bool dbl = std::is_same<decltype(sf)::value_type, double>::value;
+        EXPECT_TRUE(dbl);
+        EXPECT_NEAR(1000. * double(0.1f), sf(1), 1e-9);
+
+        xarray<int> i(xshape<size_t>({ 4 }));
+        i(0) = 1; i(1) = 2; i(2) = 2; i(3) = 2;
+        EXPECT_EQ(1.75, mean(i)());
+        EXPECT_EQ(8, prod(i)());
+    }
+
+    TEST(xreducer, extrema)
+    {
+        xarray<double> a = make_reducer_array();
+        xarray<double> mn = amin(a, { 1 });
+        xarray<double> mx = amax(a, { 1 });
+        xarray<size_t> imn = argmin(a, { 1 });
+        xarray<size_t> imx = argmax(a, 1);
+        for(size_t i = 0; i < 3; ++i)
+        {
+            for(size_t k = 0; k < 5; ++k)
+            {
+                size_t jmin = 0;
+                size_t jmax = 0;
+                for(size_t j = 1; j < 4; ++j)
+                {
+                    jmin = a(i, j, k) < a(i, jmin, k) ? j : jmin;
+                    jmax = a(i, j, k) > a(i, jmax, k) ? j : jmax;
+                }
+                EXPECT_EQ(a(i, jmin, k), mn(i, k));
+                EXPECT_EQ(a(i, jmax, k), mx(i, k));
+                EXPECT_EQ(jmin, imn(i, k));
+                EXPECT_EQ(jmax, imx(i, k));
+                EXPECT_EQ(jmin, argmin(a, { 1 })(i, k));
+            }
+        }
+
+        // ties are resolved to the first index, NaNs propagate
+        xarray<double> b(xshape<size_t>({ 5 }), 1.);
+        b(3) = 0.;
+        b(4) = 0.;
+        EXPECT_EQ(3, argmin(b)());
+        EXPECT_EQ(0, argmax(b)());
+        b(2) = std::numeric_limits<double>::quiet_NaN();
+        EXPECT_TRUE(std::isnan(amin(b)()));
+        EXPECT_TRUE(std::isnan(amax(b)()));
+        EXPECT_EQ(2, argmin(b)());
+        EXPECT_EQ(2, argmax(b)());
+    }
+
+    TEST(xreducer, empty)
+    {
+        xarray<double> a(xshape<size_t>({ 3, 0 }));
+        xarray<double> s = sum(a, { 1 });
+        ASSERT_EQ(1, s.dimension());
+        EXPECT_EQ(3, s.size());
+        EXPECT_EQ(0., s(1));
+        xarray<double> p = prod(a, { 1 });
+        EXPECT_EQ(1., p(2));
+        EXPECT_EQ(std::numeric_limits<double>::infinity(), amin(a, { 1 })(0));
+
+        xarray<double> s0 = sum(a, { 0 });
+        EXPECT_EQ(0, s0.size());
+    }
+
+    xarray<float> make_large_reducer_array()
+    {
+        xarray<float> a(xshape<size_t>({ 3, 2500, 7 }));
+        for(size_t i = 0; i < a.size(); ++i)
+        {
+            a.data_element(i) = 0.1f + float(i % 17) * 0.37f;
+        }
+        return a;
+    }
+
+    template <class E>
+    xarray<float> parallel_sum(const E& e, const std::vector<size_t>& axes, size_t thread_count)
+    {
+        xthread_pool pool(thread_count);
+        set_parallel_threshold(1);
+        xarray<float> res;
+        assign_xexpression(res, sum(e, axes), pool);
+        set_parallel_threshold(default_parallel_threshold);
+        return res;
+    }
+
+    TEST(xreducer, deterministic)
+    {
+        xarray<float> a = make_large_reducer_array();
+        auto v = make_xview(a, range(0, 3), range(1, 2500), range(1, 7));
+        std::vector<std::vector<size_t>> axes = { { 0 }, { 1 }, { 0, 1 }, { 1, 2 }, { 0, 1, 2 } };
+        for(const auto& ax : axes)
+        {
+            xarray<float> res = sum(a, ax);
+            xarray<float> resv = sum(v, ax);
+            for(size_t n = 1; n <= 4; ++n)
+            {
+                EXPECT_EQ(res, parallel_sum(a, ax, n));
+                EXPECT_EQ(resv, parallel_sum(v, ax, n));
+            }
+        }
+
+        // the row by row evaluation accumulates the elements in the
+        // order of the element-wise evaluation
+        auto r = sum(a, { 1 });
+        xarray<float> res = r;
+        xarray<float> res2 = r + 0.f;
+        EXPECT_EQ(res, res2);
+        auto rv = sum(v, { 0, 1 });
+        xarray<float> resv = rv;
+        xarray<float> resv2 = rv + 0.f;
+        EXPECT_EQ(resv, resv2);
+    }
+
+    TEST(xreducer, accuracy)
+    {
+        xarray<float> a(xshape<size_t>({ 1000000 }), 0.1f);
+        double ref = 1000000. * double(0.1f);
+        xarray<float> s = sum(a);
+        EXPECT_NEAR(ref, double(s()), ref * 1e-6);
+        EXPECT_NEAR(ref, double(sum(a)()), ref * 1e-6);
+
+        xarray<float> b(xshape<size_t>({ 4000, 3 }), 0.1f);
+        xarray<float> sb = sum(b, { 0 });
+        EXPECT_NEAR(4000. * double(0.1f), double(sb(2)), 1e-6 * 4000.);
+    }
+
+    TEST(xreducer, lazy_bitwise)
+    {
+        // Element-wise evaluations accumulate the same blocks, in the same
+        // order, as assignments, including the SIMD lanes of contiguous
+        // reductions.
+        xarray<float> a = make_large_reducer_array();
+        float total = sum(a)();
+        EXPECT_EQ(xarray<float>(sum(a))(), total);
+
+        std::vector<std::vector<size_t>> axes = { { 2 }, { 1, 2 }, { 1 }, { 0 } };
+        for(const auto& ax : axes)
+        {
+            auto r = sum(a, ax);
+            xarray<float> res = r;
+            xarray<float> res2 = r * 1.f;
+            EXPECT_EQ(res, res2);
+            EXPECT_TRUE(std::equal(r.cbegin(), r.cend(), res.cbegin()));
+        }
+
+        auto rows = sum(a, { 1, 2 });
+        xarray<float> res = rows;
+        for(size_t i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(res(i), rows(i));
+        }
+        xarray<float> b(xshape<size_t>({ 2, 3 }), 1.f);
+        xarray<float> res3 = b + rows;
+        EXPECT_EQ(res(2) + 1.f, res3(1, 2));
+    }
+}
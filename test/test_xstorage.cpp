@@ -0,0 +1,180 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "xtensor/xstorage.hpp"
+#include "xtensor/xarray.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xt
+{
+    using std::size_t;
+    using vector_type = svector<size_t, 4>;
+
+    TEST(svector, constructors)
+    {
+        vector_type a;
+        EXPECT_TRUE(a.empty());
+        EXPECT_TRUE(a.on_stack());
+
+        vector_type b(3, size_t(2));
+        EXPECT_EQ(3, b.size());
+        EXPECT_EQ(2, b[2]);
+
+        vector_type c = {1, 2, 3, 4, 5, 6};
+        EXPECT_EQ(6, c.size());
+        EXPECT_FALSE(c.on_stack());
+        EXPECT_EQ(6, c.back());
+
+        std::vector<size_t> v = {4, 5};
+        vector_type d(v.begin(), v.end());
+        EXPECT_EQ(2, d.size());
+        EXPECT_EQ(4, d.front());
+    }
+
+    TEST(svector, copy_and_move)
+    {
+        vector_type small = {1, 2};
+        vector_type large = {1, 2, 3, 4, 5};
+
+        vector_type a(small);
+        EXPECT_EQ(small, a);
+        EXPECT_TRUE(a.on_stack());
+
+        vector_type b(large);
+        EXPECT_EQ(large, b);
+        EXPECT_NE(large.data(), b.data());
+
+        a = large;
+        EXPECT_EQ(large, a);
+        b = small;
+        EXPECT_EQ(small, b);
+
+        const size_t* data = large.data();
+        vector_type c(std::move(large));
+        EXPECT_EQ(data, c.data());
+        EXPECT_TRUE(large.empty());
+
+        vector_type d(std::move(small));
+        EXPECT_EQ(2, d.size());
+        EXPECT_TRUE(d.on_stack());
+
+        c = std::move(d);
+        EXPECT_EQ(2, c.size());
+        EXPECT_TRUE(c.on_stack());
+    }
+
+    TEST(svector, resize)
+    {
+        vector_type a(2, size_t(1));
+        a.resize(4, size_t(3));
+        EXPECT_TRUE(a.on_stack());
+        EXPECT_EQ(vector_type({1, 1, 3, 3}), a);
+
+        a.resize(6);
+        EXPECT_FALSE(a.on_stack());
+        EXPECT_EQ(vector_type({1, 1, 3, 3, 0, 0}), a);
+
+        a.resize(1);
+        EXPECT_EQ(1, a.size());
+        a.push_back(7);
+        EXPECT_EQ(vector_type({1, 7}), a);
+        a.pop_back();
+        EXPECT_EQ(vector_type({1}), a);
+    }
+
+    TEST(svector, xarray_shape)
+    {
+        xarray<double> a(xarray<double>::shape_type({3, 2, 4}));
+        EXPECT_TRUE(a.shape().on_stack());
+        EXPECT_TRUE(a.strides().on_stack());
+    }
+
+    TEST(aligned_allocator, alignment)
+    {
+        aligned_allocator<double, 64> alloc;
+        for (std::size_t n : {1, 3, 17, 1024})
+        {
+            double* p = alloc.allocate(n);
+            EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(p) % 64);
+            alloc.deallocate(p, n);
+        }
+    }
+
+    TEST(uvector, constructors)
+    {
+        using uvector_type = uvector<double>;
+
+        uvector_type a;
+        EXPECT_TRUE(a.empty());
+
+        uvector_type b(5);
+        EXPECT_EQ(5, b.size());
+        EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(b.data()) % XTENSOR_DEFAULT_ALIGNMENT);
+
+        uvector_type c(3, 1.5);
+        EXPECT_EQ(uvector_type({1.5, 1.5, 1.5}), c);
+
+        std::vector<double> v = {1., 2., 3.};
+        uvector_type d(v.cbegin(), v.cend());
+        EXPECT_EQ(3, d.size());
+        EXPECT_EQ(2., d[1]);
+    }
+
+    TEST(uvector, copy_and_move)
+    {
+        using uvector_type = uvector<int>;
+        uvector_type a = {1, 2, 3};
+
+        uvector_type b(a);
+        EXPECT_EQ(a, b);
+        EXPECT_NE(a.data(), b.data());
+
+        uvector_type c = {4, 5};
+        c = a;
+        EXPECT_EQ(a, c);
+
+        const int* data = a.data();
+        uvector_type d(std::move(a));
+        EXPECT_EQ(data, d.data());
+        EXPECT_TRUE(a.empty());
+
+        c = std::move(d);
+        EXPECT_EQ(data, c.data());
+    }
+
+    TEST(uvector, resize)
+    {
+        uvector<int> a = {1, 2, 3};
+        a.resize(5, 4);
+        EXPECT_EQ(uvector<int>({1, 2, 3, 4, 4}), a);
+        a.resize(2);
+        EXPECT_EQ(uvector<int>({1, 2}), a);
+        a.clear();
+        EXPECT_TRUE(a.empty());
+    }
+
+    TEST(uvector, non_trivial)
+    {
+        uvector<std::string> a(3);
+        EXPECT_TRUE(a[2].empty());
+        a[1] = "xtensor";
+        a.resize(4);
+        EXPECT_EQ("xtensor", a[1]);
+        uvector<std::string> b(a);
+        EXPECT_EQ(a, b);
+    }
+
+    TEST(uvector, xarray_storage)
+    {
+        xarray<double> a(xarray<double>::shape_type({3, 2, 4}));
+        EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(a.data().data()) % XTENSOR_DEFAULT_ALIGNMENT);
+    }
+}
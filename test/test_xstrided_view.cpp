@@ -0,0 +1,131 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xview.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace xt
+{
+    using std::size_t;
+
+    TEST(xstrided_view, simple)
+    {
+        xshape<size_t> shape = {3, 4};
+        xarray<double> a(shape);
+        std::vector<double> data {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+        std::copy(data.begin(), data.end(), a.storage_begin());
+
+        auto view1 = make_xstrided_view(a, 1, range(1, 4));
+        EXPECT_EQ(a(1, 1), view1(0));
+        EXPECT_EQ(a(1, 2), view1(1));
+        EXPECT_EQ(1, view1.dimension());
+        EXPECT_EQ(5, view1.data_offset());
+        EXPECT_TRUE(view1.is_contiguous());
+
+        auto view2 = make_xstrided_view(a, range(0, 2), 2);
+        EXPECT_EQ(a(0, 2), view2(0));
+        EXPECT_EQ(a(1, 2), view2(1));
+        EXPECT_EQ(1, view2.dimension());
+        EXPECT_EQ(2, view2.shape()[0]);
+        EXPECT_EQ(4, view2.strides()[0]);
+        EXPECT_FALSE(view2.is_contiguous());
+
+        auto view3 = make_xstrided_view(a, range(1, 3));
+        EXPECT_EQ(2, view3.dimension());
+        EXPECT_EQ(a(2, 3), view3(1, 3));
+        EXPECT_TRUE(view3.is_contiguous());
+
+        auto view4 = make_xstrided_view(a, 1, 2);
+        EXPECT_EQ(0, view4.dimension());
+        EXPECT_EQ(a(1, 2), view4());
+    }
+
+    TEST(xstrided_view, stepped_range)
+    {
+        xshape<size_t> shape = {4, 8};
+        xarray<int> a(shape);
+        std::iota(a.storage_begin(), a.storage_end(), 0);
+
+        auto view = make_xstrided_view(a, range(0, 4, 2), range(1, 7, 3));
+        xshape<size_t> expected_shape = {2, 2};
+        EXPECT_EQ(expected_shape, view.shape());
+        EXPECT_EQ(1, view.data_offset());
+        EXPECT_EQ(16, view.strides()[0]);
+        EXPECT_EQ(3, view.strides()[1]);
+        EXPECT_EQ(a(2, 4), view(1, 1));
+        EXPECT_FALSE(view.is_contiguous());
+    }
+
+    TEST(xstrided_view, iterator)
+    {
+        xshape<size_t> shape = {2, 3, 4};
+        xarray<int> a(shape);
+        std::iota(a.storage_begin(), a.storage_end(), 0);
+
+        auto view = make_xstrided_view(a, range(0, 2), 1, range(1, 4));
+        auto xv = make_xview(a, range(0, 2), 1, range(1, 4));
+        EXPECT_TRUE(std::equal(view.cbegin(), view.cend(), xv.cbegin()));
+        EXPECT_EQ(view.size(), static_cast<size_t>(std::distance(view.cbegin(), view.cend())));
+
+        std::vector<int> expected = {5, 6, 7, 17, 18, 19};
+        EXPECT_TRUE(std::equal(view.cbegin(), view.cend(), expected.cbegin()));
+    }
+
+    TEST(xstrided_view, nested)
+    {
+        xshape<size_t> shape = {4, 5};
+        xarray<int> a(shape);
+        std::iota(a.storage_begin(), a.storage_end(), 0);
+
+        auto view = make_xstrided_view(a, range(1, 4), range(1, 5));
+        auto nested = make_xstrided_view(view, range(1, 3), 2);
+        EXPECT_EQ(1, nested.dimension());
+        EXPECT_EQ(a(2, 3), nested(0));
+        EXPECT_EQ(a(3, 3), nested(1));
+        EXPECT_EQ(7, nested.data_offset());
+        EXPECT_EQ(view.storage_begin() + 7, nested.storage_begin());
+    }
+
+    TEST(xstrided_view, assign)
+    {
+        xshape<size_t> shape = {3, 4};
+        xarray<double> a(shape, 1.);
+        xarray<double> b = {1., 2., 3., 4.};
+
+        auto row = make_xstrided_view(a, 1, range(0, 4));
+        EXPECT_TRUE(row.is_trivial_broadcast(b.strides()));
+        row = b;
+        EXPECT_EQ(1., a(0, 3));
+        EXPECT_EQ(3., a(1, 2));
+        EXPECT_EQ(1., a(2, 0));
+
+        auto col = make_xstrided_view(a, range(0, 3), 3);
+        xarray<double> c = {5., 6., 7.};
+        EXPECT_FALSE(col.is_trivial_broadcast(c.strides()));
+        col = c + 1.;
+        EXPECT_EQ(6., a(0, 3));
+        EXPECT_EQ(7., a(1, 3));
+        EXPECT_EQ(8., a(2, 3));
+        EXPECT_EQ(3., a(1, 2));
+
+        xarray<double> res = make_xstrided_view(a, range(1, 3), range(2, 4)) * 2.;
+        xarray<double> expected = {{6., 14.}, {2., 16.}};
+        EXPECT_EQ(expected, res);
+
+        auto rows = make_xstrided_view(a, range(1, 3));
+        xarray<double> b2 = {{1., 2., 3., 4.}, {5., 6., 7., 8.}};
+        EXPECT_TRUE(rows.is_trivial_broadcast(b2.strides()));
+        xarray<double> res2 = rows + b2;
+        xarray<double> expected2 = {{2., 4., 6., 11.}, {6., 7., 8., 16.}};
+        EXPECT_EQ(expected2, res2);
+    }
+}
@@ -0,0 +1,167 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xview.hpp"
+#include "test_common.hpp"
+
+namespace xt
+{
+    using std::size_t;
+    using tensor_type = xtensor<int, 3>;
+
+    template <class R>
+    inline typename tensor_type::shape_type to_tensor_shape(const R& r)
+    {
+        typename tensor_type::shape_type res;
+        std::copy(r.begin(), r.end(), res.begin());
+        return res;
+    }
+
+    template <class V, class R>
+    void compare_tensor_shape(const V& vec, const R& result)
+    {
+        EXPECT_EQ(vec.shape(), to_tensor_shape(result.shape()));
+        EXPECT_EQ(vec.strides(), to_tensor_shape(result.strides()));
+        EXPECT_EQ(vec.backstrides(), to_tensor_shape(result.backstrides()));
+        EXPECT_EQ(vec.size(), result.size());
+    }
+
+    TEST(xtensor, shaped_constructor)
+    {
+        {
+            SCOPED_TRACE("row_major constructor");
+            row_major_result rm;
+            tensor_type ra(to_tensor_shape(rm.m_shape));
+            compare_tensor_shape(ra, rm);
+        }
+
+        {
+            SCOPED_TRACE("column_major constructor");
+            column_major_result cm;
+            tensor_type ca(to_tensor_shape(cm.m_shape), layout::column_major);
+            compare_tensor_shape(ca, cm);
+        }
+    }
+
+    TEST(xtensor, strided_constructor)
+    {
+        central_major_result cmr;
+        tensor_type cma(to_tensor_shape(cmr.m_shape), to_tensor_shape(cmr.m_strides));
+        compare_tensor_shape(cma, cmr);
+    }
+
+    TEST(xtensor, valued_constructor)
+    {
+        row_major_result rm;
+        int value = 2;
+        tensor_type ra(to_tensor_shape(rm.m_shape), value);
+        compare_tensor_shape(ra, rm);
+        tensor_type::container_type vec(ra.size(), value);
+        EXPECT_EQ(ra.data(), vec);
+    }
+
+    TEST(xtensor, copy_semantic)
+    {
+        central_major_result res;
+        int value = 2;
+        tensor_type a(to_tensor_shape(res.m_shape), to_tensor_shape(res.m_strides), value);
+
+        {
+            SCOPED_TRACE("copy constructor");
+            tensor_type b(a);
+            EXPECT_EQ(a, b);
+        }
+
+        {
+            SCOPED_TRACE("assignment operator");
+            row_major_result r;
+            tensor_type c(to_tensor_shape(r.m_shape), 0);
+            EXPECT_NE(a.data(), c.data());
+            c = a;
+            EXPECT_EQ(a, c);
+        }
+    }
+
+    TEST(xtensor, access)
+    {
+        row_major_result rm;
+        tensor_type a(to_tensor_shape(rm.m_shape));
+        assign_array(a, rm.m_assigner);
+        EXPECT_EQ(a.data(), to_container<tensor_type>(rm.m_data));
+
+        column_major_result cm;
+        a.reshape(to_tensor_shape(cm.m_shape), layout::column_major);
+        assign_array(a, cm.m_assigner);
+        EXPECT_EQ(a.data(), to_container<tensor_type>(cm.m_data));
+    }
+
+    TEST(xtensor, initializer_list)
+    {
+        xtensor<int, 1> a1 = {1, 2};
+        xtensor<int, 2> a2 = {{1, 2}, {2, 4}, {5, 6}};
+        EXPECT_EQ(2, a1(1));
+        EXPECT_EQ(4, a2(1, 1));
+        EXPECT_EQ(3, a2.shape()[0]);
+        EXPECT_EQ(2, a2.shape()[1]);
+    }
+
+    TEST(xtensor, zerod)
+    {
+        xtensor<int, 0> a;
+        EXPECT_EQ(1, a.size());
+        EXPECT_EQ(0, a.dimension());
+    }
+
+    TEST(xtensor, shape_promotion)
+    {
+        xtensor<int, 2> a = {{1, 2, 3}, {4, 5, 6}};
+        xtensor<int, 1> b = {1, 2, 3};
+        xarray<int> c = {1, 2, 3};
+
+        using fixed_function_shape = decltype(a + b)::shape_type;
+        using dynamic_function_shape = decltype(a + c)::shape_type;
+        using scalar_function_shape = decltype(a + 2)::shape_type;
+        bool fixed_promotion = std::is_same<fixed_function_shape, std::array<size_t, 2>>::value;
+        bool dynamic_promotion = std::is_same<dynamic_function_shape, xarray<int>::shape_type>::value;
+        bool scalar_promotion = std::is_same<scalar_function_shape, std::array<size_t, 2>>::value;
+        EXPECT_TRUE(fixed_promotion);
+        EXPECT_TRUE(dynamic_promotion);
+        EXPECT_TRUE(scalar_promotion);
+    }
+
+    TEST(xtensor, broadcast_assign)
+    {
+        xtensor<int, 2> a = {{1, 2, 3}, {4, 5, 6}};
+        xtensor<int, 1> b = {1, 2, 3};
+        xtensor<int, 2> res = a + b;
+        xtensor<int, 2> expected = {{2, 4, 6}, {5, 7, 9}};
+        EXPECT_EQ(expected, res);
+
+        xarray<int> c = {{1, 2, 3}, {4, 5, 6}};
+        xtensor<int, 2> res2 = c * b;
+        xtensor<int, 2> expected2 = {{1, 4, 9}, {4, 10, 18}};
+        EXPECT_EQ(expected2, res2);
+
+        res += b;
+        xtensor<int, 2> expected3 = {{3, 6, 9}, {6, 9, 12}};
+        EXPECT_EQ(expected3, res);
+    }
+
+    TEST(xtensor, view)
+    {
+        xtensor<int, 2> a = {{1, 2, 3}, {4, 5, 6}};
+        auto v = make_xview(a, 1, range(0, 2));
+        bool fixed_view_shape = std::is_same<decltype(v)::shape_type, std::array<size_t, 1>>::value;
+        EXPECT_TRUE(fixed_view_shape);
+        EXPECT_EQ(2, v.shape()[0]);
+        EXPECT_EQ(5, v(1));
+    }
+}
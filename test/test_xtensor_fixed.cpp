@@ -0,0 +1,126 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "xtensor/xtensor_fixed.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xarray.hpp"
+
+namespace xt
+{
+    using std::size_t;
+    using fixed_type = xtensor_fixed<int, 3, 2, 4>;
+
+    TEST(xtensor_fixed, constexpr_shape)
+    {
+        static_assert(fixed_type::size() == 24, "size must be a constant expression");
+        static_assert(fixed_type::dimension() == 3, "dimension must be a constant expression");
+        static_assert(fixed_type::strides()[0] == 8, "strides must be constant expressions");
+        static_assert(fixed_type::data_offset(1, 1, 2) == 14, "data_offset must be a constant expression");
+
+        using shape_type = fixed_type::shape_type;
+        shape_type shape = { 3, 2, 4 };
+        shape_type strides = { 8, 4, 1 };
+        shape_type backstrides = { 16, 4, 3 };
+        EXPECT_EQ(shape, fixed_type::shape());
+        EXPECT_EQ(strides, fixed_type::strides());
+        EXPECT_EQ(backstrides, fixed_type::backstrides());
+        EXPECT_EQ(sizeof(int) * 24, sizeof(fixed_type));
+    }
+
+    TEST(xtensor_fixed, unit_shape)
+    {
+        using unit_type = xtensor_fixed<int, 3, 1, 4>;
+        using shape_type = unit_type::shape_type;
+        shape_type strides = { 4, 0, 1 };
+        shape_type backstrides = { 8, 0, 3 };
+        EXPECT_EQ(strides, unit_type::strides());
+        EXPECT_EQ(backstrides, unit_type::backstrides());
+    }
+
+    TEST(xtensor_fixed, access)
+    {
+        xtensor_fixed<int, 2, 3> a = {{1, 2, 3}, {4, 5, 6}};
+        EXPECT_EQ(2, a(0, 1));
+        EXPECT_EQ(6, a(1, 2));
+        a(1, 1) = 8;
+        EXPECT_EQ(8, a.data()[4]);
+    }
+
+    TEST(xtensor_fixed, initializer_list_mismatch)
+    {
+        using type = xtensor_fixed<int, 2, 3>;
+        EXPECT_THROW(type({{1, 2}, {4, 5}}), broadcast_error<size_t>);
+    }
+
+    TEST(xtensor_fixed, assign_xexpression)
+    {
+        xtensor_fixed<double, 3, 3> a = {{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}};
+        xtensor_fixed<double, 3> b = {1., 2., 3.};
+        xtensor_fixed<double, 3, 3> res = a * b + 1.;
+        xtensor_fixed<double, 3, 3> expected = {{2., 5., 10.}, {5., 11., 19.}, {8., 17., 28.}};
+        EXPECT_EQ(expected, res);
+
+        res = a;
+        res += a;
+        EXPECT_EQ(2. * a(2, 1), res(2, 1));
+    }
+
+    TEST(xtensor_fixed, simd_assign)
+    {
+        using array_type = xtensor_fixed<double, 3, 5>;
+        array_type a;
+        array_type b;
+        xarray<double> c(xarray<double>::shape_type({ 3, 5 }));
+        for(size_t i = 0; i < a.size(); ++i)
+        {
+            a.data_element(i) = double(i) / 7.;
+            b.data_element(i) = 2. - double(i);
+            c.data()[i] = double(i) + 0.5;
+        }
+
+        bool simd = simd_traits<double>::size != 1;
+        EXPECT_EQ(simd, (has_simd_interface<array_type, double>::value));
+        EXPECT_EQ(simd, (detail::simd_assignable<array_type, decltype(a * b + c)>::value));
+        EXPECT_FALSE((has_simd_interface<xtensor_fixed<int, 3, 5>, double>::value));
+
+        array_type res = a * b + c;
+        for(size_t i = 0; i < res.size(); ++i)
+        {
+            EXPECT_EQ(a.data()[i] * b.data()[i] + c.data()[i], res.data_element(i));
+        }
+
+        res += sqrt(a);
+        for(size_t i = 0; i < res.size(); ++i)
+        {
+            EXPECT_EQ(a.data()[i] * b.data()[i] + c.data()[i] + std::sqrt(a.data()[i]), res.data()[i]);
+        }
+    }
+
+    TEST(xtensor_fixed, mixed_expression)
+    {
+        xtensor_fixed<int, 2, 3> a = {{1, 2, 3}, {4, 5, 6}};
+        xarray<int> b = {1, 2, 3};
+        xtensor<int, 2> c = {{1, 1, 1}, {2, 2, 2}};
+
+        xarray<int> res = a + b;
+        EXPECT_EQ(9, res(1, 2));
+
+        xtensor_fixed<int, 2, 3> res2 = a + c;
+        EXPECT_EQ(8, res2(1, 2));
+    }
+
+    TEST(xtensor_fixed, incompatible_shape)
+    {
+        xtensor_fixed<int, 2, 3> a;
+        xarray<int> b = {{1, 2}, {3, 4}};
+        EXPECT_THROW(a = b, broadcast_error<size_t>);
+    }
+}
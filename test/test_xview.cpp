@@ -141,6 +141,54 @@ namespace xt
         EXPECT_EQ(iter2, iter_end2);
     }
 
+    TEST(xview, random_access_iterator)
+    {
+        xshape<size_t> shape = {2, 3, 4};
+        xarray<double> a(shape);
+        std::vector<double> data {24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13,
+                                  12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1};
+        std::copy(data.begin(), data.end(), a.storage_begin());
+
+        auto view1 = make_xview(a, range(0, 2), 1, range(1, 4));
+        auto iter = view1.begin();
+        EXPECT_EQ(6, view1.end() - iter);
+        EXPECT_EQ(18, iter[1]);
+        EXPECT_EQ(7, *(iter + 3));
+        EXPECT_EQ(5, *(view1.end() - 1));
+
+        std::sort(view1.begin(), view1.end());
+        std::vector<double> expected {5, 6, 7, 17, 18, 19};
+        EXPECT_TRUE(std::equal(expected.cbegin(), expected.cend(), view1.cbegin()));
+        EXPECT_EQ(5, a(0, 1, 1));
+        EXPECT_EQ(19, a(1, 1, 3));
+        EXPECT_EQ(24, a(0, 0, 0));
+        EXPECT_EQ(9, a(1, 0, 3));
+    }
+
+    TEST(xview, storage_iterator)
+    {
+        xshape<size_t> shape = {3, 4};
+        xarray<int> a(shape);
+        std::vector<int> data {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+        std::copy(data.begin(), data.end(), a.storage_begin());
+
+        auto col = make_xview(a, range(0, 3), 1);
+        std::vector<int> expected {2, 6, 10};
+        EXPECT_EQ(3, std::distance(col.storage_begin(), col.storage_end()));
+        EXPECT_TRUE(std::equal(col.storage_begin(), col.storage_end(), expected.cbegin()));
+
+        const auto& ccol = col;
+        EXPECT_TRUE(std::equal(ccol.storage_begin(), ccol.storage_end(), expected.cbegin()));
+
+        std::fill(col.storage_begin(), col.storage_end(), 0);
+        EXPECT_EQ(0, a(2, 1));
+        EXPECT_EQ(11, a(2, 2));
+
+        auto row = make_xview(a, 1, range(1, 4));
+        EXPECT_EQ(a.storage_begin() + 5, row.data_xbegin());
+        EXPECT_TRUE(std::equal(row.storage_begin(), row.storage_end(), row.data_xbegin()));
+    }
+
     TEST(xview, xview_on_xfunction)
     {
         xshape<size_t> shape = {3, 4};
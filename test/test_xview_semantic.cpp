@@ -7,6 +7,7 @@
 ****************************************************************************/
 
 #include "gtest/gtest.h"
+#include "xtensor/xnoalias.hpp"
 #include "xtensor/xview.hpp"
 #include "test_xsemantic.hpp"
 
@@ -390,5 +391,93 @@ namespace xt
             EXPECT_EQ(t.vres_ru, b);
         }
     }
-}
 
+    TEST(xview_semantic, noalias_contiguous)
+    {
+        xshape<size_t> shape = {3, 4};
+        xarray<double> a(shape, 1.);
+        xarray<double> b = {1., 2., 3., 4.};
+
+        auto row = make_xview(a, 1, range(0, 4));
+        EXPECT_TRUE(row.is_contiguous());
+        EXPECT_EQ(4, row.data_offset());
+        noalias(row) = b + 1.;
+        xarray<double> expected = {{1., 1., 1., 1.}, {2., 3., 4., 5.}, {1., 1., 1., 1.}};
+        EXPECT_EQ(expected, a);
+
+        noalias(row) += b;
+        expected = {{1., 1., 1., 1.}, {3., 5., 7., 9.}, {1., 1., 1., 1.}};
+        EXPECT_EQ(expected, a);
+
+        auto rows = make_xview(a, range(0, 2));
+        EXPECT_TRUE(rows.is_contiguous());
+        rows = xarray<double>({{0., 1., 2., 3.}, {4., 5., 6., 7.}});
+        expected = {{0., 1., 2., 3.}, {4., 5., 6., 7.}, {1., 1., 1., 1.}};
+        EXPECT_EQ(expected, a);
+    }
+
+    TEST(xview_semantic, noalias_non_contiguous)
+    {
+        xshape<size_t> shape = {3, 4};
+        xarray<double> a(shape, 1.);
+
+        auto col = make_xview(a, range(0, 3), 2);
+        EXPECT_FALSE(col.is_contiguous());
+        EXPECT_EQ(4, col.strides()[0]);
+        noalias(col) = xarray<double>({5., 6., 7.});
+        noalias(col) += xarray<double>({1., 1., 1.});
+        xarray<double> expected = {{1., 1., 6., 1.}, {1., 1., 7., 1.}, {1., 1., 8., 1.}};
+        EXPECT_EQ(expected, a);
+
+        xarray<double> c(shape, 0., layout::column_major);
+        auto block = make_xview(c, range(0, 3), range(1, 3));
+        EXPECT_TRUE(block.is_contiguous());
+        xarray<double> b = {{1., 2.}, {3., 4.}, {5., 6.}};
+        EXPECT_FALSE(b.is_trivial_broadcast(block.strides()));
+        noalias(block) = b;
+        EXPECT_EQ(2., c(0, 2));
+        EXPECT_EQ(3., c(1, 1));
+        EXPECT_EQ(0., c(2, 3));
+        EXPECT_EQ(6., c(2, 2));
+    }
+
+    TEST(xview_semantic, contiguous_scalar_elements)
+    {
+        // int has no SIMD interface, so contiguous views are copied
+        // along their data iterators.
+        xshape<size_t> shape = {3, 4};
+        xarray<int> a(shape, 1);
+        xarray<int> b = {1, 2, 3, 4};
+
+        auto row = make_xview(a, 1, range(0, 4));
+        auto first = make_xview(a, 0, range(0, 4));
+        noalias(row) = first + b;
+        xarray<int> expected = {{1, 1, 1, 1}, {2, 3, 4, 5}, {1, 1, 1, 1}};
+        EXPECT_EQ(expected, a);
+
+        auto last = make_xview(a, 2, range(0, 4));
+        noalias(last) = row;
+        expected = {{1, 1, 1, 1}, {2, 3, 4, 5}, {2, 3, 4, 5}};
+        EXPECT_EQ(expected, a);
+
+        last += 1;
+        expected = {{1, 1, 1, 1}, {2, 3, 4, 5}, {3, 4, 5, 6}};
+        EXPECT_EQ(expected, a);
+
+        auto col = make_xview(a, range(0, 3), 1);
+        col *= 2;
+        expected = {{1, 2, 1, 1}, {2, 6, 4, 5}, {3, 8, 5, 6}};
+        EXPECT_EQ(expected, a);
+    }
+
+    TEST(xview_semantic, broadcast_operand)
+    {
+        xshape<size_t> shape = {3, 4};
+        xarray<double> a(shape, 1.);
+        xarray<double> m = {{0., 1., 2., 3.}, {4., 5., 6., 7.}};
+        auto row = make_xview(m, 1);
+        xarray<double> res = a + row;
+        xarray<double> expected = {{5., 6., 7., 8.}, {5., 6., 7., 8.}, {5., 6., 7., 8.}};
+        EXPECT_EQ(expected, res);
+    }
+}